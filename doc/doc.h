@@ -454,6 +454,12 @@
  * # The Hubble parameter, here in units of km/s/Mpc, must be consistent
  * # with modelHubble.
  * h0 = 71
+ * # With MPI, all tasks can write their part of the grid at the same time
+ * # through MPI-IO instead of taking turns.
+ * #doCollectiveWrite = true
+ * # Preallocate the file and write it with direct I/O, keeping the page
+ * # cache free for the rest of the run.
+ * #useDirectIO = true
  *
  * [WhiteNoise]
  * # We want to use the RNG
@@ -1111,6 +1117,23 @@
  * patchDims = 256 256 190
  * @endcode
  *
+ * The velocity sections must not set @c doCollectiveRead: the tasks of
+ * generateICs read different numbers of tiles, and do so while converting
+ * the previous one, which collective MPI-IO reads cannot follow.
+ * generateICs hence refuses such sections.
+ *
+ * If the velocity fields were written compressed, they should be chunked
+ * to match the tiles of the mask (@c chunkNumTiles in the writer section
+ * of ginnungagap, set to the number of tiles per dimension) and the
+ * velocity sections should provide a chunk cache holding at least one
+ * chunk:
+ * @code
+ * chunkCacheMB = 64
+ * chunkCacheSlots = 12421
+ * chunkCachePreemption = 1.0
+ * @endcode
+ * This way every chunk is decompressed exactly once.
+ *
  */
 
 /*--- Page: External Dependencies ---------------------------------------*/
@@ -42,8 +42,12 @@
 #include "../libdata/dataVarType.h"
 #include "../libgrid/gridWriter.h"
 #include "../libgrid/gridWriterFactory.h"
+#ifdef WITH_HDF5
+#  include "../libgrid/gridWriterHDF5.h"
+#endif
 #include "../libgrid/gridStatistics.h"
 #include "../libgrid/gridHistogram.h"
+#include "../libgrid/gridSummary.h"
 #ifdef WITH_FFT_FFTW3
 #  include <complex.h>
 #  include <fftw3.h>
@@ -89,7 +93,10 @@ static void
 local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode);
 
 static void
-local_doStatistics(ginnungagap_t g9p, int idxOfVar);
+local_doStatistics(ginnungagap_t   g9p,
+                   int             idxOfVar,
+                   gridHistogram_t histo,
+                   const char      *histoName);
 
 static void
 local_doHistogram(ginnungagap_t         g9p,
@@ -103,6 +110,9 @@ local_doRenames(dataVar_t var, gridWriter_t writer, const char *newName);
 static void
 local_do2LPTCorrections(ginnungagap_t g9p);
 
+static void
+local_printWriteStats(ginnungagap_t g9p);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern ginnungagap_t
@@ -172,10 +182,9 @@ ginnungagap_run(ginnungagap_t g9p)
 	local_doDeltaK(g9p);
 	local_doDeltaKPk(g9p);
 	local_doDeltaX(g9p);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoDens,
-		                  g9p->setup->nameHistogramDens);
+	local_doStatistics(g9p, 0,
+	                   g9p->setup->doHistograms ? g9p->histoDens : NULL,
+	                   g9p->setup->nameHistogramDens);
 	if (g9p->rank == 0)
 		printf("\n");
 
@@ -185,10 +194,9 @@ ginnungagap_run(ginnungagap_t g9p)
 	local_doWhiteNoise(g9p, false);
 	local_doDeltaK(g9p);
 	local_doVelocities(g9p, G9PIC_MODE_VX);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoVel,
-		                  g9p->setup->nameHistogramVelx);
+	local_doStatistics(g9p, 0,
+	                   g9p->setup->doHistograms ? g9p->histoVel : NULL,
+	                   g9p->setup->nameHistogramVelx);
 	if (g9p->rank == 0)
 		printf("\n");
 
@@ -196,10 +204,9 @@ ginnungagap_run(ginnungagap_t g9p)
 	local_doWhiteNoise(g9p, false);
 	local_doDeltaK(g9p);
 	local_doVelocities(g9p, G9PIC_MODE_VY);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoVel,
-		                  g9p->setup->nameHistogramVely);
+	local_doStatistics(g9p, 0,
+	                   g9p->setup->doHistograms ? g9p->histoVel : NULL,
+	                   g9p->setup->nameHistogramVely);
 	if (g9p->rank == 0)
 		printf("\n");
 
@@ -207,10 +214,9 @@ ginnungagap_run(ginnungagap_t g9p)
 	local_doWhiteNoise(g9p, false);
 	local_doDeltaK(g9p);
 	local_doVelocities(g9p, G9PIC_MODE_VZ);
-	local_doStatistics(g9p, 0);
-	if (g9p->setup->doHistograms)
-		local_doHistogram(g9p, 0, g9p->histoVel,
-		                  g9p->setup->nameHistogramVelz);
+	local_doStatistics(g9p, 0,
+	                   g9p->setup->doHistograms ? g9p->histoVel : NULL,
+	                   g9p->setup->nameHistogramVelz);
 	if (g9p->rank == 0)
 		printf("\n");
 	}
@@ -220,7 +226,7 @@ ginnungagap_run(ginnungagap_t g9p)
 		local_doWhiteNoise(g9p, false);
 		local_doDeltaK(g9p);
 		local_doVelocities(g9p, G9PIC_MODE_LVX);
-		local_doStatistics(g9p, 0);
+		local_doStatistics(g9p, 0, NULL, NULL);
 		if (g9p->rank == 0)
 			printf("\n");
 	
@@ -228,7 +234,7 @@ ginnungagap_run(ginnungagap_t g9p)
 		local_doWhiteNoise(g9p, false);
 		local_doDeltaK(g9p);
 		local_doVelocities(g9p, G9PIC_MODE_LVY);
-		local_doStatistics(g9p, 0);
+		local_doStatistics(g9p, 0, NULL, NULL);
 		if (g9p->rank == 0)
 			printf("\n");
 	
@@ -236,7 +242,7 @@ ginnungagap_run(ginnungagap_t g9p)
 		local_doWhiteNoise(g9p, false);
 		local_doDeltaK(g9p);
 		local_doVelocities(g9p, G9PIC_MODE_LVZ);
-		local_doStatistics(g9p, 0);
+		local_doStatistics(g9p, 0, NULL, NULL);
 		if (g9p->rank == 0)
 			printf("\n");
 	}
@@ -246,7 +252,7 @@ ginnungagap_run(ginnungagap_t g9p)
 		local_doWhiteNoise(g9p, false);
 		local_doDeltaK(g9p);
 		local_doVelocities(g9p, G9PIC_MODE_SVX);
-		local_doStatistics(g9p, 0);
+		local_doStatistics(g9p, 0, NULL, NULL);
 		if (g9p->rank == 0)
 			printf("\n");
 	
@@ -254,7 +260,7 @@ ginnungagap_run(ginnungagap_t g9p)
 		local_doWhiteNoise(g9p, false);
 		local_doDeltaK(g9p);
 		local_doVelocities(g9p, G9PIC_MODE_SVY);
-		local_doStatistics(g9p, 0);
+		local_doStatistics(g9p, 0, NULL, NULL);
 		if (g9p->rank == 0)
 			printf("\n");
 	
@@ -262,7 +268,7 @@ ginnungagap_run(ginnungagap_t g9p)
 		local_doWhiteNoise(g9p, false);
 		local_doDeltaK(g9p);
 		local_doVelocities(g9p, G9PIC_MODE_SVZ);
-		local_doStatistics(g9p, 0);
+		local_doStatistics(g9p, 0, NULL, NULL);
 		if (g9p->rank == 0)
 			printf("\n");
 	}
@@ -270,6 +276,8 @@ ginnungagap_run(ginnungagap_t g9p)
 	
 	if (g9p->setup->do2LPTCorrections)
 		local_do2LPTCorrections(g9p);
+
+	local_printWriteStats(g9p);
 } /* ginnungagap_run */
 
 extern void
@@ -533,18 +541,30 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 } /* local_doVelocities */
 
 static void
-local_doStatistics(ginnungagap_t g9p, int idxOfVar)
+local_doStatistics(ginnungagap_t   g9p,
+                   int             idxOfVar,
+                   gridHistogram_t histo,
+                   const char      *histoName)
 {
 	double           timing;
 	gridStatistics_t stat;
 
-	timing = timer_start_text("  Calculating statistics... ");
+	if (histo != NULL)
+		timing = timer_start_text(
+		    "  Calculating statistics and histogram... ");
+	else
+		timing = timer_start_text("  Calculating statistics... ");
 	stat   = gridStatistics_new();
-	gridStatistics_calcGridRegularDistrib(stat, g9p->gridDistrib,
-	                                      idxOfVar);
+	gridSummary_calcGridRegularDistrib(stat, histo, g9p->gridDistrib,
+	                                   idxOfVar);
 	timing = timer_stop_text(timing, "took %.5fs\n");
-	if (g9p->rank == 0)
+	if (g9p->rank == 0) {
 		gridStatistics_printPretty(stat, stdout, "  ");
+		if (histo != NULL) {
+			gridHistogram_printPrettyFile(histo, histoName, false, "");
+			printf("    Histogram written to %s.\n", histoName);
+		}
+	}
 	gridStatistics_del(&stat);
 }
 
@@ -586,3 +606,30 @@ static void
 local_do2LPTCorrections(ginnungagap_t g9p)
 {
 }
+
+static void
+local_printWriteStats(ginnungagap_t g9p)
+{
+	double stats[3] = {0.0, 0.0, 0.0};
+
+#ifdef WITH_HDF5
+	if (gridWriter_getType(g9p->finalWriter) == GRIDIO_TYPE_HDF5) {
+		uint64_t bytesRaw, bytesStored;
+		gridWriterHDF5_getWriteStats((gridWriterHDF5_t)g9p->finalWriter,
+		                             &bytesRaw, &bytesStored, stats + 2);
+		stats[0] = (double)bytesRaw;
+		stats[1] = (double)bytesStored;
+	}
+#endif
+#ifdef WITH_MPI
+	MPI_Allreduce(MPI_IN_PLACE, stats, 3, MPI_DOUBLE, MPI_SUM,
+	              MPI_COMM_WORLD);
+#endif
+
+	if ((g9p->rank == 0) && (stats[0] > 0.0)) {
+		printf("  Wrote %.2f MB to HDF5, stored in %.2f MB (compression "
+		       "ratio %.2f), in %.2fs summed over all tasks\n",
+		       stats[0] / 1048576., stats[1] / 1048576.,
+		       stats[1] > 0. ? stats[0] / stats[1] : 0.0, stats[2]);
+	}
+}
@@ -42,6 +42,18 @@ g9pICMap_new(uint32_t     numFiles,
              const int8_t *gasLevel,
              g9pMask_t    mask,
              uint32_t zoomlevel)
+{
+	return g9pICMap_newWithTileOrder(numFiles, numGasLevel, gasLevel, mask,
+	                                 zoomlevel, NULL);
+}
+
+extern g9pICMap_t
+g9pICMap_newWithTileOrder(uint32_t       numFiles,
+                          uint32_t       numGasLevel,
+                          const int8_t   *gasLevel,
+                          g9pMask_t      mask,
+                          uint32_t       zoomlevel,
+                          const uint32_t *tileOrder)
 {
 	g9pICMap_t map;
 
@@ -62,6 +74,20 @@ g9pICMap_new(uint32_t     numFiles,
 		map->gasLevel = NULL;
 	}
 
+	map->tileOrder = NULL;
+	map->tilePos   = NULL;
+	if (tileOrder != NULL) {
+		const uint32_t numTiles = g9pMask_getTotalNumTiles(map->mask);
+
+		map->tileOrder = xmalloc(sizeof(uint32_t) * numTiles * 2);
+		map->tilePos   = map->tileOrder + numTiles;
+		for (uint32_t i = 0; i < numTiles; i++) {
+			assert(tileOrder[i] < numTiles);
+			map->tileOrder[i]          = tileOrder[i];
+			map->tilePos[tileOrder[i]] = i;
+		}
+	}
+
 	const int8_t numLevel = g9pMask_getNumLevel(map->mask);
 	map->firstTileIdx = xmalloc(sizeof(uint32_t) * map->numFiles * 2);
 	map->lastTileIdx  = map->firstTileIdx + map->numFiles;
@@ -81,6 +107,8 @@ g9pICMap_del(g9pICMap_t *g9pICMap)
 
 	xfree((*g9pICMap)->firstTileIdx);
 	xfree((*g9pICMap)->numCells);
+	if ((*g9pICMap)->tileOrder != NULL)
+		xfree((*g9pICMap)->tileOrder);
 	if ((*g9pICMap)->gasLevel != NULL)
 		xfree((*g9pICMap)->gasLevel);
 	g9pMask_del(&((*g9pICMap)->mask));
@@ -96,13 +124,14 @@ g9pICMap_getFileForTile(const g9pICMap_t map, const uint32_t tile)
 	assert(map != NULL);
 	assert(tile < g9pMask_getTotalNumTiles(map->mask));
 
+	uint32_t pos  = (map->tilePos != NULL) ? map->tilePos[tile] : tile;
 	uint32_t file = 0;
-	while ((file < map->numFiles) && (map->lastTileIdx[file] < tile)) {
+	while ((file < map->numFiles) && (map->lastTileIdx[file] < pos)) {
 		file++;
 	}
 	assert(file < map->numFiles);
-	assert(map->lastTileIdx[file] >= tile);
-	assert(map->firstTileIdx[file] <= tile);
+	assert(map->lastTileIdx[file] >= pos);
+	assert(map->firstTileIdx[file] <= pos);
 
 	return file;
 }
@@ -135,6 +164,15 @@ g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
 	return map->numCells + (file * g9pMask_getNumLevel(map->mask));
 }
 
+extern uint32_t
+g9pICMap_getTileAt(const g9pICMap_t map, const uint32_t pos)
+{
+	assert(map != NULL);
+	assert(pos < g9pMask_getTotalNumTiles(map->mask));
+
+	return (map->tileOrder != NULL) ? map->tileOrder[pos] : pos;
+}
+
 /*--- Implementations of local functions --------------------------------*/
 static void
 local_calcIdx(g9pICMap_t map, uint32_t zoomlevel)
@@ -146,6 +184,8 @@ local_calcIdx(g9pICMap_t map, uint32_t zoomlevel)
 	for (uint32_t i=0; i<numTiles; i++) {
 		numCellsTot+=g9pMask_getNumCellsInTileForLevel(map->mask, i, zoomlevel);
 	}
+	// The files take consecutive runs of positions, each position is
+	// translated to its tile.
 	uint64_t numCellsLeft = numCellsTot;
 	uint32_t cellsPerFile = numCellsLeft / map->numFiles;
 
@@ -155,8 +195,11 @@ local_calcIdx(g9pICMap_t map, uint32_t zoomlevel)
 	uint32_t numCells = 0;
 	uint32_t file = 0;
 	for (uint32_t i = 0; i < numTiles; i++) {
-		numCells += g9pMask_getNumCellsInTileForLevel(map->mask, i, zoomlevel);
-		if (numCells >= cellsPerFile) {
+		numCells += g9pMask_getNumCellsInTileForLevel(map->mask,
+		                                              g9pICMap_getTileAt(map, i),
+		                                              zoomlevel);
+		// The last file takes all remaining tiles.
+		if ((numCells >= cellsPerFile) && (file < map->numFiles - 1)) {
 			map->lastTileIdx[file] = i;
 			numCellsLeft -= numCells;
 			numCells = 0;
@@ -186,7 +229,8 @@ local_calcNumCellsPerFile(g9pICMap_t map)
 		for (int8_t k = 0; k < numLevel; k++)
 			map->numCells[i * numLevel + k] = UINT64_C(0);
 		do {
-			tmp = g9pMask_getNumCellsInTile(map->mask, j, tmp);
+			tmp = g9pMask_getNumCellsInTile(map->mask,
+			                                g9pICMap_getTileAt(map, j), tmp);
 			for (int8_t k = 0; k < numLevel; k++)
 				map->numCells[i * numLevel + k] += tmp[k];
 		} while (++j <= map->lastTileIdx[i]);
@@ -52,6 +52,37 @@ g9pICMap_new(uint32_t     numFiles,
              g9pMask_t    mask,
              uint32_t zoomlevel);
 
+/**
+ * @brief  Creates a map in which the files hold consecutive runs of tiles
+ *         in a given order instead of the tile numbering.
+ *
+ * The first and last tile of a file are then positions in that order,
+ * g9pICMap_getTileAt() translates them to tile numbers.
+ *
+ * @param[in]  numFiles
+ *                See g9pICMap_new().
+ * @param[in]  numGasLevel
+ *                See g9pICMap_new().
+ * @param[in]  *gasLevel
+ *                See g9pICMap_new().
+ * @param[in]  mask
+ *                See g9pICMap_new().
+ * @param[in]  zoomlevel
+ *                See g9pICMap_new().
+ * @param[in]  *tileOrder
+ *                Array holding each tile number of the mask once, in the
+ *                order in which the tiles should be assigned to the files.
+ *                The map keeps its own copy.  Passing @c NULL gives the
+ *                same map as g9pICMap_new().
+ */
+extern g9pICMap_t
+g9pICMap_newWithTileOrder(uint32_t       numFiles,
+                          uint32_t       numGasLevel,
+                          const int8_t   *gasLevel,
+                          g9pMask_t      mask,
+                          uint32_t       zoomlevel,
+                          const uint32_t *tileOrder);
+
 extern void
 g9pICMap_del(g9pICMap_t *g9pICMap);
 
@@ -68,6 +99,21 @@ extern const uint64_t *
 g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
                                    const uint32_t   file);
 
+/**
+ * @brief  Gives the tile at a given position in the order of the map.
+ *
+ * @param[in]  map
+ *                The map to query.
+ * @param[in]  pos
+ *                The position, as given by g9pICMap_getFirstTileInFile()
+ *                and g9pICMap_getLastTileInFile().
+ *
+ * @return  Returns the tile number, this is @c pos unless the map has been
+ *          created with g9pICMap_newWithTileOrder().
+ */
+extern uint32_t
+g9pICMap_getTileAt(const g9pICMap_t map, const uint32_t pos);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -31,6 +31,8 @@ struct g9pICMap_struct {
 	// Computed information
 	uint32_t       *firstTileIdx; // Stores for each file the first tile idx
 	uint32_t       *lastTileIdx;  // Stores for each file the last tile idx
+	uint32_t       *tileOrder;    // The tile at each position, or NULL
+	uint32_t       *tilePos;      // The position of each tile, or NULL
 	uint64_t 		*numCells; // Stores for each file cell counts
 };
 
@@ -21,9 +21,7 @@
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
-#endif
+#include "../libutil/xmem.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
@@ -61,7 +59,7 @@ g9pICMap_verifySimpleMapCreation(void)
 	// Mask at 32^3, minLevel at 16^3, maxLevel at 128^3, tiling at 2^3
 	g9pMask_t      m = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
 
-	map = g9pICMap_new(3, 0, NULL, m);
+	map = g9pICMap_new(3, 0, NULL, m, 3);
 
 	const uint64_t *numCells;
 	uint32_t       firstTile, lastTile;
@@ -94,4 +92,72 @@ g9pICMap_verifySimpleMapCreation(void)
 	return hasPassed ? true : false;
 } /* g9pICMap_verifySimpleMapCreation */
 
+extern bool
+g9pICMap_verifyMapCreationWithTileOrder(void)
+{
+	bool       hasPassed = true;
+	int        rank      = 0;
+	g9pICMap_t map;
+	uint32_t   *order;
+	uint32_t   numTilesSeen = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t     allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// 2 4 8 16 32 64 128
+	g9pHierarchy_t h = g9pHierarchy_newWithSimpleFactor(7, 2, 2);
+	// Mask at 32^3, minLevel at 16^3, maxLevel at 128^3, tiling at 4^3
+	g9pMask_t      m = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 1);
+
+	order = g9pMask_getTileOrderPeanoHilbert(m);
+	map   = g9pICMap_newWithTileOrder(3, 0, NULL, m, 3, order);
+
+	for (uint32_t i = 0; i < 3; i++) {
+		uint32_t       firstTile = g9pICMap_getFirstTileInFile(map, i);
+		uint32_t       lastTile  = g9pICMap_getLastTileInFile(map, i);
+		const uint64_t *numCells = g9pICMap_getNumCellsPerLevelInFile(map,
+		                                                              i);
+
+		if (firstTile != numTilesSeen)
+			hasPassed = false;
+		if (numCells[0] != 64 * (lastTile - firstTile + 1))
+			hasPassed = false;
+		for (uint32_t pos = firstTile; pos <= lastTile; pos++) {
+			if (g9pICMap_getTileAt(map, pos) != order[pos])
+				hasPassed = false;
+			if (g9pICMap_getFileForTile(map, order[pos]) != i)
+				hasPassed = false;
+		}
+		numTilesSeen = lastTile + 1;
+	}
+	if (numTilesSeen != 64)
+		hasPassed = false;
+
+	// Subsequent tiles along the curve are neighbours.
+	for (uint32_t pos = 1; pos < 64; pos++) {
+		uint32_t a = order[pos - 1], b = order[pos], dist = 0;
+
+		for (int i = 0; i < 3; i++, a /= 4, b /= 4)
+			dist += (a % 4 > b % 4) ? a % 4 - b % 4 : b % 4 - a % 4;
+		if (dist != 1)
+			hasPassed = false;
+	}
+
+	xfree(order);
+	g9pICMap_del(&map);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pICMap_verifyMapCreationWithTileOrder */
+
 /*--- Implementations of local functions --------------------------------*/
@@ -24,5 +24,8 @@
 extern bool
 g9pICMap_verifySimpleMapCreation(void);
 
+extern bool
+g9pICMap_verifyMapCreationWithTileOrder(void);
+
 
 #endif
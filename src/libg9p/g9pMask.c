@@ -16,10 +16,12 @@
 #include "g9pConfig.h"
 #include "g9pMask.h"
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../libutil/utilMath.h"
 #include "../libutil/xmem.h"
 #include "../libutil/lIdx.h"
+#include "../libutil/phKey.h"
 #include "../libutil/tile.h"
 
 
@@ -30,6 +32,15 @@
 /*--- Local defines -----------------------------------------------------*/
 
 
+/*--- Local structures --------------------------------------------------*/
+
+/** @brief  Pairs a tile with its Peano-Hilbert key for sorting. */
+struct local_tileKey_struct {
+	uint64_t key;
+	uint32_t tile;
+};
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 static g9pMask_t
 local_allocateEmptyMask();
@@ -48,6 +59,9 @@ local_getEmptyPatchForTile_impl(const g9pMask_t         mask,
                                 const uint32_t          tile,
                                 const gridPointUint32_t dims);
 
+static int
+local_compareTileKeys(const void *a, const void *b);
+
 
 /*--- Implementations: Creating and Deleting ----------------------------*/
 extern g9pMask_t
@@ -413,6 +427,111 @@ g9pMask_getEmptyPatchForTileLevel(const g9pMask_t mask, const uint32_t tile, uin
 	return local_getEmptyPatchForTile_impl(mask, tile, dims);
 }
 
+extern void
+g9pMask_getTileIdxsForLevel(const g9pMask_t   mask,
+                            const uint32_t    tile,
+                            uint8_t           level,
+                            gridPointUint32_t idxLo,
+                            gridPointUint32_t idxHi)
+{
+	assert(mask != NULL);
+	assert(tile < mask->totalNumTiles);
+
+	gridPointUint32_t dims, tilePos;
+
+	dims[0] = g9pMask_getDim1DLevel(mask, level);
+	for (int i = 1; i < NDIM; i++)
+		dims[i] = dims[0];
+
+	lIdx_toCoord3d(tile, mask->numTiles, tilePos);
+	tile_calcNDIdxsELAE(NDIM, dims, mask->numTiles, tilePos, idxLo, idxHi);
+}
+
+extern gridPatch_t
+g9pMask_getOccupiedPatchForTileLevel(const g9pMask_t mask,
+                                     const uint32_t  tile,
+                                     uint8_t         level)
+{
+	assert(mask != NULL);
+	assert(tile < mask->totalNumTiles);
+
+	const int8_t      *data = mask->maskTiles[tile];
+	gridPointUint32_t idxLo, idxHi, boxLo, boxHi, p;
+	uint64_t          dimLevel, dimMask;
+	bool              isOccupied = false;
+
+	g9pMask_getTileIdxsForLevel(mask, tile, level, idxLo, idxHi);
+
+	// Tiles without data are completely at the minimum level.
+	if (data == NULL)
+		return (level == mask->minLevel) ? gridPatch_new(idxLo, idxHi) : NULL;
+
+	dimLevel = idxHi[0] - idxLo[0] + 1;
+	dimMask  = g9pMask_getDim1D(mask) / mask->numTiles[0];
+	for (int i = 0; i < NDIM; i++) {
+		boxLo[i] = UINT32_MAX;
+		boxHi[i] = 0;
+	}
+
+	for (p[2] = 0; p[2] < dimLevel; p[2]++) {
+		uint64_t q2 = (p[2] * dimMask) / dimLevel;
+		for (p[1] = 0; p[1] < dimLevel; p[1]++) {
+			uint64_t q1 = (p[1] * dimMask) / dimLevel;
+			for (p[0] = 0; p[0] < dimLevel; p[0]++) {
+				uint64_t q0 = (p[0] * dimMask) / dimLevel;
+
+				if (data[q0 + (q1 + q2 * dimMask) * dimMask] != level)
+					continue;
+				isOccupied = true;
+				for (int i = 0; i < NDIM; i++) {
+					boxLo[i] = p[i] < boxLo[i] ? p[i] : boxLo[i];
+					boxHi[i] = p[i] > boxHi[i] ? p[i] : boxHi[i];
+				}
+			}
+		}
+	}
+
+	if (!isOccupied)
+		return NULL;
+
+	for (int i = 0; i < NDIM; i++) {
+		boxLo[i] += idxLo[i];
+		boxHi[i] += idxLo[i];
+	}
+
+	return gridPatch_new(boxLo, boxHi);
+} // g9pMask_getOccupiedPatchForTileLevel
+
+extern uint32_t *
+g9pMask_getTileOrderPeanoHilbert(const g9pMask_t mask)
+{
+	struct local_tileKey_struct *keys;
+	uint32_t                    *order;
+	gridPointUint32_t           tilePos;
+	int                         bits = 0;
+
+	assert(mask != NULL);
+
+	while ((UINT32_C(1) << bits) < mask->numTiles[0])
+		bits++;
+
+	keys = xmalloc(sizeof(struct local_tileKey_struct) * mask->totalNumTiles);
+	for (uint32_t i = 0; i < mask->totalNumTiles; i++) {
+		lIdx_toCoord3d(i, mask->numTiles, tilePos);
+		keys[i].key  = phKey_fromCoord3d(tilePos, bits);
+		keys[i].tile = i;
+	}
+	qsort(keys, mask->totalNumTiles, sizeof(struct local_tileKey_struct),
+	      &local_compareTileKeys);
+
+	order = xmalloc(sizeof(uint32_t) * mask->totalNumTiles);
+	for (uint32_t i = 0; i < mask->totalNumTiles; i++)
+		order[i] = keys[i].tile;
+	xfree(keys);
+
+	return order;
+} // g9pMask_getTileOrderPeanoHilbert
+
 
 /*--- Implementations of local functions --------------------------------*/
 
@@ -482,3 +601,12 @@ local_getEmptyPatchForTile_impl(const g9pMask_t         mask,
 
 	return gridPatch_new(idxLo, idxHi);
 }
+
+static int
+local_compareTileKeys(const void *a, const void *b)
+{
+	const struct local_tileKey_struct *ka = a;
+	const struct local_tileKey_struct *kb = b;
+
+	return (ka->key < kb->key) ? -1 : (ka->key > kb->key);
+}
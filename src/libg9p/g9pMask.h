@@ -169,6 +169,65 @@ g9pMask_getEmptyPatchForTile(const g9pMask_t mask, const uint32_t tile);
 extern gridPatch_t
 g9pMask_getEmptyPatchForTileLevel(const g9pMask_t mask, const uint32_t tile, uint8_t level);
 
+/**
+ * @brief  Gives the index range a tile covers on the grid of a given level.
+ *
+ * @param[in]   mask
+ *                 The mask to work with.
+ * @param[in]   tile
+ *                 The tile to work on.
+ * @param[in]   level
+ *                 The level of the grid the indices refer to.
+ * @param[out]  idxLo
+ *                 Receives the lower indices of the tile (inclusive).
+ * @param[out]  idxHi
+ *                 Receives the upper indices of the tile (inclusive).
+ *
+ * @return  Returns nothing.
+ */
+extern void
+g9pMask_getTileIdxsForLevel(const g9pMask_t   mask,
+                            const uint32_t    tile,
+                            uint8_t           level,
+                            gridPointUint32_t idxLo,
+                            gridPointUint32_t idxHi);
+
+/**
+ * @brief  Gives an empty patch tightly enclosing the cells of a tile that
+ *         belong to a given level.
+ *
+ * The cells of the level's grid are tested against the mask cell they
+ * fall into, hence the patch encloses exactly the cells for which
+ * particles are generated.
+ *
+ * @param[in]  mask
+ *                The mask to work with.
+ * @param[in]  tile
+ *                The tile to work on.
+ * @param[in]  level
+ *                The level of interest.
+ *
+ * @return  Returns a new patch on the grid of the given level, or @c NULL
+ *          if no cell of the tile belongs to that level.
+ */
+extern gridPatch_t
+g9pMask_getOccupiedPatchForTileLevel(const g9pMask_t mask,
+                                     const uint32_t  tile,
+                                     uint8_t         level);
+
+/**
+ * @brief  Gives the tiles ordered along a Peano-Hilbert curve.
+ *
+ * @param[in]  mask
+ *                The mask to work with.
+ *
+ * @return  Returns a new array holding all tile numbers, ordered by the
+ *          Peano-Hilbert key of the tile position.  The caller is
+ *          responsible for freeing it.
+ */
+extern uint32_t *
+g9pMask_getTileOrderPeanoHilbert(const g9pMask_t mask);
+
 
 /** @} */
 
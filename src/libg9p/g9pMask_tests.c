@@ -273,6 +273,88 @@ g9pMask_verifyCreationOfPatch(void)
 	return hasPassed ? true : false;
 } // g9pMask_verifyCreationOfPatch
 
+extern bool
+g9pMask_verifyCreationOfOccupiedPatch(void)
+{
+	bool   hasPassed      = true;
+	int    rank           = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	g9pHierarchy_t    h    = local_getHierarchy();
+	g9pMask_t         mask = g9pMask_newMinMaxTiledMask(h, 5, 3, 9, 2);
+	uint64_t          nCTM = g9pMask_getNumCellsInMaskTile(mask);
+	int8_t            *data;
+	gridPatch_t       p;
+	gridPointUint32_t idxLo, dims, tileLo, tileHi;
+
+	// Tile 1 is at x = 24..47 on the mask grid (192 cells, 8 tiles).  It
+	// is at level 3, except for a box at level 5.
+	data = xmalloc(sizeof(int8_t) * nCTM);
+	memset(data, 3, sizeof(int8_t) * nCTM);
+	for (uint32_t k = 20; k <= 23; k++)
+		for (uint32_t j = 10; j <= 11; j++)
+			for (uint32_t i = 4; i <= 7; i++)
+				data[i + (j + k * 24) * 24] = 5;
+	(void)g9pMask_setTileData(mask, 1, data);
+
+	p = g9pMask_getOccupiedPatchForTileLevel(mask, 1, 5);
+	if (p == NULL) {
+		hasPassed = false;
+	} else {
+		gridPatch_getIdxLo(p, idxLo);
+		gridPatch_getDims(p, dims);
+		if ((idxLo[0] != 28) || (idxLo[1] != 10) || (idxLo[2] != 20))
+			hasPassed = false;
+		if ((dims[0] != 4) || (dims[1] != 2) || (dims[2] != 4))
+			hasPassed = false;
+		gridPatch_del(&p);
+	}
+
+	p = g9pMask_getOccupiedPatchForTileLevel(mask, 1, 4);
+	if (p != NULL) {
+		hasPassed = false;
+		gridPatch_del(&p);
+	}
+
+	// Tiles without data are completely at the minimum level.
+	p = g9pMask_getOccupiedPatchForTileLevel(mask, 0, 3);
+	g9pMask_getTileIdxsForLevel(mask, 0, 3, tileLo, tileHi);
+	if (p == NULL) {
+		hasPassed = false;
+	} else {
+		gridPatch_getIdxLo(p, idxLo);
+		gridPatch_getDims(p, dims);
+		for (int i = 0; i < NDIM; i++) {
+			if ((idxLo[i] != tileLo[i])
+			    || (dims[i] != tileHi[i] - tileLo[i] + 1))
+				hasPassed = false;
+		}
+		gridPatch_del(&p);
+	}
+
+	p = g9pMask_getOccupiedPatchForTileLevel(mask, 0, 5);
+	if (p != NULL) {
+		hasPassed = false;
+		gridPatch_del(&p);
+	}
+
+	g9pMask_del(&mask);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} // g9pMask_verifyCreationOfOccupiedPatch
+
 extern bool
 g9pMask_verifyDelete(void)
 {
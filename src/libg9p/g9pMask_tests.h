@@ -36,6 +36,15 @@ g9pMask_verifyCreationOfGridStructure(void);
 extern bool
 g9pMask_verifyCreationOfPatch(void);
 
+/**
+ * @brief  Verifies that the occupied patch of a tile encloses exactly the
+ *         cells at the requested level.
+ *
+ * @return  Returns @c true if the test passed and @c false otherwise.
+ */
+extern bool
+g9pMask_verifyCreationOfOccupiedPatch(void);
+
 /**
  * @brief  Verifies that referencing/dereferencing works as expected.
  *
@@ -107,6 +107,7 @@ main(int argc, char **argv)
 	RUNTEST(&g9pMask_verifyNumCellsEmptyMask, hasFailed);
 	RUNTEST(&g9pMask_verifyCreationOfGridStructure, hasFailed);
 	RUNTEST(&g9pMask_verifyCreationOfPatch, hasFailed);
+	RUNTEST(&g9pMask_verifyCreationOfOccupiedPatch, hasFailed);
 	RUNTEST(&g9pMask_verifyDelete, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
@@ -164,6 +165,7 @@ main(int argc, char **argv)
 		printf("\nRunning tests for g9pICMap:\n");
 	}
 	RUNTEST(&g9pICMap_verifySimpleMapCreation, hasFailed);
+	RUNTEST(&g9pICMap_verifyMapCreationWithTileOrder, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -17,6 +17,7 @@
 #include "gridHistogram.h"
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 #include <inttypes.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
@@ -26,6 +27,7 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
+#include "gridUtil.h"
 #include "../libutil/xmem.h"
 #include "../libutil/xfile.h"
 #include "../libutil/diediedie.h"
@@ -40,6 +42,21 @@
 /** @brief  Gives the largest amount of bins that are support. */
 #define LOCAL_NUMBINS_MAX 4096
 
+/**
+ * @brief  Gives the number of cells that are converted and binned in one
+ *         go before the counts are updated.
+ */
+#define LOCAL_BLOCKSIZE 1024
+
+/**
+ * @brief  Gives the number of interleaved sub-counters per bin.
+ *
+ * Consecutive cells are counted into different sub-counters, which
+ * avoids that every increment waits for the previous one when many cells
+ * fall into the same bin (e.g. the empty cells of a mask).
+ */
+#define LOCAL_NUMLANES 4
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static gridHistogram_t
@@ -59,7 +76,13 @@ static void
 local_count(void *data, dataVar_t var, uint64_t len, gridHistogram_t histo);
 
 static void
-local_countValue(double value, gridHistogram_t histo);
+local_calcBins(const double          *values,
+               int                   num,
+               const gridHistogram_t histo,
+               uint32_t              *bins);
+
+static uint32_t
+local_findBin(double value, const gridHistogram_t histo);
 
 static int
 local_cmpFunc(const void *val, const void *bins);
@@ -92,11 +115,36 @@ gridHistogram_new(uint32_t numBins, double min, double max)
 	histo->binLimits[histo->numBins - 1] = max;
 	histo->binLimits[histo->numBins]     = HUGE_VAL;
 
+	histo->isUniform                     = true;
+	histo->min                           = min;
+	histo->invDelta                      = numBins / (max - min);
+
 	local_nullHistogram(histo);
 
 	return histo;
 }
 
+extern gridHistogram_t
+gridHistogram_clone(const gridHistogram_t histo)
+{
+	gridHistogram_t clone;
+
+	assert(histo != NULL);
+
+	clone = local_mallocHistogram(histo->numBinsReal);
+	memcpy(clone->binLimits, histo->binLimits,
+	       sizeof(double) * (histo->numBins + 1));
+	memcpy(clone->binCounts, histo->binCounts,
+	       sizeof(uint64_t) * histo->numBins);
+	clone->totalCounts        = histo->totalCounts;
+	clone->totalCountsInRange = histo->totalCountsInRange;
+	clone->isUniform          = histo->isUniform;
+	clone->min                = histo->min;
+	clone->invDelta           = histo->invDelta;
+
+	return clone;
+}
+
 extern void
 gridHistogram_del(gridHistogram_t *histo)
 {
@@ -111,6 +159,14 @@ gridHistogram_del(gridHistogram_t *histo)
 	*histo = NULL;
 }
 
+extern void
+gridHistogram_reset(gridHistogram_t histo)
+{
+	assert(histo != NULL);
+
+	local_nullHistogram(histo);
+}
+
 extern void
 gridHistogram_calcGridPatch(gridHistogram_t   histo,
                             const gridPatch_t patch,
@@ -149,7 +205,66 @@ gridHistogram_calcGridRegularDistrib(gridHistogram_t            histo,
 	                      NULL, idxOfVar);
 }
 
-extern uint32_t
+extern void
+gridHistogram_addGridPatch(gridHistogram_t   histo,
+                           const gridPatch_t patch,
+                           int               idxOfVar)
+{
+	assert(histo != NULL);
+	assert(patch != NULL);
+
+	local_calcRegularCore(histo, NULL, NULL, patch, idxOfVar);
+}
+
+extern void
+gridHistogram_addValues(gridHistogram_t histo,
+                        const double    *values,
+                        uint64_t        num)
+{
+	uint32_t bins[LOCAL_BLOCKSIZE];
+
+	assert(histo != NULL);
+	assert(values != NULL || num == UINT64_C(0));
+
+	for (uint64_t i = 0; i < num; i += LOCAL_BLOCKSIZE) {
+		int numInBlock = (num - i < LOCAL_BLOCKSIZE)
+		                 ? (int)(num - i) : LOCAL_BLOCKSIZE;
+
+		local_calcBins(values + i, numInBlock, histo, bins);
+		for (int j = 0; j < numInBlock; j++)
+			histo->binCounts[bins[j]]++;
+		for (int j = 0; j < numInBlock; j++)
+			histo->totalCountsInRange +=
+			    (bins[j] > 0 && bins[j] < histo->numBins - 1) ? 1 : 0;
+	}
+	histo->totalCounts += num;
+}
+
+extern void
+gridHistogram_merge(gridHistogram_t histo, const gridHistogram_t other)
+{
+	assert(histo != NULL);
+	assert(other != NULL);
+	assert(histo->numBins == other->numBins);
+
+	for (uint32_t i = 0; i < histo->numBins; i++)
+		histo->binCounts[i] += other->binCounts[i];
+	histo->totalCounts        += other->totalCounts;
+	histo->totalCountsInRange += other->totalCountsInRange;
+}
+
+#ifdef WITH_MPI
+extern void
+gridHistogram_reduce(gridHistogram_t histo, MPI_Comm comm)
+{
+	assert(histo != NULL);
+
+	local_mpiReduceHisto(histo, comm);
+}
+
+#endif
+
+extern uint64_t
 gridHistogram_getCountInBin(const gridHistogram_t histo, uint32_t bin)
 {
 	assert(histo != NULL);
@@ -193,7 +308,7 @@ gridHistogram_printPretty(const gridHistogram_t histo,
 	fprintf(out, "# Counts in range:  %" PRIu64 "\n",
 	        histo->totalCountsInRange);
 	for (uint32_t i = 0; i < histo->numBins; i++) {
-		fprintf(out, "%s %15e %15e %" PRIu32 "\n",
+		fprintf(out, "%s %15e %15e %" PRIu64 "\n",
 		        prefix != NULL ? prefix : "",
 		        gridHistogram_getBinLimitLeft(histo, i),
 		        gridHistogram_getBinLimitRight(histo, i),
@@ -248,7 +363,8 @@ local_mallocHistogram(uint32_t numBins)
 	histo->numBins     = numBins + 2;
 	histo->numBinsReal = numBins;
 	histo->binLimits   = xmalloc(sizeof(double) * (histo->numBins + 1));
-	histo->binCounts   = xmalloc(sizeof(uint32_t) * (histo->numBins));
+	histo->binCounts   = xmalloc(sizeof(uint64_t) * (histo->numBins));
+	histo->isUniform   = false;
 
 	return histo;
 }
@@ -303,58 +419,87 @@ local_calcRegularCore(gridHistogram_t            histo,
 static void
 local_count(void *data, dataVar_t var, uint64_t len, gridHistogram_t histo)
 {
-	dataVarType_t type = dataVar_getType(var);
-
+	dataVarType_t type      = dataVar_getType(var);
+	uint64_t      numBlocks = (len + LOCAL_BLOCKSIZE - 1) / LOCAL_BLOCKSIZE;
 
-	switch (type) {
-	case DATAVARTYPE_INT:
-	case DATAVARTYPE_INT32:
-	{
-		int *tmp = (int *)data;
-		for (uint64_t i = 0; i < len; i++)
-			local_countValue(tmp[i], histo);
-	}
-	break;
-	case DATAVARTYPE_INT64:
-	{
-		int64_t *tmp = (int64_t *)data;
-		for (uint64_t i = 0; i < len; i++)
-			local_countValue(tmp[i], histo);
-	}
-	break;
-	case DATAVARTYPE_INT8:
-	{
-		int8_t *tmp = (int8_t *)data;
-		for (uint64_t i = 0; i < len; i++)
-			local_countValue(tmp[i], histo);
-	}
-	break;
-	case DATAVARTYPE_DOUBLE:
-	{
-		double *tmp = (double *)data;
-		for (uint64_t i = 0; i < len; i++)
-			local_countValue(tmp[i], histo);
-	}
-	break;
-	case DATAVARTYPE_FLOAT:
-	{
-		float *tmp = (float *)data;
-		for (uint64_t i = 0; i < len; i++)
-			local_countValue(tmp[i], histo);
-	}
-	break;
-	case DATAVARTYPE_FPV:
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(data, type, len, histo, numBlocks)
+#endif
 	{
-		fpv_t *tmp = (fpv_t *)data;
-		for (uint64_t i = 0; i < len; i++)
-			local_countValue(tmp[i], histo);
-	}
-	break;
+		uint64_t *counts;
+		double   values[LOCAL_BLOCKSIZE];
+		uint32_t bins[LOCAL_BLOCKSIZE];
+		uint64_t countsInRange = UINT64_C(0);
+
+		counts = xmalloc(sizeof(uint64_t) * histo->numBins * LOCAL_NUMLANES);
+		memset(counts, 0, sizeof(uint64_t) * histo->numBins * LOCAL_NUMLANES);
+
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(static)
+#endif
+		for (uint64_t b = 0; b < numBlocks; b++) {
+			uint64_t offset = b * LOCAL_BLOCKSIZE;
+			int      num    = (len - offset < LOCAL_BLOCKSIZE)
+			                  ? (int)(len - offset) : LOCAL_BLOCKSIZE;
+
+			gridUtil_convertToDouble(data, type, offset, num, values);
+			local_calcBins(values, num, histo, bins);
+			for (int i = 0; i < num; i++)
+				counts[bins[i] * LOCAL_NUMLANES + i % LOCAL_NUMLANES]++;
+		}
+
+		for (uint32_t i = 0; i < histo->numBins; i++) {
+			uint64_t sum = UINT64_C(0);
+			for (int j = 0; j < LOCAL_NUMLANES; j++)
+				sum += counts[i * LOCAL_NUMLANES + j];
+			counts[i] = sum;
+		}
+
+		for (uint32_t i = 1; i < histo->numBins - 1; i++)
+			countsInRange += counts[i];
+
+#ifdef WITH_OPENMP
+#  pragma omp critical
+#endif
+		{
+			for (uint32_t i = 0; i < histo->numBins; i++)
+				histo->binCounts[i] += counts[i];
+			histo->totalCountsInRange += countsInRange;
+		}
+
+		xfree(counts);
 	}
+
+	histo->totalCounts += len;
 } /* local_count */
 
 static void
-local_countValue(double value, gridHistogram_t histo)
+local_calcBins(const double          *values,
+               int                   num,
+               const gridHistogram_t histo,
+               uint32_t              *bins)
+{
+	if (histo->isUniform) {
+		const double min         = histo->min;
+		const double invDelta    = histo->invDelta;
+		const double numBinsReal = (double)(histo->numBinsReal);
+
+		// Values below the range map to -1, values above it (and NaNs)
+		// to numBinsReal, so shifting by one yields the bin directly.
+		for (int i = 0; i < num; i++) {
+			double x = (values[i] - min) * invDelta;
+			x       = (x < 0.) ? -1. : x;
+			x       = (x < numBinsReal) ? x : numBinsReal;
+			bins[i] = (uint32_t)(x + 1.);
+		}
+	} else {
+		for (int i = 0; i < num; i++)
+			bins[i] = local_findBin(values[i], histo);
+	}
+}
+
+static uint32_t
+local_findBin(double value, const gridHistogram_t histo)
 {
 	double   *leftBinEdge;
 	uint32_t binNumber;
@@ -364,11 +509,8 @@ local_countValue(double value, gridHistogram_t histo)
 	                      sizeof(double), &local_cmpFunc);
 	binNumber = leftBinEdge - histo->binLimits;
 	assert(binNumber < histo->numBins);
-	histo->binCounts[binNumber]++;
-	histo->totalCounts++;
-	if ((binNumber > 0) && (binNumber < histo->numBins - 1)) {
-		histo->totalCountsInRange++;
-	}
+
+	return binNumber;
 }
 
 static int
@@ -390,16 +532,16 @@ local_cmpFunc(const void *val, const void *bins)
 static void
 local_mpiReduceHisto(gridHistogram_t histo, MPI_Comm comm)
 {
-	uint32_t *bins;
+	uint64_t *bins;
 	uint64_t countsSend[2], countsRecv[2];
 
-	bins          = xmalloc(sizeof(uint32_t) * histo->numBins);
+	bins          = xmalloc(sizeof(uint64_t) * histo->numBins);
 	countsSend[0] = histo->totalCounts;
 	countsSend[1] = histo->totalCountsInRange;
 
-	MPI_Allreduce(histo->binCounts, bins, histo->numBins, MPI_INT,
+	MPI_Allreduce(histo->binCounts, bins, histo->numBins, MPI_UINT64_T,
 	              MPI_SUM, comm);
-	MPI_Allreduce(countsSend, countsRecv, 2, MPI_LONG, MPI_SUM, comm);
+	MPI_Allreduce(countsSend, countsRecv, 2, MPI_UINT64_T, MPI_SUM, comm);
 
 	xfree(histo->binCounts);
 	histo->binCounts          = bins;
@@ -23,6 +23,9 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -33,9 +36,15 @@ typedef struct gridHistogram_struct *gridHistogram_t;
 extern gridHistogram_t
 gridHistogram_new(uint32_t numBins, double min, double max);
 
+extern gridHistogram_t
+gridHistogram_clone(const gridHistogram_t histo);
+
 extern void
 gridHistogram_del(gridHistogram_t *histo);
 
+extern void
+gridHistogram_reset(gridHistogram_t histo);
+
 extern void
 gridHistogram_calcGridPatch(gridHistogram_t   histo,
                             const gridPatch_t patch,
@@ -51,7 +60,26 @@ gridHistogram_calcGridRegularDistrib(gridHistogram_t            histo,
                                      const gridRegularDistrib_t distrib,
                                      int                        idxOfVar);
 
-extern uint32_t
+extern void
+gridHistogram_addGridPatch(gridHistogram_t   histo,
+                           const gridPatch_t patch,
+                           int               idxOfVar);
+
+extern void
+gridHistogram_addValues(gridHistogram_t histo,
+                        const double    *values,
+                        uint64_t        num);
+
+extern void
+gridHistogram_merge(gridHistogram_t histo, const gridHistogram_t other);
+
+#ifdef WITH_MPI
+extern void
+gridHistogram_reduce(gridHistogram_t histo, MPI_Comm comm);
+
+#endif
+
+extern uint64_t
 gridHistogram_getCountInBin(const gridHistogram_t histo, uint32_t bin);
 
 extern double
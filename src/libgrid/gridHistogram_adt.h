@@ -17,6 +17,7 @@
 
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
+#include <stdbool.h>
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -30,11 +31,21 @@ struct gridHistogram_struct {
 	/** @brief  Stores the corners of the bins. */
 	double   *binLimits;
 	/** @brief  Stores the number of counts in each bin. */
-	uint32_t *binCounts;
+	uint64_t *binCounts;
 	/** @brief  Stores the total number of counts. */
 	uint64_t totalCounts;
 	/** @brief  Stores the total number of counts within the covered range. */
 	uint64_t totalCountsInRange;
+	/**
+	 * @brief  Flags whether the bins within the covered range are equally
+	 *         spaced, in which case the bin of a value is computed
+	 *         directly instead of being searched for.
+	 */
+	bool     isUniform;
+	/** @brief  The lower limit of the covered range. */
+	double   min;
+	/** @brief  The inverse width of the bins (only for uniform bins). */
+	double   invDelta;
 };
 
 
@@ -36,6 +36,13 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/**
+ * @brief  The number of slices fed into the histogram by
+ *         gridHistogram_addGridPatch_test(), each slice holds 2^24 cells,
+ *         the total being larger than 2^32.
+ */
+#define LOCAL_NUMSLICES 257
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static gridPatch_t
@@ -226,6 +233,64 @@ gridHistogram_calcGridRegularDistrib_test(void)
 	return hasPassed ? true : false;
 } /* gridHistogram_calcGridRegularDistrib_test */
 
+extern bool
+gridHistogram_addGridPatch_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridHistogram_t   gridHistogram;
+	gridPatch_t       patch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo     = { 0, 0, 0 };
+	gridPointUint32_t idxHi     = { 255, 255, 255 };
+	uint64_t          numCells;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0) {
+		printf("Testing %s... ", __func__);
+
+		var   = dataVar_new("TEST", DATAVARTYPE_INT8, 1);
+		patch = gridPatch_new(idxLo, idxHi);
+		gridPatch_attachVar(patch, var);
+		numCells = gridPatch_getNumCells(patch);
+		memset(gridPatch_getVarDataHandle(patch, 0), 0, numCells);
+
+		gridHistogram = gridHistogram_new(4, -1.0, 1.0);
+		for (int i = 0; i < LOCAL_NUMSLICES; i++)
+			gridHistogram_addGridPatch(gridHistogram, patch, 0);
+		numCells *= LOCAL_NUMSLICES;
+
+		if (numCells <= UINT64_C(4294967296))
+			hasPassed = false;
+		if (gridHistogram_getCountInBin(gridHistogram, 3) != numCells)
+			hasPassed = false;
+		if (gridHistogram->totalCounts != numCells)
+			hasPassed = false;
+		if (gridHistogram->totalCountsInRange != numCells)
+			hasPassed = false;
+		for (uint32_t i = 0; i < gridHistogram->numBins; i++) {
+			if ((i != 3) && (gridHistogram_getCountInBin(gridHistogram, i)
+			                 != UINT64_C(0)))
+				hasPassed = false;
+		}
+
+		gridHistogram_del(&gridHistogram);
+		gridPatch_del(&patch);
+		dataVar_del(&var);
+	}
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridHistogram_addGridPatch_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridPatch_t
 local_getFakePatch(void)
@@ -36,5 +36,8 @@ gridHistogram_calcGridRegular_test(void);
 extern bool
 gridHistogram_calcGridRegularDistrib_test(void);
 
+extern bool
+gridHistogram_addGridPatch_test(void);
+
 
 #endif
@@ -38,6 +38,9 @@ static const char *local_typeGraficStr  = "grafic";
 /** @brief  The ASCII string for the HDF5 type. */
 static const char *local_typeHDF5Str    = "hdf5";
 
+/** @brief  The ASCII string for the brick type. */
+static const char *local_typeBrickStr   = "brick";
+
 /** @brief  ASCII string for unknown type. */
 static const char *local_typeUnknownStr = "unknown";
 
@@ -61,6 +64,8 @@ gridIO_getTypeFromName(const char *name)
 		rtn = GRIDIO_TYPE_GRAFIC;
 	else if (strcmp(name, local_typeHDF5Str) == 0)
 		rtn = GRIDIO_TYPE_HDF5;
+	else if (strcmp(name, local_typeBrickStr) == 0)
+		rtn = GRIDIO_TYPE_BRICK;
 	else
 		rtn = GRIDIO_TYPE_UNKNOWN;
 
@@ -80,6 +85,8 @@ gridIO_getNameFromType(gridIO_type_t type)
 		rtn = local_typeGraficStr;
 	else if (type == GRIDIO_TYPE_HDF5)
 		rtn = local_typeHDF5Str;
+	else if (type == GRIDIO_TYPE_BRICK)
+		rtn = local_typeBrickStr;
 	else
 		rtn = local_typeUnknownStr;
 
@@ -34,6 +34,8 @@ typedef enum {
 	GRIDIO_TYPE_GRAFIC,
 	/** Corresponds to HDF5 format. */
 	GRIDIO_TYPE_HDF5,
+	/** Corresponds to the native brick file format. */
+	GRIDIO_TYPE_BRICK,
 	/** Stands for an unknown file format. */
 	GRIDIO_TYPE_UNKNOWN
 } gridIO_type_t;
@@ -44,6 +44,8 @@ gridIO_getTypeFromName_test(void)
 		hasPassed = false;
 	if (gridIO_getTypeFromName("silo") != GRIDIO_TYPE_SILO)
 		hasPassed = false;
+	if (gridIO_getTypeFromName("brick") != GRIDIO_TYPE_BRICK)
+		hasPassed = false;
 	if (gridIO_getTypeFromName("This will fail") != GRIDIO_TYPE_UNKNOWN)
 		hasPassed = false;
 #ifdef XMEM_TRACK_MEM
@@ -73,6 +75,8 @@ gridIO_getNameFromType_test(void)
 		hasPassed = false;
 	if (strcmp("silo", gridIO_getNameFromType(GRIDIO_TYPE_SILO)) != 0)
 		hasPassed = false;
+	if (strcmp("brick", gridIO_getNameFromType(GRIDIO_TYPE_BRICK)) != 0)
+		hasPassed = false;
 	if (strcmp("unknown", gridIO_getNameFromType(GRIDIO_TYPE_UNKNOWN)) != 0)
 		hasPassed = false;
 #ifdef XMEM_TRACK_MEM
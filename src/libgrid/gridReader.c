@@ -18,6 +18,9 @@
 #include <assert.h>
 #include <stdio.h>
 #include "gridPatch.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "gridSummary.h"
 #include "../libutil/xmem.h"
 #include "../libutil/filename.h"
 
@@ -62,9 +65,67 @@ gridReader_readIntoPatchForVar(gridReader_t reader,
 	assert(idxOfVar >= 0 && idxOfVar < gridPatch_getNumVars(patch));
 
 	reader->func->readIntoPatchForVar(reader, patch, idxOfVar);
+
+	if ((reader->stat != NULL) || (reader->histo != NULL))
+		gridSummary_addGridPatch(reader->stat, reader->histo,
+		                         patch, idxOfVar);
 }
 
 /*--- Implementations of final functions --------------------------------*/
+extern void
+gridReader_calcSummary(gridReader_t            reader,
+                       gridStatistics_t        stat,
+                       gridHistogram_t         histo,
+                       const gridPointUint32_t dims,
+                       uint32_t                numPlanesPerSlab)
+{
+	gridStatistics_t  oldStat;
+	gridHistogram_t   oldHisto;
+	gridPointUint32_t idxLo, idxHi;
+
+	assert(reader != NULL);
+	assert(numPlanesPerSlab > 0);
+
+	oldStat  = reader->stat;
+	oldHisto = reader->histo;
+
+	if (stat != NULL)
+		gridStatistics_reset(stat);
+	if (histo != NULL)
+		gridHistogram_reset(histo);
+	gridReader_setSummary(reader, stat, histo);
+
+	for (int i = 0; i < NDIM; i++) {
+		idxLo[i] = 0;
+		idxHi[i] = dims[i] - 1;
+	}
+	for (uint32_t k = 0; k < dims[NDIM - 1]; k += numPlanesPerSlab) {
+		gridPatch_t patch;
+
+		idxLo[NDIM - 1] = k;
+		idxHi[NDIM - 1] = (dims[NDIM - 1] - k > numPlanesPerSlab)
+		                  ? k + numPlanesPerSlab - 1 : dims[NDIM - 1] - 1;
+		patch           = gridPatch_new(idxLo, idxHi);
+		gridReader_readIntoPatch(reader, patch);
+		gridPatch_del(&patch);
+	}
+
+	gridReader_setSummary(reader, oldStat, oldHisto);
+	if (stat != NULL)
+		gridStatistics_finalize(stat);
+} /* gridReader_calcSummary */
+
+extern void
+gridReader_setSummary(gridReader_t     reader,
+                      gridStatistics_t stat,
+                      gridHistogram_t  histo)
+{
+	assert(reader != NULL);
+
+	reader->stat  = stat;
+	reader->histo = histo;
+}
+
 extern void
 gridReader_setFileName(gridReader_t reader,
                        filename_t   fileName)
@@ -104,6 +165,14 @@ gridReader_getFileName(const gridReader_t reader)
 	return reader->fileName;
 }
 
+extern gridIO_type_t
+gridReader_getType(const gridReader_t reader)
+{
+	assert(reader != NULL);
+
+	return reader->type;
+}
+
 extern void
 gridReaderHDF5_setDoPatch(gridReader_t reader, bool doPatch)
 {
@@ -144,6 +213,8 @@ gridReader_init(gridReader_t                          reader,
 	reader->func                 = func;
 	reader->handleFilenameChange = handleFilenameChange;
 	reader->fileName             = NULL;
+	reader->stat                 = NULL;
+	reader->histo                = NULL;
 }
 
 extern void
@@ -18,6 +18,9 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridPatch.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "gridIO.h"
 #include "../libutil/filename.h"
 
 
@@ -104,6 +107,78 @@ gridReader_readIntoPatchForVar(gridReader_t reader,
 
 /*--- Prototypes of final functions -------------------------------------*/
 
+/**
+ * @name  Using (Public, Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Calculates the statistics and the histogram of a whole file
+ *         while reading it slab by slab.
+ *
+ * Only one slab of @c numPlanesPerSlab planes (along the last dimension)
+ * is held in memory at any time, hence this works for files that do not
+ * fit into memory.  The statistics are finalized on return.
+ *
+ * The slabs are read with gridReader_readIntoPatch(), which the HDF5
+ * reader does not support; for HDF5 files this terminates the program
+ * with an error.
+ *
+ * @param[in,out]  reader
+ *                    The reader to use.  Passing @c NULL is undefined.
+ * @param[in,out]  stat
+ *                    The statistics to calculate, may be @c NULL.
+ * @param[in,out]  histo
+ *                    The histogram to calculate, may be @c NULL.
+ * @param[in]      dims
+ *                    The dimensions of the grid in the file.
+ * @param[in]      numPlanesPerSlab
+ *                    The number of planes to read in one go, this must be
+ *                    positive.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReader_calcSummary(gridReader_t            reader,
+                       gridStatistics_t        stat,
+                       gridHistogram_t         histo,
+                       const gridPointUint32_t dims,
+                       uint32_t                numPlanesPerSlab);
+
+/** @} */
+
+/**
+ * @name  Setter (Public, Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Sets the statistics and the histogram into which all data read
+ *         by the reader is accumulated.
+ *
+ * The reader does not take ownership of the objects and will neither
+ * reset nor finalize them, see gridSummary_addGridPatch().
+ *
+ * @param[in,out]  reader
+ *                    The reader to work with.  Passing @c NULL is
+ *                    undefined.
+ * @param[in]      stat
+ *                    The statistics to use, @c NULL to disable.
+ * @param[in]      histo
+ *                    The histogram to use, @c NULL to disable.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReader_setSummary(gridReader_t     reader,
+                      gridStatistics_t stat,
+                      gridHistogram_t  histo);
+
+/** @} */
+
+
 /**
  * @name  Setter (Public, Final)
  *
@@ -167,6 +242,18 @@ gridReader_overlayFileName(gridReader_t reader,
 extern const filename_t
 gridReader_getFileName(const gridReader_t reader);
 
+/**
+ * @brief  Retrieves the type of the reader.
+ *
+ * @param[in]  reader
+ *                The reader to query, this must be a valid reader, passing
+ *                @c NULL is undefined.
+ *
+ * @return  Returns the type of the file the reader reads.
+ */
+extern gridIO_type_t
+gridReader_getType(const gridReader_t reader);
+
 extern void
 gridReaderHDF5_setDoPatch(gridReader_t reader, bool doPatch);
 
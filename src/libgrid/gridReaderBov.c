@@ -142,6 +142,16 @@ gridReaderBov_getBov(const gridReaderBov_t reader)
 	return reader->bov;
 }
 
+extern void
+gridReaderBov_setUseMmap(gridReaderBov_t reader, bool useMmap)
+{
+	assert(reader != NULL);
+
+	reader->useMmap = useMmap;
+	if (reader->bov != NULL)
+		bov_setUseMmap(reader->bov, useMmap);
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridReaderBov_t
 gridReaderBov_alloc(void)
@@ -152,7 +162,8 @@ gridReaderBov_alloc(void)
 extern void
 gridReaderBov_init(gridReaderBov_t reader)
 {
-	reader->bov = NULL;
+	reader->bov     = NULL;
+	reader->useMmap = false;
 }
 
 extern void
@@ -254,5 +265,6 @@ local_handleFilenameChange(gridReader_t reader)
 	bov_t bov;
 
 	bov = bov_newFromFile(filename_getFullName(reader->fileName));
+	bov_setUseMmap(bov, ((gridReaderBov_t)reader)->useMmap);
 	gridReaderBov_setBov((gridReaderBov_t)reader, bov);
 }
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridReader.h"
+#include <stdbool.h>
 #include "../libutil/parse_ini.h"
 #include "../libutil/bov.h"
 
@@ -109,6 +110,33 @@ gridReaderBov_getBov(const gridReaderBov_t reader);
 /** @} */
 
 
+/**
+ * @name  Setter (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Selects whether the data is read through a memory mapping.
+ *
+ * The setting is kept when the file name of the reader changes.  See
+ * bov_setUseMmap() for details.
+ *
+ * @param[in,out]  reader
+ *                    The reader to work with, passing @c NULL is
+ *                    undefined.
+ * @param[in]      useMmap
+ *                    Whether to use a memory mapping.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderBov_setUseMmap(gridReaderBov_t reader, bool useMmap);
+
+
+/** @} */
+
+
 /*--- Doxygen group definitions -----------------------------------------*/
 
 /**
@@ -17,6 +17,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridReader_adt.h"
+#include <stdbool.h>
 #include "../libutil/bov.h"
 
 
@@ -28,6 +29,8 @@ struct gridReaderBov_struct {
 	struct gridReader_struct base;
 	/** @brief  The low level BOV interface. */
 	bov_t bov;
+	/** @brief  Toggles reading through a memory mapping of the file. */
+	bool  useMmap;
 };
 
 
@@ -16,6 +16,9 @@
 #include "gridReaderBov_tests.h"
 #include "gridReaderBov.h"
 #include "gridReaderFactory.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "gridSummary.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -215,6 +218,68 @@ gridReaderBov_readIntoPatchForVar_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+gridReaderBov_calcSummary_test(void)
+{
+	bool              hasPassed      = true;
+	int               rank           = 0;
+#  ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#  endif
+	uint32_t          idxLo[3]       = {0, 0, 0};
+	uint32_t          idxHi[3]       = {7, 7, 7};
+	gridPointUint32_t dims           = {8, 8, 8};
+	gridPatch_t       patch          = gridPatch_new(idxLo, idxHi);
+	gridReaderBov_t   reader;
+	gridStatistics_t  stat, statRef;
+	gridHistogram_t   histo, histoRef;
+#  ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#  endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	reader   = local_getReader();
+	stat     = gridStatistics_new();
+	statRef  = gridStatistics_new();
+	histo    = gridHistogram_new(16, 0., 512.);
+	histoRef = gridHistogram_new(16, 0., 512.);
+
+	gridReader_calcSummary((gridReader_t)reader, stat, histo, dims, 3);
+
+	gridReaderBov_readIntoPatch((gridReader_t)reader, patch);
+	gridSummary_calcGridPatch(statRef, histoRef, patch, 0);
+
+	if (islessgreater(gridStatistics_getMax(stat), 511.))
+		hasPassed = false;
+	if (fabs(gridStatistics_getMean(stat) - gridStatistics_getMean(statRef))
+	    > 1e-10 * fabs(gridStatistics_getMean(statRef)))
+		hasPassed = false;
+	if (fabs(gridStatistics_getVariance(stat)
+	         - gridStatistics_getVariance(statRef))
+	    > 1e-10 * gridStatistics_getVariance(statRef))
+		hasPassed = false;
+	for (uint32_t i = 0; i < 18; i++) {
+		if (gridHistogram_getCountInBin(histo, i)
+		    != gridHistogram_getCountInBin(histoRef, i))
+			hasPassed = false;
+	}
+
+	gridHistogram_del(&histoRef);
+	gridHistogram_del(&histo);
+	gridStatistics_del(&statRef);
+	gridStatistics_del(&stat);
+	gridReaderBov_del((gridReader_t *)&reader);
+	gridPatch_del(&patch);
+#  ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#  endif
+
+	return hasPassed ? true : false;
+} /* gridReaderBov_calcSummary_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridReaderBov_t
 local_getReader(void)
@@ -47,6 +47,11 @@ extern bool
 gridReaderBov_readIntoPatchForVar_test(void);
 
 
+/** @brief  Tests gridReader_calcSummary() with a bov reader. */
+extern bool
+gridReaderBov_calcSummary_test(void);
+
+
 /*--- Doxygen group definitions -----------------------------------------*/
 
 /**
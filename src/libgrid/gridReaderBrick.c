@@ -0,0 +1,224 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridReaderBrick.c
+ * @ingroup  libgridIOInBrick
+ * @brief  Implements the brick file reader.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridReaderBrick.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "gridPatch.h"
+#include "../libdata/dataVar.h"
+#include "../libutil/xmem.h"
+#include "../libutil/xstring.h"
+#include "../libutil/brickFile.h"
+#include "../libutil/diediedie.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "gridReader_adt.h"
+#include "gridReaderBrick_adt.h"
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  Stores the functions table for the brick reader. */
+static struct gridReader_func_struct local_func
+    = {&gridReaderBrick_del,
+	   &gridReaderBrick_readIntoPatch,
+	   &gridReaderBrick_readIntoPatchForVar};
+
+/*--- Prototypes of local functions -------------------------------------*/
+static dataVar_t
+local_getNewVar(gridReaderBrick_t reader);
+
+static brickFileFormat_t
+local_translateGridTypeToBrickType(dataVarType_t type);
+
+static void
+local_handleFilenameChange(gridReader_t reader);
+
+
+/*--- Implementations of abstract functions -----------------------------*/
+extern void
+gridReaderBrick_del(gridReader_t *reader)
+{
+	assert(reader != NULL && *reader != NULL);
+	assert((*reader)->type == GRIDIO_TYPE_BRICK);
+
+	gridReader_free(*reader);
+	gridReaderBrick_free((gridReaderBrick_t)*reader);
+
+	xfree(*reader);
+	*reader = NULL;
+}
+
+extern void
+gridReaderBrick_readIntoPatch(gridReader_t reader, gridPatch_t patch)
+{
+	dataVar_t var;
+	int       idxOfVar;
+
+	assert(reader->type == GRIDIO_TYPE_BRICK);
+	assert(patch != NULL);
+
+	var      = local_getNewVar((gridReaderBrick_t)reader);
+	idxOfVar = gridPatch_attachVar(patch, var);
+
+	gridReader_readIntoPatchForVar(reader, patch, idxOfVar);
+
+	dataVar_del(&var);
+}
+
+extern void
+gridReaderBrick_readIntoPatchForVar(gridReader_t reader,
+                                    gridPatch_t  patch,
+                                    int          idxOfVar)
+{
+	dataVar_t         var;
+	void              *data;
+	brickFileFormat_t format;
+	uint32_t          dims[3];
+	uint32_t          idxLo[3];
+
+	assert(reader->type == GRIDIO_TYPE_BRICK);
+	assert(patch != NULL);
+	assert(idxOfVar >= 0 && idxOfVar < gridPatch_getNumVars(patch));
+
+	var    = gridPatch_getVarHandle(patch, idxOfVar);
+	data   = gridPatch_getVarDataHandle(patch, idxOfVar);
+	format = local_translateGridTypeToBrickType(dataVar_getType(var));
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+#if (NDIM == 2)
+	idxLo[2] = 0;
+	dims[2]  = 1;
+#endif
+
+	brickFile_readWindowed(((gridReaderBrick_t)reader)->brickFile, data,
+	                       format, dataVar_getNumComponents(var),
+	                       idxLo, dims);
+}
+
+/*--- Implementations of final functions --------------------------------*/
+extern gridReaderBrick_t
+gridReaderBrick_new(void)
+{
+	gridReaderBrick_t reader;
+
+	reader = gridReaderBrick_alloc();
+
+	gridReader_init((gridReader_t)reader, GRIDIO_TYPE_BRICK, &local_func,
+	                &local_handleFilenameChange);
+	gridReaderBrick_init(reader);
+
+	return reader;
+}
+
+extern brickFile_t
+gridReaderBrick_getBrickFile(const gridReaderBrick_t reader)
+{
+	assert(reader != NULL);
+
+	return reader->brickFile;
+}
+
+/*--- Implementations of protected functions ----------------------------*/
+extern gridReaderBrick_t
+gridReaderBrick_alloc(void)
+{
+	gridReaderBrick_t reader;
+
+	reader = xmalloc(sizeof(struct gridReaderBrick_struct));
+
+	return reader;
+}
+
+extern void
+gridReaderBrick_init(gridReaderBrick_t reader)
+{
+	reader->brickFile = NULL;
+}
+
+extern void
+gridReaderBrick_free(gridReaderBrick_t reader)
+{
+	if (reader->brickFile != NULL)
+		brickFile_del(&(reader->brickFile));
+}
+
+extern void
+gridReaderBrick_setBrickFile(gridReaderBrick_t reader, brickFile_t brickFile)
+{
+	assert(reader != NULL);
+
+	if (brickFile != reader->brickFile) {
+		if (reader->brickFile != NULL)
+			brickFile_del(&(reader->brickFile));
+		reader->brickFile = brickFile;
+	}
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static dataVar_t
+local_getNewVar(gridReaderBrick_t reader)
+{
+	char          *name;
+	dataVar_t     var;
+	dataVarType_t type = DATAVARTYPE_FPV;
+
+	if (brickFile_getFormat(reader->brickFile) == BRICKFILE_FORMAT_DOUBLE)
+		type = DATAVARTYPE_DOUBLE;
+
+	name = xbasename(brickFile_getFileName(reader->brickFile));
+	var  = dataVar_new(name, type,
+	                   brickFile_getNumComponents(reader->brickFile));
+
+	xfree(name);
+
+	return var;
+}
+
+static brickFileFormat_t
+local_translateGridTypeToBrickType(dataVarType_t type)
+{
+	brickFileFormat_t format;
+
+	if (type == DATAVARTYPE_DOUBLE) {
+		format = BRICKFILE_FORMAT_DOUBLE;
+	} else if (type == DATAVARTYPE_FPV) {
+		if (dataVarType_isNativeFloat(type))
+			format = BRICKFILE_FORMAT_FLOAT;
+		else
+			format = BRICKFILE_FORMAT_DOUBLE;
+	} else {
+		fprintf(stderr, "Grid type not compatible with brick type.");
+		diediedie(EXIT_FAILURE);
+	}
+
+	return format;
+}
+
+static void
+local_handleFilenameChange(gridReader_t reader)
+{
+	assert(reader != NULL);
+	assert(reader->type == GRIDIO_TYPE_BRICK);
+
+	brickFile_t brickFile;
+
+	brickFile = brickFile_newFromFile(filename_getFullName(reader->fileName));
+	gridReaderBrick_setBrickFile((gridReaderBrick_t)reader, brickFile);
+}
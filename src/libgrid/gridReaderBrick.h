@@ -0,0 +1,115 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDREADERBRICK_H
+#define GRIDREADERBRICK_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridReaderBrick.h
+ * @ingroup  libgridIOInBrick
+ * @brief  Provides the interface for the brick file reader.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridReader.h"
+#include "../libutil/brickFile.h"
+
+
+/*--- ADT handle --------------------------------------------------------*/
+
+/** @brief  The handle for the brick file reader. */
+typedef struct gridReaderBrick_struct *gridReaderBrick_t;
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Virtual)
+ *
+ * @{
+ */
+
+/** @copydoc gridReader_del() */
+extern void
+gridReaderBrick_del(gridReader_t *reader);
+
+/** @} */
+
+/**
+ * @name  Using (Virtual)
+ *
+ * @{
+ */
+
+/** @copydoc gridReader_readIntoPatch() */
+extern void
+gridReaderBrick_readIntoPatch(gridReader_t reader, gridPatch_t patch);
+
+/** @copydoc gridReader_readIntoPatchForVar() */
+extern void
+gridReaderBrick_readIntoPatchForVar(gridReader_t reader,
+                                    gridPatch_t  patch,
+                                    int          idxOfVar);
+
+/** @} */
+
+
+/*--- Prototypes of final functions -------------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Creates a new empty brick file reader.
+ *
+ * @return  The new reader.
+ */
+extern gridReaderBrick_t
+gridReaderBrick_new(void);
+
+/** @} */
+
+/**
+ * @name  Getter (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Retrieves the underlying brick file object from a brick file
+ *         reader.
+ *
+ * @param[in]  reader
+ *                The reader that should be queried, passing @c NULL is
+ *                undefined.
+ *
+ * @return  Returns a handle to the internal brick file object, the caller
+ *          must not try free the object.
+ */
+extern brickFile_t
+gridReaderBrick_getBrickFile(const gridReaderBrick_t reader);
+
+/** @} */
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libgridIOInBrick Brick Reader
+ * @ingroup libgridIOIn
+ * @brief  Provides the reader for brick files.
+ *
+ * The brick index is read once when the file name is set, reading a patch
+ * then only touches the bricks intersecting the patch.
+ */
+
+#endif
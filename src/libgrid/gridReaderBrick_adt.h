@@ -0,0 +1,105 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDREADERBRICK_ADT_H
+#define GRIDREADERBRICK_ADT_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridReaderBrick_adt.h
+ * @ingroup  libgridIOInBrick
+ * @brief  Provides the main structure of the brick file reader.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridReader_adt.h"
+#include "../libutil/brickFile.h"
+
+
+/*--- ADT implementation ------------------------------------------------*/
+
+/** @brief  The main structure. */
+struct gridReaderBrick_struct {
+	/** @brief  The base structure. */
+	struct gridReader_struct base;
+	/** @brief  The low level brick file interface. */
+	brickFile_t              brickFile;
+};
+
+
+/*--- Prototypes of protected functions ---------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Protected)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Allocates memory for a brick file reader.
+ *
+ * @return  Returns a handle to a new (uninitialized) brick reader structure.
+ */
+extern gridReaderBrick_t
+gridReaderBrick_alloc();
+
+
+/**
+ * @brief  Sets all required fields of the brick reader structure to safe
+ *         initial values.
+ *
+ * @param[in,out]  reader
+ *                    The reader to initialize.  This must be a valid reader
+ *                    object.  Passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderBrick_init(gridReaderBrick_t reader);
+
+
+/**
+ * @brief  Frees all members of the brick reader structure.
+ *
+ * @param[in,out]  reader
+ *                    The reader to work with,  This must be a valid reader,
+ *                    passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderBrick_free(gridReaderBrick_t reader);
+
+/** @} */
+
+/**
+ * @name  Setter (Protected)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Sets the underlying brick file object to the provided one.
+ *
+ * @param[in,out]  reader
+ *                    The reader to set the brick file object for.  Passing
+ *                    @c NULL is undefined.
+ * @param[in]      brickFile
+ *                    The brick file object that should be set.  The caller
+ *                    relinquishes control over the object.  Passing @c NULL
+ *                    is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderBrick_setBrickFile(gridReaderBrick_t reader, brickFile_t brickFile);
+
+/** @} */
+
+
+#endif
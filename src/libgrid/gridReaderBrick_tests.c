@@ -0,0 +1,216 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridReaderBrick_tests.c
+ * @ingroup  libgridIOInBrickTests
+ * @brief  Implements the tests for the brick reader.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridReaderBrick_tests.h"
+#include "gridReaderBrick.h"
+#include "gridReaderFactory.h"
+#include "gridWriterBrick.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#ifdef XMEM_TRACK_MEM
+#  include "../libutil/xmem.h"
+#endif
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "gridReaderBrick_adt.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static gridReaderBrick_t
+local_getReader(void);
+
+static void
+local_writeFile(void);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+gridReaderBrick_new_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridReaderBrick_t reader;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	reader = gridReaderBrick_new();
+	if ((reader->base).type != GRIDIO_TYPE_BRICK)
+		hasPassed = false;
+	if ((reader->base).fileName != NULL)
+		hasPassed = false;
+	if (reader->brickFile != NULL)
+		hasPassed = false;
+
+	gridReaderBrick_del((gridReader_t *)&reader);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+gridReaderBrick_del_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridReaderBrick_t reader;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	local_writeFile();
+	reader = local_getReader();
+	if (gridReaderBrick_getBrickFile(reader) != reader->brickFile)
+		hasPassed = false;
+	gridReaderBrick_del((gridReader_t *)&reader);
+	if (reader != NULL)
+		hasPassed = false;
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+gridReaderBrick_readIntoPatch_test(void)
+{
+	bool              hasPassed      = true;
+	int               rank           = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+	uint32_t          idxLo[3]       = {1, 2, 3};
+	uint32_t          idxHi[3]       = {6, 4, 7};
+	gridPatch_t       patch          = gridPatch_new(idxLo, idxHi);
+	gridReaderBrick_t reader;
+	fpv_t             *data;
+	uint64_t          pos = 0;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	local_writeFile();
+	reader = local_getReader();
+
+	gridReaderBrick_readIntoPatch((gridReader_t)reader, patch);
+	data = gridPatch_getVarDataHandle(patch, 0);
+	for (uint32_t k = idxLo[2]; k <= idxHi[2]; k++) {
+		for (uint32_t j = idxLo[1]; j <= idxHi[1]; j++) {
+			for (uint32_t i = idxLo[0]; i <= idxHi[0]; i++) {
+				if (islessgreater(data[pos++], (fpv_t)(i + (j + k * 8) * 8)))
+					hasPassed = false;
+			}
+		}
+	}
+
+	gridReaderBrick_del((gridReader_t *)&reader);
+	gridPatch_del(&patch);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridReaderBrick_readIntoPatch_test */
+
+/*--- Implementations of local functions --------------------------------*/
+static gridReaderBrick_t
+local_getReader(void)
+{
+	gridReaderBrick_t reader;
+	parse_ini_t       ini;
+
+	ini    = parse_ini_open("tests/reading.ini");
+	reader = (gridReaderBrick_t)
+	         gridReaderFactory_newReaderFromIni(ini, "ReaderBrick");
+	parse_ini_close(&ini);
+
+	return reader;
+}
+
+static void
+local_writeFile(void)
+{
+	gridWriterBrick_t writer;
+	brickFile_t       brickFile;
+	uint32_t          size[3]      = {8, 8, 8};
+	uint32_t          brickSize[3] = {4, 3, 5};
+	uint32_t          idxLo[3]     = {0, 0, 0};
+	uint32_t          idxHi[3]     = {7, 7, 7};
+	gridPatch_t       patch        = gridPatch_new(idxLo, idxHi);
+	dataVar_t         var          = dataVar_new("test", DATAVARTYPE_FPV, 1);
+	fpv_t             *data;
+
+#ifdef WITH_MPI
+	// Other tasks may still be reading the previous file.
+	MPI_Barrier(MPI_COMM_WORLD);
+#endif
+	gridPatch_attachVar(patch, var);
+	data = gridPatch_getVarDataHandle(patch, 0);
+	for (uint64_t i = 0; i < gridPatch_getNumCells(patch); i++)
+		data[i] = (fpv_t)i;
+
+	writer    = gridWriterBrick_new();
+	brickFile = gridWriterBrick_getBrickFile(writer);
+	brickFile_setSize(brickFile, size);
+	brickFile_setBrickSize(brickFile, brickSize);
+	brickFile_setCompression(brickFile, BRICKFILE_COMPRESSION_SHUFFLE_LZ);
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       filename_newFull(NULL, "gridReaderBrickTest",
+	                                        NULL, ".brick"));
+#ifdef WITH_MPI
+	gridWriter_initParallel((gridWriter_t)writer, MPI_COMM_WORLD);
+#endif
+
+	gridWriter_activate((gridWriter_t)writer);
+	gridWriter_writeGridPatch((gridWriter_t)writer, patch, "test",
+	                          NULL, NULL);
+	gridWriter_deactivate((gridWriter_t)writer);
+#ifdef WITH_MPI
+	MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+	gridWriter_del((gridWriter_t *)&writer);
+	dataVar_del(&var);
+	gridPatch_del(&patch);
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDREADERBRICK_TESTS_H
+#define GRIDREADERBRICK_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridReaderBrick_tests.h
+ * @ingroup  libgridIOInBrickTests
+ * @brief  Provides the interface to the tests.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/** @brief  Tests gridReaderBrick_new(). */
+extern bool
+gridReaderBrick_new_test(void);
+
+
+/** @brief  Tests gridReaderBrick_del(). */
+extern bool
+gridReaderBrick_del_test(void);
+
+
+/**
+ * @brief  Tests gridReaderBrick_readIntoPatch() on a file written with
+ *         the brick writer.
+ */
+extern bool
+gridReaderBrick_readIntoPatch_test(void);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libgridIOInBrickTests Tests
+ * @ingroup libgridIOInBrick
+ * @brief  Provides the tests for the brick reader.
+ */
+
+
+#endif
@@ -22,6 +22,7 @@
 #include "gridIOCommon.h"
 #include "gridReaderGrafic.h"
 #include "gridReaderBov.h"
+#include "gridReaderBrick.h"
 #ifdef WITH_HDF5
 #  include "gridReaderHDF5.h"
 #  include <string.h>
@@ -84,8 +85,11 @@ gridReaderFactory_newFromIniGrafic(parse_ini_t ini,
                                    filename_t  fn)
 {
 	gridReaderGrafic_t reader;
+	bool               useMmap;
 
 	reader = gridReaderGrafic_new();
+	if (parse_ini_get_bool(ini, "useMmap", sectionName, &useMmap))
+		gridReaderGrafic_setUseMmap(reader, useMmap);
 
 	if (fn == GRIDREADERFACTORY_GET_FILENAME_FROM_SPECIFIC_SECTION) {
 		fn = gridIOCommon_getFileName(ini, sectionName, false);
@@ -107,8 +111,34 @@ gridReaderFactory_newFromIniBov(parse_ini_t ini,
                                 filename_t  fn)
 {
 	gridReaderBov_t reader;
+	bool            useMmap;
 
 	reader = gridReaderBov_new();
+	if (parse_ini_get_bool(ini, "useMmap", sectionName, &useMmap))
+		gridReaderBov_setUseMmap(reader, useMmap);
+
+	if (fn == GRIDREADERFACTORY_GET_FILENAME_FROM_SPECIFIC_SECTION) {
+		fn = gridIOCommon_getFileName(ini, sectionName, false);
+	} else {
+		filename_t fnSpecific = gridIOCommon_getFileName(ini, sectionName,
+		                                                 true);
+		filename_copySetFields(fn, fnSpecific);
+		filename_del(&fnSpecific);
+	}
+
+	gridReader_setFileName((gridReader_t)reader, fn);
+
+	return reader;
+}
+
+extern gridReaderBrick_t
+gridReaderFactory_newFromIniBrick(parse_ini_t ini,
+                                  const char  *sectionName,
+                                  filename_t  fn)
+{
+	gridReaderBrick_t reader;
+
+	reader = gridReaderBrick_new();
 
 	if (fn == GRIDREADERFACTORY_GET_FILENAME_FROM_SPECIFIC_SECTION) {
 		fn = gridIOCommon_getFileName(ini, sectionName, false);
@@ -132,6 +162,8 @@ gridReaderFactory_newFromIniHDF5(parse_ini_t ini,
 {
 	gridReaderHDF5_t reader;
 	bool tmp, doPatch;
+	bool doCollectiveRead;
+	int32_t chunkCacheMB;
 
 	reader = gridReaderHDF5_new();
 
@@ -152,6 +184,34 @@ gridReaderFactory_newFromIniHDF5(parse_ini_t ini,
 		local_doPatch(ini, sectionName, reader);
 	}
 
+	if (parse_ini_get_int32(ini, "chunkCacheMB", sectionName,
+	                        &chunkCacheMB)) {
+		int32_t chunkCacheSlots;
+		double  chunkCachePreemption;
+		if (!parse_ini_get_int32(ini, "chunkCacheSlots", sectionName,
+		                         &chunkCacheSlots))
+			chunkCacheSlots = -1;
+		if (!parse_ini_get_double(ini, "chunkCachePreemption", sectionName,
+		                          &chunkCachePreemption))
+			chunkCachePreemption = 1.0;
+		gridReaderHDF5_setChunkCache(reader,
+		                             (size_t)chunkCacheMB * 1024 * 1024,
+		                             chunkCacheSlots > 0
+		                             ? (size_t)chunkCacheSlots
+		                             : H5D_CHUNK_CACHE_NSLOTS_DEFAULT,
+		                             chunkCachePreemption);
+	}
+
+	if (parse_ini_get_bool(ini, "doCollectiveRead", sectionName,
+	                       &doCollectiveRead) && doCollectiveRead) {
+#ifdef WITH_MPI
+		gridReaderHDF5_initParallel(reader, MPI_COMM_WORLD);
+#else
+		fprintf(stderr,
+		        "WARNING: doCollectiveRead requires MPI, ignoring it.\n");
+#endif
+	}
+
 	return reader;
 }
 
@@ -283,6 +343,9 @@ local_newFromIniWrapper(parse_ini_t ini,
 	} else if (type == GRIDIO_TYPE_GRAFIC) {
 		r = (gridReader_t)gridReaderFactory_newFromIniGrafic(ini, extended,
 		                                                     fn);
+	} else if (type == GRIDIO_TYPE_BRICK) {
+		r = (gridReader_t)gridReaderFactory_newFromIniBrick(ini, extended,
+		                                                    fn);
 	} else if (type == GRIDIO_TYPE_HDF5) {
 #ifdef WITH_HDF5
 		r = (gridReader_t)gridReaderFactory_newFromIniHDF5(ini, extended,
@@ -87,6 +87,9 @@ gridReaderFactory_newReaderFromIni(parse_ini_t ini, const char *sectionName);
  *  <dt>HDF5</dt>
  *  <dd>The name is given by #local_typeHDF5Str.  For further
  *      construction details see @ref libgridIOInHDF5IniFormat.</dd>
+ *  <dt>Brick</dt>
+ *  <dd>The name is given by #local_typeBrickStr.  For further
+ *      construction details see @ref libgridIOInBrickIniFormat.</dd>
  * </dl>
  *
  * @section libgridIOInGraficIniFormat  Grafic
@@ -112,6 +115,12 @@ gridReaderFactory_newReaderFromIni(parse_ini_t ini, const char *sectionName);
  * @code
  * [SectionName]
  * @endcode
+ *
+ * @section libgridIOInBrickIniFormat  Brick
+ *
+ * @code
+ * [SectionName]
+ * @endcode
  */
 
 
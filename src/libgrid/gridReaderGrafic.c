@@ -143,6 +143,16 @@ gridReaderGrafic_getGrafic(const gridReaderGrafic_t reader)
 	return reader->grafic;
 }
 
+extern void
+gridReaderGrafic_setUseMmap(gridReaderGrafic_t reader, bool useMmap)
+{
+	assert(reader != NULL);
+
+	reader->useMmap = useMmap;
+	if (reader->grafic != NULL)
+		grafic_setUseMmap(reader->grafic, useMmap);
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridReaderGrafic_t
 gridReaderGrafic_alloc(void)
@@ -157,7 +167,8 @@ gridReaderGrafic_alloc(void)
 extern void
 gridReaderGrafic_init(gridReaderGrafic_t reader)
 {
-	reader->grafic = NULL;
+	reader->grafic  = NULL;
+	reader->useMmap = false;
 }
 
 extern void
@@ -222,5 +233,6 @@ local_handleFilenameChange(gridReader_t reader)
 	grafic_t grafic;
 
 	grafic = grafic_newFromFile(filename_getFullName(reader->fileName));
+	grafic_setUseMmap(grafic, ((gridReaderGrafic_t)reader)->useMmap);
 	gridReaderGrafic_setGrafic((gridReaderGrafic_t)reader, grafic);
 }
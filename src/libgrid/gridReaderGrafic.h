@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridReader.h"
+#include <stdbool.h>
 #include "../libutil/grafic.h"
 
 
@@ -101,6 +102,33 @@ gridReaderGrafic_getGrafic(const gridReaderGrafic_t writer);
 /** @} */
 
 
+/**
+ * @name  Setter (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Selects whether windows are read through a memory mapping.
+ *
+ * The setting is kept when the file name of the reader changes.  See
+ * grafic_setUseMmap() for details.
+ *
+ * @param[in,out]  reader
+ *                    The reader to work with, passing @c NULL is
+ *                    undefined.
+ * @param[in]      useMmap
+ *                    Whether to use a memory mapping.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderGrafic_setUseMmap(gridReaderGrafic_t reader, bool useMmap);
+
+
+/** @} */
+
+
 /*--- Doxygen group definitions -----------------------------------------*/
 
 /**
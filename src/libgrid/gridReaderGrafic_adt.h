@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridReader_adt.h"
+#include <stdbool.h>
 #include "../libutil/grafic.h"
 
 
@@ -29,6 +30,8 @@ struct gridReaderGrafic_struct {
 	struct gridReader_struct base;
 	/** @brief  The low level Grafic interface. */
 	grafic_t grafic;
+	/** @brief  Toggles reading through a memory mapping of the file. */
+	bool     useMmap;
 };
 
 
@@ -16,9 +16,13 @@
 #include "gridConfig.h"
 #include "gridReaderHDF5.h"
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
 #include "gridUtilHDF5.h"
 #include "../libutil/xmem.h"
 #include "../libutil/xstring.h"
+#include "../libutil/diediedie.h"
+#include "../libutil/timer.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
@@ -29,6 +33,12 @@
  #define MIN(X,Y) ((X) < (Y) ? (X) : (Y))
  #define MAX(X,Y) ((X) > (Y) ? (X) : (Y))
 
+/**
+ * @brief  The maximal number of pieces into which a patch is split along
+ *         one dimension by the periodic wrapping of the region in the file.
+ */
+#define LOCAL_MAXRUNS 2
+
 /*--- Local variables ---------------------------------------------------*/
 
 /** @brief  Stores the functions table for the HDF5 reader. */
@@ -46,8 +56,49 @@ local_readIntoPatchForVar_old(gridReader_t reader,
                                    int          idxOfVar);
 static void
 local_readIntoPatchForVar_doPatch(gridReader_t reader,
-                                   gridPatch_t  patch,
-                                   int          idxOfVar);
+                                  gridPatch_t  patch,
+                                  int          idxOfVar);
+
+static hid_t
+local_getFileAccessProps(const gridReaderHDF5_t reader);
+
+static hid_t
+local_getTransferProps(const gridReaderHDF5_t reader);
+
+static void
+local_read(gridReaderHDF5_t reader,
+           hid_t            dataSet,
+           hid_t            dataType,
+           hid_t            dataSpaceMem,
+           hid_t            dataSpaceFile,
+           void             *data);
+
+static bool
+local_isCompatibleDatatype(hid_t dataTypeFile, hid_t dataTypeMem);
+
+static hid_t
+local_openDataSet(gridReaderHDF5_t reader, const char *name);
+
+static void
+local_closeDataSet(gridReaderHDF5_t reader);
+
+static int
+local_getRuns(const gridReader_t reader,
+              int                dim,
+              uint32_t           idxLoPatch,
+              uint32_t           dimPatch,
+              uint32_t           *runPatch,
+              uint32_t           *runFile,
+              uint32_t           *runLen);
+
+static void
+local_selectRuns(hid_t       dataSpaceFile,
+                 hid_t       dataSpacePatch,
+                 const int   *numRuns,
+                 const int   *runOfSplit,
+                 uint32_t    runPatch[NDIM][LOCAL_MAXRUNS],
+                 uint32_t    runFile[NDIM][LOCAL_MAXRUNS],
+                 uint32_t    runLen[NDIM][LOCAL_MAXRUNS]);
 
 /*--- Implementations of exported functions -----------------------------*/
 extern void
@@ -70,23 +121,16 @@ gridReaderHDF5_readIntoPatch(gridReader_t reader, gridPatch_t patch)
 	assert(reader->type = GRIDIO_TYPE_HDF5);
 	assert(patch != NULL);
 
-	/** 
-	 * @bug  This function does nothing as it is not implemented.
+	/**
 	 * @todo Figure out the vars in the HDF5 file, create a gridVar for each
 	 * and attach to patch, read the data from the file into the patch via
 	 * gridReaderHDF5_readIntoPatchForVar().
 	 */
-#if 0
-	dataVar_t var;
-	int       idxOfVar;
-
-	var      = local_getNewVar(((gridReaderHDF5_t)reader)->file);
-	idxOfVar = gridPatch_attachVar(patch, var);
-
-	gridReader_readIntoPatchForVar(reader, patch, idxOfVar);
-
-	dataVar_del(&var);
-#endif
+	fprintf(stderr,
+	        "ERROR: Cannot read %s without a variable, the HDF5 reader only "
+	        "supports gridReader_readIntoPatchForVar().\n",
+	        filename_getFullName(reader->fileName));
+	diediedie(EXIT_FAILURE);
 }
 
 
@@ -128,6 +172,53 @@ gridReaderHDF5_getH5File(const gridReaderHDF5_t reader)
 	return reader->file;
 }
 
+extern void
+gridReaderHDF5_getReadStats(const gridReaderHDF5_t reader,
+                            uint64_t               *bytesRead,
+                            double                 *secondsRead)
+{
+	assert(reader != NULL);
+	assert(bytesRead != NULL);
+	assert(secondsRead != NULL);
+
+	*bytesRead   = reader->bytesRead;
+	*secondsRead = reader->secondsRead;
+}
+
+extern void
+gridReaderHDF5_setChunkCache(gridReaderHDF5_t reader,
+                             size_t           numBytes,
+                             size_t           numSlots,
+                             double           preemption)
+{
+	assert(reader != NULL);
+	assert(preemption >= 0.0 && preemption <= 1.0);
+
+	reader->chunkCacheBytes      = numBytes;
+	reader->chunkCacheSlots      = numSlots;
+	reader->chunkCachePreemption = preemption;
+
+	// The cache is set when opening the dataset.
+	local_closeDataSet(reader);
+}
+
+#ifdef WITH_MPI
+extern void
+gridReaderHDF5_initParallel(gridReaderHDF5_t reader, MPI_Comm mpiComm)
+{
+	assert(reader != NULL);
+	assert(mpiComm != MPI_COMM_NULL);
+
+	reader->doCollectiveRead = true;
+	reader->mpiComm          = mpiComm;
+
+	// A file opened earlier used the default driver and is reopened.
+	if (reader->base.fileName != NULL)
+		local_handleFilenameChange((gridReader_t)reader);
+}
+
+#endif
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridReaderHDF5_t
 gridReaderHDF5_alloc(void)
@@ -138,7 +229,18 @@ gridReaderHDF5_alloc(void)
 extern void
 gridReaderHDF5_init(gridReaderHDF5_t reader)
 {
-	reader->file = H5I_INVALID_HID;
+	reader->file             = H5I_INVALID_HID;
+	reader->doCollectiveRead = false;
+#ifdef WITH_MPI
+	reader->mpiComm          = MPI_COMM_NULL;
+#endif
+	reader->bytesRead        = UINT64_C(0);
+	reader->secondsRead      = 0.0;
+	reader->chunkCacheBytes      = 0;
+	reader->chunkCacheSlots      = H5D_CHUNK_CACHE_NSLOTS_DEFAULT;
+	reader->chunkCachePreemption = 1.0;
+	reader->dataSet              = H5I_INVALID_HID;
+	reader->dataSetName          = NULL;
 	gridReaderHDF5_setDoPatch((gridReader_t)reader,false);
 	gridReaderHDF5_setDims((gridReader_t)reader, 100000000);
 }
@@ -146,6 +248,7 @@ gridReaderHDF5_init(gridReaderHDF5_t reader)
 extern void
 gridReaderHDF5_free(gridReaderHDF5_t reader)
 {
+	local_closeDataSet(reader);
 	if (reader->file != H5I_INVALID_HID)
 		H5Fclose(reader->file);
 
@@ -157,6 +260,7 @@ gridReaderHDF5_setH5File(gridReaderHDF5_t reader, hid_t file)
 	assert(reader != NULL);
 
 	if (file != reader->file) {
+		local_closeDataSet(reader);
 		if (reader->file != H5I_INVALID_HID)
 			H5Fclose(reader->file);
 		reader->file = file;
@@ -186,7 +290,10 @@ local_handleFilenameChange(gridReader_t reader)
 		diediedie(EXIT_FAILURE);
 	}
 
-	hid_t file = H5Fopen(fileName, H5F_ACC_RDONLY, H5P_DEFAULT);
+	hid_t accessProps = local_getFileAccessProps((gridReaderHDF5_t)reader);
+	hid_t file        = H5Fopen(fileName, H5F_ACC_RDONLY, accessProps);
+	if (accessProps != H5P_DEFAULT)
+		H5Pclose(accessProps);
 	if (file < 0) {
 		fprintf(stderr, "ERROR: Could not open %s for reading.\n", fileName);
 		diediedie(EXIT_FAILURE);
@@ -235,8 +342,8 @@ local_readIntoPatchForVar_old(gridReader_t reader,
 	gridPatch_getIdxLo(patch, idxLoPatch);
 	gridPatch_getDims(patch, dimsPatch);
 
-	dataSet        = H5Dopen(((gridReaderHDF5_t)reader)->file,
-	                         dataVar_getName(var), H5P_DEFAULT);
+	dataSet        = local_openDataSet((gridReaderHDF5_t)reader,
+	                                   dataVar_getName(var));
 	dataTypeFile   = H5Dget_type(dataSet);
 	dataSpaceFile  = H5Dget_space(dataSet);
 
@@ -247,9 +354,9 @@ local_readIntoPatchForVar_old(gridReader_t reader,
 	
 	//local_memUsage();
 	
-	if (H5Tequal(dataTypeFile, dataTypePatch)) {
-		H5Dread(dataSet, dataTypeFile, dataSpacePatch,
-		        dataSpaceFile, H5P_DEFAULT, data);
+	if (local_isCompatibleDatatype(dataTypeFile, dataTypePatch)) {
+		local_read((gridReaderHDF5_t)reader, dataSet, dataTypePatch,
+		           dataSpacePatch, dataSpaceFile, data);
 	} else {
 		fprintf(stderr, "ERROR: Datatype in memory differs from file.\n");
 		diediedie(EXIT_FAILURE);
@@ -260,55 +367,14 @@ local_readIntoPatchForVar_old(gridReader_t reader,
 	H5Tclose(dataTypePatch);
 	H5Sclose(dataSpaceFile);
 	H5Tclose(dataTypeFile);
-	H5Dclose(dataSet);
 }
 
 
 
-#define read() \
-{ \
-	doRead=true; \
-	for(int k=0; k<NDIM; k++) { \
-        idxLoRead[k]=MAX(idxLoW[k], idxLoPatch[k]); \
-        idxHiRead[k]=MIN(idxLoPatch[k]+dimsPatch[k]-1, idxHiW[k]); \
-        if(idxHiRead[k]<idxLoRead[k]) doRead=false; \        
-        idxLoReadRtw[k]=idxLoRead[k]-reader->rtwLo[k]; \
-        idxLoReadRtw[k] = idxLoReadRtw[k]<0 ? idxLoReadRtw[k]+period[k] : idxLoReadRtw[k]; \
-        idxLoReadRtw[k] = idxLoReadRtw[k]>=period[k] ? idxLoReadRtw[k]-period[k] : idxLoReadRtw[k]; \
-		dimsRead[k]=idxHiRead[k]-idxLoRead[k]+1; \
-	} \
-    if (doRead) { \
-		dataSet        = H5Dopen(((gridReaderHDF5_t)reader)->file, \
-								 dataVar_getName(var), H5P_DEFAULT); \
-		dataTypeFile   = H5Dget_type(dataSet); \
-		dataSpaceFile  = H5Dget_space(dataSet); \
-		dataTypePatch  = dataVar_getHDF5Datatype(var); \
-		dataSpacePatch = gridUtilHDF5_getDataSpaceFromDims(dimsRead); \
-		gridUtilHDF5_selectHyperslab(dataSpaceFile, idxLoReadRtw, dimsRead); \
-		if (H5Tequal(dataTypeFile, dataTypePatch)) { \
-			H5Dread(dataSet, dataTypeFile, dataSpacePatch, \
-					dataSpaceFile, H5P_DEFAULT, data); \
-		} else { \
-			fprintf(stderr, "ERROR: Datatype in memory differs from file.\n"); \
-			diediedie(EXIT_FAILURE); \
-		} \
-		H5Sclose(dataSpacePatch); \
-		H5Tclose(dataTypePatch); \
-		H5Sclose(dataSpaceFile); \
-		H5Tclose(dataTypeFile); \
-		H5Dclose(dataSet); \
-		gridPatch_allocateVarData(patch,idxOfVar); \
-		gridPatch_putWindowedData(patch, idxOfVar, idxLoRead, idxHiRead, data); \
-	} \
-}
-	
-	
-	
-
 static void
 local_readIntoPatchForVar_doPatch(gridReader_t reader,
-                                   gridPatch_t  patch,
-                                   int          idxOfVar)
+                                  gridPatch_t  patch,
+                                  int          idxOfVar)
 {
 	assert(reader != NULL);
 	assert(reader->type = GRIDIO_TYPE_HDF5);
@@ -318,102 +384,264 @@ local_readIntoPatchForVar_doPatch(gridReader_t reader,
 	hid_t             dataSet;
 	hid_t             dataSpaceFile, dataTypeFile;
 	hid_t             dataSpacePatch, dataTypePatch;
-	gridPointUint32_t idxLoPatch, dimsPatch, idxLoRead, dimsRead, idxHiRead;
-	gridPointUint32_t period, rtwHi;
-	int32_t 		  idxLo1[3], idxLo2[3], idxHi1[3], idxHi2[3], idxLoW[3], idxHiW[3], idxLoReadRtw[3];
-	dataVar_t         var   = gridPatch_getVarHandle(patch, idxOfVar);
-	void             *data;
-	bool              doRead;
-	//void             *dataPatch = gridPatch_getVarDataHandle(patch, idxOfVar);
-	uint64_t  numCellsToAllocate = 1;
-	numCellsToAllocate = gridPatch_getNumCellsActual(patch,
-	                                                 idxOfVar);
-	data               = dataVar_getMemory(var, numCellsToAllocate);
-	
-	for(int k=0; k<NDIM; k++) {
-		period[k] = reader->gridDims[k];
-		rtwHi[k] = reader->rtwLo[k] + reader->rtwDims[k]-1;
-	}
-	
+	gridPointUint32_t idxLoPatch, dimsPatch, dimsActual;
+	uint32_t          runPatch[NDIM][LOCAL_MAXRUNS];
+	uint32_t          runFile[NDIM][LOCAL_MAXRUNS];
+	uint32_t          runLen[NDIM][LOCAL_MAXRUNS];
+	int               numRuns[NDIM];
+	bool              isSplit[NDIM];
+	int               numReads = 1;
+	int               numReadsAll;
+	dataVar_t         var      = gridPatch_getVarHandle(patch, idxOfVar);
+	void              *data    = gridPatch_allocateVarData(patch, idxOfVar);
+
 	gridPatch_getIdxLo(patch, idxLoPatch);
 	gridPatch_getDims(patch, dimsPatch);
-	
-	for(int k=0; k<NDIM; k++) {
-		idxLo1[k] = reader->rtwLo[k]<0 ? reader->rtwLo[k]+period[k] : reader->rtwLo[k];
-		idxHi1[k] = MIN(rtwHi[k], period[k]-1);
-		idxHi1[k] = reader->rtwLo[k]<0 ? period[k]-1 : idxHi1[k];
-		idxLo2[k] = rtwHi[k]>=period[k] ? 0 : rtwHi[k];
-		idxLo2[k] = reader->rtwLo[k]<0 ? 0 : idxLo2[k];
-		idxHi2[k] = rtwHi[k]>=period[k] ? rtwHi[k]-period[k] : rtwHi[k];
-		if (idxHi2[k] == idxLo2[k]) idxHi2[k] -= 1;
+	gridPatch_getDimsActual(patch, idxOfVar, dimsActual);
+
+	for (int k = 0; k < NDIM; k++) {
+		numRuns[k] = local_getRuns(reader, k, idxLoPatch[k], dimsPatch[k],
+		                           runPatch[k], runFile[k], runLen[k]);
+		if (numRuns[k] == 0)
+			numReads = 0;
+		// Selections are traversed in order of increasing coordinates, runs
+		// that are ordered differently in the patch and the file need to be
+		// read separately.
+		isSplit[k] = (numRuns[k] > 1) && (runFile[k][1] < runFile[k][0]);
+		if (isSplit[k])
+			numReads *= numRuns[k];
 	}
-    
-	idxLoW[0] = idxLo1[0];
-	idxLoW[1] = idxLo1[1];
-	idxLoW[2] = idxLo1[2];
-	idxHiW[0] = idxHi1[0];
-	idxHiW[1] = idxHi1[1];
-	idxHiW[2] = idxHi1[2];
-	read();
-	
-	idxLoW[0] = idxLo2[0];
-	idxLoW[1] = idxLo1[1];
-	idxLoW[2] = idxLo1[2];
-	idxHiW[0] = idxHi2[0];
-	idxHiW[1] = idxHi1[1];
-	idxHiW[2] = idxHi1[2];
-	read();
-	
-	idxLoW[0] = idxLo1[0];
-	idxLoW[1] = idxLo2[1];
-	idxLoW[2] = idxLo1[2];
-	idxHiW[0] = idxHi1[0];
-	idxHiW[1] = idxHi2[1];
-	idxHiW[2] = idxHi1[2];
-	read();
-	
-	idxLoW[0] = idxLo1[0];
-	idxLoW[1] = idxLo1[1];
-	idxLoW[2] = idxLo2[2];
-	idxHiW[0] = idxHi1[0];
-	idxHiW[1] = idxHi1[1];
-	idxHiW[2] = idxHi2[2];
-	read();
-	
-	idxLoW[0] = idxLo2[0];
-	idxLoW[1] = idxLo2[1];
-	idxLoW[2] = idxLo1[2];
-	idxHiW[0] = idxHi2[0];
-	idxHiW[1] = idxHi2[1];
-	idxHiW[2] = idxHi1[2];
-	read();
-	
-	idxLoW[0] = idxLo1[0];
-	idxLoW[1] = idxLo2[1];
-	idxLoW[2] = idxLo2[2];
-	idxHiW[0] = idxHi1[0];
-	idxHiW[1] = idxHi2[1];
-	idxHiW[2] = idxHi2[2];
-	read();
-	
-	idxLoW[0] = idxLo2[0];
-	idxLoW[1] = idxLo1[1];
-	idxLoW[2] = idxLo2[2];
-	idxHiW[0] = idxHi2[0];
-	idxHiW[1] = idxHi1[1];
-	idxHiW[2] = idxHi2[2];
-	read();
-	
-	idxLoW[0] = idxLo2[0];
-	idxLoW[1] = idxLo2[1];
-	idxLoW[2] = idxLo2[2];
-	idxHiW[0] = idxHi2[0];
-	idxHiW[1] = idxHi2[1];
-	idxHiW[2] = idxHi2[2];
-	read();
-	
-	dataVar_freeMemory(var, data);
-	
-} 
 
-#undef read
+	dataSet       = local_openDataSet((gridReaderHDF5_t)reader,
+	                                  dataVar_getName(var));
+	dataTypeFile  = H5Dget_type(dataSet);
+	dataSpaceFile = H5Dget_space(dataSet);
+	dataTypePatch = dataVar_getHDF5Datatype(var);
+	if (!local_isCompatibleDatatype(dataTypeFile, dataTypePatch)) {
+		fprintf(stderr, "ERROR: Datatype in memory differs from file.\n");
+		diediedie(EXIT_FAILURE);
+	}
+	dataSpacePatch = gridUtilHDF5_getDataSpaceFromDims(dimsActual);
+
+	numReadsAll    = numReads;
+#ifdef WITH_MPI
+	// Collective reads need to be issued by all tasks the same number of
+	// times, tasks with less to read take part with empty selections.
+	if (((gridReaderHDF5_t)reader)->doCollectiveRead)
+		MPI_Allreduce(&numReads, &numReadsAll, 1, MPI_INT, MPI_MAX,
+		              ((gridReaderHDF5_t)reader)->mpiComm);
+#endif
+
+	for (int r = 0; r < numReadsAll; r++) {
+		int runOfSplit[NDIM];
+		int tmp = r;
+
+		if (r < numReads) {
+			for (int k = 0; k < NDIM; k++) {
+				runOfSplit[k] = isSplit[k] ? tmp % numRuns[k] : -1;
+				tmp          /= isSplit[k] ? numRuns[k] : 1;
+			}
+			local_selectRuns(dataSpaceFile, dataSpacePatch, numRuns,
+			                 runOfSplit, runPatch, runFile, runLen);
+		} else {
+			H5Sselect_none(dataSpaceFile);
+			H5Sselect_none(dataSpacePatch);
+		}
+		local_read((gridReaderHDF5_t)reader, dataSet, dataTypePatch,
+		           dataSpacePatch, dataSpaceFile, data);
+	}
+
+	H5Sclose(dataSpacePatch);
+	H5Tclose(dataTypePatch);
+	H5Sclose(dataSpaceFile);
+	H5Tclose(dataTypeFile);
+} /* local_readIntoPatchForVar_doPatch */
+
+static hid_t
+local_getFileAccessProps(const gridReaderHDF5_t reader)
+{
+	hid_t accessProps = H5P_DEFAULT;
+
+#ifdef WITH_MPI
+	if (reader->doCollectiveRead) {
+		accessProps = H5Pcreate(H5P_FILE_ACCESS);
+		if (accessProps < 0)
+			diediedie(EXIT_FAILURE);
+		if (H5Pset_fapl_mpio(accessProps, reader->mpiComm,
+		                     MPI_INFO_NULL) < 0)
+			diediedie(EXIT_FAILURE);
+	}
+#endif
+
+	return accessProps;
+}
+
+static hid_t
+local_getTransferProps(const gridReaderHDF5_t reader)
+{
+	hid_t transProps = H5P_DEFAULT;
+
+#ifdef WITH_MPI
+	if (reader->doCollectiveRead) {
+		transProps = H5Pcreate(H5P_DATASET_XFER);
+		assert(transProps >= 0);
+		H5Pset_dxpl_mpio(transProps, H5FD_MPIO_COLLECTIVE);
+	}
+#endif
+
+	return transProps;
+}
+
+static void
+local_read(gridReaderHDF5_t reader,
+           hid_t            dataSet,
+           hid_t            dataType,
+           hid_t            dataSpaceMem,
+           hid_t            dataSpaceFile,
+           void             *data)
+{
+	hid_t  transProps = local_getTransferProps(reader);
+	double timing     = timer_startLocal();
+
+	if (H5Dread(dataSet, dataType, dataSpaceMem, dataSpaceFile,
+	            transProps, data) < 0) {
+		fprintf(stderr, "ERROR: Reading from %s failed.\n",
+		        filename_getFullName(reader->base.fileName));
+		diediedie(EXIT_FAILURE);
+	}
+
+	reader->secondsRead += timer_stopLocal(timing);
+	reader->bytesRead   += (uint64_t)H5Sget_select_npoints(dataSpaceFile)
+	                       * H5Tget_size(dataType);
+
+	if (transProps != H5P_DEFAULT)
+		H5Pclose(transProps);
+}
+
+static bool
+local_isCompatibleDatatype(hid_t dataTypeFile, hid_t dataTypeMem)
+{
+	// Floating point data written with the N-bit filter have a reduced
+	// precision in the file, they are converted by the library on reading.
+	if (H5Tequal(dataTypeFile, dataTypeMem) > 0)
+		return true;
+
+	return (H5Tget_class(dataTypeFile) == H5T_FLOAT)
+	       && (H5Tget_class(dataTypeMem) == H5T_FLOAT)
+	       && (H5Tget_size(dataTypeFile) == H5Tget_size(dataTypeMem));
+}
+
+static hid_t
+local_openDataSet(gridReaderHDF5_t reader, const char *name)
+{
+	hid_t accessProps = H5P_DEFAULT;
+
+	if ((reader->dataSet != H5I_INVALID_HID)
+	    && (strcmp(reader->dataSetName, name) == 0))
+		return reader->dataSet;
+
+	local_closeDataSet(reader);
+
+	if (reader->chunkCacheBytes > 0) {
+		accessProps = H5Pcreate(H5P_DATASET_ACCESS);
+		if ((accessProps < 0)
+		    || (H5Pset_chunk_cache(accessProps, reader->chunkCacheSlots,
+		                           reader->chunkCacheBytes,
+		                           reader->chunkCachePreemption) < 0))
+			diediedie(EXIT_FAILURE);
+	}
+
+	reader->dataSet = H5Dopen(reader->file, name, accessProps);
+	if (reader->dataSet < 0) {
+		fprintf(stderr, "ERROR: Could not open dataset %s.\n", name);
+		diediedie(EXIT_FAILURE);
+	}
+	reader->dataSetName = xstrdup(name);
+
+	if (accessProps != H5P_DEFAULT)
+		H5Pclose(accessProps);
+
+	return reader->dataSet;
+}
+
+static void
+local_closeDataSet(gridReaderHDF5_t reader)
+{
+	if (reader->dataSet != H5I_INVALID_HID) {
+		H5Dclose(reader->dataSet);
+		reader->dataSet = H5I_INVALID_HID;
+	}
+	if (reader->dataSetName != NULL)
+		xfree(reader->dataSetName);
+	reader->dataSetName = NULL;
+}
+
+static int
+local_getRuns(const gridReader_t reader,
+              int                dim,
+              uint32_t           idxLoPatch,
+              uint32_t           dimPatch,
+              uint32_t           *runPatch,
+              uint32_t           *runFile,
+              uint32_t           *runLen)
+{
+	int64_t  period  = (int64_t)(reader->gridDims[dim]);
+	int64_t  rtwLo   = (int64_t)(reader->rtwLo[dim]);
+	int64_t  rtwDim  = (int64_t)(reader->rtwDims[dim]);
+	int      numRuns = 0;
+	uint32_t i       = 0;
+
+	while (i < dimPatch) {
+		int64_t f = ((int64_t)idxLoPatch + i - rtwLo) % period;
+
+		f = (f < 0) ? f + period : f;
+		if (f < rtwDim) {
+			uint32_t len = (uint32_t)MIN(dimPatch - i, rtwDim - f);
+			assert(numRuns < LOCAL_MAXRUNS);
+			runPatch[numRuns] = i;
+			runFile[numRuns]  = (uint32_t)f;
+			runLen[numRuns]   = len;
+			numRuns++;
+			i += len;
+		} else {
+			i += (uint32_t)MIN(dimPatch - i, period - f);
+		}
+	}
+
+	return numRuns;
+}
+
+static void
+local_selectRuns(hid_t       dataSpaceFile,
+                 hid_t       dataSpacePatch,
+                 const int   *numRuns,
+                 const int   *runOfSplit,
+                 uint32_t    runPatch[NDIM][LOCAL_MAXRUNS],
+                 uint32_t    runFile[NDIM][LOCAL_MAXRUNS],
+                 uint32_t    runLen[NDIM][LOCAL_MAXRUNS])
+{
+	int           numBoxes = 1;
+	H5S_seloper_t op       = H5S_SELECT_SET;
+
+	for (int k = 0; k < NDIM; k++)
+		numBoxes *= (runOfSplit[k] < 0) ? numRuns[k] : 1;
+
+	for (int b = 0; b < numBoxes; b++) {
+		gridPointUint32_t idxLoFile, idxLoMem, dims;
+		int               tmp = b;
+
+		for (int k = 0; k < NDIM; k++) {
+			int run = runOfSplit[k];
+			if (run < 0) {
+				run  = tmp % numRuns[k];
+				tmp /= numRuns[k];
+			}
+			idxLoFile[k] = runFile[k][run];
+			idxLoMem[k]  = runPatch[k][run];
+			dims[k]      = runLen[k][run];
+		}
+		gridUtilHDF5_selectHyperslabOp(dataSpaceFile, op, idxLoFile, dims);
+		gridUtilHDF5_selectHyperslabOp(dataSpacePatch, op, idxLoMem, dims);
+		op = H5S_SELECT_OR;
+	}
+}
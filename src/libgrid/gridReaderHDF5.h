@@ -19,7 +19,11 @@
 #include "gridConfig.h"
 #include "gridReader.h"
 #include "../libutil/parse_ini.h"
+#include <stdint.h>
 #include <hdf5.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -48,7 +52,20 @@ gridReaderHDF5_del(gridReader_t *reader);
  * @{
  */
 
-/** @copydoc gridReader_readIntoPatch() */
+/**
+ * @brief  Not supported, the program terminates with an error.
+ *
+ * Without a variable the reader cannot tell which dataset to read, use
+ * gridReaderHDF5_readIntoPatchForVar() instead.  This also means that
+ * gridReader_calcSummary() cannot be used with HDF5 files.
+ *
+ * @param[in]      reader
+ *                    The reader to use.
+ * @param[in,out]  patch
+ *                    The patch that would be read into.
+ *
+ * @return  Does not return.
+ */
 extern void
 gridReaderHDF5_readIntoPatch(gridReader_t reader, gridPatch_t patch);
 
@@ -100,6 +117,92 @@ gridReaderHDF5_new(void);
 extern hid_t
 gridReaderHDF5_getH5File(const gridReaderHDF5_t writer);
 
+
+/**
+ * @brief  Retrieves the amount of data read and the time spent doing so.
+ *
+ * This allows to compare the throughput of the independent and the
+ * collective read mode.  The reader does not report the numbers itself,
+ * this is left to the application.
+ *
+ * @param[in]   reader
+ *                 The reader that should be queried, passing @c NULL is
+ *                 undefined.
+ * @param[out]  bytesRead
+ *                 Will receive the number of bytes read by this task.
+ * @param[out]  secondsRead
+ *                 Will receive the time this task spent in reading.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderHDF5_getReadStats(const gridReaderHDF5_t reader,
+                            uint64_t               *bytesRead,
+                            double                 *secondsRead);
+
+/** @} */
+
+/**
+ * @name  Setting (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Configures the chunk cache used for reading chunked datasets.
+ *
+ * The dataset that was read last stays open between calls to
+ * gridReader_readIntoPatchForVar(), hence a chunk cache large enough to
+ * hold all chunks touched by one read lets consecutive reads of
+ * neighbouring patches reuse decompressed chunks.
+ *
+ * @param[in,out]  reader
+ *                    The reader to work with, passing @c NULL is
+ *                    undefined.
+ * @param[in]      numBytes
+ *                    The size of the cache in bytes, 0 selects the HDF5
+ *                    default.
+ * @param[in]      numSlots
+ *                    The number of hash slots, should be a prime about
+ *                    100 times the number of chunks fitting into the
+ *                    cache.  H5D_CHUNK_CACHE_NSLOTS_DEFAULT keeps the
+ *                    default of the file.
+ * @param[in]      preemption
+ *                    The preemption policy, between 0 and 1.  With 1,
+ *                    chunks that have been read completely are evicted
+ *                    first.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderHDF5_setChunkCache(gridReaderHDF5_t reader,
+                             size_t           numBytes,
+                             size_t           numSlots,
+                             double           preemption);
+
+#ifdef WITH_MPI
+
+/**
+ * @brief  Switches the reader to collective MPI-IO reads.
+ *
+ * The file is (re)opened with the MPI-IO driver and all subsequent reads
+ * are collective operations, hence all tasks of the communicator must
+ * call gridReader_readIntoPatchForVar() the same number of times (a task
+ * may pass a patch that lies outside of the region in the file).
+ *
+ * @param[in,out]  reader
+ *                    The reader to work with, passing @c NULL is
+ *                    undefined.
+ * @param[in]      mpiComm
+ *                    The communicator of the tasks that read together.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderHDF5_initParallel(gridReaderHDF5_t reader, MPI_Comm mpiComm);
+
+#endif
+
 /** @} */
 
 /*--- Doxygen group definitions -----------------------------------------*/
@@ -18,7 +18,12 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridReader_adt.h"
+#include <stdbool.h>
+#include <stdint.h>
 #include <hdf5.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -28,7 +33,27 @@ struct gridReaderHDF5_struct {
 	/** @brief  The base structure. */
 	struct gridReader_struct base;
 	/** @brief  The HDF5 file handle. */
-	hid_t file;
+	hid_t    file;
+	/** @brief  Flags whether the data is read with collective MPI-IO. */
+	bool     doCollectiveRead;
+#ifdef WITH_MPI
+	/** @brief  The communicator of the tasks that read collectively. */
+	MPI_Comm mpiComm;
+#endif
+	/** @brief  The number of bytes read so far. */
+	uint64_t bytesRead;
+	/** @brief  The time spent in reading so far (in seconds). */
+	double   secondsRead;
+	/** @brief  The size of the chunk cache (0 uses the HDF5 default). */
+	size_t   chunkCacheBytes;
+	/** @brief  The number of hash slots of the chunk cache. */
+	size_t   chunkCacheSlots;
+	/** @brief  The preemption policy of the chunk cache. */
+	double   chunkCachePreemption;
+	/** @brief  The dataset kept open between reads (to keep its cache). */
+	hid_t    dataSet;
+	/** @brief  The name of the dataset that is kept open. */
+	char     *dataSetName;
 };
 
 /*--- Prototypes of protected functions ---------------------------------*/
@@ -218,6 +218,128 @@ gridReaderHDF5_readIntoPatchForVar_test(void)
 	return hasPassed ? true : false;
 } /* gridReaderHDF5_readIntoPatchForVar_test */
 
+extern bool
+gridReaderHDF5_readIntoPatchForVarPeriodic_test(void)
+{
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+	bool              hasPassed      = true;
+	int               rank           = 0;
+	gridReaderHDF5_t  reader;
+	dataVar_t         var;
+	int32_t           rtwLo[3]     = {30, 2, 20};
+	gridPointUint32_t rtwDims      = {4, 8, 16};
+	uint32_t          idxLo[2][3]  = {{0, 0, 0}, {0, 3, 0}};
+	uint32_t          idxHi[2][3]  = {{31, 15, 31}, {1, 5, 3}};
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	reader = local_getReader();
+	var    = dataVar_new("FakeVar", DATAVARTYPE_DOUBLE, 1);
+	gridReaderHDF5_setDoPatch((gridReader_t)reader, true);
+	gridReaderHDF5_setRtw((gridReader_t)reader, rtwLo, rtwDims);
+	gridReaderHDF5_setDims((gridReader_t)reader, 32);
+
+	// The first patch covers the whole periodic box and hence sees the
+	// region wrapped around in x and z, the second one lies inside.
+	for (int p = 0; p < 2; p++) {
+		gridPatch_t       patch = gridPatch_new(idxLo[p], idxHi[p]);
+		gridPointUint32_t dims;
+		double            *data;
+
+		gridPatch_attachVar(patch, var);
+		gridPatch_getDims(patch, dims);
+		gridReaderHDF5_readIntoPatchForVar((gridReader_t)reader, patch, 0);
+		data = (double *)gridPatch_getVarDataHandle(patch, 0);
+
+		for (uint32_t k = 0; k < dims[2]; k++) {
+			for (uint32_t j = 0; j < dims[1]; j++) {
+				for (uint32_t i = 0; i < dims[0]; i++) {
+					int32_t f[3];
+					bool    isInFile = true;
+					f[0] = (idxLo[p][0] + i - rtwLo[0] + 32) % 32;
+					f[1] = (idxLo[p][1] + j - rtwLo[1] + 32) % 32;
+					f[2] = (idxLo[p][2] + k - rtwLo[2] + 32) % 32;
+					for (int d = 0; d < 3; d++)
+						isInFile = isInFile && (f[d] < (int32_t)rtwDims[d]);
+					if (isInFile
+					    && islessgreater(data[i + (j + k * dims[1])
+					                          * dims[0]],
+					                     f[0] + (f[1] + f[2] * 8) * 4))
+						hasPassed = false;
+				}
+			}
+		}
+		gridPatch_del(&patch);
+	}
+
+	gridReaderHDF5_del((gridReader_t *)&reader);
+	dataVar_del(&var);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridReaderHDF5_readIntoPatchForVarPeriodic_test */
+
+extern bool
+gridReaderHDF5_setChunkCache_test(void)
+{
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+	bool              hasPassed      = true;
+	int               rank           = 0;
+	gridReaderHDF5_t  reader;
+	dataVar_t         var;
+	hid_t             dataSet        = H5I_INVALID_HID;
+	uint32_t          idxLo[2][3]    = {{0, 0, 0}, {0, 0, 8}};
+	uint32_t          idxHi[2][3]    = {{3, 7, 7}, {3, 7, 15}};
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	reader = local_getReader();
+	var    = dataVar_new("FakeVar", DATAVARTYPE_DOUBLE, 1);
+	gridReaderHDF5_setChunkCache(reader, 1024 * 1024, 521, 1.0);
+
+	// Consecutive reads of the same variable use the same dataset and
+	// hence the same chunk cache.
+	for (int p = 0; p < 2; p++) {
+		gridPatch_t patch = gridPatch_new(idxLo[p], idxHi[p]);
+		double      *data;
+
+		gridPatch_attachVar(patch, var);
+		gridReaderHDF5_readIntoPatchForVar((gridReader_t)reader, patch, 0);
+		data = (double *)gridPatch_getVarDataHandle(patch, 0);
+		if (islessgreater(data[0], idxLo[p][2] * 32.))
+			hasPassed = false;
+		if (p == 0)
+			dataSet = reader->dataSet;
+		else if (reader->dataSet != dataSet)
+			hasPassed = false;
+		gridPatch_del(&patch);
+	}
+
+	gridReaderHDF5_del((gridReader_t *)&reader);
+	dataVar_del(&var);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridReaderHDF5_setChunkCache_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridReaderHDF5_t
 local_getReader(void)
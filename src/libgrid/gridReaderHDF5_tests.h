@@ -46,6 +46,12 @@ gridReaderHDF5_readIntoPatch_test(void);
 extern bool
 gridReaderHDF5_readIntoPatchForVar_test(void);
 
+extern bool
+gridReaderHDF5_readIntoPatchForVarPeriodic_test(void);
+
+extern bool
+gridReaderHDF5_setChunkCache_test(void);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -20,6 +20,8 @@
 #include "gridReader.h"
 #include "gridIO.h"
 #include "gridPatch.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
 #include "../libutil/filename.h"
 
 
@@ -90,6 +92,10 @@ struct gridReader_struct {
 	gridPointUint32_t	 rtwDims;
 	/** @brief	Gives whole grid dims. */
 	gridPointUint32_t	 gridDims;
+	/** @brief  Accumulates the statistics of the data read, may be NULL. */
+	gridStatistics_t                      stat;
+	/** @brief  Accumulates the histogram of the data read, may be NULL. */
+	gridHistogram_t                       histo;
 };
 
 
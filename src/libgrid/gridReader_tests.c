@@ -143,6 +143,36 @@ gridReader_getFileName_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+gridReader_getType_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridReader_t     reader;
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	reader = local_getReader();
+
+	if (gridReader_getType(reader) != GRIDIO_TYPE_BOV)
+		hasPassed = false;
+
+	gridReader_del(&reader);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
 /*--- Implementations of local functions --------------------------------*/
 static gridReader_t
 local_getReader(void)
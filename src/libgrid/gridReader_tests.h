@@ -35,6 +35,10 @@ gridReader_overlayFileName_test(void);
 extern bool
 gridReader_getFileName_test(void);
 
+/** @brief  Tests gridReader_getType(). */
+extern bool
+gridReader_getType_test(void);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <math.h>
+#include <inttypes.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
@@ -28,6 +29,7 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
+#include "gridUtil.h"
 #include "../libutil/xmem.h"
 #include "../libutil/utilMath.h"
 #include "../libutil/diediedie.h"
@@ -39,6 +41,20 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/**
+ * @brief  Gives the number of cells that are processed in one go.
+ *
+ * The moments of such a block are calculated in two sweeps while the
+ * block is in the cache and are then merged into the running moments,
+ * hence the data is only read once from memory.
+ */
+#define LOCAL_BLOCKSIZE 1024
+
+#ifdef WITH_MPI
+/** @brief  The number of doubles required to communicate the moments. */
+#  define LOCAL_NUMMOMENTS 9
+#endif
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static void
@@ -52,54 +68,41 @@ local_calcRegularCore(gridStatistics_t           stat,
                       int                        idxOfVar);
 
 static void
-local_calcRegularMeanMinMax(gridStatistics_t           stat,
-                            const gridRegularDistrib_t distrib,
-                            const gridRegular_t        grid,
-                            const gridPatch_t          patch,
-                            int                        idxOfVar,
-                            int                        numPatches,
-                            uint64_t                   norm);
+local_addData(gridStatistics_t stat,
+              const void       *data,
+              dataVarType_t    type,
+              uint64_t         len);
 
 static void
-local_calcRegularVarSkewKurt(gridStatistics_t           stat,
-                             const gridRegularDistrib_t distrib,
-                             const gridRegular_t        grid,
-                             const gridPatch_t          patch,
-                             int                        idxOfVar,
-                             int                        numPatches,
-                             uint64_t                   norm);
+local_addBlock(gridStatistics_t stat, const double *values, int num);
 
 static void
-local_calcProtoMeanMinMax(void      *data,
-                          dataVar_t var,
-                          uint64_t  len,
-                          double    *protoMean,
-                          double    *min,
-                          double    *max);
+local_addBlockNonFinite(gridStatistics_t stat,
+                        const double     *values,
+                        int              num);
 
+static void
+local_mergeStat(gridStatistics_t stat, const gridStatistics_t other);
 
 static void
-local_calcProtoVarSkewKurt(void         *data,
-                           dataVar_t    var,
-                           uint64_t     len,
-                           double       *variance,
-                           double       *skew,
-                           double       *kurt,
-                           const double mean);
+local_finalizeStat(gridStatistics_t stat);
 
 
 #ifdef WITH_MPI
 static void
-local_mpiCalcProtoMeanMinMax(MPI_Comm comm,
-                             double   *mean,
-                             double   *min,
-                             double   *max);
+local_mpiReduceStat(gridStatistics_t stat, MPI_Comm comm);
 
 static void
-local_mpiCalcProtoVarSkewKurt(MPI_Comm comm,
-                              double   *var,
-                              double   *skew,
-                              double   *kurt);
+local_mpiMergeFunc(void         *in,
+                   void         *inout,
+                   int          *len,
+                   MPI_Datatype *type);
+
+static void
+local_packStat(const gridStatistics_t stat, double *moments);
+
+static void
+local_unpackStat(gridStatistics_t stat, const double *moments);
 
 #endif
 
@@ -167,6 +170,58 @@ gridStatistics_calcGridRegularDistrib(gridStatistics_t     stat,
 	stat->valid = true;
 }
 
+extern void
+gridStatistics_reset(gridStatistics_t stat)
+{
+	assert(stat != NULL);
+
+	local_nullStat(stat);
+}
+
+extern void
+gridStatistics_addValues(gridStatistics_t stat,
+                         const double     *values,
+                         uint64_t         num)
+{
+	assert(stat != NULL);
+	assert(values != NULL || num == UINT64_C(0));
+
+	for (uint64_t i = 0; i < num; i += LOCAL_BLOCKSIZE) {
+		int numInBlock = (num - i < LOCAL_BLOCKSIZE)
+		                 ? (int)(num - i) : LOCAL_BLOCKSIZE;
+		local_addBlock(stat, values + i, numInBlock);
+	}
+}
+
+extern void
+gridStatistics_merge(gridStatistics_t stat, const gridStatistics_t other)
+{
+	assert(stat != NULL);
+	assert(other != NULL);
+
+	local_mergeStat(stat, other);
+}
+
+#ifdef WITH_MPI
+extern void
+gridStatistics_reduce(gridStatistics_t stat, MPI_Comm comm)
+{
+	assert(stat != NULL);
+
+	local_mpiReduceStat(stat, comm);
+}
+
+#endif
+
+extern void
+gridStatistics_finalize(gridStatistics_t stat)
+{
+	assert(stat != NULL);
+
+	local_finalizeStat(stat);
+	stat->valid = true;
+}
+
 extern void
 gridStatistics_invalidate(gridStatistics_t stat)
 {
@@ -239,6 +294,22 @@ gridStatistics_getMax(const gridStatistics_t stat)
 	return stat->max;
 }
 
+extern uint64_t
+gridStatistics_getNumNaN(const gridStatistics_t stat)
+{
+	assert(stat != NULL);
+
+	return stat->numNaN;
+}
+
+extern uint64_t
+gridStatistics_getNumInf(const gridStatistics_t stat)
+{
+	assert(stat != NULL);
+
+	return stat->numInf;
+}
+
 extern void
 gridStatistics_printPretty(const gridStatistics_t stat,
                            FILE                   *out,
@@ -257,6 +328,12 @@ gridStatistics_printPretty(const gridStatistics_t stat,
 		        gridStatistics_getMin(stat));
 		fprintf(out, "%s             maximum  :  %15e\n", prefix,
 		        gridStatistics_getMax(stat));
+		if (stat->numNaN + stat->numInf > UINT64_C(0)) {
+			fprintf(out, "%s      number of NaNs  :  %15" PRIu64 "\n",
+			        prefix, stat->numNaN);
+			fprintf(out, "%s      number of Infs  :  %15" PRIu64 "\n",
+			        prefix, stat->numInf);
+		}
 	} else {
 		fprintf(out, "                mean  :  %15e\n",
 		        gridStatistics_getMean(stat));
@@ -270,6 +347,12 @@ gridStatistics_printPretty(const gridStatistics_t stat,
 		        gridStatistics_getMin(stat));
 		fprintf(out, "             maximum  :  %15e\n",
 		        gridStatistics_getMax(stat));
+		if (stat->numNaN + stat->numInf > UINT64_C(0)) {
+			fprintf(out, "      number of NaNs  :  %15" PRIu64 "\n",
+			        stat->numNaN);
+			fprintf(out, "      number of Infs  :  %15" PRIu64 "\n",
+			        stat->numInf);
+		}
 	}
 }
 
@@ -277,13 +360,19 @@ gridStatistics_printPretty(const gridStatistics_t stat,
 static void
 local_nullStat(gridStatistics_t stat)
 {
-	stat->valid = false;
-	stat->mean  = 0.0;
-	stat->var   = 0.0;
-	stat->skew  = 0.0;
-	stat->kurt  = 0.0;
-	stat->min   = 1e50;
-	stat->max   = -1e50;
+	stat->valid  = false;
+	stat->mean   = 0.0;
+	stat->var    = 0.0;
+	stat->skew   = 0.0;
+	stat->kurt   = 0.0;
+	stat->min    = 1e50;
+	stat->max    = -1e50;
+	stat->num    = UINT64_C(0);
+	stat->m2     = 0.0;
+	stat->m3     = 0.0;
+	stat->m4     = 0.0;
+	stat->numNaN = UINT64_C(0);
+	stat->numInf = UINT64_C(0);
 }
 
 static void
@@ -293,40 +382,14 @@ local_calcRegularCore(gridStatistics_t           stat,
                       const gridPatch_t          patch,
                       int                        idxOfVar)
 {
-	uint64_t norm       = 2;
-	int      numPatches = 1;
+	int numPatches = 1;
 
-	if (grid != NULL) {
+	if (grid != NULL)
 		numPatches = gridRegular_getNumPatches(grid);
-		norm       = gridRegular_getNumCellsTotal(grid);
-	} else if (patch != NULL) {
-		norm = gridPatch_getNumCells(patch);
-	}
-
-	local_calcRegularMeanMinMax(stat, distrib, grid, patch,
-	                            idxOfVar, numPatches, norm);
-	local_calcRegularVarSkewKurt(stat, distrib, grid, patch,
-	                             idxOfVar, numPatches, norm);
-}
-
-static void
-local_calcRegularMeanMinMax(gridStatistics_t           stat,
-                            const gridRegularDistrib_t distrib,
-                            const gridRegular_t        grid,
-                            const gridPatch_t          patch,
-                            int                        idxOfVar,
-                            int                        numPatches,
-                            uint64_t                   norm)
-{
-	gridPatch_t myPatch;
-	dataVar_t   dataVar;
-	void        *data;
-	uint64_t    len;
-	double      min, max;
 
 	for (int i = 0; i < numPatches; i++) {
-		min = 1e50;
-		max = -1e50;
+		gridPatch_t myPatch;
+		dataVar_t   dataVar;
 
 		if (grid != NULL)
 			myPatch = gridRegular_getPatchHandle(grid, i);
@@ -334,189 +397,248 @@ local_calcRegularMeanMinMax(gridStatistics_t           stat,
 			myPatch = patch;
 
 		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
-		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
-
-		local_calcProtoMeanMinMax(data, dataVar, len, &(stat->mean),
-		                          &min, &max);
-		stat->min = (stat->min > min) ? min : stat->min;
-		stat->max = (stat->max < max) ? max : stat->max;
+		local_addData(stat,
+		              gridPatch_getVarDataHandle(myPatch, idxOfVar),
+		              dataVar_getType(dataVar),
+		              gridPatch_getNumCells(myPatch));
 	}
 
 	if (distrib != NULL) {
 #ifdef WITH_MPI
 		MPI_Comm thisComm = gridRegularDistrib_getGlobalComm(distrib);
-		local_mpiCalcProtoMeanMinMax(thisComm, &(stat->mean),
-		                             &(stat->min), &(stat->max));
+		local_mpiReduceStat(stat, thisComm);
 #endif
 	}
 
-	stat->mean /= norm;
-} /* local_calcRegularMeanMinMax */
+	local_finalizeStat(stat);
+}
 
 static void
-local_calcRegularVarSkewKurt(gridStatistics_t           stat,
-                             const gridRegularDistrib_t distrib,
-                             const gridRegular_t        grid,
-                             const gridPatch_t          patch,
-                             int                        idxOfVar,
-                             int                        numPatches,
-                             uint64_t                   norm)
-{
-	gridPatch_t myPatch;
-	dataVar_t   dataVar;
-	void        *data;
-	uint64_t    len;
+local_addData(gridStatistics_t stat,
+              const void       *data,
+              dataVarType_t    type,
+              uint64_t         len)
+{
+	uint64_t numBlocks = (len + LOCAL_BLOCKSIZE - 1) / LOCAL_BLOCKSIZE;
 
-	for (int i = 0; i < numPatches; i++) {
-		if (grid != NULL)
-			myPatch = gridRegular_getPatchHandle(grid, i);
-		else
-			myPatch = patch;
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(stat, data, type, len, numBlocks)
+#endif
+	{
+		struct gridStatistics_struct myStat;
+		double                       values[LOCAL_BLOCKSIZE];
 
-		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
-		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
+		local_nullStat(&myStat);
 
-		local_calcProtoVarSkewKurt(data, dataVar, len, &(stat->var),
-		                           &(stat->skew), &(stat->kurt),
-		                           stat->mean);
-	}
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(static)
+#endif
+		for (uint64_t b = 0; b < numBlocks; b++) {
+			uint64_t offset = b * LOCAL_BLOCKSIZE;
+			int      num    = (len - offset < LOCAL_BLOCKSIZE)
+			                  ? (int)(len - offset) : LOCAL_BLOCKSIZE;
 
-	if (distrib != NULL) {
-#ifdef WITH_MPI
-		MPI_Comm thisComm = gridRegularDistrib_getGlobalComm(distrib);
-		local_mpiCalcProtoVarSkewKurt(thisComm, &(stat->var),
-		                              &(stat->skew), &(stat->kurt));
+			gridUtil_convertToDouble(data, type, offset, num, values);
+			local_addBlock(&myStat, values, num);
+		}
+
+#ifdef WITH_OPENMP
+#  pragma omp critical
 #endif
+		local_mergeStat(stat, &myStat);
+	}
+}
+
+static void
+local_addBlock(gridStatistics_t stat, const double *values, int num)
+{
+	struct gridStatistics_struct block;
+	double                       sum = 0.0;
+	double                       min = stat->min;
+	double                       max = stat->max;
+
+	for (int i = 0; i < num; i++) {
+		sum += values[i];
+		min  = (values[i] < min) ? values[i] : min;
+		max  = (values[i] > max) ? values[i] : max;
+	}
+
+	// NaNs and infinities propagate into the sum, hence only then the
+	// block needs to be looked at value by value.
+	if (!isfinite(sum)) {
+		local_addBlockNonFinite(stat, values, num);
+		return;
 	}
 
-	stat->var  /= (norm - 1);
-	stat->skew /= (norm * stat->var * sqrt(stat->var));
-	stat->kurt  = stat->kurt / (norm * POW2(stat->var)) - 3;
+	local_nullStat(&block);
+	block.num  = (uint64_t)num;
+	block.mean = sum / num;
+	block.min  = min;
+	block.max  = max;
+	for (int i = 0; i < num; i++) {
+		double dev    = values[i] - block.mean;
+		double devSqr = POW2(dev);
+		block.m2 += devSqr;
+		block.m3 += devSqr * dev;
+		block.m4 += POW2(devSqr);
+	}
+
+	local_mergeStat(stat, &block);
 }
 
 static void
-local_calcProtoMeanMinMax(void      *data,
-                          dataVar_t var,
-                          uint64_t  len,
-                          double    *protoMean,
-                          double    *min,
-                          double    *max)
-{
-	union { double *lf;
-		    int    *i;
-		    int8_t *i8;
-		    fpv_t  *fpv;
-		    void   *v;
-	}             tmp;
-	dataVarType_t type = dataVar_getType(var);
-
-	for (uint64_t i = 0; i < len; i++) {
-		tmp.v = dataVar_getPointerByOffset(var, data, i);
-		switch (type) {
-		case DATAVARTYPE_INT:
-			*min        = (*(tmp.i) < *min) ? (double)*(tmp.i) : *min;
-			*max        = (*(tmp.i) > *max) ? (double)*(tmp.i) : *max;
-			*protoMean += (double)*(tmp.i);
-			break;
-		case DATAVARTYPE_INT8:
-			*min        = (*(tmp.i8) < *min) ? (double)*(tmp.i8) : *min;
-			*max        = (*(tmp.i8) > *max) ? (double)*(tmp.i8) : *max;
-			*protoMean += (double)*(tmp.i);
-			break;
-		case DATAVARTYPE_DOUBLE:
-			*min        = (*(tmp.lf) < *min) ? *(tmp.lf) : *min;
-			*max        = (*(tmp.lf) > *max) ? *(tmp.lf) : *max;
-			*protoMean += *(tmp.lf);
-			break;
-		case DATAVARTYPE_FPV:
-			*min        = (*(tmp.fpv) < *min) ? (double)*(tmp.fpv) : *min;
-			*max        = (*(tmp.fpv) > *max) ? (double)*(tmp.fpv) : *max;
-			*protoMean += (double)*(tmp.fpv);
-			break;
-		default:
-			diediedie(999);
-		}
+local_addBlockNonFinite(gridStatistics_t stat,
+                        const double     *values,
+                        int              num)
+{
+	double finite[num];
+	int    numFinite = 0;
+
+	for (int i = 0; i < num; i++) {
+		if (isfinite(values[i]))
+			finite[numFinite++] = values[i];
+		else if (isnan(values[i]))
+			stat->numNaN++;
+		else
+			stat->numInf++;
+	}
+
+	// If all values are finite, their sum overflowed and the block is
+	// split until the partial sums are representable.
+	if (numFinite == num) {
+		local_addBlock(stat, values, num / 2);
+		local_addBlock(stat, values + num / 2, num - num / 2);
+	} else if (numFinite > 0) {
+		local_addBlock(stat, finite, numFinite);
 	}
 }
 
 static void
-local_calcProtoVarSkewKurt(void         *data,
-                           dataVar_t    var,
-                           uint64_t     len,
-                           double       *variance,
-                           double       *skew,
-                           double       *kurt,
-                           const double mean)
-{
-	union { double *lf;
-		    int    *i;
-		    int    *i8;
-		    fpv_t  *fpv;
-		    void   *v;
-	}             tmp;
-	double        tmpNo, tmpSqr;
-	dataVarType_t type = dataVar_getType(var);
-
-	for (uint64_t i = 0; i < len; i++) {
-		tmp.v = dataVar_getPointerByOffset(var, data, i);
-		switch (type) {
-		case DATAVARTYPE_INT:
-			tmpNo = (double)*(tmp.i) - mean;
-			break;
-		case DATAVARTYPE_INT8:
-			tmpNo = (double)*(tmp.i8) - mean;
-			break;
-		case DATAVARTYPE_DOUBLE:
-			tmpNo = *(tmp.lf) - mean;
-			break;
-		case DATAVARTYPE_FPV:
-			tmpNo = (double)*(tmp.fpv) - mean;
-			break;
-		default:
-			diediedie(999);
-		}
-		tmpSqr     = POW2(tmpNo);
-		*variance += tmpSqr;
-		*skew     += tmpSqr * tmpNo;
-		*kurt     += POW2(tmpSqr);
+local_mergeStat(gridStatistics_t stat, const gridStatistics_t other)
+{
+	double nA, nB, n, delta, deltaN, m2, m3, m4;
+
+	stat->numNaN += other->numNaN;
+	stat->numInf += other->numInf;
+
+	if (other->num == UINT64_C(0))
+		return;
+
+	stat->min = (other->min < stat->min) ? other->min : stat->min;
+	stat->max = (other->max > stat->max) ? other->max : stat->max;
+
+	if (stat->num == UINT64_C(0)) {
+		stat->num  = other->num;
+		stat->mean = other->mean;
+		stat->m2   = other->m2;
+		stat->m3   = other->m3;
+		stat->m4   = other->m4;
+		return;
 	}
+
+	// Pairwise update of the central moments, see Chan, Golub & LeVeque
+	// (1979) and Pebay (2008), with A being stat and B being other.
+	nA     = (double)(stat->num);
+	nB     = (double)(other->num);
+	n      = nA + nB;
+	delta  = other->mean - stat->mean;
+	deltaN = delta / n;
+
+	m2 = stat->m2 + other->m2 + POW2(delta) * nA * nB / n;
+	m3 = stat->m3 + other->m3
+	     + POW3(delta) * nA * nB * (nA - nB) / POW2(n)
+	     + 3.0 * deltaN * (nA * other->m2 - nB * stat->m2);
+	m4 = stat->m4 + other->m4
+	     + POW4(delta) * nA * nB * (POW2(nA) - nA * nB + POW2(nB))
+	     / POW3(n)
+	     + 6.0 * POW2(deltaN) * (POW2(nA) * other->m2 + POW2(nB) * stat->m2)
+	     + 4.0 * deltaN * (nA * other->m3 - nB * stat->m3);
+
+	stat->num  += other->num;
+	stat->mean += deltaN * nB;
+	stat->m2    = m2;
+	stat->m3    = m3;
+	stat->m4    = m4;
+} /* local_mergeStat */
+
+static void
+local_finalizeStat(gridStatistics_t stat)
+{
+	double norm = (double)(stat->num);
+
+	stat->var  = stat->m2 / (norm - 1);
+	stat->skew = stat->m3 / (norm * stat->var * sqrt(stat->var));
+	stat->kurt = stat->m4 / (norm * POW2(stat->var)) - 3;
 }
 
 #ifdef WITH_MPI
 static void
-local_mpiCalcProtoMeanMinMax(MPI_Comm comm,
-                             double   *mean,
-                             double   *min,
-                             double   *max)
+local_mpiReduceStat(gridStatistics_t stat, MPI_Comm comm)
 {
-	double myMean = *mean;
-	double myMin  = *min;
-	double myMax  = *max;
+	double       momentsIn[LOCAL_NUMMOMENTS];
+	double       momentsOut[LOCAL_NUMMOMENTS];
+	MPI_Datatype momentsType;
+	MPI_Op       mergeOp;
+
+	MPI_Type_contiguous(LOCAL_NUMMOMENTS, MPI_DOUBLE, &momentsType);
+	MPI_Type_commit(&momentsType);
+	MPI_Op_create(&local_mpiMergeFunc, 1, &mergeOp);
 
-	MPI_Allreduce(&myMean, mean, 1, MPI_DOUBLE, MPI_SUM, comm);
-	MPI_Allreduce(&myMin, min, 1, MPI_DOUBLE, MPI_MIN, comm);
-	MPI_Allreduce(&myMax, max, 1, MPI_DOUBLE, MPI_MAX, comm);
+	local_packStat(stat, momentsIn);
+	MPI_Allreduce(momentsIn, momentsOut, 1, momentsType, mergeOp, comm);
+	local_unpackStat(stat, momentsOut);
+
+	MPI_Op_free(&mergeOp);
+	MPI_Type_free(&momentsType);
 }
 
 static void
-local_mpiCalcProtoVarSkewKurt(MPI_Comm comm,
-                              double   *var,
-                              double   *skew,
-                              double   *kurt)
+local_mpiMergeFunc(void         *in,
+                   void         *inout,
+                   int          *len,
+                   MPI_Datatype *type)
 {
-	double tmpIn[3], tmpOut[3];
+	double *momentsIn    = (double *)in;
+	double *momentsInout = (double *)inout;
+
+	for (int i = 0; i < *len; i++) {
+		struct gridStatistics_struct statIn, statInout;
 
-	tmpIn[0] = *var;
-	tmpIn[1] = *skew;
-	tmpIn[2] = *kurt;
+		local_unpackStat(&statIn, momentsIn + i * LOCAL_NUMMOMENTS);
+		local_unpackStat(&statInout, momentsInout + i * LOCAL_NUMMOMENTS);
+		local_mergeStat(&statInout, &statIn);
+		local_packStat(&statInout, momentsInout + i * LOCAL_NUMMOMENTS);
+	}
+}
 
-	MPI_Allreduce(tmpIn, tmpOut, 3, MPI_DOUBLE, MPI_SUM, comm);
+static void
+local_packStat(const gridStatistics_t stat, double *moments)
+{
+	// The count is exactly representable up to 2^53 cells.
+	moments[0] = (double)(stat->num);
+	moments[1] = stat->mean;
+	moments[2] = stat->m2;
+	moments[3] = stat->m3;
+	moments[4] = stat->m4;
+	moments[5] = stat->min;
+	moments[6] = stat->max;
+	moments[7] = (double)(stat->numNaN);
+	moments[8] = (double)(stat->numInf);
+}
 
-	*var  = tmpOut[0];
-	*skew = tmpOut[1];
-	*kurt = tmpOut[2];
+static void
+local_unpackStat(gridStatistics_t stat, const double *moments)
+{
+	local_nullStat(stat);
+	stat->num    = (uint64_t)(moments[0]);
+	stat->mean   = moments[1];
+	stat->m2     = moments[2];
+	stat->m3     = moments[3];
+	stat->m4     = moments[4];
+	stat->min    = moments[5];
+	stat->max    = moments[6];
+	stat->numNaN = (uint64_t)(moments[7]);
+	stat->numInf = (uint64_t)(moments[8]);
 }
 
 #endif
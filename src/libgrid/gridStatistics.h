@@ -23,6 +23,9 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -53,6 +56,26 @@ gridStatistics_calcGridRegularDistrib(gridStatistics_t     stat,
                                       gridRegularDistrib_t distrib,
                                       int                  idxOfVar);
 
+extern void
+gridStatistics_reset(gridStatistics_t stat);
+
+extern void
+gridStatistics_addValues(gridStatistics_t stat,
+                         const double     *values,
+                         uint64_t         num);
+
+extern void
+gridStatistics_merge(gridStatistics_t stat, const gridStatistics_t other);
+
+#ifdef WITH_MPI
+extern void
+gridStatistics_reduce(gridStatistics_t stat, MPI_Comm comm);
+
+#endif
+
+extern void
+gridStatistics_finalize(gridStatistics_t stat);
+
 extern void
 gridStatistics_invalidate(gridStatistics_t stat);
 
@@ -80,6 +103,12 @@ gridStatistics_getMin(const gridStatistics_t stat);
 extern double
 gridStatistics_getMax(const gridStatistics_t stat);
 
+extern uint64_t
+gridStatistics_getNumNaN(const gridStatistics_t stat);
+
+extern uint64_t
+gridStatistics_getNumInf(const gridStatistics_t stat);
+
 extern void
 gridStatistics_printPretty(const gridStatistics_t stat,
                            FILE *out,
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -25,19 +26,31 @@
 /** @brief  The main structure for the grid statistics. */
 struct gridStatistics_struct {
 	/** @brief  Flags if the statistics is valid or not. */
-	bool   valid;
+	bool     valid;
 	/** @brief  The mean of the data. */
-	double mean;
+	double   mean;
 	/** @brief  The variance of the data. */
-	double var;
+	double   var;
 	/** @brief  The skewness of the data. */
-	double skew;
+	double   skew;
 	/** @brief  The kurtosis of the data. */
-	double kurt;
+	double   kurt;
 	/** @brief  The minimum value in the data. */
-	double min;
+	double   min;
 	/** @brief  The maximum value in the data. */
-	double max;
+	double   max;
+	/** @brief  The number of values that entered the statistics. */
+	uint64_t num;
+	/** @brief  The sum of the squared deviations from the mean. */
+	double   m2;
+	/** @brief  The sum of the cubed deviations from the mean. */
+	double   m3;
+	/** @brief  The sum of the fourth powers of the deviations. */
+	double   m4;
+	/** @brief  The number of NaNs, these are not part of the moments. */
+	uint64_t numNaN;
+	/** @brief  The number of infinities, these are not part of the moments. */
+	uint64_t numInf;
 };
 
 
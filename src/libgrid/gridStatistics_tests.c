@@ -226,6 +226,57 @@ gridStatistics_calcGridRegularDistrib_test(void)
 	return hasPassed ? true : false;
 } /* gridStatistics_calcGridRegular_test */
 
+extern bool
+gridStatistics_addValues_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridStatistics_t gridStatistics;
+	double           values[3000];
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < 3000; i++)
+		values[i] = (i % 2 == 0) ? -1.0 : 1.0;
+	values[17]   = NAN;
+	values[18]   = NAN;
+	values[2500] = INFINITY;
+	values[2501] = -INFINITY;
+	values[2502] = INFINITY;
+
+	gridStatistics = gridStatistics_new();
+	gridStatistics_addValues(gridStatistics, values, 1000);
+	gridStatistics_addValues(gridStatistics, values + 1000, 2000);
+	gridStatistics_finalize(gridStatistics);
+
+	if (gridStatistics_getNumNaN(gridStatistics) != 2)
+		hasPassed = false;
+	if (gridStatistics_getNumInf(gridStatistics) != 3)
+		hasPassed = false;
+	if (gridStatistics->num != 2995)
+		hasPassed = false;
+	if (islessgreater(gridStatistics_getMin(gridStatistics), -1.0)
+	    || islessgreater(gridStatistics_getMax(gridStatistics), 1.0))
+		hasPassed = false;
+	if (fabs(gridStatistics_getMean(gridStatistics) - 1. / 2995.) > 1e-12)
+		hasPassed = false;
+
+	gridStatistics_del(&gridStatistics);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridStatistics_addValues_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridPatch_t
 local_getFakePatch(void)
@@ -36,6 +36,9 @@ gridStatistics_calcGridRegular_test(void);
 extern bool
 gridStatistics_calcGridRegularDistrib_test(void);
 
+extern bool
+gridStatistics_addValues_test(void);
+
 extern bool
 gridStatistics_invalidate_test(void);
 
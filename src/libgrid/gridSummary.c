@@ -0,0 +1,216 @@
+// Copyright (C) 2010, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridSummary.c
+ * @ingroup libgridAnalysisSummary
+ * @brief  This file provides the implementation of the combined statistics
+ *         and histogram calculation.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridSummary.h"
+#include <assert.h>
+#include <stdint.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libdata/dataVar.h"
+#include "../libdata/dataVarType.h"
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridRegularDistrib.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "gridUtil.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/**
+ * @brief  Gives the number of cells that are converted in one go and then
+ *         handed to the statistics and the histogram while still in cache.
+ */
+#define LOCAL_BLOCKSIZE 1024
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static void
+local_calcRegularCore(gridStatistics_t           stat,
+                      gridHistogram_t            histo,
+                      const gridRegularDistrib_t distrib,
+                      const gridRegular_t        grid,
+                      const gridPatch_t          patch,
+                      int                        idxOfVar);
+
+static void
+local_addData(gridStatistics_t stat,
+              gridHistogram_t  histo,
+              const void       *data,
+              dataVarType_t    type,
+              uint64_t         len);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern void
+gridSummary_calcGridPatch(gridStatistics_t  stat,
+                          gridHistogram_t   histo,
+                          const gridPatch_t patch,
+                          int               idxOfVar)
+{
+	assert(stat != NULL || histo != NULL);
+	assert(patch != NULL);
+
+	local_calcRegularCore(stat, histo, NULL, NULL, patch, idxOfVar);
+}
+
+extern void
+gridSummary_calcGridRegular(gridStatistics_t    stat,
+                            gridHistogram_t     histo,
+                            const gridRegular_t grid,
+                            int                 idxOfVar)
+{
+	assert(stat != NULL || histo != NULL);
+	assert(grid != NULL);
+
+	local_calcRegularCore(stat, histo, NULL, grid, NULL, idxOfVar);
+}
+
+extern void
+gridSummary_calcGridRegularDistrib(gridStatistics_t           stat,
+                                   gridHistogram_t            histo,
+                                   const gridRegularDistrib_t distrib,
+                                   int                        idxOfVar)
+{
+	assert(stat != NULL || histo != NULL);
+	assert(distrib != NULL);
+
+	local_calcRegularCore(stat, histo, distrib,
+	                      gridRegularDistrib_getGridHandle(distrib),
+	                      NULL, idxOfVar);
+}
+
+extern void
+gridSummary_addGridPatch(gridStatistics_t  stat,
+                         gridHistogram_t   histo,
+                         const gridPatch_t patch,
+                         int               idxOfVar)
+{
+	dataVar_t dataVar;
+
+	assert(stat != NULL || histo != NULL);
+	assert(patch != NULL);
+
+	dataVar = gridPatch_getVarHandle(patch, idxOfVar);
+	local_addData(stat, histo,
+	              gridPatch_getVarDataHandle(patch, idxOfVar),
+	              dataVar_getType(dataVar),
+	              gridPatch_getNumCells(patch)
+	              * dataVar_getNumComponents(dataVar));
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_calcRegularCore(gridStatistics_t           stat,
+                      gridHistogram_t            histo,
+                      const gridRegularDistrib_t distrib,
+                      const gridRegular_t        grid,
+                      const gridPatch_t          patch,
+                      int                        idxOfVar)
+{
+	int numPatches = 1;
+
+	if (stat != NULL)
+		gridStatistics_reset(stat);
+	if (histo != NULL)
+		gridHistogram_reset(histo);
+
+	if (grid != NULL)
+		numPatches = gridRegular_getNumPatches(grid);
+
+	for (int i = 0; i < numPatches; i++) {
+		gridPatch_t myPatch;
+
+		if (grid != NULL)
+			myPatch = gridRegular_getPatchHandle(grid, i);
+		else
+			myPatch = patch;
+
+		gridSummary_addGridPatch(stat, histo, myPatch, idxOfVar);
+	}
+
+	if (distrib != NULL) {
+#ifdef WITH_MPI
+		MPI_Comm thisComm = gridRegularDistrib_getGlobalComm(distrib);
+		if (stat != NULL)
+			gridStatistics_reduce(stat, thisComm);
+		if (histo != NULL)
+			gridHistogram_reduce(histo, thisComm);
+#endif
+	}
+
+	if (stat != NULL)
+		gridStatistics_finalize(stat);
+} /* local_calcRegularCore */
+
+static void
+local_addData(gridStatistics_t stat,
+              gridHistogram_t  histo,
+              const void       *data,
+              dataVarType_t    type,
+              uint64_t         len)
+{
+	uint64_t numBlocks = (len + LOCAL_BLOCKSIZE - 1) / LOCAL_BLOCKSIZE;
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel shared(stat, histo, data, type, len, numBlocks)
+#endif
+	{
+		gridStatistics_t myStat  = NULL;
+		gridHistogram_t  myHisto = NULL;
+		double           values[LOCAL_BLOCKSIZE];
+
+		if (stat != NULL)
+			myStat = gridStatistics_new();
+		if (histo != NULL) {
+			myHisto = gridHistogram_clone(histo);
+			gridHistogram_reset(myHisto);
+		}
+
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(static)
+#endif
+		for (uint64_t b = 0; b < numBlocks; b++) {
+			uint64_t offset = b * LOCAL_BLOCKSIZE;
+			int      num    = (len - offset < LOCAL_BLOCKSIZE)
+			                  ? (int)(len - offset) : LOCAL_BLOCKSIZE;
+
+			gridUtil_convertToDouble(data, type, offset, num, values);
+			if (myStat != NULL)
+				gridStatistics_addValues(myStat, values, (uint64_t)num);
+			if (myHisto != NULL)
+				gridHistogram_addValues(myHisto, values, (uint64_t)num);
+		}
+
+#ifdef WITH_OPENMP
+#  pragma omp critical
+#endif
+		{
+			if (myStat != NULL)
+				gridStatistics_merge(stat, myStat);
+			if (myHisto != NULL)
+				gridHistogram_merge(histo, myHisto);
+		}
+
+		if (myStat != NULL)
+			gridStatistics_del(&myStat);
+		if (myHisto != NULL)
+			gridHistogram_del(&myHisto);
+	}
+} /* local_addData */
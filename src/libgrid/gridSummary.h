@@ -0,0 +1,73 @@
+// Copyright (C) 2010, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDSUMMARY_H
+#define GRIDSUMMARY_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridSummary.h
+ * @ingroup libgridAnalysisSummary
+ * @brief  This file provides the interface to the combined statistics and
+ *         histogram calculation for grids.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridRegularDistrib.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern void
+gridSummary_calcGridPatch(gridStatistics_t  stat,
+                          gridHistogram_t   histo,
+                          const gridPatch_t patch,
+                          int               idxOfVar);
+
+extern void
+gridSummary_calcGridRegular(gridStatistics_t    stat,
+                            gridHistogram_t     histo,
+                            const gridRegular_t grid,
+                            int                 idxOfVar);
+
+extern void
+gridSummary_calcGridRegularDistrib(gridStatistics_t           stat,
+                                   gridHistogram_t            histo,
+                                   const gridRegularDistrib_t distrib,
+                                   int                        idxOfVar);
+
+extern void
+gridSummary_addGridPatch(gridStatistics_t  stat,
+                         gridHistogram_t   histo,
+                         const gridPatch_t patch,
+                         int               idxOfVar);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libgridAnalysisSummary Summary
+ * @ingroup libgridAnalysis
+ * @brief This provides the statistics and the histogram of a grid variable
+ *        from a single sweep over the data.
+ *
+ * Either the statistics or the histogram may be passed as @c NULL, in
+ * which case only the other one is calculated.  All components of a
+ * variable enter the summary.
+ *
+ * gridSummary_addGridPatch() only accumulates into the statistics and the
+ * histogram without resetting them first, this allows to build up the
+ * summary piece by piece while data passes through, the statistics then
+ * need to be completed with gridStatistics_finalize().
+ */
+
+
+#endif
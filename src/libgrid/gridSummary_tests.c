@@ -0,0 +1,265 @@
+// Copyright (C) 2010, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridSummary_tests.c
+ * @ingroup libgridAnalysisSummary
+ * @brief  This file provides the implementations of the tests for the
+ *         grid summary.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridSummary_tests.h"
+#include "gridSummary.h"
+#include <stdio.h>
+#include <math.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridRegularDistrib.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "../libutil/rng.h"
+#ifdef XMEM_TRACK_MEM
+#  include "../libutil/xmem.h"
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_FAKE_MEAN     1.0
+#define LOCAL_FAKE_VARIANCE 4.0
+#define LOCAL_NUMBINS       32
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static gridPatch_t
+local_getFakePatch(void);
+
+static gridRegularDistrib_t
+local_getFakeDistrib(void);
+
+static bool
+local_compare(const gridStatistics_t statA,
+              const gridHistogram_t  histoA,
+              const gridStatistics_t statB,
+              const gridHistogram_t  histoB);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+gridSummary_calcGridPatch_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridStatistics_t stat, statRef;
+	gridHistogram_t  histo, histoRef;
+	gridPatch_t      patch;
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	stat     = gridStatistics_new();
+	statRef  = gridStatistics_new();
+	histo    = gridHistogram_new(LOCAL_NUMBINS, -5., 7.);
+	histoRef = gridHistogram_new(LOCAL_NUMBINS, -5., 7.);
+	patch    = local_getFakePatch();
+
+	gridSummary_calcGridPatch(stat, histo, patch, 0);
+	gridStatistics_calcGridPatch(statRef, patch, 0);
+	gridHistogram_calcGridPatch(histoRef, patch, 0);
+	if (!local_compare(stat, histo, statRef, histoRef))
+		hasPassed = false;
+
+	gridSummary_calcGridPatch(NULL, histo, patch, 0);
+	gridSummary_calcGridPatch(stat, NULL, patch, 0);
+	if (!local_compare(stat, histo, statRef, histoRef))
+		hasPassed = false;
+
+	gridPatch_del(&patch);
+	gridHistogram_del(&histoRef);
+	gridHistogram_del(&histo);
+	gridStatistics_del(&statRef);
+	gridStatistics_del(&stat);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridSummary_calcGridPatch_test */
+
+extern bool
+gridSummary_calcGridRegularDistrib_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridStatistics_t     stat, statRef;
+	gridHistogram_t      histo, histoRef;
+	gridRegularDistrib_t distrib;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	stat     = gridStatistics_new();
+	statRef  = gridStatistics_new();
+	histo    = gridHistogram_new(LOCAL_NUMBINS, -5., 7.);
+	histoRef = gridHistogram_new(LOCAL_NUMBINS, -5., 7.);
+	distrib  = local_getFakeDistrib();
+
+	gridSummary_calcGridRegularDistrib(stat, histo, distrib, 0);
+	gridStatistics_calcGridRegularDistrib(statRef, distrib, 0);
+	gridHistogram_calcGridRegularDistrib(histoRef, distrib, 0);
+	if (!local_compare(stat, histo, statRef, histoRef))
+		hasPassed = false;
+	if (fabs(gridStatistics_getMean(stat) - LOCAL_FAKE_MEAN) > 0.05)
+		hasPassed = false;
+	if (fabs(gridStatistics_getVariance(stat) - LOCAL_FAKE_VARIANCE) > 0.10)
+		hasPassed = false;
+
+	gridRegularDistrib_del(&distrib);
+	gridHistogram_del(&histoRef);
+	gridHistogram_del(&histo);
+	gridStatistics_del(&statRef);
+	gridStatistics_del(&stat);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridSummary_calcGridRegularDistrib_test */
+
+/*--- Implementations of local functions --------------------------------*/
+static gridPatch_t
+local_getFakePatch(void)
+{
+	gridPatch_t       patch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo;
+	gridPointUint32_t idxHi;
+	double            *data;
+	uint64_t          num;
+	rng_t             rng;
+	int               size = 1;
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+	var      = dataVar_new("TEST", DATAVARTYPE_DOUBLE, 1);
+	idxLo[0] = 0;
+	idxHi[0] = 15;
+	idxLo[1] = 0;
+	idxHi[1] = 63;
+#if (NDIM > 2)
+	idxLo[2] = 0;
+	idxHi[2] = 63;
+#endif
+	patch    = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(patch, var);
+
+	data = gridPatch_getVarDataHandle(patch, 0);
+	rng  = rng_new(3, size, 45452);
+	num  = gridPatch_getNumCells(patch);
+	for (uint64_t i = 0; i < num; i++) {
+		data[i] = rng_getGauss(rng, 0, LOCAL_FAKE_MEAN,
+		                       sqrt(LOCAL_FAKE_VARIANCE));
+	}
+	dataVar_del(&var);
+	rng_del(&rng);
+
+	return patch;
+} /* local_getFakePatch */
+
+static gridRegularDistrib_t
+local_getFakeDistrib(void)
+{
+	gridRegularDistrib_t distrib;
+	gridRegular_t        grid;
+	gridPatch_t          patch;
+	dataVar_t            var;
+	gridPointDbl_t       origin = {0., 0., 0.};
+	gridPointDbl_t       extent = {1., 1., 1.};
+	gridPointUint32_t    dims   = {64, 64, 64};
+	gridPointInt_t       nProcs = {0, 0, 0};
+	rng_t                rng;
+	int                  rank = 0;
+	int                  size = 1;
+	double               *data;
+	uint64_t             num;
+
+	grid    = gridRegular_new("TEST", origin, extent, dims);
+	var     = dataVar_new("TESTVAR", DATAVARTYPE_DOUBLE, 1);
+	gridRegular_attachVar(grid, var);
+	distrib = gridRegularDistrib_new(grid, nProcs);
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	gridRegularDistrib_initMPI(distrib, nProcs, MPI_COMM_WORLD);
+	rank = gridRegularDistrib_getLocalRank(distrib);
+#endif
+
+	patch = gridRegularDistrib_getPatchForRank(distrib, rank);
+	gridRegular_attachPatch(grid, patch);
+	data  = gridPatch_getVarDataHandle(patch, 0);
+	rng   = rng_new(3, size, 45452);
+	num   = gridPatch_getNumCells(patch);
+	for (uint64_t i = 0; i < num; i++) {
+		data[i] = rng_getGauss(rng, 0, LOCAL_FAKE_MEAN,
+		                       sqrt(LOCAL_FAKE_VARIANCE));
+	}
+	rng_del(&rng);
+
+	gridRegular_del(&grid);
+
+	return distrib;
+} /* local_getFakeDistrib */
+
+static bool
+local_compare(const gridStatistics_t statA,
+              const gridHistogram_t  histoA,
+              const gridStatistics_t statB,
+              const gridHistogram_t  histoB)
+{
+	if (fabs(gridStatistics_getMean(statA)
+	         - gridStatistics_getMean(statB)) > 1e-10)
+		return false;
+	if (fabs(gridStatistics_getVariance(statA)
+	         - gridStatistics_getVariance(statB)) > 1e-10)
+		return false;
+	if (fabs(gridStatistics_getSkew(statA)
+	         - gridStatistics_getSkew(statB)) > 1e-10)
+		return false;
+	if (fabs(gridStatistics_getKurtosis(statA)
+	         - gridStatistics_getKurtosis(statB)) > 1e-10)
+		return false;
+	if ((gridStatistics_getMin(statA) != gridStatistics_getMin(statB))
+	    || (gridStatistics_getMax(statA) != gridStatistics_getMax(statB)))
+		return false;
+
+	for (uint32_t i = 0; i < LOCAL_NUMBINS + 2; i++) {
+		if (gridHistogram_getCountInBin(histoA, i)
+		    != gridHistogram_getCountInBin(histoB, i))
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,31 @@
+// Copyright (C) 2010, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDSUMMARY_TESTS_H
+#define GRIDSUMMARY_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridSummary_tests.h
+ * @ingroup libgridAnalysisSummary
+ * @brief  This file provides the test functions for the grid summary.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+gridSummary_calcGridPatch_test(void);
+
+extern bool
+gridSummary_calcGridRegularDistrib_test(void);
+
+
+#endif
@@ -7,6 +7,7 @@
 #include "gridConfig.h"
 #include "gridUtil.h"
 #include <assert.h>
+#include <string.h>
 #include "../libutil/xmem.h"
 
 
@@ -35,4 +36,54 @@ gridUtil_intersection1D(uint32_t loA,
 	return true;
 }
 
+extern void
+gridUtil_convertToDouble(const void    *data,
+                         dataVarType_t type,
+                         uint64_t      offset,
+                         int           num,
+                         double        *values)
+{
+	switch (type) {
+	case DATAVARTYPE_INT:
+	case DATAVARTYPE_INT32:
+	{
+		const int *tmp = (const int *)data + offset;
+		for (int i = 0; i < num; i++)
+			values[i] = tmp[i];
+	}
+	break;
+	case DATAVARTYPE_INT64:
+	{
+		const int64_t *tmp = (const int64_t *)data + offset;
+		for (int i = 0; i < num; i++)
+			values[i] = tmp[i];
+	}
+	break;
+	case DATAVARTYPE_INT8:
+	{
+		const int8_t *tmp = (const int8_t *)data + offset;
+		for (int i = 0; i < num; i++)
+			values[i] = tmp[i];
+	}
+	break;
+	case DATAVARTYPE_DOUBLE:
+		memcpy(values, (const double *)data + offset, sizeof(double) * num);
+		break;
+	case DATAVARTYPE_FLOAT:
+	{
+		const float *tmp = (const float *)data + offset;
+		for (int i = 0; i < num; i++)
+			values[i] = tmp[i];
+	}
+	break;
+	case DATAVARTYPE_FPV:
+	{
+		const fpv_t *tmp = (const fpv_t *)data + offset;
+		for (int i = 0; i < num; i++)
+			values[i] = tmp[i];
+	}
+	break;
+	}
+} /* gridUtil_convertToDouble */
+
 /*--- Implementations of local functions --------------------------------*/
@@ -10,6 +10,7 @@
 #include "gridConfig.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include "../libdata/dataVarType.h"
 
 /*--- Prototypes of exported functions ----------------------------------*/
 extern bool
@@ -20,5 +21,12 @@ gridUtil_intersection1D(uint32_t loA,
                        uint32_t *loC,
                        uint32_t *hiC);
 
+extern void
+gridUtil_convertToDouble(const void    *data,
+                         dataVarType_t type,
+                         uint64_t      offset,
+                         int           num,
+                         double        *values);
+
 
 #endif
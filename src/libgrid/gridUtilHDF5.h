@@ -24,10 +24,14 @@
 /*--- Prototypes of exported functions ----------------------------------*/
 
 /**
- * @brief  Selects an hyperslab for a given offset and extent.
+ * @brief  Combines an hyperslab for a given offset and extent with the
+ *         current selection.
  *
  * @param[in,out]  ds
  *                    The dataspace on which to select the hyperslab.
+ * @param[in]      op
+ *                    The operation to combine the hyperslab with the
+ *                    current selection, e.g. @c H5S_SELECT_OR.
  * @param[in]      idxLo
  *                    The offset of the selection.
  * @param[in]      dims
@@ -36,9 +40,10 @@
  * @return  Returns nothing.
  */
 inline static void
-gridUtilHDF5_selectHyperslab(hid_t             ds,
-                             gridPointUint32_t idxLo,
-                             gridPointUint32_t dims)
+gridUtilHDF5_selectHyperslabOp(hid_t             ds,
+                               H5S_seloper_t     op,
+                               gridPointUint32_t idxLo,
+                               gridPointUint32_t dims)
 {
 	hsize_t dsDims[NDIM];
 	hsize_t dsIdxLo[NDIM];
@@ -48,7 +53,27 @@ gridUtilHDF5_selectHyperslab(hid_t             ds,
 		dsIdxLo[i] = (idxLo == NULL) ? 0 : idxLo[NDIM - 1 - i];
 	}
 
-	H5Sselect_hyperslab(ds, H5S_SELECT_SET, dsIdxLo, NULL, dsDims, NULL);
+	H5Sselect_hyperslab(ds, op, dsIdxLo, NULL, dsDims, NULL);
+}
+
+/**
+ * @brief  Selects an hyperslab for a given offset and extent.
+ *
+ * @param[in,out]  ds
+ *                    The dataspace on which to select the hyperslab.
+ * @param[in]      idxLo
+ *                    The offset of the selection.
+ * @param[in]      dims
+ *                    The extent of the selection.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+gridUtilHDF5_selectHyperslab(hid_t             ds,
+                             gridPointUint32_t idxLo,
+                             gridPointUint32_t dims)
+{
+	gridUtilHDF5_selectHyperslabOp(ds, H5S_SELECT_SET, idxLo, dims);
 }
 
 /**
@@ -24,6 +24,9 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridPoint.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "gridSummary.h"
 #include "../libutil/xmem.h"
 #include "../libutil/filename.h"
 
@@ -78,6 +81,10 @@ gridWriter_writeGridPatch(gridWriter_t   writer,
 	assert(writer->func->writeGridPatch != NULL);
 
 	writer->func->writeGridPatch(writer, patch, patchName, origin, delta);
+
+	if ((writer->stat != NULL) || (writer->histo != NULL))
+		gridSummary_addGridPatch(writer->stat, writer->histo, patch,
+		                         writer->idxOfSummaryVar);
 }
 
 extern void
@@ -89,6 +96,13 @@ gridWriter_writeGridRegular(gridWriter_t  writer,
 	assert(writer->func->writeGridRegular != NULL);
 
 	writer->func->writeGridRegular(writer, grid);
+
+	if ((writer->stat != NULL) || (writer->histo != NULL)) {
+		for (int i = 0; i < gridRegular_getNumPatches(grid); i++)
+			gridSummary_addGridPatch(writer->stat, writer->histo,
+			                         gridRegular_getPatchHandle(grid, i),
+			                         writer->idxOfSummaryVar);
+	}
 }
 
 #ifdef WITH_MPI
@@ -160,6 +174,14 @@ gridWriter_getFileName(const gridWriter_t writer)
 	return writer->fileName;
 }
 
+extern gridIO_type_t
+gridWriter_getType(const gridWriter_t writer)
+{
+	assert(writer != NULL);
+
+	return writer->type;
+}
+
 extern bool
 gridWriter_isActive(const gridWriter_t writer)
 {
@@ -176,6 +198,20 @@ gridWriter_hasBeenActivated(const gridWriter_t writer)
 	return writer->hasBeenActivated;
 }
 
+extern void
+gridWriter_setSummary(gridWriter_t     writer,
+                      gridStatistics_t stat,
+                      gridHistogram_t  histo,
+                      int              idxOfVar)
+{
+	assert(writer != NULL);
+	assert(idxOfVar >= 0);
+
+	writer->stat            = stat;
+	writer->histo           = histo;
+	writer->idxOfSummaryVar = idxOfVar;
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern void
 gridWriter_init(gridWriter_t      writer,
@@ -190,6 +226,9 @@ gridWriter_init(gridWriter_t      writer,
 	writer->hasBeenActivated      = false;
 	writer->overwriteFileIfExists = false;
 	writer->fileName              = NULL;
+	writer->stat                  = NULL;
+	writer->histo                 = NULL;
+	writer->idxOfSummaryVar       = 0;
 }
 
 extern void
@@ -20,6 +20,9 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridPoint.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
+#include "gridIO.h"
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
@@ -210,6 +213,33 @@ extern bool
 gridWriter_getOverwriteFileIfExists(const gridWriter_t writer);
 
 
+/**
+ * @brief  Sets the statistics and the histogram into which the data of one
+ *         variable is accumulated whenever the writer writes a patch or a
+ *         grid.
+ *
+ * The writer does not take ownership of the objects and will neither
+ * reset nor finalize them, see gridSummary_addGridPatch().
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with.  Passing @c NULL is
+ *                    undefined.
+ * @param[in]      stat
+ *                    The statistics to use, @c NULL to disable.
+ * @param[in]      histo
+ *                    The histogram to use, @c NULL to disable.
+ * @param[in]      idxOfVar
+ *                    The index of the variable that is summarized.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriter_setSummary(gridWriter_t     writer,
+                      gridStatistics_t stat,
+                      gridHistogram_t  histo,
+                      int              idxOfVar);
+
+
 /**
  * @brief  Sets a new file name for the writer.
  *
@@ -265,6 +295,18 @@ gridWriter_overlayFileName(gridWriter_t writer,
 extern const filename_t
 gridWriter_getFileName(const gridWriter_t writer);
 
+/**
+ * @brief  Retrieves the type of the writer.
+ *
+ * @param[in]  writer
+ *                The writer to query, this must be a valid writer, passing
+ *                @c NULL is undefined.
+ *
+ * @return  Returns the type of the file the writer writes.
+ */
+extern gridIO_type_t
+gridWriter_getType(const gridWriter_t writer);
+
 
 /** @} */
 
@@ -0,0 +1,288 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBrick.c
+ * @ingroup  libgridIOOutBrick
+ * @brief  Implements the brick file writer.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriterBrick.h"
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#  include "../libutil/groupi.h"
+#endif
+#include "../libdata/dataVar.h"
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridPoint.h"
+#include "../libutil/xmem.h"
+#include "../libutil/diediedie.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "gridWriterBrick_adt.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+#ifdef WITH_MPI
+/** @brief  The tag used for MPI messages in the parallel IO communication. */
+#  define LOCAL_MPI_TAG 988
+#endif
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  Stores the functions table for the brick writer. */
+static struct gridWriter_func_struct local_func
+    = {&gridWriterBrick_del,
+	   &gridWriterBrick_activate,
+	   &gridWriterBrick_deactivate,
+	   &gridWriterBrick_writeGridPatch,
+	   &gridWriterBrick_writeGridRegular,
+#ifdef WITH_MPI
+	   &gridWriterBrick_initParallel
+#endif
+	};
+
+/** @brief  Gives the default path of the output file. */
+static const char *local_defaultFileNamePath = NULL;
+
+/** @brief  Gives the default prefix of the output file. */
+static const char *local_defaultFileNamePrefix = "out";
+
+/** @brief  Gives the default suffix for the output file. */
+static const char *local_defaultFileNameSuffix = ".brick";
+
+/** @brief  Gives the default qualifier of the output file. */
+static const char *local_defaultFileNameQualifier = "";
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Translates the grid variable type to a brick file format.
+ *
+ * @param[in]  var
+ *                The variable that should be translated.
+ *
+ * @return  Returns the corresponding brick file format.
+ */
+static brickFileFormat_t
+local_getBrickTypeFromGridType(const dataVar_t var);
+
+
+/*--- Implementations of abstract functions -----------------------------*/
+extern void
+gridWriterBrick_del(gridWriter_t *writer)
+{
+	assert(writer != NULL && *writer != NULL);
+	assert((*writer)->type == GRIDIO_TYPE_BRICK);
+
+	gridWriter_free(*writer);
+	gridWriterBrick_free((gridWriterBrick_t)*writer);
+
+	xfree(*writer);
+	*writer = NULL;
+}
+
+extern void
+gridWriterBrick_activate(gridWriter_t writer)
+{
+	gridWriterBrick_t w = (gridWriterBrick_t)writer;
+
+	assert(w != NULL);
+	assert(w->base.type == GRIDIO_TYPE_BRICK);
+#ifdef WITH_MPI
+	assert(w->groupi != NULL);
+#endif
+
+	if (!gridWriter_isActive(writer)) {
+		bool isFirst = true;
+
+#ifdef WITH_MPI
+		groupi_acquire(w->groupi);
+		isFirst = groupi_isFirstInGroup(w->groupi);
+#endif
+		brickFile_setFileName(w->brickFile,
+		                      filename_getFullName(w->base.fileName));
+		if (isFirst)
+			brickFile_makeEmptyFile(w->brickFile);
+
+		gridWriter_setIsActive(writer);
+	}
+}
+
+extern void
+gridWriterBrick_deactivate(gridWriter_t writer)
+{
+	assert(writer != NULL);
+	assert(writer->type == GRIDIO_TYPE_BRICK);
+#ifdef WITH_MPI
+	assert(((gridWriterBrick_t)writer)->groupi != NULL);
+#endif
+
+	if (gridWriter_isActive(writer)) {
+#ifdef WITH_MPI
+		groupi_release(((gridWriterBrick_t)writer)->groupi);
+#endif
+		gridWriter_setIsInactive(writer);
+	}
+}
+
+extern void
+gridWriterBrick_writeGridPatch(gridWriter_t   writer,
+                               gridPatch_t    patch,
+                               const char     *patchName,
+                               gridPointDbl_t origin,
+                               gridPointDbl_t delta)
+{
+	gridWriterBrick_t w = (gridWriterBrick_t)writer;
+	dataVar_t         var;
+	gridPointUint32_t dims;
+	gridPointUint32_t idxLo;
+	uint32_t          idxLo3[3] = {0, 0, 0};
+	uint32_t          dims3[3]  = {1, 1, 1};
+
+	assert(w != NULL);
+	assert(w->base.type == GRIDIO_TYPE_BRICK);
+	assert(gridWriter_isActive(writer));
+	assert(patch != NULL);
+
+	if ((patchName == NULL) || (origin == NULL) || (delta == NULL))
+		;
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+	for (int i = 0; i < NDIM; i++) {
+		idxLo3[i] = idxLo[i];
+		dims3[i]  = dims[i];
+	}
+	var = gridPatch_getVarHandle(patch, 0);
+
+	brickFile_writeWindowed(w->brickFile,
+	                        gridPatch_getVarDataHandle(patch, 0),
+	                        local_getBrickTypeFromGridType(var),
+	                        dataVar_getNumComponents(var),
+	                        idxLo3, dims3);
+}
+
+extern void
+gridWriterBrick_writeGridRegular(gridWriter_t  writer,
+                                 gridRegular_t grid)
+{
+	gridPatch_t patch;
+
+	assert(writer != NULL);
+	assert(writer->type == GRIDIO_TYPE_BRICK);
+	assert(writer->isActive);
+	assert(grid != NULL);
+
+	patch = gridRegular_getPatchHandle(grid, 0);
+	gridWriterBrick_writeGridPatch(writer, patch, "null", NULL, NULL);
+}
+
+#ifdef WITH_MPI
+extern void
+gridWriterBrick_initParallel(gridWriter_t writer, MPI_Comm mpiComm)
+{
+	gridWriterBrick_t tmp = (gridWriterBrick_t)writer;
+
+	assert(tmp != NULL);
+	assert(tmp->base.type == GRIDIO_TYPE_BRICK);
+
+	tmp->groupi = groupi_new(1, mpiComm, LOCAL_MPI_TAG, GROUPI_MODE_BLOCK);
+}
+
+#endif
+
+
+/*--- Implementations of final functions --------------------------------*/
+extern gridWriterBrick_t
+gridWriterBrick_new(void)
+{
+	gridWriterBrick_t writer;
+
+	writer = gridWriterBrick_alloc();
+
+	gridWriter_init((gridWriter_t)writer, GRIDIO_TYPE_BRICK, &local_func);
+	gridWriterBrick_init(writer);
+
+	return writer;
+}
+
+extern brickFile_t
+gridWriterBrick_getBrickFile(const gridWriterBrick_t writer)
+{
+	assert(writer != NULL);
+
+	return writer->brickFile;
+}
+
+/*--- Implementations of protected functions ----------------------------*/
+extern gridWriterBrick_t
+gridWriterBrick_alloc(void)
+{
+	gridWriterBrick_t writer;
+
+	writer = xmalloc(sizeof(struct gridWriterBrick_struct));
+
+	return writer;
+}
+
+extern void
+gridWriterBrick_init(gridWriterBrick_t writer)
+{
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       filename_newFull(local_defaultFileNamePath,
+	                                        local_defaultFileNamePrefix,
+	                                        local_defaultFileNameQualifier,
+	                                        local_defaultFileNameSuffix));
+
+	writer->brickFile = brickFile_new();
+#ifdef WITH_MPI
+	writer->groupi    = NULL;
+#endif
+}
+
+extern void
+gridWriterBrick_free(gridWriterBrick_t writer)
+{
+	if (writer->brickFile != NULL)
+		brickFile_del(&(writer->brickFile));
+#ifdef WITH_MPI
+	if (writer->groupi != NULL)
+		groupi_del(&(writer->groupi));
+#endif
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static brickFileFormat_t
+local_getBrickTypeFromGridType(const dataVar_t var)
+{
+	brickFileFormat_t varType;
+
+	switch (dataVar_getType(var)) {
+	case DATAVARTYPE_DOUBLE:
+		varType = BRICKFILE_FORMAT_DOUBLE;
+		break;
+	case DATAVARTYPE_FPV:
+		varType = sizeof(fpv_t) == 4 ?
+		          BRICKFILE_FORMAT_FLOAT : BRICKFILE_FORMAT_DOUBLE;
+		break;
+	case DATAVARTYPE_INT:
+	default:
+		diediedie(EXIT_FAILURE);
+	}
+
+	return varType;
+}
@@ -0,0 +1,179 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDWRITERBRICK_H
+#define GRIDWRITERBRICK_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBrick.h
+ * @ingroup  libgridIOOutBrick
+ * @brief  Provides the interface for the brick file writer.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriter.h"
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridPoint.h"
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/brickFile.h"
+
+
+/*--- ADT handle --------------------------------------------------------*/
+
+/** @brief  The handle for the brick file writer object. */
+typedef struct gridWriterBrick_struct *gridWriterBrick_t;
+
+
+/*--- Prototypes of implemented abstract functions ----------------------*/
+
+
+/**
+ * @name  Creating and Deleting (Virtual)
+ *
+ * @{
+ */
+
+
+/** @copydoc gridWriter_del() */
+extern void
+gridWriterBrick_del(gridWriter_t *writer);
+
+
+/** @} */
+
+
+/**
+ * @name  Using (Virtual)
+ *
+ * @{
+ */
+
+/** @copydoc gridWriter_activate() */
+extern void
+gridWriterBrick_activate(gridWriter_t writer);
+
+
+/** @copydoc gridWriter_deactivate() */
+extern void
+gridWriterBrick_deactivate(gridWriter_t writer);
+
+
+/** @copydoc gridWriter_writeGridPatch() */
+extern void
+gridWriterBrick_writeGridPatch(gridWriter_t   writer,
+                               gridPatch_t    patch,
+                               const char     *patchName,
+                               gridPointDbl_t origin,
+                               gridPointDbl_t delta);
+
+
+/** @copydoc gridWriter_writeGridRegular() */
+extern void
+gridWriterBrick_writeGridRegular(gridWriter_t  writer,
+                                 gridRegular_t grid);
+
+
+/** @} */
+
+#ifdef WITH_MPI
+
+/**
+ * @name  Additional Initialization (Virtual)
+ *
+ * @{
+ */
+
+/** @copydoc gridWriter_initParallel() */
+extern void
+gridWriterBrick_initParallel(gridWriter_t writer, MPI_Comm mpiComm);
+
+
+/** @} */
+
+#endif
+
+
+/*--- Prototypes of final functions -------------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Creates a new empty brick file writer.
+ *
+ * @return  The new writer.
+ */
+extern gridWriterBrick_t
+gridWriterBrick_new(void);
+
+
+/** @} */
+
+/**
+ * @name  Getting (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Retrieves the underlying brick file object from a brick file
+ *         writer.
+ *
+ * The object should be set up (size, brick size, precision, ...) before
+ * the writer is activated.
+ *
+ * @param[in]  writer
+ *                The writer that should be queried, passing @c NULL is
+ *                undefined.
+ *
+ * @return  Returns a handle to the internal brick file object, the caller
+ *          must not try free the object.
+ */
+extern brickFile_t
+gridWriterBrick_getBrickFile(const gridWriterBrick_t writer);
+
+
+/** @} */
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libgridIOOutBrick Brick Writer
+ * @ingroup libgridIOOut
+ * @brief  Provides the writer for brick files.
+ *
+ * Under MPI the tasks take turns in writing their patches into the file.
+ *
+ * @section libgridIOOutBrickIniFormat  Expected Format for Ini Files
+ *
+ * @code
+ * [SectionName]
+ * size = <int>, <int>, <int>
+ * # Optional keys
+ * brickSize = <int>, <int>, <int>
+ * numComponents = <int>
+ * doublePrecision = <true|false>
+ * doCompression = <true|false>
+ * @endcode
+ *
+ * The bricks default to 32^3 cells, the data to one single precision
+ * component.  With @c doCompression the bricks are byte-shuffled and
+ * compressed with a fast LZ coder, bricks that do not shrink are stored
+ * as they are.
+ */
+
+
+#endif
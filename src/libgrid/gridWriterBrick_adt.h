@@ -0,0 +1,89 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDWRITERBRICK_ADT_H
+#define GRIDWRITERBRICK_ADT_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBrick_adt.h
+ * @ingroup  libgridIOOutBrick
+ * @brief  Provides the main structure of the brick file writer.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriter_adt.h"
+#ifdef WITH_MPI
+#  include <mpi.h>
+#  include "../libutil/groupi.h"
+#endif
+#include "../libutil/brickFile.h"
+
+
+/*--- ADT implementation ------------------------------------------------*/
+
+/** @brief  The main structure. */
+struct gridWriterBrick_struct {
+	/** @brief  The base structure. */
+	struct gridWriter_struct base;
+	/** @brief  The low level brick file interface. */
+	brickFile_t              brickFile;
+#ifdef WITH_MPI
+	/** @brief  Provides a Poor-Man Parallel IO interface. */
+	groupi_t groupi;
+#endif
+};
+
+/*--- Prototypes of protected functions ---------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Protected)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Allocates memory for a brick file writer.
+ *
+ * @return  Returns a handle to a new (uninitialized) brick writer structure.
+ */
+extern gridWriterBrick_t
+gridWriterBrick_alloc();
+
+
+/**
+ * @brief  Sets all required fields of the brick writer structure to safe
+ *         initial values.
+ *
+ * @param[in,out]  writer
+ *                    The writer to initialize.  This must be a valid writer
+ *                    object.  Passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterBrick_init(gridWriterBrick_t writer);
+
+
+/**
+ * @brief  Frees all members of the brick writer structure.
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with,  This must be a valid writer,
+ *                    passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterBrick_free(gridWriterBrick_t writer);
+
+
+/** @} */
+
+
+#endif
@@ -20,6 +20,7 @@
 #include "../libutil/diediedie.h"
 #include "gridIOCommon.h"
 #include "gridWriterGrafic.h"
+#include "gridWriterBrick.h"
 #ifdef WITH_SILO
 #  include "gridWriterSilo.h"
 #  include <silo.h>
@@ -110,6 +111,8 @@ gridWriterFactory_newFromIniGrafic(parse_ini_t ini, const char *sectionName)
 	gridWriterGrafic_t writer;
 	grafic_t           grafic;
 	bool               isWhiteNoise;
+	bool               doCollectiveWrite;
+	bool               useDirectIO;
 	uint32_t           *size = NULL;
 
 
@@ -151,9 +154,66 @@ gridWriterFactory_newFromIniGrafic(parse_ini_t ini, const char *sectionName)
 		grafic_setH0(grafic, (float)tmp);
 	}
 
+	if (parse_ini_get_bool(ini, "doCollectiveWrite", sectionName,
+	                       &doCollectiveWrite) && doCollectiveWrite) {
+#ifdef WITH_MPI
+		gridWriterGrafic_setDoCollectiveWrite(writer, true);
+#else
+		fprintf(stderr,
+		        "WARNING: doCollectiveWrite requires MPI, ignoring it.\n");
+#endif
+	}
+
+	if (parse_ini_get_bool(ini, "useDirectIO", sectionName, &useDirectIO))
+		grafic_setUseDirectIO(grafic, useDirectIO);
+
 	return (gridWriter_t)writer;
 } /* gridWriterFactory_newFromIniGrafic */
 
+extern gridWriter_t
+gridWriterFactory_newFromIniBrick(parse_ini_t ini, const char *sectionName)
+{
+	gridWriterBrick_t writer;
+	brickFile_t       brickFile;
+	uint32_t          *size = NULL;
+	int32_t           numComponents;
+	bool              tmp;
+
+	assert(ini != NULL);
+	assert(sectionName != NULL);
+
+	writer    = gridWriterBrick_new();
+	brickFile = gridWriterBrick_getBrickFile(writer);
+
+	if (!parse_ini_get_int32list(ini, "size", sectionName, 3,
+	                             (int32_t **)&size)) {
+		fprintf(stderr, "FATAL:  Could not get size from section %s.\n",
+		        sectionName);
+		exit(EXIT_FAILURE);
+	}
+	brickFile_setSize(brickFile, size);
+	xfree(size);
+
+	if (parse_ini_get_int32list(ini, "brickSize", sectionName, 3,
+	                            (int32_t **)&size)) {
+		brickFile_setBrickSize(brickFile, size);
+		xfree(size);
+	}
+
+	if (parse_ini_get_int32(ini, "numComponents", sectionName,
+	                        &numComponents))
+		brickFile_setNumComponents(brickFile, (int)numComponents);
+
+	if (parse_ini_get_bool(ini, "doublePrecision", sectionName, &tmp) && tmp)
+		brickFile_setFormat(brickFile, BRICKFILE_FORMAT_DOUBLE);
+
+	if (parse_ini_get_bool(ini, "doCompression", sectionName, &tmp) && tmp)
+		brickFile_setCompression(brickFile,
+		                         BRICKFILE_COMPRESSION_SHUFFLE_LZ);
+
+	return (gridWriter_t)writer;
+} /* gridWriterFactory_newFromIniBrick */
+
 #ifdef WITH_HDF5
 extern gridWriter_t
 gridWriterFactory_newFromIniHDF5(parse_ini_t ini, const char *sectionName)
@@ -163,6 +223,8 @@ gridWriterFactory_newFromIniHDF5(parse_ini_t ini, const char *sectionName)
 
 	gridWriterHDF5_t writer;
 	bool             tmp, doChunking, doChecksum, doCompression, doPatch;
+	bool             doShuffle, doScaleOffset, doNBit;
+	int32_t          numSubfiles;
 
 
 	writer = gridWriterHDF5_new();
@@ -170,16 +232,25 @@ gridWriterFactory_newFromIniHDF5(parse_ini_t ini, const char *sectionName)
 	if (tmp && doChunking) {
 		int32_t           *sizeFile;
 		gridPointUint32_t sizeCode;
-		if (!parse_ini_get_int32list(ini, "chunkSize", sectionName,
-		                             NDIM, (int32_t **)&sizeFile)) {
-			fprintf(stderr, "Could not get chunkSize from section %s.\n",
-			        sectionName);
-			diediedie(EXIT_FAILURE);
+		if (parse_ini_get_int32list(ini, "chunkNumTiles", sectionName,
+		                            NDIM, (int32_t **)&sizeFile)) {
+			for (int i = 0; i < NDIM; i++)
+				sizeCode[i] = sizeFile[i];
+			xfree(sizeFile);
+			gridWriterHDF5_setChunkNumTiles(writer, sizeCode);
+		} else {
+			if (!parse_ini_get_int32list(ini, "chunkSize", sectionName,
+			                             NDIM, (int32_t **)&sizeFile)) {
+				fprintf(stderr,
+				        "Could not get chunkSize from section %s.\n",
+				        sectionName);
+				diediedie(EXIT_FAILURE);
+			}
+			for (int i = 0; i < NDIM; i++)
+				sizeCode[i] = sizeFile[i];
+			xfree(sizeFile);
+			gridWriterHDF5_setChunkSize(writer, sizeCode);
 		}
-		for (int i = 0; i < NDIM; i++)
-			sizeCode[i] = sizeFile[i];
-		xfree(sizeFile);
-		gridWriterHDF5_setChunkSize(writer, sizeCode);
 	}
 
 	if (parse_ini_get_bool(ini, "doChecksum", sectionName, &doChecksum))
@@ -188,9 +259,35 @@ gridWriterFactory_newFromIniHDF5(parse_ini_t ini, const char *sectionName)
 	tmp = parse_ini_get_bool(ini, "doCompression", sectionName,
 	                         &doCompression);
 	if (tmp && doCompression) {
-		char *filterName;
+		char    *filterName;
+		int32_t deflateLevel;
 		getFromIni(&filterName, parse_ini_get_string, ini,
 		           "filterName", sectionName);
+		gridWriterHDF5_setCompressionFilter(writer, filterName);
+		xfree(filterName);
+		if (parse_ini_get_int32(ini, "deflateLevel", sectionName,
+		                        &deflateLevel))
+			gridWriterHDF5_setDeflateLevel(writer, (int)deflateLevel);
+	}
+
+	if (parse_ini_get_bool(ini, "doShuffle", sectionName, &doShuffle))
+		gridWriterHDF5_setDoShuffle(writer, doShuffle);
+
+	tmp = parse_ini_get_bool(ini, "doScaleOffset", sectionName,
+	                         &doScaleOffset);
+	if (tmp && doScaleOffset) {
+		int32_t digits;
+		getFromIni(&digits, parse_ini_get_int32, ini,
+		           "scaleOffsetDigits", sectionName);
+		gridWriterHDF5_setScaleOffset(writer, true, (int)digits);
+	}
+
+	tmp = parse_ini_get_bool(ini, "doNBit", sectionName, &doNBit);
+	if (tmp && doNBit) {
+		int32_t mantissaBits;
+		getFromIni(&mantissaBits, parse_ini_get_int32, ini,
+		           "nbitMantissaBits", sectionName);
+		gridWriterHDF5_setNBit(writer, true, (int)mantissaBits);
 	}
 	
 	tmp = parse_ini_get_bool(ini, "doPatch", sectionName,
@@ -199,6 +296,9 @@ gridWriterFactory_newFromIniHDF5(parse_ini_t ini, const char *sectionName)
 		local_doPatch(ini, sectionName, writer);
 	}
 
+	if (parse_ini_get_int32(ini, "numSubfiles", sectionName, &numSubfiles))
+		gridWriterHDF5_setNumSubfiles(writer, (int)numSubfiles);
+
 
 	return (gridWriter_t)writer;
 } /* gridWriterFactory_newFromIniHDF5 */
@@ -380,6 +480,8 @@ local_getWriter(parse_ini_t ini, const char *secName, gridIO_type_t type)
 #endif
 	} else if (type == GRIDIO_TYPE_GRAFIC) {
 		writer = gridWriterFactory_newFromIniGrafic(ini, secName);
+	} else if (type == GRIDIO_TYPE_BRICK) {
+		writer = gridWriterFactory_newFromIniBrick(ini, secName);
 	} else if (type == GRIDIO_TYPE_HDF5) {
 #ifdef WITH_HDF5
 		writer = gridWriterFactory_newFromIniHDF5(ini, secName);
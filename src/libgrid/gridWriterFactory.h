@@ -79,6 +79,9 @@ gridWriterFactory_newWriterFromIni(parse_ini_t ini,
  *  <dt>HDF5</dt>
  *  <dd>The name is given by #local_typeHDF5Str.  For further
  *      construction details see @ref libgridIOOutHDF5IniFormat.</dd>
+ *  <dt>Brick</dt>
+ *  <dd>The name is given by #local_typeBrickStr.  For further
+ *      construction details see @ref libgridIOOutBrickIniFormat.</dd>
  * </dl>
  * Additional construction information for the actual reader is taken from
  * the current section, or -- if present -- from the section specified by
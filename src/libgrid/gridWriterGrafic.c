@@ -20,6 +20,7 @@
 #ifdef WITH_MPI
 #  include <mpi.h>
 #  include "../libutil/groupi.h"
+#  include "../libutil/graficMPI.h"
 #endif
 #include "../libdata/dataVar.h"
 #include "gridPatch.h"
@@ -113,8 +114,13 @@ gridWriterGrafic_activate(gridWriter_t writer)
 		bool isFirst = true;
 
 #ifdef WITH_MPI
-		groupi_acquire(w->groupi);
-		isFirst = groupi_isFirstInGroup(w->groupi);
+		// The file is created by the collective write.
+		if (w->doCollectiveWrite) {
+			isFirst = false;
+		} else {
+			groupi_acquire(w->groupi);
+			isFirst = groupi_isFirstInGroup(w->groupi);
+		}
 #endif
 		grafic_setFileName(w->grafic, filename_getFullName(w->base.fileName));
 		if (isFirst)
@@ -135,7 +141,8 @@ gridWriterGrafic_deactivate(gridWriter_t writer)
 
 	if (gridWriter_isActive(writer)) {
 #ifdef WITH_MPI
-		groupi_release(((gridWriterGrafic_t)writer)->groupi);
+		if (!((gridWriterGrafic_t)writer)->doCollectiveWrite)
+			groupi_release(((gridWriterGrafic_t)writer)->groupi);
 #endif
 		gridWriter_setIsInactive(writer);
 	}
@@ -173,6 +180,14 @@ gridWriterGrafic_writeGridPatch(gridWriter_t   writer,
 	numComponents = dataVar_getNumComponents(var);
 	format        = local_getGraficTypeFromGridType(var);
 
+#ifdef WITH_MPI
+	if (w->doCollectiveWrite) {
+		assert(w->mpiComm != MPI_COMM_NULL);
+		graficMPI_writeWindowed(w->grafic, data, format, numComponents,
+		                        idxLo, dims, w->mpiComm);
+		return;
+	}
+#endif
 	grafic_writeWindowed(w->grafic, data, format, numComponents,
 	                     idxLo, dims);
 }
@@ -200,10 +215,11 @@ gridWriterGrafic_initParallel(gridWriter_t writer, MPI_Comm mpiComm)
 	gridWriterGrafic_t tmp = (gridWriterGrafic_t)writer;
 
 	assert(tmp != NULL);
-	assert(tmp->type == GRIDIO_TYPE_GRAFIC);
+	assert(tmp->base.type == GRIDIO_TYPE_GRAFIC);
 
-	tmp->groupi = groupi_new(1, mpiComm, LOCAL_MPI_TAG,
-	                         GROUPI_MODE_BLOCK);
+	tmp->groupi  = groupi_new(1, mpiComm, LOCAL_MPI_TAG,
+	                          GROUPI_MODE_BLOCK);
+	tmp->mpiComm = mpiComm;
 }
 
 #endif
@@ -243,6 +259,16 @@ gridWriterGrafic_getGrafic(const gridWriterGrafic_t writer)
 	return writer->grafic;
 }
 
+extern void
+gridWriterGrafic_setDoCollectiveWrite(gridWriterGrafic_t writer,
+                                      bool               doCollectiveWrite)
+{
+	assert(writer != NULL);
+	assert(!gridWriter_isActive((gridWriter_t)writer));
+
+	writer->doCollectiveWrite = doCollectiveWrite;
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridWriterGrafic_t
 gridWriterGrafic_alloc(void)
@@ -263,9 +289,11 @@ gridWriterGrafic_init(gridWriterGrafic_t writer)
 	                                        local_defaultFileNameQualifier,
 	                                        local_defaultFileNameSuffix));
 
-	writer->grafic = grafic_new();
+	writer->grafic            = grafic_new();
+	writer->doCollectiveWrite = false;
 #ifdef WITH_MPI
-	writer->groupi = NULL;
+	writer->groupi            = NULL;
+	writer->mpiComm           = MPI_COMM_NULL;
 #endif
 }
 
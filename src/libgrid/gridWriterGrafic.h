@@ -158,6 +158,29 @@ gridWriterGrafic_setGrafic(gridWriterGrafic_t writer, grafic_t grafic);
 extern grafic_t
 gridWriterGrafic_getGrafic(const gridWriterGrafic_t writer);
 
+/**
+ * @brief  Selects whether the file is written collectively with MPI-IO.
+ *
+ * By default the tasks take turns in writing their patches into the file.
+ * With collective writing, all tasks write at the same time with
+ * graficMPI_writeWindowed(), the resulting file is identical.  In this
+ * mode every task of the communicator given to
+ * gridWriter_initParallel() must write exactly one patch (which may be
+ * empty) per activation of the writer.  Without MPI this setting has no
+ * effect.
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with, passing @c NULL is
+ *                    undefined.
+ * @param[in]      doCollectiveWrite
+ *                    Whether to write collectively.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterGrafic_setDoCollectiveWrite(gridWriterGrafic_t writer,
+                                      bool               doCollectiveWrite);
+
 /**
  * @brief  Sets the writer to white noise mode.
  *
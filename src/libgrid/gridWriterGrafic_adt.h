@@ -34,9 +34,13 @@ struct gridWriterGrafic_struct {
 	struct gridWriter_struct base;
 	/** @brief  The low level Grafic interface. */
 	grafic_t                 grafic;
+	/** @brief  Flags whether the data is written with collective MPI-IO. */
+	bool                     doCollectiveWrite;
 #ifdef WITH_MPI
 	/** @brief  Provides a Poor-Man Parallel IO interface. */
 	groupi_t groupi;
+	/** @brief  The communicator of the tasks that write together. */
+	MPI_Comm mpiComm;
 #endif
 };
 
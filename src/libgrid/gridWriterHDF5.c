@@ -17,9 +17,11 @@
 #include "gridWriterHDF5.h"
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
 #include <hdf5.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
+#  include "../libutil/groupi.h"
 #endif
 #include "gridPatch.h"
 #include "gridRegular.h"
@@ -28,6 +30,7 @@
 #include "../libutil/xmem.h"
 #include "../libutil/xstring.h"
 #include "../libutil/diediedie.h"
+#include "../libutil/timer.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
@@ -38,6 +41,23 @@
  #define MIN(X,Y) ((X) < (Y) ? (X) : (Y))
  #define MAX(X,Y) ((X) > (Y) ? (X) : (Y))
 
+#ifdef WITH_MPI
+/** @brief  The tag used for MPI messages in the subfile communication. */
+#  define LOCAL_MPI_TAG 989
+
+/**
+ * @brief  The number of integers describing one patch in a subfile (group,
+ *         rank, patch number, lower index and dimensions).
+ */
+#  define LOCAL_SUBFILE_BOX_SIZE (3 + 2 * NDIM)
+
+/**
+ * @brief  The number of integers describing one patch sent to the
+ *         aggregator of a subfile (patch number and dimensions).
+ */
+#  define LOCAL_SUBFILE_PATCH_SIZE (1 + NDIM)
+#endif
+
 /*--- Local variables ---------------------------------------------------*/
 
 /** @brief  Stores the functions table for the HDF5 writer. */
@@ -110,12 +130,89 @@ local_getAccessPropsFileAccessMPI(MPI_Comm comm);
  * @param[in]  writer
  *                The writer holding the information about the chunking,
  *                checksumming and compression.
+ * @param[in]  dt
+ *                The datatype of the dataset, selects the flavour of the
+ *                scale-offset filter.
+ * @param[in]  space
+ *                The extent of the dataset, chunks will not exceed it.
+ * @param[in]  dimsTiled
+ *                The dimensions of the grid the tiling refers to, only
+ *                used for tile aligned chunks.
  *
  * @return  Returns a new property list for use with H5Dcreate to deal with
  *          chunking, checksumming and compression.
  */
 static hid_t
-local_getDSCreationPropList(const gridWriterHDF5_t writer);
+local_getDSCreationPropList(const gridWriterHDF5_t  writer,
+                            hid_t                   dt,
+                            hid_t                   space,
+                            const gridPointUint32_t dimsTiled);
+
+/**
+ * @brief  Gets the datatype used for storing data in the file.
+ *
+ * @param[in]  writer
+ *                The writer, if the N-bit filter is active, floating point
+ *                types will have a reduced mantissa.
+ * @param[in]  dt
+ *                The datatype of the data in memory.
+ *
+ * @return  Returns a new datatype that must be closed by the caller.
+ */
+static hid_t
+local_getFileDatatype(const gridWriterHDF5_t writer, hid_t dt);
+
+/**
+ * @brief  Creates a dataset with the filter pipeline of the writer.
+ *
+ * @param[in]  writer
+ *                The writer to work with.
+ * @param[in]  name
+ *                The name of the dataset.
+ * @param[in]  dt
+ *                The datatype of the data in memory.
+ * @param[in]  space
+ *                The extent of the dataset.
+ * @param[in]  dimsTiled
+ *                The dimensions of the grid the tiling refers to.
+ *
+ * @return  Returns the handle of the new dataset.
+ */
+static hid_t
+local_createDataSet(const gridWriterHDF5_t  writer,
+                    const char              *name,
+                    hid_t                   dt,
+                    hid_t                   space,
+                    const gridPointUint32_t dimsTiled);
+
+/**
+ * @brief  Closes a dataset and records the amount of data written, the
+ *         space it occupies in the file and the time spent.
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with.
+ * @param[in]      dataSet
+ *                    The dataset to close.
+ * @param[in]      timing
+ *                    The value of timer_startLocal() from when the dataset
+ *                    has been created.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_closeDataSet(gridWriterHDF5_t writer, hid_t dataSet, double timing);
+
+/**
+ * @brief  Checks whether the writer applies data reducing filters.
+ *
+ * @param[in]  writer
+ *                The writer to check.
+ *
+ * @return  Returns @c true if any of the compression, shuffle,
+ *          scale-offset or N-bit filter is active.
+ */
+static bool
+local_hasFilters(const gridWriterHDF5_t writer);
 
 /**
  * @brief  Helper function to write the data of a variable at a given patch.
@@ -156,6 +253,200 @@ local_writeVariableAtPatch(dataVar_t   var,
 static bool
 local_checkIfPatchIsCompleteGrid(hid_t space, gridPointUint32_t patchDims);
 
+/**
+ * @brief  Checks whether the writer distributes the grid over subfiles.
+ *
+ * @param[in]  writer
+ *                The writer to check.
+ *
+ * @return  Returns @c true if subfiles are written and @c false if the
+ *          grid goes into one shared file.
+ */
+static bool
+local_isSubfiling(const gridWriterHDF5_t writer);
+
+
+#ifdef WITH_MPI
+
+/**
+ * @brief  Writes a grid into the subfiles and indexes it in the master
+ *         file.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use.
+ * @param[in]      grid
+ *                    The grid that should be written.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeGridSubfiled(gridWriterHDF5_t writer, gridRegular_t grid);
+
+
+/**
+ * @brief  Writes the patches of a group into the subfile of the group.
+ *
+ * The first task of the group is the aggregator, it writes its own
+ * patches and then receives and writes the patches of the other tasks of
+ * the group one after the other.  The other tasks only send.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use.
+ * @param[in]      grid
+ *                    The grid that should be written.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeSubfile(gridWriterHDF5_t writer, gridRegular_t grid);
+
+
+/**
+ * @brief  Sends the local patches of a grid to the aggregator of the
+ *         group.
+ *
+ * The number of non-empty patches is sent first, followed by their
+ * numbers and dimensions (#LOCAL_SUBFILE_PATCH_SIZE integers per patch)
+ * and then the data of every variable for every patch.
+ *
+ * @param[in]  writer
+ *                The writer to use.
+ * @param[in]  grid
+ *                The grid that should be written.
+ * @param[in]  aggregator
+ *                The rank of the task writing the subfile.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_sendPatchesToAggregator(const gridWriterHDF5_t writer,
+                              gridRegular_t          grid,
+                              int                    aggregator);
+
+
+/**
+ * @brief  Receives the patches of one task of the group and writes them
+ *         into the opened subfile.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use, the subfile must be open.
+ * @param[in]      grid
+ *                    The grid that should be written, it provides the
+ *                    variables.
+ * @param[in]      source
+ *                    The rank of the task owning the patches.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_recvPatchesIntoSubfile(gridWriterHDF5_t writer,
+                             gridRegular_t    grid,
+                             int              source);
+
+
+/**
+ * @brief  Writes the data of one variable of one patch as a dataset into
+ *         the opened subfile, replacing an existing dataset of that name.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use, the subfile must be open.
+ * @param[in]      var
+ *                    The variable that is written.
+ * @param[in]      owner
+ *                    The rank of the task owning the patch.
+ * @param[in]      patchNumber
+ *                    The number of the patch within the grid of the
+ *                    owner.
+ * @param[in]      dims
+ *                    The dimensions of the patch.
+ * @param[in]      data
+ *                    The data of the variable in the patch.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeSubfileDataSet(gridWriterHDF5_t        writer,
+                          dataVar_t               var,
+                          int                     owner,
+                          int                     patchNumber,
+                          const gridPointUint32_t dims,
+                          const void              *data);
+
+
+/**
+ * @brief  Collects the patch extents of all tasks and lets the root task
+ *         write the virtual datasets into the master file.
+ *
+ * @param[in]  writer
+ *                The writer to use.
+ * @param[in]  grid
+ *                The grid that has been written into the subfiles.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeMasterFile(const gridWriterHDF5_t writer, gridRegular_t grid);
+
+
+/**
+ * @brief  Creates the virtual datasets in the master file.
+ *
+ * @param[in]  writer
+ *                The writer to use.
+ * @param[in]  grid
+ *                The grid that has been written into the subfiles.
+ * @param[in]  boxes
+ *                The descriptions of all patches in the subfiles,
+ *                #LOCAL_SUBFILE_BOX_SIZE integers per patch.
+ * @param[in]  numBoxes
+ *                The number of patches.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeVirtualDataSets(const gridWriterHDF5_t writer,
+                           gridRegular_t          grid,
+                           const int              *boxes,
+                           int                    numBoxes);
+
+
+/**
+ * @brief  Constructs the name of a subfile.
+ *
+ * @param[in]  writer
+ *                The writer providing the name of the master file.
+ * @param[in]  groupNumber
+ *                The group writing the subfile.
+ * @param[in]  withPath
+ *                Toggles whether the path is included, the virtual
+ *                datasets refer to the subfiles relative to the master
+ *                file.
+ *
+ * @return  Returns a new string that must be freed by the caller.
+ */
+static char *
+local_getSubfileName(const gridWriterHDF5_t writer,
+                     int                    groupNumber,
+                     bool                   withPath);
+
+
+/**
+ * @brief  Constructs the name of the dataset holding a patch in a subfile.
+ *
+ * @param[in]  varName
+ *                The name of the variable.
+ * @param[in]  rank
+ *                The rank of the task that owns the patch.
+ * @param[in]  patchNumber
+ *                The number of the patch within the local grid.
+ *
+ * @return  Returns a new string that must be freed by the caller.
+ */
+static char *
+local_getSubfileDataSetName(const char *varName, int rank, int patchNumber);
+
+#endif
+
 inline static void
 local_writeNull();
 
@@ -184,7 +475,14 @@ gridWriterHDF5_activate(gridWriter_t writer)
 
 	if (!gridWriter_isActive(writer)) {
 		assert(w->fileHandle == H5I_INVALID_HID);
-		w->fileHandle = local_getFileHandle(w);
+#ifdef WITH_MPI
+		// A new file name needs new subfiles and a new master file.
+		if (!gridWriter_hasBeenActivated(writer))
+			w->hasSubfiles = false;
+#endif
+		// With subfiles the files are only opened while writing.
+		if (!local_isSubfiling(w))
+			w->fileHandle = local_getFileHandle(w);
 		gridWriter_setIsActive(writer);
 	}
 }
@@ -198,7 +496,8 @@ gridWriterHDF5_deactivate(gridWriter_t writer)
 	assert(w->base.type == GRIDIO_TYPE_HDF5);
 
 	if (gridWriter_isActive(writer)) {
-		H5Fclose(w->fileHandle);
+		if (w->fileHandle != H5I_INVALID_HID)
+			H5Fclose(w->fileHandle);
 		w->fileHandle = H5I_INVALID_HID;
 		gridWriter_setIsInactive(writer);
 	}
@@ -221,22 +520,27 @@ gridWriterHDF5_writeGridPatch(gridWriter_t   writer,
 
 	int               numVars = gridPatch_getNumVars(patch);
 	gridPointUint32_t dims;
-	hid_t             patchSize, dsCreationPropList;
+	hid_t             patchSize;
+
+	if (local_isSubfiling(w)) {
+		fprintf(stderr, "Cannot write single patches into subfiles.\n");
+		diediedie(EXIT_FAILURE);
+	}
 
 	gridPatch_getDims(patch, dims);
-	patchSize          = gridUtilHDF5_getDataSpaceFromDims(dims);
-	dsCreationPropList = local_getDSCreationPropList(w);
+	patchSize = gridUtilHDF5_getDataSpaceFromDims(dims);
 
 	for (int i = 0; i < numVars; i++) {
-		dataVar_t var = gridPatch_getVarHandle(patch, i);
-		hid_t     dt  = dataVar_getHDF5Datatype(var);
-		hid_t     dataSet = H5Dcreate(w->fileHandle, dataVar_getName(var),
-		                              dt, patchSize, H5P_DEFAULT,
-		                              dsCreationPropList,
-		                              H5P_DEFAULT);
+		dataVar_t var     = gridPatch_getVarHandle(patch, i);
+		hid_t     dt      = dataVar_getHDF5Datatype(var);
+		double    timing  = timer_startLocal();
+		hid_t     dataSet = local_createDataSet(w, dataVar_getName(var),
+		                                        dt, patchSize, dims);
 		local_writeVariableAtPatch(var, patch, dataSet, dt, patchSize);
-		H5Dclose(dataSet);
+		local_closeDataSet(w, dataSet, timing);
+		H5Tclose(dt);
 	}
+	H5Sclose(patchSize);
 }
 
 extern void
@@ -247,6 +551,10 @@ gridWriterHDF5_writeGridRegular(gridWriter_t  writer,
 	assert(w != NULL);
 	if(w->doPatch)
 		local_writeGridRtw(writer, grid);
+#ifdef WITH_MPI
+	else if (local_isSubfiling(w))
+		local_writeGridSubfiled(w, grid);
+#endif
 	else
 		local_writeGridRegular(writer, grid);
 }
@@ -296,10 +604,25 @@ gridWriterHDF5_setChunkSize(gridWriterHDF5_t w, gridPointUint32_t chunkSize)
 	if (!w->doChunking)
 		w->doChunking = true;
 
+	w->doTileChunking = false;
 	for (int i = 0; i < NDIM; i++)
 		w->chunkSize[i] = (hsize_t)(chunkSize[NDIM - 1 - i]);
 }
 
+extern void
+gridWriterHDF5_setChunkNumTiles(gridWriterHDF5_t  w,
+                                gridPointUint32_t numTiles)
+{
+	assert(w != NULL);
+
+	w->doChunking     = true;
+	w->doTileChunking = true;
+	for (int i = 0; i < NDIM; i++) {
+		assert(numTiles[i] > 0);
+		w->chunkNumTiles[i] = numTiles[i];
+	}
+}
+
 extern void
 gridWriterHDF5_setDoChecksum(gridWriterHDF5_t w, bool doChecksum)
 {
@@ -361,6 +684,78 @@ gridWriterHDF5_setCompressionFilter(gridWriterHDF5_t w,
 	}
 }
 
+extern void
+gridWriterHDF5_setDeflateLevel(gridWriterHDF5_t w, int deflateLevel)
+{
+	assert(w != NULL);
+	assert(deflateLevel >= 0 && deflateLevel <= 9);
+
+#ifdef WITH_MPI
+	// No compression in parallel HDF5 writing.
+	return;
+#endif
+
+	w->deflateLevel = deflateLevel;
+	if (!w->doCompression) {
+		gridWriterHDF5_setCompressionFilter(w, "gzip");
+	} else if (w->compressionFilter != H5Z_FILTER_DEFLATE) {
+		fprintf(stderr,
+		        "WARNING: The deflate level only applies to the gzip "
+		        "filter, keeping the configured filter.\n");
+	}
+}
+
+extern void
+gridWriterHDF5_setDoShuffle(gridWriterHDF5_t w, bool doShuffle)
+{
+	assert(w != NULL);
+
+#ifdef WITH_MPI
+	// No filters in parallel HDF5 writing.
+	doShuffle = false;
+#endif
+
+	w->doShuffle = doShuffle;
+	if (w->doShuffle)
+		assert(H5Zfilter_avail(H5Z_FILTER_SHUFFLE));
+}
+
+extern void
+gridWriterHDF5_setScaleOffset(gridWriterHDF5_t w,
+                              bool             doScaleOffset,
+                              int              decimalDigits)
+{
+	assert(w != NULL);
+	assert(decimalDigits >= 0);
+
+#ifdef WITH_MPI
+	// No filters in parallel HDF5 writing.
+	doScaleOffset = false;
+#endif
+
+	w->doScaleOffset     = doScaleOffset;
+	w->scaleOffsetDigits = decimalDigits;
+	if (w->doScaleOffset)
+		assert(H5Zfilter_avail(H5Z_FILTER_SCALEOFFSET));
+}
+
+extern void
+gridWriterHDF5_setNBit(gridWriterHDF5_t w, bool doNBit, int mantissaBits)
+{
+	assert(w != NULL);
+	assert(mantissaBits > 0);
+
+#ifdef WITH_MPI
+	// No filters in parallel HDF5 writing.
+	doNBit = false;
+#endif
+
+	w->doNBit           = doNBit;
+	w->nbitMantissaBits = mantissaBits;
+	if (w->doNBit)
+		assert(H5Zfilter_avail(H5Z_FILTER_NBIT));
+}
+
 extern void
 gridWriterHDF5_setDoPatch(gridWriterHDF5_t w, bool doPatch)
 {
@@ -379,6 +774,39 @@ gridWriterHDF5_setRtw(gridWriterHDF5_t w, int32_t* Lo, gridPointUint32_t d)
 }
 
 
+extern void
+gridWriterHDF5_setNumSubfiles(gridWriterHDF5_t w, int numSubfiles)
+{
+	assert(w != NULL);
+	assert(numSubfiles >= 0);
+
+#ifdef WITH_MPI
+	w->numSubfiles = numSubfiles;
+	if (w->groupi != NULL)
+		groupi_del(&(w->groupi));
+#else
+	if (numSubfiles > 0)
+		fprintf(stderr, "WARNING: numSubfiles requires MPI, ignoring it.\n");
+#endif
+}
+
+extern void
+gridWriterHDF5_getWriteStats(const gridWriterHDF5_t w,
+                             uint64_t               *bytesRaw,
+                             uint64_t               *bytesStored,
+                             double                 *secondsWritten)
+{
+	assert(w != NULL);
+	assert(bytesRaw != NULL);
+	assert(bytesStored != NULL);
+	assert(secondsWritten != NULL);
+
+	*bytesRaw       = w->bytesRaw;
+	*bytesStored    = w->bytesStored;
+	*secondsWritten = w->secondsWritten;
+}
+
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridWriterHDF5_t
 gridWriterHDF5_alloc(void)
@@ -401,17 +829,31 @@ gridWriterHDF5_init(gridWriterHDF5_t writer)
 
 	writer->fileHandle = H5I_INVALID_HID;
 #ifdef WITH_MPI
-	writer->mpiComm    = MPI_COMM_NULL;
+	writer->mpiComm     = MPI_COMM_NULL;
+	writer->numSubfiles = 0;
+	writer->groupi      = NULL;
+	writer->hasSubfiles = false;
 #endif
-	writer->doChunking = false;
+	writer->doChunking     = false;
+	writer->doTileChunking = false;
 	for (int i = 0; i < NDIM; i++) {
-		writer->chunkSize[i] = 0;
+		writer->chunkSize[i]     = 0;
+		writer->chunkNumTiles[i] = 1;
 		writer->rtwLo[i]=0;
 		writer->rtwDims[i]=0;
 	}
 	writer->doChecksum        = false;
 	writer->doCompression     = false;
 	writer->compressionFilter = H5I_INVALID_HID;
+	writer->deflateLevel      = 1;
+	writer->doShuffle         = false;
+	writer->doScaleOffset     = false;
+	writer->scaleOffsetDigits = 0;
+	writer->doNBit            = false;
+	writer->nbitMantissaBits  = 0;
+	writer->bytesRaw          = UINT64_C(0);
+	writer->bytesStored       = UINT64_C(0);
+	writer->secondsWritten    = 0.0;
 	writer->doPatch			  = false;
 }
 
@@ -419,6 +861,10 @@ extern void
 gridWriterHDF5_free(gridWriterHDF5_t writer)
 {
 	assert(writer->fileHandle == H5I_INVALID_HID);
+#ifdef WITH_MPI
+	if (writer->groupi != NULL)
+		groupi_del(&(writer->groupi));
+#endif
 }
 
 /*--- Implementations of local functions --------------------------------*/
@@ -531,7 +977,7 @@ local_writeGridRtw(gridWriter_t  writer,
 	int               numVars, numPatches;
 	gridPointUint32_t dims, period;
 	int32_t idxLo1[3], idxLo2[3], idxHi1[3], idxHi2[3], idxLoW[3], idxHiW[3], idxLo[3], idxHi[3];
-	hid_t             gridSize, dsCreationPropList;
+	hid_t             gridSize;
 	
 	gridPointUint32_t rtwHi, dimsPatch;
 	uint32_t	oldLo;
@@ -544,15 +990,23 @@ local_writeGridRtw(gridWriter_t  writer,
 
 	gridRegular_getDims(grid, period);
 	
-	gridSize           = gridUtilHDF5_getDataSpaceFromDims(w->rtwDims);
-	dsCreationPropList = local_getDSCreationPropList(w);
+	gridSize = gridUtilHDF5_getDataSpaceFromDims(w->rtwDims);
+	if (w->doTileChunking) {
+		for (int k = 0; k < NDIM; k++) {
+			uint32_t c = (period[k] + w->chunkNumTiles[k] - 1)
+			             / w->chunkNumTiles[k];
+			if ((((w->rtwLo[k] % (int32_t)c) + (int32_t)c) % (int32_t)c) != 0)
+				fprintf(stderr, "WARNING: patchLo[%i] = %i is not a multiple "
+				        "of the chunk size %u, chunks and tiles will not "
+				        "align.\n", k, w->rtwLo[k], c);
+		}
+	}
 	for (int i = 0; i < numVars; i++) {
 		dataVar_t var     = gridRegular_getVarHandle(grid, i);
 		hid_t     dt      = dataVar_getHDF5Datatype(var);
-		hid_t     dataSet = H5Dcreate(w->fileHandle, dataVar_getName(var),
-	                              dt, gridSize, H5P_DEFAULT,
-	                              dsCreationPropList,
-	                              H5P_DEFAULT);
+		double    timing  = timer_startLocal();
+		hid_t     dataSet = local_createDataSet(w, dataVar_getName(var),
+		                                        dt, gridSize, period);
 		for (int j = 0; j < numPatches; j++) {
 			gridPatch_t patch = gridRegular_getPatchHandle(grid, j);
 			assert(w->fileHandle != H5I_INVALID_HID);
@@ -636,7 +1090,8 @@ local_writeGridRtw(gridWriter_t  writer,
 			idxHiW[2] = idxHi2[2];
 			write();
 		}
-		H5Dclose(dataSet);
+		local_closeDataSet(w, dataSet, timing);
+		H5Tclose(dt);
 	}
 	H5Sclose(gridSize);
 	
@@ -657,28 +1112,27 @@ local_writeGridRegular(gridWriter_t  writer,
 
 	int               numVars, numPatches;
 	gridPointUint32_t dims;
-	hid_t             gridSize, dsCreationPropList;
+	hid_t             gridSize;
 
 	numVars    = gridRegular_getNumVars(grid);
 	numPatches = gridRegular_getNumPatches(grid);
 
 	gridRegular_getDims(grid, dims);
-	gridSize           = gridUtilHDF5_getDataSpaceFromDims(dims);
-	dsCreationPropList = local_getDSCreationPropList(w);
+	gridSize = gridUtilHDF5_getDataSpaceFromDims(dims);
 
 	for (int i = 0; i < numVars; i++) {
 		dataVar_t var     = gridRegular_getVarHandle(grid, i);
 		hid_t     dt      = dataVar_getHDF5Datatype(var);
-		hid_t     dataSet = H5Dcreate(w->fileHandle, dataVar_getName(var),
-		                              dt, gridSize, H5P_DEFAULT,
-		                              dsCreationPropList,
-		                              H5P_DEFAULT);
+		double    timing  = timer_startLocal();
+		hid_t     dataSet = local_createDataSet(w, dataVar_getName(var),
+		                                        dt, gridSize, dims);
 		for (int j = 0; j < numPatches; j++) {
 			gridPatch_t patch = gridRegular_getPatchHandle(grid, j);
 			assert(w->fileHandle != H5I_INVALID_HID);
 			local_writeVariableAtPatch(var, patch, dataSet, dt, gridSize);
 		}
-		H5Dclose(dataSet);
+		local_closeDataSet(w, dataSet, timing);
+		H5Tclose(dt);
 	}
 	H5Sclose(gridSize);
 }
@@ -736,39 +1190,168 @@ local_getFileHandle(const gridWriterHDF5_t writer)
 }
 
 static hid_t
-local_getDSCreationPropList(const gridWriterHDF5_t writer)
+local_getDSCreationPropList(const gridWriterHDF5_t  writer,
+                            hid_t                   dt,
+                            hid_t                   space,
+                            const gridPointUint32_t dimsTiled)
 {
 	hid_t rtn = H5P_DEFAULT;
 
 	if (writer->doChunking) {
-		herr_t err;
+		herr_t      err     = 0;
+		H5T_class_t dtClass = H5Tget_class(dt);
+		hsize_t     chunkSize[NDIM], spaceDims[NDIM];
+
+		H5Sget_simple_extent_dims(space, spaceDims, NULL);
+		for (int i = 0; i < NDIM; i++) {
+			chunkSize[i] = writer->chunkSize[i];
+			if (writer->doTileChunking) {
+				// The HDF5 dimensions are reversed.
+				uint32_t d = dimsTiled[NDIM - 1 - i];
+				uint32_t n = writer->chunkNumTiles[NDIM - 1 - i];
+				if (d % n != 0)
+					fprintf(stderr, "WARNING: %u cells cannot be split "
+					        "evenly into %u tiles, chunks and tiles will "
+					        "not align.\n", d, n);
+				chunkSize[i] = (hsize_t)((d + n - 1) / n);
+			}
+			chunkSize[i] = MIN(chunkSize[i], spaceDims[i]);
+		}
+
 		rtn = H5Pcreate(H5P_DATASET_CREATE);
 		assert(rtn >= 0);
 
-		err = H5Pset_chunk(rtn, NDIM, writer->chunkSize);
+		err = H5Pset_chunk(rtn, NDIM, chunkSize);
 		if (err < 0)
 			diediedie(EXIT_FAILURE);
 		err = H5Pset_alloc_time(rtn,H5D_ALLOC_TIME_INCR);
 		if (err < 0)
 			diediedie(EXIT_FAILURE);
 
-		if (writer->doChecksum) {
-			err = H5Pset_filter(rtn, H5Z_FILTER_FLETCHER32,
-			                    H5Z_FLAG_MANDATORY, 0, NULL);
+		// The order in which the filters are added is the order in which
+		// they are applied when writing.
+		if (writer->doScaleOffset && (dtClass == H5T_FLOAT)) {
+			err = H5Pset_scaleoffset(rtn, H5Z_SO_FLOAT_DSCALE,
+			                         writer->scaleOffsetDigits);
+			if (err < 0)
+				diediedie(EXIT_FAILURE);
+		} else if (writer->doScaleOffset && (dtClass == H5T_INTEGER)) {
+			err = H5Pset_scaleoffset(rtn, H5Z_SO_INT,
+			                         H5Z_SO_INT_MINBITS_DEFAULT);
+			if (err < 0)
+				diediedie(EXIT_FAILURE);
+		} else if (writer->doNBit && (dtClass == H5T_FLOAT)) {
+			err = H5Pset_nbit(rtn);
+			if (err < 0)
+				diediedie(EXIT_FAILURE);
+		}
+		if (writer->doShuffle) {
+			err = H5Pset_shuffle(rtn);
 			if (err < 0)
 				diediedie(EXIT_FAILURE);
 		}
 		if (writer->doCompression) {
 			if (writer->compressionFilter == H5Z_FILTER_DEFLATE)
-				H5Pset_deflate(rtn, 9);
+				err = H5Pset_deflate(rtn, (unsigned)writer->deflateLevel);
+			else if (writer->compressionFilter == H5Z_FILTER_SZIP)
+				err = H5Pset_szip(rtn, H5_SZIP_NN_OPTION_MASK, 32);
+			if (err < 0)
+				diediedie(EXIT_FAILURE);
+		}
+		if (writer->doChecksum) {
+			err = H5Pset_filter(rtn, H5Z_FILTER_FLETCHER32,
+			                    H5Z_FLAG_MANDATORY, 0, NULL);
 			if (err < 0)
 				diediedie(EXIT_FAILURE);
 		}
 	}
 
+	return rtn;
+} /* local_getDSCreationPropList */
+
+static hid_t
+local_getFileDatatype(const gridWriterHDF5_t writer, hid_t dt)
+{
+	hid_t  rtn  = H5Tcopy(dt);
+	size_t size = H5Tget_size(dt);
+	size_t spos, epos, esize, mpos, msize;
+
+	if (!writer->doChunking || !writer->doNBit || writer->doScaleOffset
+	    || (H5Tget_class(dt) != H5T_FLOAT))
+		return rtn;
+
+	// Drop the least significant bits of the mantissa, the N-bit filter
+	// will then only store the remaining precision.
+	H5Tget_fields(rtn, &spos, &epos, &esize, &mpos, &msize);
+	if ((size_t)(writer->nbitMantissaBits) < msize) {
+		size_t drop = msize - (size_t)(writer->nbitMantissaBits);
+		if ((H5Tset_fields(rtn, spos, epos, esize, mpos + drop, msize - drop)
+		     < 0)
+		    || (H5Tset_offset(rtn, mpos + drop) < 0)
+		    || (H5Tset_precision(rtn, spos + 1 - (mpos + drop)) < 0)
+		    || (H5Tset_size(rtn, size) < 0))
+			diediedie(EXIT_FAILURE);
+	}
+
 	return rtn;
 }
 
+static hid_t
+local_createDataSet(const gridWriterHDF5_t  writer,
+                    const char              *name,
+                    hid_t                   dt,
+                    hid_t                   space,
+                    const gridPointUint32_t dimsTiled)
+{
+	hid_t dataSet;
+	hid_t dtFile             = local_getFileDatatype(writer, dt);
+	hid_t dsCreationPropList = local_getDSCreationPropList(writer, dtFile,
+	                                                       space, dimsTiled);
+
+	dataSet = H5Dcreate(writer->fileHandle, name, dtFile, space,
+	                    H5P_DEFAULT, dsCreationPropList, H5P_DEFAULT);
+	if (dataSet < 0)
+		diediedie(EXIT_FAILURE);
+
+	if (dsCreationPropList != H5P_DEFAULT)
+		H5Pclose(dsCreationPropList);
+	H5Tclose(dtFile);
+
+	return dataSet;
+}
+
+static void
+local_closeDataSet(gridWriterHDF5_t writer, hid_t dataSet, double timing)
+{
+	hid_t    space    = H5Dget_space(dataSet);
+	hid_t    dt       = H5Dget_type(dataSet);
+	uint64_t bytesRaw = (uint64_t)H5Sget_simple_extent_npoints(space)
+	                    * H5Tget_size(dt);
+	uint64_t bytesStored;
+
+	H5Tclose(dt);
+	H5Sclose(space);
+
+	// Make sure all chunks went through the filters before asking for the
+	// storage size.
+	if (local_hasFilters(writer))
+		H5Fflush(writer->fileHandle, H5F_SCOPE_LOCAL);
+	bytesStored = (uint64_t)H5Dget_storage_size(dataSet);
+	H5Dclose(dataSet);
+
+	writer->bytesRaw       += bytesRaw;
+	writer->bytesStored    += bytesStored;
+	writer->secondsWritten += timer_stopLocal(timing);
+}
+
+static bool
+local_hasFilters(const gridWriterHDF5_t writer)
+{
+	return writer->doChunking
+	       && (writer->doCompression || writer->doShuffle
+	           || writer->doScaleOffset || writer->doNBit);
+}
+
 inline static void
 local_writeVariableAtPatch(dataVar_t   var,
                            gridPatch_t patch,
@@ -835,3 +1418,373 @@ local_checkIfPatchIsCompleteGrid(hid_t space, gridPointUint32_t patchDims)
 
 	return patchIsCompleteGrid ? true : false;
 }
+
+static bool
+local_isSubfiling(const gridWriterHDF5_t writer)
+{
+#ifdef WITH_MPI
+	return (writer->numSubfiles > 0) && !writer->doPatch;
+#else
+	return false;
+#endif
+}
+
+#ifdef WITH_MPI
+static void
+local_writeGridSubfiled(gridWriterHDF5_t writer, gridRegular_t grid)
+{
+	assert(writer->mpiComm != MPI_COMM_NULL);
+
+	if (writer->groupi == NULL) {
+		int size;
+		MPI_Comm_size(writer->mpiComm, &size);
+		writer->groupi = groupi_new(MIN(writer->numSubfiles, size),
+		                            writer->mpiComm, LOCAL_MPI_TAG,
+		                            GROUPI_MODE_BLOCK);
+	}
+
+	local_writeSubfile(writer, grid);
+	local_writeMasterFile(writer, grid);
+	writer->hasSubfiles = true;
+}
+
+static void
+local_writeSubfile(gridWriterHDF5_t writer, gridRegular_t grid)
+{
+	int  rank, aggregator;
+	int  numVars    = gridRegular_getNumVars(grid);
+	int  numPatches = gridRegular_getNumPatches(grid);
+	char *fname;
+
+	MPI_Comm_rank(writer->mpiComm, &rank);
+	// The groups are blocks of consecutive tasks.
+	aggregator = rank - groupi_getRankInGroup(writer->groupi);
+	if (rank != aggregator) {
+		local_sendPatchesToAggregator(writer, grid, aggregator);
+		return;
+	}
+
+	fname = local_getSubfileName(writer,
+	                             groupi_getGroupNumber(writer->groupi),
+	                             true);
+	if (!writer->hasSubfiles) {
+		unsigned flags = H5F_ACC_EXCL;
+		if (gridWriter_getOverwriteFileIfExists((gridWriter_t)writer))
+			flags = H5F_ACC_TRUNC;
+		writer->fileHandle = H5Fcreate(fname, flags, H5P_DEFAULT,
+		                               H5P_DEFAULT);
+	} else {
+		writer->fileHandle = H5Fopen(fname, H5F_ACC_RDWR, H5P_DEFAULT);
+	}
+	if (writer->fileHandle < 0)
+		diediedie(EXIT_FAILURE);
+
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t var = gridRegular_getVarHandle(grid, i);
+		for (int j = 0; j < numPatches; j++) {
+			gridPatch_t       patch = gridRegular_getPatchHandle(grid, j);
+			gridPointUint32_t dims;
+			const void        *data;
+
+			if (gridPatch_getNumCells(patch) == 0)
+				continue;
+			gridPatch_getDims(patch, dims);
+			data = gridPatch_getVarDataHandleByVar(patch, var);
+			local_writeSubfileDataSet(writer, var, rank, j, dims, data);
+		}
+	}
+	for (int i = 1; i < groupi_getSizeOfGroup(writer->groupi); i++)
+		local_recvPatchesIntoSubfile(writer, grid, aggregator + i);
+
+	H5Fclose(writer->fileHandle);
+	writer->fileHandle = H5I_INVALID_HID;
+	xfree(fname);
+} /* local_writeSubfile */
+
+static void
+local_sendPatchesToAggregator(const gridWriterHDF5_t writer,
+                              gridRegular_t          grid,
+                              int                    aggregator)
+{
+	int numVars    = gridRegular_getNumVars(grid);
+	int numPatches = gridRegular_getNumPatches(grid);
+	int numLocal   = 0;
+	int *patches;
+
+	patches = xmalloc(sizeof(int) * LOCAL_SUBFILE_PATCH_SIZE
+	                  * (numPatches > 0 ? numPatches : 1));
+	for (int j = 0; j < numPatches; j++) {
+		gridPatch_t       patch = gridRegular_getPatchHandle(grid, j);
+		int               *p    = patches
+		                          + numLocal * LOCAL_SUBFILE_PATCH_SIZE;
+		gridPointUint32_t dims;
+
+		if (gridPatch_getNumCells(patch) == 0)
+			continue;
+		gridPatch_getDims(patch, dims);
+		p[0] = j;
+		for (int k = 0; k < NDIM; k++)
+			p[1 + k] = (int)(dims[k]);
+		numLocal++;
+	}
+
+	MPI_Send(&numLocal, 1, MPI_INT, aggregator, LOCAL_MPI_TAG,
+	         writer->mpiComm);
+	MPI_Send(patches, numLocal * LOCAL_SUBFILE_PATCH_SIZE, MPI_INT,
+	         aggregator, LOCAL_MPI_TAG, writer->mpiComm);
+
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t    var  = gridRegular_getVarHandle(grid, i);
+		MPI_Datatype type = dataVar_getMPIDatatype(var);
+		for (int j = 0; j < numLocal; j++) {
+			int         idx   = patches[j * LOCAL_SUBFILE_PATCH_SIZE];
+			gridPatch_t patch = gridRegular_getPatchHandle(grid, idx);
+			uint64_t    cells = gridPatch_getNumCells(patch);
+
+			MPI_Send(gridPatch_getVarDataHandleByVar(patch, var),
+			         dataVar_getMPICount(var, cells), type, aggregator,
+			         LOCAL_MPI_TAG, writer->mpiComm);
+		}
+	}
+
+	xfree(patches);
+} /* local_sendPatchesToAggregator */
+
+static void
+local_recvPatchesIntoSubfile(gridWriterHDF5_t writer,
+                             gridRegular_t    grid,
+                             int              source)
+{
+	int numVars = gridRegular_getNumVars(grid);
+	int numRemote;
+	int *patches;
+
+	MPI_Recv(&numRemote, 1, MPI_INT, source, LOCAL_MPI_TAG,
+	         writer->mpiComm, MPI_STATUS_IGNORE);
+	patches = xmalloc(sizeof(int) * LOCAL_SUBFILE_PATCH_SIZE
+	                  * (numRemote > 0 ? numRemote : 1));
+	MPI_Recv(patches, numRemote * LOCAL_SUBFILE_PATCH_SIZE, MPI_INT,
+	         source, LOCAL_MPI_TAG, writer->mpiComm, MPI_STATUS_IGNORE);
+
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t    var  = gridRegular_getVarHandle(grid, i);
+		MPI_Datatype type = dataVar_getMPIDatatype(var);
+		for (int j = 0; j < numRemote; j++) {
+			const int         *p       = patches
+			                             + j * LOCAL_SUBFILE_PATCH_SIZE;
+			uint64_t          numCells = 1;
+			gridPointUint32_t dims;
+			void              *data;
+
+			for (int k = 0; k < NDIM; k++) {
+				dims[k]   = (uint32_t)(p[1 + k]);
+				numCells *= dims[k];
+			}
+			data = dataVar_getMemory(var, numCells);
+			MPI_Recv(data, dataVar_getMPICount(var, numCells), type,
+			         source, LOCAL_MPI_TAG, writer->mpiComm,
+			         MPI_STATUS_IGNORE);
+			local_writeSubfileDataSet(writer, var, source, p[0], dims, data);
+			dataVar_freeMemory(var, data);
+		}
+	}
+
+	xfree(patches);
+} /* local_recvPatchesIntoSubfile */
+
+static void
+local_writeSubfileDataSet(gridWriterHDF5_t        writer,
+                          dataVar_t               var,
+                          int                     owner,
+                          int                     patchNumber,
+                          const gridPointUint32_t dims,
+                          const void              *data)
+{
+	double timing = timer_startLocal();
+	hid_t  dt     = dataVar_getHDF5Datatype(var);
+	hid_t  space  = gridUtilHDF5_getDataSpaceFromDims(dims);
+	hid_t  dataSet;
+	char   *dsName;
+
+	dsName = local_getSubfileDataSetName(dataVar_getName(var), owner,
+	                                     patchNumber);
+	// The variable is written again, the old data is replaced.
+	if (H5Lexists(writer->fileHandle, dsName, H5P_DEFAULT) > 0)
+		H5Ldelete(writer->fileHandle, dsName, H5P_DEFAULT);
+	dataSet = local_createDataSet(writer, dsName, dt, space, dims);
+	H5Dwrite(dataSet, dt, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+	local_closeDataSet(writer, dataSet, timing);
+
+	xfree(dsName);
+	H5Sclose(space);
+	H5Tclose(dt);
+}
+
+static void
+local_writeMasterFile(const gridWriterHDF5_t writer, gridRegular_t grid)
+{
+	int rank, size, numInts, numLocal = 0, numTotal = 0;
+	int numPatches = gridRegular_getNumPatches(grid);
+	int group      = groupi_getGroupNumber(writer->groupi);
+	int *boxes, *allBoxes = NULL, *counts = NULL, *displs = NULL;
+
+	MPI_Comm_rank(writer->mpiComm, &rank);
+	MPI_Comm_size(writer->mpiComm, &size);
+
+	boxes = xmalloc(sizeof(int) * LOCAL_SUBFILE_BOX_SIZE
+	                * (numPatches > 0 ? numPatches : 1));
+	for (int j = 0; j < numPatches; j++) {
+		gridPatch_t       patch = gridRegular_getPatchHandle(grid, j);
+		int               *box  = boxes + numLocal * LOCAL_SUBFILE_BOX_SIZE;
+		gridPointUint32_t idxLo, dims;
+
+		if (gridPatch_getNumCells(patch) == 0)
+			continue;
+		gridPatch_getIdxLo(patch, idxLo);
+		gridPatch_getDims(patch, dims);
+		box[0] = group;
+		box[1] = rank;
+		box[2] = j;
+		for (int k = 0; k < NDIM; k++) {
+			box[3 + k]        = (int)(idxLo[k]);
+			box[3 + NDIM + k] = (int)(dims[k]);
+		}
+		numLocal++;
+	}
+	numInts = numLocal * LOCAL_SUBFILE_BOX_SIZE;
+
+	if (rank == 0) {
+		counts = xmalloc(sizeof(int) * size);
+		displs = xmalloc(sizeof(int) * size);
+	}
+	MPI_Gather(&numInts, 1, MPI_INT, counts, 1, MPI_INT, 0,
+	           writer->mpiComm);
+	if (rank == 0) {
+		for (int i = 0; i < size; i++) {
+			displs[i] = numTotal;
+			numTotal += counts[i];
+		}
+		allBoxes = xmalloc(sizeof(int) * (numTotal > 0 ? numTotal : 1));
+	}
+	MPI_Gatherv(boxes, numInts, MPI_INT, allBoxes, counts, displs, MPI_INT,
+	            0, writer->mpiComm);
+
+	if (rank == 0) {
+		local_writeVirtualDataSets(writer, grid, allBoxes,
+		                           numTotal / LOCAL_SUBFILE_BOX_SIZE);
+		xfree(allBoxes);
+		xfree(displs);
+		xfree(counts);
+	}
+	xfree(boxes);
+
+	// Nobody should try to read the grid before the index is complete.
+	MPI_Barrier(writer->mpiComm);
+} /* local_writeMasterFile */
+
+static void
+local_writeVirtualDataSets(const gridWriterHDF5_t writer,
+                           gridRegular_t          grid,
+                           const int              *boxes,
+                           int                    numBoxes)
+{
+	int               numVars = gridRegular_getNumVars(grid);
+	const char        *fname  = filename_getFullName(writer->base.fileName);
+	gridPointUint32_t dims;
+	hid_t             fileHandle, gridSize;
+
+	if (!writer->hasSubfiles) {
+		unsigned flags = H5F_ACC_EXCL;
+		if (gridWriter_getOverwriteFileIfExists((gridWriter_t)writer))
+			flags = H5F_ACC_TRUNC;
+		fileHandle = H5Fcreate(fname, flags, H5P_DEFAULT, H5P_DEFAULT);
+	} else {
+		fileHandle = H5Fopen(fname, H5F_ACC_RDWR, H5P_DEFAULT);
+	}
+	if (fileHandle < 0)
+		diediedie(EXIT_FAILURE);
+
+	gridRegular_getDims(grid, dims);
+	gridSize = gridUtilHDF5_getDataSpaceFromDims(dims);
+
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t var   = gridRegular_getVarHandle(grid, i);
+		hid_t     dt    = dataVar_getHDF5Datatype(var);
+		hid_t     props = H5Pcreate(H5P_DATASET_CREATE);
+		hid_t     dataSet;
+
+		assert(props >= 0);
+		for (int j = 0; j < numBoxes; j++) {
+			const int         *box = boxes + j * LOCAL_SUBFILE_BOX_SIZE;
+			gridPointUint32_t idxLo, dimsPatch;
+			hid_t             srcSpace, dstSpace;
+			char              *srcFile, *srcName;
+
+			for (int k = 0; k < NDIM; k++) {
+				idxLo[k]     = (uint32_t)(box[3 + k]);
+				dimsPatch[k] = (uint32_t)(box[3 + NDIM + k]);
+			}
+			srcFile  = local_getSubfileName(writer, box[0], false);
+			srcName  = local_getSubfileDataSetName(dataVar_getName(var),
+			                                       box[1], box[2]);
+			srcSpace = gridUtilHDF5_getDataSpaceFromDims(dimsPatch);
+			dstSpace = H5Scopy(gridSize);
+			gridUtilHDF5_selectHyperslab(dstSpace, idxLo, dimsPatch);
+			if (H5Pset_virtual(props, dstSpace, srcFile, srcName,
+			                   srcSpace) < 0)
+				diediedie(EXIT_FAILURE);
+			H5Sclose(dstSpace);
+			H5Sclose(srcSpace);
+			xfree(srcName);
+			xfree(srcFile);
+		}
+		if (H5Lexists(fileHandle, dataVar_getName(var), H5P_DEFAULT) > 0)
+			H5Ldelete(fileHandle, dataVar_getName(var), H5P_DEFAULT);
+		dataSet = H5Dcreate(fileHandle, dataVar_getName(var), dt, gridSize,
+		                    H5P_DEFAULT, props, H5P_DEFAULT);
+		if (dataSet < 0)
+			diediedie(EXIT_FAILURE);
+		H5Dclose(dataSet);
+		H5Pclose(props);
+		H5Tclose(dt);
+	}
+
+	H5Sclose(gridSize);
+	H5Fclose(fileHandle);
+} /* local_writeVirtualDataSets */
+
+static char *
+local_getSubfileName(const gridWriterHDF5_t writer,
+                     int                    groupNumber,
+                     bool                   withPath)
+{
+	filename_t fn        = filename_clone(writer->base.fileName);
+	const char *oldQual  = filename_getQualifier(fn);
+	char       subQual[32];
+	char       *qualifier, *name;
+
+	sprintf(subQual, ".sub%05i", groupNumber);
+	qualifier = xstrmerge(oldQual == NULL ? "" : oldQual, subQual);
+	filename_setQualifier(fn, qualifier);
+	if (!withPath)
+		filename_setPath(fn, NULL);
+	name = xstrdup(filename_getFullName(fn));
+
+	xfree(qualifier);
+	filename_del(&fn);
+
+	return name;
+}
+
+static char *
+local_getSubfileDataSetName(const char *varName, int rank, int patchNumber)
+{
+	size_t len  = strlen(varName) + 32;
+	char   *name = xmalloc(len);
+
+	snprintf(name, len, "%s.%06i.%03i", varName, rank, patchNumber);
+
+	return name;
+}
+
+#endif
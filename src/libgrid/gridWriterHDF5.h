@@ -21,6 +21,7 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridPoint.h"
+#include <stdint.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
@@ -156,6 +157,27 @@ extern void
 gridWriterHDF5_setChunkSize(gridWriterHDF5_t w, gridPointUint32_t chunkSize);
 
 
+/**
+ * @brief  This will align the chunks with a tiling of the grid.
+ *
+ * The chunk size is derived from the dimensions of the grid when the
+ * dataset is written, such that every tile consists of whole chunks.  Use
+ * the number of tiles of the mask (or a multiple of it) with which the
+ * data will later be read tile by tile.  Calling this function will also
+ * activate the chunked writing.
+ *
+ * @param[in]  w
+ *                The writer for which to work with.
+ * @param[in]  numTiles
+ *                The number of tiles in each dimension.
+ *
+ * *@return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_setChunkNumTiles(gridWriterHDF5_t  w,
+                                gridPointUint32_t numTiles);
+
+
 /**
  * @brief  This will activate the checksum calculation.
  *
@@ -201,6 +223,86 @@ gridWriterHDF5_setDoCompression(gridWriterHDF5_t w, bool doCompression);
 extern void
 gridWriterHDF5_setCompressionFilter(gridWriterHDF5_t w,
                                     const char       *filterName);
+
+
+/**
+ * @brief  Sets the level used with the deflate (gzip) filter.
+ *
+ * If no compression is active yet, setting the level activates the
+ * compression with the deflate filter.  An already configured filter is
+ * kept, if it is not deflate the level has no effect and a warning is
+ * printed.  For noisy floating point data, levels above 1 are much slower
+ * and hardly improve the compression; use the shuffle filter instead.
+ *
+ * @param[in]  w
+ *                The writer for which to work with.
+ * @param[in]  deflateLevel
+ *                The level, must be between 0 and 9.  The default is 1.
+ *
+ * *@return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_setDeflateLevel(gridWriterHDF5_t w, int deflateLevel);
+
+
+/**
+ * @brief  This will activate the byte shuffle filter.
+ *
+ * The shuffle filter is applied before the compression and is what makes
+ * floating point data compressible.
+ *
+ * @param[in]  w
+ *                The writer for which to work with.
+ * @param[in]  doShuffle
+ *                Toggles the shuffle filter.
+ *
+ * *@return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_setDoShuffle(gridWriterHDF5_t w, bool doShuffle);
+
+
+/**
+ * @brief  This will activate the lossy scale-offset filter.
+ *
+ * Floating point data are stored with @c decimalDigits digits after the
+ * decimal point, integer data are stored losslessly with the minimal
+ * number of bits.
+ *
+ * @param[in]  w
+ *                The writer for which to work with.
+ * @param[in]  doScaleOffset
+ *                Toggles the scale-offset filter.
+ * @param[in]  decimalDigits
+ *                The number of decimal digits to keep for floating point
+ *                data.
+ *
+ * *@return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_setScaleOffset(gridWriterHDF5_t w,
+                              bool             doScaleOffset,
+                              int              decimalDigits);
+
+
+/**
+ * @brief  This will activate the N-bit filter.
+ *
+ * Floating point data are stored with only @c mantissaBits bits of the
+ * mantissa, the sign and exponent are kept.  Integer data are not
+ * affected.  The N-bit filter is ignored if scale-offset is active.
+ *
+ * @param[in]  w
+ *                The writer for which to work with.
+ * @param[in]  doNBit
+ *                Toggles the N-bit filter.
+ * @param[in]  mantissaBits
+ *                The number of mantissa bits to keep.
+ *
+ * *@return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_setNBit(gridWriterHDF5_t w, bool doNBit, int mantissaBits);
                                     
 
 /**
@@ -233,6 +335,70 @@ extern void
 gridWriterHDF5_setRtw(gridWriterHDF5_t w, int32_t *Lo, gridPointUint32_t d);
 
 
+/**
+ * @brief  Writes the grid into a number of subfiles indexed by a master
+ *         file instead of into one shared file.
+ *
+ * The tasks are split into @c numSubfiles blocks of consecutive tasks.
+ * The first task of each block aggregates the patches of its block: it
+ * receives them one after the other and writes them into the subfile of
+ * the block with the serial HDF5 driver, hence only that task opens the
+ * subfile.  The master file (the file name of the writer) then exposes
+ * every variable as one virtual dataset covering the whole grid.  The
+ * subfiles are referenced relative to the master file and must be kept
+ * in the same directory.  Writing a variable again replaces it.
+ *
+ * This only has an effect for MPI runs and is ignored when writing only a
+ * patch (see gridWriterHDF5_setDoPatch()).
+ *
+ * @param[in,out]  w
+ *                    The writer for which to set the number of subfiles.
+ * @param[in]      numSubfiles
+ *                    The number of subfiles, 0 selects the default of
+ *                    writing one shared file collectively.  If it exceeds
+ *                    the number of tasks, each task writes its own
+ *                    subfile.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_setNumSubfiles(gridWriterHDF5_t w, int numSubfiles);
+
+
+/** @} */
+
+
+/**
+ * @name  Getting (Public, Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Retrieves the amount of data written so far.
+ *
+ * The numbers are summed over all datasets this task has written.  The
+ * writer does not report them itself, this is left to the application.
+ *
+ * @param[in]   w
+ *                 The writer to query.
+ * @param[out]  bytesRaw
+ *                 Will receive the number of uncompressed bytes written.
+ * @param[out]  bytesStored
+ *                 Will receive the number of bytes the datasets occupy in
+ *                 the file.
+ * @param[out]  secondsWritten
+ *                 Will receive the time spent writing.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterHDF5_getWriteStats(const gridWriterHDF5_t w,
+                             uint64_t               *bytesRaw,
+                             uint64_t               *bytesStored,
+                             double                 *secondsWritten);
+
+
 /** @} */
 
 
@@ -247,7 +413,31 @@ gridWriterHDF5_setRtw(gridWriterHDF5_t w, int32_t *Lo, gridPointUint32_t d);
  *
  * @code
  * [SectionName]
+ * doChunking = true
+ * chunkSize = 64 64 64
+ * # Alternatively, align the chunks with the tiles of a mask.
+ * chunkNumTiles = 8 8 8
+ * # Optional, all filters require chunking.
+ * doChecksum = false
+ * doCompression = true
+ * filterName = gzip
+ * deflateLevel = 1
+ * doShuffle = true
+ * doScaleOffset = false
+ * scaleOffsetDigits = 3
+ * doNBit = false
+ * nbitMantissaBits = 12
+ * # Optional, only for MPI runs.
+ * numSubfiles = 16
  * @endcode
+ *
+ * Filters are applied in the order scale-offset or N-bit, shuffle,
+ * compression and checksum.  In parallel runs all filters are disabled.
+ *
+ * With @c numSubfiles the grid is written to that many subfiles named
+ * like the output file with an additional qualifier @c .subXXXXX and the
+ * output file itself only holds virtual datasets mapping onto them, see
+ * gridWriterHDF5_setNumSubfiles().
  */
 
 
@@ -19,9 +19,11 @@
 #include "gridConfig.h"
 #include "gridWriter_adt.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <hdf5.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
+#  include "../libutil/groupi.h"
 #endif
 
 
@@ -36,17 +38,45 @@ struct gridWriterHDF5_struct {
 #ifdef WITH_MPI
 	/** @brief  The MPI communicator to be used. */
 	MPI_Comm mpiComm;
+	/** @brief  The number of subfiles, 0 writes one shared file. */
+	int      numSubfiles;
+	/** @brief  Distributes the tasks onto the subfiles. */
+	groupi_t groupi;
+	/** @brief  Flags whether the subfiles have been created. */
+	bool     hasSubfiles;
 #endif
 	/** @brief  Toggles the writing of chunked data. */
 	bool         doChunking;
 	/** @brief  Gives the chunk size. */
 	hsize_t      chunkSize[NDIM];
+	/** @brief  Toggles deriving the chunk size from a tiling of the grid. */
+	bool         doTileChunking;
+	/** @brief  Gives the number of tiles per dimension for the chunking. */
+	gridPointUint32_t chunkNumTiles;
 	/** @brief  Toggles the checksum calcluation (requires chunking). */
 	bool         doChecksum;
 	/** @brief  Toggles the compression (requires chunking). */
 	bool         doCompression;
 	/** @brief  Selects the compression filter. */
 	H5Z_filter_t compressionFilter;
+	/** @brief  The level used with the deflate filter. */
+	int          deflateLevel;
+	/** @brief  Toggles the byte shuffle filter (requires chunking). */
+	bool         doShuffle;
+	/** @brief  Toggles the lossy scale-offset filter. */
+	bool         doScaleOffset;
+	/** @brief  The number of decimal digits kept by scale-offset. */
+	int          scaleOffsetDigits;
+	/** @brief  Toggles the N-bit filter for floating point data. */
+	bool         doNBit;
+	/** @brief  The number of mantissa bits kept by the N-bit filter. */
+	int          nbitMantissaBits;
+	/** @brief  The total number of bytes handed to the library. */
+	uint64_t     bytesRaw;
+	/** @brief  The total number of bytes stored in the file. */
+	uint64_t     bytesStored;
+	/** @brief  The total time spent in writing datasets. */
+	double       secondsWritten;
 	/** @brief	Toggles region to write patch. */
 	bool		 doPatch;
 	/** @brief	Gives region to write idxLo. */
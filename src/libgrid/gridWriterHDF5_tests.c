@@ -19,12 +19,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <hdf5.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
-#endif
+#include "../libutil/xmem.h"
 #include "gridRegular.h"
 #include "gridRegularDistrib.h"
 #include "gridPatch.h"
@@ -45,6 +44,9 @@ local_getFakeGrid(void);
 static void
 local_fillPatchWithIdxOfCells(gridPatch_t patch, gridPointUint32_t dimsGrid);
 
+static bool
+local_checkFileHasIdxOfCells(const char *fname, uint64_t numCells);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern bool
@@ -173,6 +175,236 @@ gridWriterHDF5_writeGridRegular_test(void)
 	return hasPassed ? true : false;
 } /* gridWriterHDF5_writeGridRegular_test */
 
+extern bool
+gridWriterHDF5_setFilters_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridWriterHDF5_t  writer;
+	gridPointUint32_t chunkSize = { 4, 4, 2 };
+	gridRegular_t     grid;
+	filename_t        fn;
+	uint64_t          bytesRaw, bytesStored;
+	double            seconds;
+	const char        *names[3] = { "outGridShuffle", "outGridScaleOffset",
+		                            "outGridNBit" };
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid = local_getFakeGrid();
+
+	for (int i = 0; i < 3; i++) {
+		writer = gridWriterHDF5_new();
+		fn     = filename_newFull(NULL, names[i], NULL, ".h5");
+		gridWriter_setFileName((gridWriter_t)writer, fn);
+		gridWriter_setOverwriteFileIfExists((gridWriter_t)writer, true);
+		gridWriterHDF5_setChunkSize(writer, chunkSize);
+		gridWriterHDF5_setDoShuffle(writer, true);
+		gridWriterHDF5_setDeflateLevel(writer, 1);
+		if (i == 1)
+			gridWriterHDF5_setScaleOffset(writer, true, 0);
+		if (i == 2)
+			gridWriterHDF5_setNBit(writer, true, 12);
+#ifdef WITH_MPI
+		gridWriterHDF5_initParallel((gridWriter_t)writer, MPI_COMM_WORLD);
+#endif
+		gridWriterHDF5_activate((gridWriter_t)writer);
+		gridWriterHDF5_writeGridRegular((gridWriter_t)writer, grid);
+		gridWriterHDF5_deactivate((gridWriter_t)writer);
+
+		gridWriterHDF5_getWriteStats(writer, &bytesRaw, &bytesStored,
+		                             &seconds);
+		if (bytesRaw != 4 * 8 * 16 * sizeof(double))
+			hasPassed = false;
+#ifndef WITH_MPI
+		// The cell indices are smooth and compress well.
+		if (bytesStored >= bytesRaw)
+			hasPassed = false;
+		// With 0 digits or 12 bits of mantissa the indices are exact.
+		if (!local_checkFileHasIdxOfCells(
+		        filename_getFullName(((gridWriter_t)writer)->fileName),
+		        4 * 8 * 16))
+			hasPassed = false;
+#endif
+		gridWriterHDF5_del((gridWriter_t *)&writer);
+	}
+
+#ifndef WITH_MPI
+	// The deflate level must not replace an explicitly configured filter.
+	writer = gridWriterHDF5_new();
+	gridWriterHDF5_setDeflateLevel(writer, 3);
+	if (!writer->doCompression
+	    || (writer->compressionFilter != H5Z_FILTER_DEFLATE)
+	    || (writer->deflateLevel != 3))
+		hasPassed = false;
+	if (H5Zfilter_avail(H5Z_FILTER_SZIP) > 0) {
+		gridWriterHDF5_setCompressionFilter(writer, "szip");
+		gridWriterHDF5_setDeflateLevel(writer, 1);
+		if (writer->compressionFilter != H5Z_FILTER_SZIP)
+			hasPassed = false;
+	}
+	gridWriterHDF5_del((gridWriter_t *)&writer);
+#endif
+
+	gridRegular_del(&grid);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridWriterHDF5_setFilters_test */
+
+extern bool
+gridWriterHDF5_setChunkNumTiles_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridWriterHDF5_t  writer;
+	gridPointUint32_t numTiles  = { 2, 2, 4 };
+	gridRegular_t     grid;
+	filename_t        fn;
+	hid_t             file, dataSet, props;
+	hsize_t           chunkSize[NDIM];
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid   = local_getFakeGrid();
+
+	writer = gridWriterHDF5_new();
+	fn     = filename_newFull(NULL, "outGridChunkTiles", NULL, ".h5");
+	gridWriter_setFileName((gridWriter_t)writer, fn);
+	gridWriter_setOverwriteFileIfExists((gridWriter_t)writer, true);
+	gridWriterHDF5_setChunkNumTiles(writer, numTiles);
+#ifdef WITH_MPI
+	gridWriterHDF5_initParallel((gridWriter_t)writer, MPI_COMM_WORLD);
+#endif
+	gridWriterHDF5_activate((gridWriter_t)writer);
+	gridWriterHDF5_writeGridRegular((gridWriter_t)writer, grid);
+	gridWriterHDF5_deactivate((gridWriter_t)writer);
+
+	if (rank == 0) {
+		file    = H5Fopen(filename_getFullName(fn), H5F_ACC_RDONLY,
+		                  H5P_DEFAULT);
+		dataSet = H5Dopen(file, "FakeVar", H5P_DEFAULT);
+		props   = H5Dget_create_plist(dataSet);
+		// The grid is 4 x 8 x 16, the dimensions in the file are reversed.
+		if ((H5Pget_chunk(props, NDIM, chunkSize) != NDIM)
+		    || (chunkSize[0] != 4) || (chunkSize[1] != 4)
+		    || (chunkSize[2] != 2))
+			hasPassed = false;
+		H5Pclose(props);
+		H5Dclose(dataSet);
+		H5Fclose(file);
+	}
+	gridWriterHDF5_del((gridWriter_t *)&writer);
+
+	gridRegular_del(&grid);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridWriterHDF5_setChunkNumTiles_test */
+
+extern bool
+gridWriterHDF5_setNumSubfiles_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridWriterHDF5_t writer;
+	gridRegular_t    grid;
+	filename_t       fn;
+	hid_t            file, dataSet, props;
+	H5D_layout_t     layout;
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid   = local_getFakeGrid();
+
+	writer = gridWriterHDF5_new();
+	fn     = filename_newFull(NULL, "outGridSubfiles", NULL, ".h5");
+	gridWriter_setFileName((gridWriter_t)writer, fn);
+	gridWriter_setOverwriteFileIfExists((gridWriter_t)writer, true);
+	gridWriterHDF5_setNumSubfiles(writer, 2);
+#ifdef WITH_MPI
+	gridWriterHDF5_initParallel((gridWriter_t)writer, MPI_COMM_WORLD);
+#endif
+	gridWriterHDF5_activate((gridWriter_t)writer);
+	gridWriterHDF5_writeGridRegular((gridWriter_t)writer, grid);
+#ifdef WITH_MPI
+	// Writing the variable again must replace it.
+	gridWriterHDF5_writeGridRegular((gridWriter_t)writer, grid);
+#endif
+	gridWriterHDF5_deactivate((gridWriter_t)writer);
+
+	if (rank == 0) {
+		if (!local_checkFileHasIdxOfCells(filename_getFullName(fn),
+		                                  4 * 8 * 16))
+			hasPassed = false;
+		file    = H5Fopen(filename_getFullName(fn), H5F_ACC_RDONLY,
+		                  H5P_DEFAULT);
+		dataSet = H5Dopen(file, "FakeVar", H5P_DEFAULT);
+		props   = H5Dget_create_plist(dataSet);
+		layout  = H5Pget_layout(props);
+#ifdef WITH_MPI
+		if (layout != H5D_VIRTUAL)
+			hasPassed = false;
+#else
+		// Without MPI there is only one file.
+		if (layout == H5D_VIRTUAL)
+			hasPassed = false;
+#endif
+		H5Pclose(props);
+		H5Dclose(dataSet);
+		H5Fclose(file);
+	}
+
+	// The next output of the same writer goes to new files.
+	fn = filename_newFull(NULL, "outGridSubfilesNext", NULL, ".h5");
+	gridWriter_overlayFileName((gridWriter_t)writer, fn);
+	filename_del(&fn);
+	gridWriter_activate((gridWriter_t)writer);
+	gridWriterHDF5_writeGridRegular((gridWriter_t)writer, grid);
+	gridWriter_deactivate((gridWriter_t)writer);
+	if (rank == 0) {
+		if (!local_checkFileHasIdxOfCells("outGridSubfilesNext.h5",
+		                                  4 * 8 * 16))
+			hasPassed = false;
+	}
+	gridWriterHDF5_del((gridWriter_t *)&writer);
+
+	gridRegular_del(&grid);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridWriterHDF5_setNumSubfiles_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridRegular_t
 local_getFakeGrid(void)
@@ -233,3 +465,26 @@ local_fillPatchWithIdxOfCells(gridPatch_t patch, gridPointUint32_t dimsGrid)
 		}
 	}
 }
+
+static bool
+local_checkFileHasIdxOfCells(const char *fname, uint64_t numCells)
+{
+	bool   hasPassed = true;
+	double *data     = xmalloc(sizeof(double) * numCells);
+	hid_t  file      = H5Fopen(fname, H5F_ACC_RDONLY, H5P_DEFAULT);
+	hid_t  dataSet   = H5Dopen(file, "FakeVar", H5P_DEFAULT);
+
+	if (H5Dread(dataSet, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+	            data) < 0)
+		hasPassed = false;
+	for (uint64_t i = 0; hasPassed && i < numCells; i++) {
+		if (data[i] != (double)i)
+			hasPassed = false;
+	}
+
+	H5Dclose(dataSet);
+	H5Fclose(file);
+	xfree(data);
+
+	return hasPassed ? true : false;
+}
@@ -30,5 +30,14 @@ gridWriterHDF5_del_test(void);
 extern bool
 gridWriterHDF5_writeGridRegular_test(void);
 
+extern bool
+gridWriterHDF5_setFilters_test(void);
+
+extern bool
+gridWriterHDF5_setChunkNumTiles_test(void);
+
+extern bool
+gridWriterHDF5_setNumSubfiles_test(void);
+
 
 #endif
@@ -27,6 +27,8 @@
 #include "gridPatch.h"
 #include "gridRegular.h"
 #include "gridPoint.h"
+#include "gridStatistics.h"
+#include "gridHistogram.h"
 #include "../libutil/filename.h"
 
 
@@ -124,6 +126,12 @@ struct gridWriter_struct {
 	bool              overwriteFileIfExists;
 	/** @brief  Holds the file name object for the file. */
 	filename_t        fileName;
+	/** @brief  Accumulates the statistics of the data written, may be NULL. */
+	gridStatistics_t  stat;
+	/** @brief  Accumulates the histogram of the data written, may be NULL. */
+	gridHistogram_t   histo;
+	/** @brief  The index of the variable that is summarized. */
+	int               idxOfSummaryVar;
 };
 
 
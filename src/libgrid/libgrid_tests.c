@@ -11,10 +11,12 @@
 #include "gridUtil_tests.h"
 #include "gridHistogram_tests.h"
 #include "gridStatistics_tests.h"
+#include "gridSummary_tests.h"
 #include "gridIO_tests.h"
 #include "gridReaderFactory_tests.h"
 #include "gridReader_tests.h"
 #include "gridReaderBov_tests.h"
+#include "gridReaderBrick_tests.h"
 #ifdef WITH_HDF5
 #  include "gridWriterHDF5_tests.h"
 #  include "gridReaderHDF5_tests.h"
@@ -183,6 +185,7 @@ main(int argc, char **argv)
 #ifdef WITH_MPI
 	RUNTEST(&gridHistogram_calcGridRegularDistrib_test, hasFailed);
 #endif
+	RUNTEST(&gridHistogram_addGridPatch_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -196,9 +199,23 @@ main(int argc, char **argv)
 	RUNTEST(&gridStatistics_del_test, hasFailed);
 	RUNTEST(&gridStatistics_calcGridPatch_test, hasFailed);
 	RUNTEST(&gridStatistics_calcGridRegular_test, hasFailed);
+	RUNTEST(&gridStatistics_addValues_test, hasFailed);
 #ifdef WITH_MPI
 	RUNTEST(&gridStatistics_calcGridRegularDistrib_test, hasFailed);
 #endif
+#ifdef XMEM_TRACK_MEM
+	if (rank == 0)
+		xmem_info(stdout);
+	global_max_allocated_bytes = 0;
+#endif
+
+	if (rank == 0) {
+		printf("\nRunning tests for gridSummary:\n");
+	}
+	RUNTEST(&gridSummary_calcGridPatch_test, hasFailed);
+#ifdef WITH_MPI
+	RUNTEST(&gridSummary_calcGridRegularDistrib_test, hasFailed);
+#endif
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -233,6 +250,7 @@ main(int argc, char **argv)
 	RUNTEST(&gridReader_setFileName_test, hasFailed);
 	RUNTEST(&gridReader_overlayFileName_test, hasFailed);
 	RUNTEST(&gridReader_getFileName_test, hasFailed);
+	RUNTEST(&gridReader_getType_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -247,6 +265,19 @@ main(int argc, char **argv)
 	RUNTEST(&gridReaderBov_getBov_test, hasFailed);
 	RUNTEST(&gridReaderBov_readIntoPatch_test, hasFailed);
 	RUNTEST(&gridReaderBov_readIntoPatchForVar_test, hasFailed);
+	RUNTEST(&gridReaderBov_calcSummary_test, hasFailed);
+#ifdef XMEM_TRACK_MEM
+	if (rank == 0)
+		xmem_info(stdout);
+	global_max_allocated_bytes = 0;
+#endif
+
+	if (rank == 0) {
+		printf("\nRunning tests for gridReaderBrick:\n");
+	}
+	RUNTEST(&gridReaderBrick_new_test, hasFailed);
+	RUNTEST(&gridReaderBrick_del_test, hasFailed);
+	RUNTEST(&gridReaderBrick_readIntoPatch_test, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -267,6 +298,9 @@ main(int argc, char **argv)
 	//RUNTEST(&gridWriterHDF5_deactivate_test, hasFailed);
 	//RUNTEST(&gridWriterHDF5_writeGridPatch_test, hasFailed);
 	RUNTEST(&gridWriterHDF5_writeGridRegular_test, hasFailed);
+	RUNTEST(&gridWriterHDF5_setFilters_test, hasFailed);
+	RUNTEST(&gridWriterHDF5_setChunkNumTiles_test, hasFailed);
+	RUNTEST(&gridWriterHDF5_setNumSubfiles_test, hasFailed);
 #  ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -281,6 +315,8 @@ main(int argc, char **argv)
 	RUNTEST(&gridReaderHDF5_getH5File_test, hasFailed);
 	RUNTEST(&gridReaderHDF5_readIntoPatch_test, hasFailed);
 	RUNTEST(&gridReaderHDF5_readIntoPatchForVar_test, hasFailed);
+	RUNTEST(&gridReaderHDF5_readIntoPatchForVarPeriodic_test, hasFailed);
+	RUNTEST(&gridReaderHDF5_setChunkCache_test, hasFailed);
 #  ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -12,6 +12,14 @@
  */
 
 
+/*--- Feature test macros -----------------------------------------------*/
+// mmap() and posix_madvise() are XSI, this must be set before any system
+// header is included.
+#ifndef _XOPEN_SOURCE
+#  define _XOPEN_SOURCE 600
+#endif
+
+
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "bov.h"
@@ -19,6 +27,17 @@
 #include <string.h>
 #include <ctype.h>
 #include <inttypes.h>
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+#  include <errno.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#endif
+#ifdef WITH_OPENMP
+#  include <omp.h>
+#endif
 #include "endian.h"
 #include "xmem.h"
 #include "xstring.h"
@@ -273,6 +292,41 @@ local_readWindowedActualRead(bov_t       bov,
                              uint32_t    *dims);
 
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+
+/**
+ * @brief  Reads a window of the data through a memory mapping of the data
+ *         file.
+ *
+ * Only the part of the file covering the window is mapped.  The rows of
+ * the window are copied in parallel directly from the mapping into the
+ * data array, byteswapping and type conversion happen on the fly.
+ *
+ * @param[in]   bov
+ *                 The object from which to read.
+ * @param[out]  *data
+ *                 The array into which to read.
+ * @param[in]   dataFormat
+ *                 The format of the data array.
+ * @param[in]   numComponents
+ *                 The number of components of the data array.
+ * @param[in]   *idxLo
+ *                 The lower corner of the window.
+ * @param[in]   *dims
+ *                 The size of the window.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_readWindowedMmap(bov_t          bov,
+                       void           *data,
+                       bovFormat_t    dataFormat,
+                       int            numComponents,
+                       const uint32_t *idxLo,
+                       const uint32_t *dims);
+
+#endif
+
 /**
  * @brief  Gets the size in bytes for the given format.
  *
@@ -286,6 +340,22 @@ static size_t
 local_getSizeForFormat(bovFormat_t format);
 
 
+/**
+ * @brief  Swaps the byte order of all elements in a buffer.
+ *
+ * @param[in]      bov
+ *                    The bov file object describing the elements.
+ * @param[in,out]  *buffer
+ *                    The buffer to work on.
+ * @param[in]      numElements
+ *                    The number of elements in the buffer.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_byteswapBuffer(const bov_t bov, void *buffer, size_t numElements);
+
+
 /**
  * @brief  Reads a pencil from the data file into a buffer.
  *
@@ -419,6 +489,7 @@ bov_new(void)
 	bov->byte_offset     = 0;
 	bov->divide_brick    = false;
 	bov->data_components = 1;
+	bov->useMmap         = false;
 
 	return bov;
 }
@@ -657,6 +728,26 @@ bov_setDataComponents(bov_t bov, const int numComponents)
 	bov->data_components = numComponents;
 }
 
+extern void
+bov_setUseMmap(bov_t bov, const bool useMmap)
+{
+	assert(bov != NULL);
+
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	bov->useMmap = useMmap;
+#else
+	bov->useMmap = false;
+#endif
+}
+
+extern bool
+bov_getUseMmap(const bov_t bov)
+{
+	assert(bov != NULL);
+
+	return bov->useMmap;
+}
+
 extern void
 bov_read(bov_t       bov,
          void        *data,
@@ -671,6 +762,15 @@ bov_read(bov_t       bov,
 	assert(data != NULL);
 	assert(numComponents > 0);
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	if (bov->useMmap) {
+		const uint32_t idxLo[3] = {0, 0, 0};
+		local_readWindowedMmap(bov, data, dataFormat, numComponents,
+		                       idxLo, bov->data_size);
+		return;
+	}
+#endif
+
 	numElements = bov->data_size[0] * bov->data_size[1] * bov->data_size[2];
 	fileName    = bov_getDataFileName(bov);
 	f           = xfopen(fileName, "rb");
@@ -710,6 +810,13 @@ bov_readWindowed(bov_t       bov,
 		diediedie(EXIT_FAILURE);
 	}
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	if (bov->useMmap) {
+		local_readWindowedMmap(bov, data, dataFormat, numComponents,
+		                       idxLo, dims);
+		return;
+	}
+#endif
 	local_readWindowedActualRead(bov, data, dataFormat, numComponents,
 	                             idxLo, dims);
 }
@@ -1101,6 +1208,111 @@ local_readWindowedActualRead(bov_t       bov,
 	xfree(dataFileName);
 } /* local_readWindowedActualRead */
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+static void
+local_readWindowedMmap(bov_t          bov,
+                       void           *data,
+                       bovFormat_t    dataFormat,
+                       int            numComponents,
+                       const uint32_t *idxLo,
+                       const uint32_t *dims)
+{
+	char        *dataFileName = bov_getDataFileName(bov);
+	size_t      recBuffer     = local_getSizeForFormat(bov->data_format)
+	                            * bov->data_components;
+	size_t      numRows       = (size_t)(dims[1]) * dims[2];
+	bool        doSwap        = bov->machineEndianess != bov->data_endian;
+	int         numThreads    = 1;
+	char        *buffer       = NULL;
+	off_t       offsetFirst, offsetEnd, mapStart;
+	size_t      mapLength;
+	struct stat fileStat;
+	void        *map;
+	int         fd;
+
+	offsetFirst = bov->byte_offset
+	              + (off_t)recBuffer
+	              * (idxLo[0] + ((off_t)(idxLo[1])
+	                             + (off_t)(idxLo[2]) * bov->data_size[1])
+	                 * bov->data_size[0]);
+	offsetEnd   = bov->byte_offset
+	              + (off_t)recBuffer
+	              * (idxLo[0] + dims[0]
+	                 + ((off_t)(idxLo[1] + dims[1] - 1)
+	                    + (off_t)(idxLo[2] + dims[2] - 1)
+	                    * bov->data_size[1]) * bov->data_size[0]);
+	mapStart    = offsetFirst - offsetFirst % sysconf(_SC_PAGESIZE);
+	mapLength   = (size_t)(offsetEnd - mapStart);
+
+	fd          = open(dataFileName, O_RDONLY);
+	if ((fd == -1) || (fstat(fd, &fileStat) != 0)) {
+		fprintf(stderr, "Could not open %s: %s\n",
+		        dataFileName, strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+	if (fileStat.st_size < offsetEnd) {
+		fprintf(stderr, "%s is too small for the data described by %s\n",
+		        dataFileName, bov->bovFileName);
+		diediedie(EXIT_FAILURE);
+	}
+	map = mmap(NULL, mapLength, PROT_READ, MAP_PRIVATE, fd, mapStart);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "Could not map %s: %s\n",
+		        dataFileName, strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+	close(fd);
+	// Every thread walks through its rows in file order.
+	posix_madvise(map, mapLength, POSIX_MADV_SEQUENTIAL);
+
+#ifdef WITH_OPENMP
+	numThreads = omp_get_max_threads();
+#endif
+	if (doSwap)
+		buffer = xmalloc(recBuffer * dims[0] * numThreads);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+	for (size_t r = 0; r < numRows; r++) {
+		size_t     j          = idxLo[1] + r % dims[1];
+		size_t     k          = idxLo[2] + r / dims[1];
+		off_t      offset     = bov->byte_offset
+		                        + (off_t)recBuffer
+		                        * (idxLo[0] + (j + k * bov->data_size[1])
+		                           * (off_t)(bov->data_size[0]));
+		const char *row       = (const char *)map + (offset - mapStart);
+		size_t     dataOffset = r * dims[0];
+
+		if (doSwap) {
+			int  tid = 0;
+			char *rowSwap;
+#ifdef WITH_OPENMP
+			tid = omp_get_thread_num();
+#endif
+			rowSwap = buffer + recBuffer * dims[0] * tid;
+			memcpy(rowSwap, row, recBuffer * dims[0]);
+			local_byteswapBuffer(bov, rowSwap, (size_t)(dims[0]));
+			row = rowSwap;
+		}
+		if (dataFormat == bov->data_format)
+			local_mvBufferToData(bov, row, (size_t)(dims[0]),
+			                     data, dataOffset, dataFormat,
+			                     numComponents);
+		else
+			local_cpBufferToData(bov, row, (size_t)(dims[0]),
+			                     data, dataOffset, dataFormat,
+			                     numComponents);
+	}
+
+	if (buffer != NULL)
+		xfree(buffer);
+	munmap(map, mapLength);
+	xfree(dataFileName);
+} /* local_readWindowedMmap */
+
+#endif
+
 static size_t
 local_getSizeForFormat(bovFormat_t format)
 {
@@ -1128,10 +1340,16 @@ local_readPencil(const bov_t bov,
 
 	xfread(buffer, sizePerEle * bov->data_components, numElements, f);
 
-	if (bov->machineEndianess != bov->data_endian) {
-		for (size_t i = 0; i < bov->data_components * numElements; i++)
-			byteswap(((char *)buffer) + (i * sizePerEle), sizePerEle);
-	}
+	if (bov->machineEndianess != bov->data_endian)
+		local_byteswapBuffer(bov, buffer, numElements);
+}
+
+static void
+local_byteswapBuffer(const bov_t bov, void *buffer, size_t numElements)
+{
+	size_t sizePerEle = local_getSizeForFormat(bov->data_format);
+
+	byteswapArray(buffer, sizePerEle, bov->data_components * numElements);
 }
 
 static void
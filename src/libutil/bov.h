@@ -402,6 +402,37 @@ bov_setBrickSize(bov_t bov, const double *brickSize);
 extern void
 bov_setDataComponents(bov_t bov, const int numComponents);
 
+/**
+ * @brief  Selects whether the data file is read through a memory mapping.
+ *
+ * With a memory mapping the requested data is copied (and converted, if
+ * required) directly from the mapped file into the target array instead
+ * of being read into a temporary buffer first.  This is only available
+ * on systems conforming to XSI (_XOPEN_SOURCE >= 600), otherwise the
+ * setting is ignored, see bov_getUseMmap().
+ *
+ * @param[in,out]  bov
+ *                    The object to update.
+ * @param[in]      useMmap
+ *                    Whether to use a memory mapping.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bov_setUseMmap(bov_t bov, const bool useMmap);
+
+/**
+ * @brief  Tells whether the data file is read through a memory mapping.
+ *
+ * @param[in]  bov
+ *                The object to query.
+ *
+ * @return  Returns @c true if reads go through a memory mapping, this is
+ *          always @c false without XSI support.
+ */
+extern bool
+bov_getUseMmap(const bov_t bov);
+
 
 /** @} */
 
@@ -36,6 +36,8 @@ struct bov_struct {
 	char     *bovFilePath;
 	/** @brief The endianess of the machine. */
 	endian_t machineEndianess;
+	/** @brief Toggles reading the data through a memory mapping. */
+	bool     useMmap;
 	//
 	// Required BOV entries
 	//
@@ -897,4 +897,67 @@ bov_readWindowed_test(void)
 	return hasPassed ? true : false;
 } /* bov_readWindowed_test */
 
+extern bool
+bov_readWindowedMmap_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	bov_t       bov;
+	uint32_t    idxLo[3]  = {1, 2, 3};
+	uint32_t    dims[3]   = {6, 5, 4};
+	size_t      numElements;
+	bovFormat_t formats[2]    = {BOV_FORMAT_DOUBLE, BOV_FORMAT_FLOAT};
+	int         components[2] = {2, 1};
+	endian_t    endians[2]    = {ENDIAN_BIG, ENDIAN_LITTLE};
+#ifdef XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	bov         = bov_newFromFile("tests/test_1.bov");
+	numElements = dims[0] * dims[1] * dims[2];
+
+	// Reading through the mapping must give exactly what the buffered
+	// reading gives, with and without byteswapping and conversion.
+	for (int e = 0; e < 2; e++) {
+		bov_setDataEndian(bov, endians[e]);
+		for (int f = 0; f < 2; f++) {
+			for (int c = 0; c < 2; c++) {
+				size_t bytes = sizeof(double) * components[c] * numElements;
+				char   *dataBuffered = xmalloc(bytes);
+				char   *dataMapped   = xmalloc(bytes);
+
+				memset(dataBuffered, 0, bytes);
+				memset(dataMapped, 0, bytes);
+				bov_setUseMmap(bov, false);
+				bov_readWindowed(bov, dataBuffered, formats[f],
+				                 components[c], idxLo, dims);
+				bov_setUseMmap(bov, true);
+				// Otherwise the buffered reading is compared to itself.
+				if (!bov_getUseMmap(bov))
+					hasPassed = false;
+				bov_readWindowed(bov, dataMapped, formats[f],
+				                 components[c], idxLo, dims);
+				if (memcmp(dataBuffered, dataMapped, bytes) != 0)
+					hasPassed = false;
+				xfree(dataMapped);
+				xfree(dataBuffered);
+			}
+		}
+	}
+
+	bov_del(&bov);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* bov_readWindowedMmap_test */
+
 /*--- Implementations of local functions --------------------------------*/
@@ -87,5 +87,8 @@ bov_read_test(void);
 extern bool
 bov_readWindowed_test(void);
 
+extern bool
+bov_readWindowedMmap_test(void);
+
 
 #endif
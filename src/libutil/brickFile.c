@@ -0,0 +1,1055 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/brickFile.c
+ * @ingroup libutilFilesBrickFile
+ * @brief  This file provides the implementation of the brick file type.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "brickFile.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "endian.h"
+#include "xmem.h"
+#include "xstring.h"
+#include "xfile.h"
+#include "diediedie.h"
+#include "byteswap.h"
+#include "lzBlock.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "brickFile_adt.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The size of the file header in bytes. */
+#define LOCAL_HEADER_SIZE 128
+
+/** @brief  The magic bytes at the beginning of every brick file. */
+#define LOCAL_MAGIC "G9PBRICK"
+
+/** @brief  The version of the file layout. */
+#define LOCAL_VERSION 1
+
+/** @brief  Used to detect the byte order of a file. */
+#define LOCAL_ENDIAN_MARKER UINT32_C(0x01020304)
+
+/** @brief  The number of index entries written at once for empty files. */
+#define LOCAL_INDEX_CHUNK 4096
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static void
+local_calcNumBricks(brickFile_t brickFile);
+
+static size_t
+local_getFormatSize(brickFileFormat_t format);
+
+static size_t
+local_getMaxRawBrickBytes(const brickFile_t brickFile);
+
+static void
+local_getBrickExtent(const brickFile_t brickFile,
+                     const uint32_t    *brick,
+                     uint32_t          *lo,
+                     uint32_t          *ext);
+
+static uint64_t
+local_getBrickNumber(const brickFile_t brickFile, const uint32_t *brick);
+
+static void
+local_packHeader(const brickFile_t brickFile, unsigned char *header);
+
+static void
+local_unpackHeader(brickFile_t brickFile, const unsigned char *header);
+
+static void
+local_readHeader(brickFile_t brickFile, FILE *f);
+
+static void
+local_writeHeader(const brickFile_t brickFile, FILE *f);
+
+static void
+local_loadIndex(brickFile_t brickFile, FILE *f);
+
+static void
+local_readIndexEntry(const brickFile_t brickFile,
+                     FILE              *f,
+                     uint64_t          brickNumber,
+                     uint64_t          *entry);
+
+static void
+local_writeIndexEntry(const brickFile_t brickFile,
+                      FILE              *f,
+                      uint64_t          brickNumber,
+                      const uint64_t    *entry);
+
+static void
+local_readBrick(const brickFile_t brickFile,
+                FILE              *f,
+                const uint64_t    *entry,
+                size_t            rawBytes,
+                void              *brick,
+                void              *shuffled,
+                void              *packed);
+
+static void
+local_storeBrick(const brickFile_t brickFile,
+                 FILE              *f,
+                 void              *brick,
+                 size_t            rawBytes,
+                 void              *shuffled,
+                 void              *packed,
+                 uint64_t          *entry);
+
+static void
+local_copyBrickToData(const brickFile_t        brickFile,
+                      const void *restrict     brick,
+                      const uint32_t *restrict brickLo,
+                      const uint32_t *restrict brickExt,
+                      void *restrict           data,
+                      brickFileFormat_t        dataFormat,
+                      int                      numComponents,
+                      const uint32_t *restrict idxLo,
+                      const uint32_t *restrict dims);
+
+static void
+local_copyDataToBrick(const brickFile_t        brickFile,
+                      void *restrict           brick,
+                      const uint32_t *restrict brickLo,
+                      const uint32_t *restrict brickExt,
+                      const void *restrict     data,
+                      brickFileFormat_t        dataFormat,
+                      int                      numComponents,
+                      const uint32_t *restrict idxLo,
+                      const uint32_t *restrict dims);
+
+static void
+local_addBrickToStatistics(brickFile_t brickFile,
+                           const void  *brick,
+                           size_t      numValues);
+
+static bool
+local_removeBrickFromStatistics(brickFile_t brickFile,
+                                const void  *brick,
+                                size_t      numValues);
+
+static void
+local_recalcExtrema(brickFile_t brickFile,
+                    FILE        *f,
+                    void        *brick,
+                    void        *shuffled,
+                    void        *packed);
+
+static void
+local_getIntersection(const uint32_t *brickLo,
+                      const uint32_t *brickExt,
+                      const uint32_t *idxLo,
+                      const uint32_t *dims,
+                      uint32_t       *lo,
+                      uint32_t       *hi);
+
+static inline double
+local_getValue(const void *p, brickFileFormat_t format, size_t i);
+
+static inline void
+local_setValue(void *p, brickFileFormat_t format, size_t i, double v);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern brickFile_t
+brickFile_new(void)
+{
+	brickFile_t brickFile;
+
+	brickFile                   = xmalloc(sizeof(struct brickFile_struct));
+	brickFile->fileName         = NULL;
+	brickFile->machineEndianess = endian_getSystemEndianess();
+	brickFile->fileEndianess    = brickFile->machineEndianess;
+	for (int i = 0; i < 3; i++) {
+		brickFile->dims[i]      = 1;
+		brickFile->brickDims[i] = 32;
+	}
+	brickFile->format        = BRICKFILE_FORMAT_FLOAT;
+	brickFile->numComponents = 1;
+	brickFile->compression   = BRICKFILE_COMPRESSION_NONE;
+	brickFile->statCount     = 0;
+	brickFile->statMin       = 0.0;
+	brickFile->statMax       = 0.0;
+	brickFile->statSum       = 0.0;
+	brickFile->statSumSq     = 0.0;
+	brickFile->index         = NULL;
+	local_calcNumBricks(brickFile);
+
+	return brickFile;
+}
+
+extern brickFile_t
+brickFile_newFromFile(const char *fileName)
+{
+	brickFile_t brickFile;
+	FILE        *f;
+
+	assert(fileName != NULL);
+
+	brickFile           = brickFile_new();
+	brickFile->fileName = xstrdup(fileName);
+
+	f = xfopen(fileName, "rb");
+	local_readHeader(brickFile, f);
+	local_loadIndex(brickFile, f);
+	xfclose(&f);
+
+	return brickFile;
+}
+
+extern void
+brickFile_del(brickFile_t *brickFile)
+{
+	assert(brickFile != NULL && *brickFile != NULL);
+
+	if ((*brickFile)->fileName != NULL)
+		xfree((*brickFile)->fileName);
+	if ((*brickFile)->index != NULL)
+		xfree((*brickFile)->index);
+	xfree(*brickFile);
+
+	*brickFile = NULL;
+}
+
+extern const char *
+brickFile_getFileName(const brickFile_t brickFile)
+{
+	assert(brickFile != NULL);
+
+	return brickFile->fileName;
+}
+
+extern void
+brickFile_getSize(const brickFile_t brickFile, uint32_t *dims)
+{
+	assert(brickFile != NULL);
+	assert(dims != NULL);
+
+	for (int i = 0; i < 3; i++)
+		dims[i] = brickFile->dims[i];
+}
+
+extern void
+brickFile_getBrickSize(const brickFile_t brickFile, uint32_t *brickDims)
+{
+	assert(brickFile != NULL);
+	assert(brickDims != NULL);
+
+	for (int i = 0; i < 3; i++)
+		brickDims[i] = brickFile->brickDims[i];
+}
+
+extern brickFileFormat_t
+brickFile_getFormat(const brickFile_t brickFile)
+{
+	assert(brickFile != NULL);
+
+	return brickFile->format;
+}
+
+extern int
+brickFile_getNumComponents(const brickFile_t brickFile)
+{
+	assert(brickFile != NULL);
+
+	return brickFile->numComponents;
+}
+
+extern brickFileCompression_t
+brickFile_getCompression(const brickFile_t brickFile)
+{
+	assert(brickFile != NULL);
+
+	return brickFile->compression;
+}
+
+extern uint64_t
+brickFile_getStatistics(const brickFile_t brickFile,
+                        double            *min,
+                        double            *max,
+                        double            *mean,
+                        double            *rms)
+{
+	uint64_t n;
+
+	assert(brickFile != NULL);
+
+	n = brickFile->statCount;
+	if (min != NULL)
+		*min = brickFile->statMin;
+	if (max != NULL)
+		*max = brickFile->statMax;
+	if (mean != NULL)
+		*mean = (n > 0) ? brickFile->statSum / n : 0.0;
+	if (rms != NULL)
+		*rms = (n > 0) ? sqrt(brickFile->statSumSq / n) : 0.0;
+
+	return n;
+}
+
+extern void
+brickFile_setFileName(brickFile_t brickFile, const char *fileName)
+{
+	assert(brickFile != NULL);
+	assert(fileName != NULL);
+
+	if (brickFile->fileName != NULL)
+		xfree(brickFile->fileName);
+	brickFile->fileName = xstrdup(fileName);
+}
+
+extern void
+brickFile_setSize(brickFile_t brickFile, const uint32_t *dims)
+{
+	assert(brickFile != NULL);
+	assert(dims != NULL);
+	assert(dims[0] > 0 && dims[1] > 0 && dims[2] > 0);
+
+	for (int i = 0; i < 3; i++)
+		brickFile->dims[i] = dims[i];
+	local_calcNumBricks(brickFile);
+}
+
+extern void
+brickFile_setBrickSize(brickFile_t brickFile, const uint32_t *brickDims)
+{
+	assert(brickFile != NULL);
+	assert(brickDims != NULL);
+	assert(brickDims[0] > 0 && brickDims[1] > 0 && brickDims[2] > 0);
+
+	for (int i = 0; i < 3; i++)
+		brickFile->brickDims[i] = brickDims[i];
+	local_calcNumBricks(brickFile);
+}
+
+extern void
+brickFile_setFormat(brickFile_t brickFile, brickFileFormat_t format)
+{
+	assert(brickFile != NULL);
+	assert(format == BRICKFILE_FORMAT_FLOAT
+	       || format == BRICKFILE_FORMAT_DOUBLE);
+
+	brickFile->format = format;
+}
+
+extern void
+brickFile_setNumComponents(brickFile_t brickFile, int numComponents)
+{
+	assert(brickFile != NULL);
+	assert(numComponents > 0);
+
+	brickFile->numComponents = numComponents;
+}
+
+extern void
+brickFile_setCompression(brickFile_t            brickFile,
+                         brickFileCompression_t compression)
+{
+	assert(brickFile != NULL);
+	assert(compression == BRICKFILE_COMPRESSION_NONE
+	       || compression == BRICKFILE_COMPRESSION_SHUFFLE_LZ);
+
+	brickFile->compression = compression;
+}
+
+extern void
+brickFile_makeEmptyFile(const brickFile_t brickFile)
+{
+	FILE     *f;
+	uint64_t numBricks;
+	uint64_t *chunk;
+
+	assert(brickFile != NULL);
+	assert(brickFile->fileName != NULL);
+
+	brickFile->fileEndianess = brickFile->machineEndianess;
+	brickFile->statCount     = 0;
+	brickFile->statMin       = 0.0;
+	brickFile->statMax       = 0.0;
+	brickFile->statSum       = 0.0;
+	brickFile->statSumSq     = 0.0;
+	if (brickFile->index != NULL)
+		xfree(brickFile->index);
+	brickFile->index = NULL;
+
+	numBricks = (uint64_t)(brickFile->numBricks[0])
+	            * brickFile->numBricks[1] * brickFile->numBricks[2];
+	chunk     = xmalloc(sizeof(uint64_t) * 2 * LOCAL_INDEX_CHUNK);
+	memset(chunk, 0, sizeof(uint64_t) * 2 * LOCAL_INDEX_CHUNK);
+
+	f = xfopen(brickFile->fileName, "wb");
+	local_writeHeader(brickFile, f);
+	while (numBricks > 0) {
+		size_t n = numBricks > LOCAL_INDEX_CHUNK
+		           ? LOCAL_INDEX_CHUNK : (size_t)numBricks;
+		xfwrite(chunk, sizeof(uint64_t) * 2, n, f);
+		numBricks -= n;
+	}
+	xfclose(&f);
+
+	xfree(chunk);
+}
+
+extern void
+brickFile_readWindowed(const brickFile_t        brickFile,
+                       void *restrict           data,
+                       brickFileFormat_t        dataFormat,
+                       int                      numComponents,
+                       const uint32_t *restrict idxLo,
+                       const uint32_t *restrict dims)
+{
+	FILE     *f;
+	uint32_t bLo[3], bHi[3], brick[3], lo[3], ext[3];
+	size_t   maxRawBytes, formatSize;
+	void     *brickBuf, *shuffled, *packed;
+
+	assert(brickFile != NULL);
+	assert(brickFile->fileName != NULL);
+	assert(data != NULL);
+	assert(numComponents >= brickFile->numComponents);
+	assert(idxLo != NULL && dims != NULL);
+	for (int i = 0; i < 3; i++) {
+		assert(dims[i] > 0);
+		assert(idxLo[i] + dims[i] <= brickFile->dims[i]);
+		bLo[i] = idxLo[i] / brickFile->brickDims[i];
+		bHi[i] = (idxLo[i] + dims[i] - 1) / brickFile->brickDims[i];
+	}
+
+	f = xfopen(brickFile->fileName, "rb");
+	if (brickFile->index == NULL) {
+		local_readHeader(brickFile, f);
+		local_loadIndex(brickFile, f);
+	}
+
+	formatSize  = local_getFormatSize(brickFile->format);
+	maxRawBytes = local_getMaxRawBrickBytes(brickFile);
+	brickBuf    = xmalloc(maxRawBytes);
+	shuffled    = xmalloc(maxRawBytes);
+	packed      = xmalloc(maxRawBytes);
+
+	for (brick[2] = bLo[2]; brick[2] <= bHi[2]; brick[2]++) {
+		for (brick[1] = bLo[1]; brick[1] <= bHi[1]; brick[1]++) {
+			for (brick[0] = bLo[0]; brick[0] <= bHi[0]; brick[0]++) {
+				uint64_t num = local_getBrickNumber(brickFile, brick);
+				size_t   rawBytes;
+
+				local_getBrickExtent(brickFile, brick, lo, ext);
+				rawBytes = (size_t)ext[0] * ext[1] * ext[2]
+				           * brickFile->numComponents * formatSize;
+				local_readBrick(brickFile, f, brickFile->index + 2 * num,
+				                rawBytes, brickBuf, shuffled, packed);
+				local_copyBrickToData(brickFile, brickBuf, lo, ext, data,
+				                      dataFormat, numComponents, idxLo, dims);
+			}
+		}
+	}
+
+	xfree(packed);
+	xfree(shuffled);
+	xfree(brickBuf);
+	xfclose(&f);
+} /* brickFile_readWindowed */
+
+extern void
+brickFile_writeWindowed(const brickFile_t        brickFile,
+                        const void *restrict     data,
+                        brickFileFormat_t        dataFormat,
+                        int                      numComponents,
+                        const uint32_t *restrict idxLo,
+                        const uint32_t *restrict dims)
+{
+	FILE     *f;
+	uint32_t bLo[3], bHi[3], brick[3], lo[3], ext[3];
+	size_t   maxRawBytes, formatSize;
+	void     *brickBuf, *shuffled, *packed;
+	bool     extremaAreStale = false;
+
+	assert(brickFile != NULL);
+	assert(brickFile->fileName != NULL);
+	assert(data != NULL);
+	assert(idxLo != NULL && dims != NULL);
+
+	f = xfopen(brickFile->fileName, "r+b");
+	// Other objects may have written to the file in the meantime.
+	local_readHeader(brickFile, f);
+	if (brickFile->index != NULL)
+		xfree(brickFile->index);
+	brickFile->index = NULL;
+
+	assert(numComponents >= brickFile->numComponents);
+	for (int i = 0; i < 3; i++) {
+		assert(dims[i] > 0);
+		assert(idxLo[i] + dims[i] <= brickFile->dims[i]);
+		bLo[i] = idxLo[i] / brickFile->brickDims[i];
+		bHi[i] = (idxLo[i] + dims[i] - 1) / brickFile->brickDims[i];
+	}
+
+	formatSize  = local_getFormatSize(brickFile->format);
+	maxRawBytes = local_getMaxRawBrickBytes(brickFile);
+	brickBuf    = xmalloc(maxRawBytes);
+	shuffled    = xmalloc(maxRawBytes);
+	packed      = xmalloc(lzBlock_getMaxCompressedSize(maxRawBytes));
+
+	for (brick[2] = bLo[2]; brick[2] <= bHi[2]; brick[2]++) {
+		for (brick[1] = bLo[1]; brick[1] <= bHi[1]; brick[1]++) {
+			for (brick[0] = bLo[0]; brick[0] <= bHi[0]; brick[0]++) {
+				uint64_t num = local_getBrickNumber(brickFile, brick);
+				uint64_t entry[2];
+				size_t   rawBytes;
+				bool     isCovered = true;
+
+				local_getBrickExtent(brickFile, brick, lo, ext);
+				rawBytes = (size_t)ext[0] * ext[1] * ext[2]
+				           * brickFile->numComponents * formatSize;
+				for (int i = 0; i < 3; i++) {
+					if ((lo[i] < idxLo[i])
+					    || (lo[i] + ext[i] > idxLo[i] + dims[i]))
+						isCovered = false;
+				}
+				local_readIndexEntry(brickFile, f, num, entry);
+				// The old values of a stored brick leave the statistics.
+				if (!isCovered || (entry[1] > 0)) {
+					local_readBrick(brickFile, f, entry, rawBytes,
+					                brickBuf, shuffled, packed);
+				}
+				if (entry[1] > 0) {
+					if (local_removeBrickFromStatistics(brickFile, brickBuf,
+					                                    rawBytes / formatSize))
+						extremaAreStale = true;
+				}
+				local_copyDataToBrick(brickFile, brickBuf, lo, ext, data,
+				                      dataFormat, numComponents, idxLo, dims);
+				local_addBrickToStatistics(brickFile, brickBuf,
+				                           rawBytes / formatSize);
+				local_storeBrick(brickFile, f, brickBuf, rawBytes,
+				                 shuffled, packed, entry);
+				local_writeIndexEntry(brickFile, f, num, entry);
+			}
+		}
+	}
+
+	if (extremaAreStale)
+		local_recalcExtrema(brickFile, f, brickBuf, shuffled, packed);
+	local_writeHeader(brickFile, f);
+
+	xfree(packed);
+	xfree(shuffled);
+	xfree(brickBuf);
+	xfclose(&f);
+} /* brickFile_writeWindowed */
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_calcNumBricks(brickFile_t brickFile)
+{
+	for (int i = 0; i < 3; i++) {
+		brickFile->numBricks[i] = (brickFile->dims[i]
+		                           + brickFile->brickDims[i] - 1)
+		                          / brickFile->brickDims[i];
+	}
+}
+
+static size_t
+local_getFormatSize(brickFileFormat_t format)
+{
+	return (format == BRICKFILE_FORMAT_FLOAT) ? sizeof(float)
+	       : sizeof(double);
+}
+
+static size_t
+local_getMaxRawBrickBytes(const brickFile_t brickFile)
+{
+	size_t bytes = local_getFormatSize(brickFile->format)
+	               * brickFile->numComponents;
+
+	for (int i = 0; i < 3; i++) {
+		bytes *= (brickFile->brickDims[i] < brickFile->dims[i])
+		         ? brickFile->brickDims[i] : brickFile->dims[i];
+	}
+
+	return bytes;
+}
+
+static void
+local_getBrickExtent(const brickFile_t brickFile,
+                     const uint32_t    *brick,
+                     uint32_t          *lo,
+                     uint32_t          *ext)
+{
+	for (int i = 0; i < 3; i++) {
+		lo[i]  = brick[i] * brickFile->brickDims[i];
+		ext[i] = brickFile->dims[i] - lo[i];
+		if (ext[i] > brickFile->brickDims[i])
+			ext[i] = brickFile->brickDims[i];
+	}
+}
+
+static uint64_t
+local_getBrickNumber(const brickFile_t brickFile, const uint32_t *brick)
+{
+	return brick[0] + brickFile->numBricks[0]
+	       * (brick[1] + (uint64_t)(brickFile->numBricks[1]) * brick[2]);
+}
+
+static void
+local_packHeader(const brickFile_t brickFile, unsigned char *header)
+{
+	uint32_t u32[12];
+	uint64_t count = brickFile->statCount;
+	double   stats[4];
+
+	memset(header, 0, LOCAL_HEADER_SIZE);
+	memcpy(header, LOCAL_MAGIC, 8);
+
+	u32[0] = LOCAL_VERSION;
+	u32[1] = LOCAL_ENDIAN_MARKER;
+	for (int i = 0; i < 3; i++) {
+		u32[2 + i] = brickFile->dims[i];
+		u32[5 + i] = brickFile->brickDims[i];
+	}
+	u32[8]   = (uint32_t)(brickFile->format);
+	u32[9]   = (uint32_t)(brickFile->numComponents);
+	u32[10]  = (uint32_t)(brickFile->compression);
+	u32[11]  = 0;
+	stats[0] = brickFile->statMin;
+	stats[1] = brickFile->statMax;
+	stats[2] = brickFile->statSum;
+	stats[3] = brickFile->statSumSq;
+
+	if (brickFile->fileEndianess != brickFile->machineEndianess) {
+		byteswapArray(u32, sizeof(uint32_t), 12);
+		byteswap(&count, sizeof(uint64_t));
+		byteswapArray(stats, sizeof(double), 4);
+	}
+
+	memcpy(header + 8, u32, sizeof(u32));
+	memcpy(header + 56, &count, sizeof(uint64_t));
+	memcpy(header + 64, stats, sizeof(stats));
+}
+
+static void
+local_unpackHeader(brickFile_t brickFile, const unsigned char *header)
+{
+	uint32_t u32[12];
+	uint64_t count;
+	double   stats[4];
+
+	if (memcmp(header, LOCAL_MAGIC, 8) != 0) {
+		fprintf(stderr, "%s is not a brick file :(\n", brickFile->fileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	memcpy(u32, header + 8, sizeof(u32));
+	memcpy(&count, header + 56, sizeof(uint64_t));
+	memcpy(stats, header + 64, sizeof(stats));
+
+	brickFile->fileEndianess = brickFile->machineEndianess;
+	if (u32[1] != LOCAL_ENDIAN_MARKER) {
+		brickFile->fileEndianess = (brickFile->machineEndianess
+		                            == ENDIAN_LITTLE)
+		                           ? ENDIAN_BIG : ENDIAN_LITTLE;
+		byteswapArray(u32, sizeof(uint32_t), 12);
+		byteswap(&count, sizeof(uint64_t));
+		byteswapArray(stats, sizeof(double), 4);
+	}
+	if ((u32[1] != LOCAL_ENDIAN_MARKER) || (u32[0] != LOCAL_VERSION)) {
+		fprintf(stderr, "Cannot understand brick file %s :(\n",
+		        brickFile->fileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	for (int i = 0; i < 3; i++) {
+		brickFile->dims[i]      = u32[2 + i];
+		brickFile->brickDims[i] = u32[5 + i];
+	}
+	brickFile->format        = (brickFileFormat_t)(u32[8]);
+	brickFile->numComponents = (int)(u32[9]);
+	brickFile->compression   = (brickFileCompression_t)(u32[10]);
+	brickFile->statCount     = count;
+	brickFile->statMin       = stats[0];
+	brickFile->statMax       = stats[1];
+	brickFile->statSum       = stats[2];
+	brickFile->statSumSq     = stats[3];
+	local_calcNumBricks(brickFile);
+}
+
+static void
+local_readHeader(brickFile_t brickFile, FILE *f)
+{
+	unsigned char header[LOCAL_HEADER_SIZE];
+
+	xfseek(f, 0L, SEEK_SET);
+	xfread(header, 1, LOCAL_HEADER_SIZE, f);
+	local_unpackHeader(brickFile, header);
+}
+
+static void
+local_writeHeader(const brickFile_t brickFile, FILE *f)
+{
+	unsigned char header[LOCAL_HEADER_SIZE];
+
+	local_packHeader(brickFile, header);
+	xfseek(f, 0L, SEEK_SET);
+	xfwrite(header, 1, LOCAL_HEADER_SIZE, f);
+}
+
+static void
+local_loadIndex(brickFile_t brickFile, FILE *f)
+{
+	size_t numBricks;
+
+	numBricks = (size_t)(brickFile->numBricks[0])
+	            * brickFile->numBricks[1] * brickFile->numBricks[2];
+
+	if (brickFile->index != NULL)
+		xfree(brickFile->index);
+	brickFile->index = xmalloc(sizeof(uint64_t) * 2 * numBricks);
+
+	xfseek(f, (long)LOCAL_HEADER_SIZE, SEEK_SET);
+	xfread(brickFile->index, sizeof(uint64_t), 2 * numBricks, f);
+	if (brickFile->fileEndianess != brickFile->machineEndianess)
+		byteswapArray(brickFile->index, sizeof(uint64_t), 2 * numBricks);
+}
+
+static void
+local_readIndexEntry(const brickFile_t brickFile,
+                     FILE              *f,
+                     uint64_t          brickNumber,
+                     uint64_t          *entry)
+{
+	xfseek(f, (long)(LOCAL_HEADER_SIZE + 2 * sizeof(uint64_t) * brickNumber),
+	       SEEK_SET);
+	xfread(entry, sizeof(uint64_t), 2, f);
+	if (brickFile->fileEndianess != brickFile->machineEndianess)
+		byteswapArray(entry, sizeof(uint64_t), 2);
+}
+
+static void
+local_writeIndexEntry(const brickFile_t brickFile,
+                      FILE              *f,
+                      uint64_t          brickNumber,
+                      const uint64_t    *entry)
+{
+	uint64_t tmp[2] = { entry[0], entry[1] };
+
+	if (brickFile->fileEndianess != brickFile->machineEndianess)
+		byteswapArray(tmp, sizeof(uint64_t), 2);
+	xfseek(f, (long)(LOCAL_HEADER_SIZE + 2 * sizeof(uint64_t) * brickNumber),
+	       SEEK_SET);
+	xfwrite(tmp, sizeof(uint64_t), 2, f);
+}
+
+static void
+local_readBrick(const brickFile_t brickFile,
+                FILE              *f,
+                const uint64_t    *entry,
+                size_t            rawBytes,
+                void              *brick,
+                void              *shuffled,
+                void              *packed)
+{
+	size_t formatSize = local_getFormatSize(brickFile->format);
+	size_t storedSize = (size_t)(entry[1]);
+
+	if (storedSize == 0) {
+		memset(brick, 0, rawBytes);
+		return;
+	}
+	if (storedSize > rawBytes) {
+		fprintf(stderr, "Corrupted brick index in %s :(\n",
+		        brickFile->fileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	xfseek(f, (long)(entry[0]), SEEK_SET);
+	if (storedSize == rawBytes) {
+		xfread(brick, 1, rawBytes, f);
+	} else {
+		xfread(packed, 1, storedSize, f);
+		if (!lzBlock_decompress(packed, storedSize, shuffled, rawBytes)) {
+			fprintf(stderr, "Corrupted brick in %s :(\n",
+			        brickFile->fileName);
+			diediedie(EXIT_FAILURE);
+		}
+		lzBlock_unshuffle(shuffled, brick, formatSize,
+		                  rawBytes / formatSize);
+	}
+
+	if (brickFile->fileEndianess != brickFile->machineEndianess)
+		byteswapArray(brick, formatSize, rawBytes / formatSize);
+}
+
+static void
+local_storeBrick(const brickFile_t brickFile,
+                 FILE              *f,
+                 void              *brick,
+                 size_t            rawBytes,
+                 void              *shuffled,
+                 void              *packed,
+                 uint64_t          *entry)
+{
+	size_t formatSize = local_getFormatSize(brickFile->format);
+	size_t storedSize = 0;
+
+	if (brickFile->fileEndianess != brickFile->machineEndianess)
+		byteswapArray(brick, formatSize, rawBytes / formatSize);
+
+	// Only keep the compressed brick if it is actually smaller.
+	if (brickFile->compression == BRICKFILE_COMPRESSION_SHUFFLE_LZ) {
+		lzBlock_shuffle(brick, shuffled, formatSize, rawBytes / formatSize);
+		storedSize = lzBlock_compress(shuffled, rawBytes, packed,
+		                              rawBytes - 1);
+	}
+
+	// Reuse the old slot if the brick still fits, otherwise append it.
+	if ((entry[1] > 0) && (entry[1] >= (storedSize > 0 ? storedSize
+	                                    : rawBytes))) {
+		xfseek(f, (long)(entry[0]), SEEK_SET);
+	} else {
+		xfseek(f, 0L, SEEK_END);
+		entry[0] = (uint64_t)xftell(f);
+	}
+	if (storedSize > 0) {
+		xfwrite(packed, 1, storedSize, f);
+		entry[1] = storedSize;
+	} else {
+		xfwrite(brick, 1, rawBytes, f);
+		entry[1] = rawBytes;
+	}
+}
+
+static void
+local_copyBrickToData(const brickFile_t        brickFile,
+                      const void *restrict     brick,
+                      const uint32_t *restrict brickLo,
+                      const uint32_t *restrict brickExt,
+                      void *restrict           data,
+                      brickFileFormat_t        dataFormat,
+                      int                      numComponents,
+                      const uint32_t *restrict idxLo,
+                      const uint32_t *restrict dims)
+{
+	uint32_t lo[3], hi[3];
+	size_t   fnc        = (size_t)(brickFile->numComponents);
+	size_t   dnc        = (size_t)numComponents;
+	size_t   formatSize = local_getFormatSize(dataFormat);
+
+	local_getIntersection(brickLo, brickExt, idxLo, dims, lo, hi);
+
+	for (uint32_t k = lo[2]; k < hi[2]; k++) {
+		for (uint32_t j = lo[1]; j < hi[1]; j++) {
+			size_t bOff, dOff, n = hi[0] - lo[0];
+
+			bOff = ((lo[0] - brickLo[0])
+			        + ((j - brickLo[1]) + (size_t)(k - brickLo[2])
+			           * brickExt[1]) * brickExt[0]) * fnc;
+			dOff = ((lo[0] - idxLo[0])
+			        + ((j - idxLo[1]) + (size_t)(k - idxLo[2])
+			           * dims[1]) * dims[0]) * dnc;
+			if ((dataFormat == brickFile->format) && (fnc == dnc)) {
+				memcpy((char *)data + dOff * formatSize,
+				       (const char *)brick + bOff * formatSize,
+				       n * fnc * formatSize);
+				continue;
+			}
+			for (size_t i = 0; i < n; i++) {
+				for (size_t c = 0; c < fnc; c++) {
+					double v = local_getValue(brick, brickFile->format,
+					                          bOff + i * fnc + c);
+					local_setValue(data, dataFormat, dOff + i * dnc + c, v);
+				}
+			}
+		}
+	}
+}
+
+static void
+local_copyDataToBrick(const brickFile_t        brickFile,
+                      void *restrict           brick,
+                      const uint32_t *restrict brickLo,
+                      const uint32_t *restrict brickExt,
+                      const void *restrict     data,
+                      brickFileFormat_t        dataFormat,
+                      int                      numComponents,
+                      const uint32_t *restrict idxLo,
+                      const uint32_t *restrict dims)
+{
+	uint32_t lo[3], hi[3];
+	size_t   fnc        = (size_t)(brickFile->numComponents);
+	size_t   dnc        = (size_t)numComponents;
+	size_t   formatSize = local_getFormatSize(dataFormat);
+
+	local_getIntersection(brickLo, brickExt, idxLo, dims, lo, hi);
+
+	for (uint32_t k = lo[2]; k < hi[2]; k++) {
+		for (uint32_t j = lo[1]; j < hi[1]; j++) {
+			size_t bOff, dOff, n = hi[0] - lo[0];
+
+			bOff = ((lo[0] - brickLo[0])
+			        + ((j - brickLo[1]) + (size_t)(k - brickLo[2])
+			           * brickExt[1]) * brickExt[0]) * fnc;
+			dOff = ((lo[0] - idxLo[0])
+			        + ((j - idxLo[1]) + (size_t)(k - idxLo[2])
+			           * dims[1]) * dims[0]) * dnc;
+			if ((dataFormat == brickFile->format) && (fnc == dnc)) {
+				memcpy((char *)brick + bOff * formatSize,
+				       (const char *)data + dOff * formatSize,
+				       n * fnc * formatSize);
+				continue;
+			}
+			for (size_t i = 0; i < n; i++) {
+				for (size_t c = 0; c < fnc; c++) {
+					double v = local_getValue(data, dataFormat,
+					                          dOff + i * dnc + c);
+					local_setValue(brick, brickFile->format,
+					               bOff + i * fnc + c, v);
+				}
+			}
+		}
+	}
+} /* local_copyDataToBrick */
+
+static void
+local_addBrickToStatistics(brickFile_t brickFile,
+                           const void  *brick,
+                           size_t      numValues)
+{
+	double min   = brickFile->statMin;
+	double max   = brickFile->statMax;
+	double sum   = 0.0;
+	double sumSq = 0.0;
+
+	// The statistics are taken from the values as they are stored.
+	for (size_t i = 0; i < numValues; i++) {
+		double v = local_getValue(brick, brickFile->format, i);
+		if ((brickFile->statCount + i == 0) || (v < min))
+			min = v;
+		if ((brickFile->statCount + i == 0) || (v > max))
+			max = v;
+		sum   += v;
+		sumSq += v * v;
+	}
+
+	brickFile->statCount += numValues;
+	brickFile->statMin    = min;
+	brickFile->statMax    = max;
+	brickFile->statSum   += sum;
+	brickFile->statSumSq += sumSq;
+}
+
+static bool
+local_removeBrickFromStatistics(brickFile_t brickFile,
+                                const void  *brick,
+                                size_t      numValues)
+{
+	bool   extremaAreStale = false;
+	double sum             = 0.0;
+	double sumSq           = 0.0;
+
+	assert(brickFile->statCount >= numValues);
+
+	for (size_t i = 0; i < numValues; i++) {
+		double v = local_getValue(brick, brickFile->format, i);
+		if ((v <= brickFile->statMin) || (v >= brickFile->statMax))
+			extremaAreStale = true;
+		sum   += v;
+		sumSq += v * v;
+	}
+
+	brickFile->statCount -= numValues;
+	brickFile->statSum   -= sum;
+	brickFile->statSumSq -= sumSq;
+
+	return extremaAreStale;
+}
+
+static void
+local_recalcExtrema(brickFile_t brickFile,
+                    FILE        *f,
+                    void        *brick,
+                    void        *shuffled,
+                    void        *packed)
+{
+	uint32_t b[3], lo[3], ext[3];
+	size_t   formatSize = local_getFormatSize(brickFile->format);
+	bool     isFirst    = true;
+
+	for (b[2] = 0; b[2] < brickFile->numBricks[2]; b[2]++) {
+		for (b[1] = 0; b[1] < brickFile->numBricks[1]; b[1]++) {
+			for (b[0] = 0; b[0] < brickFile->numBricks[0]; b[0]++) {
+				uint64_t entry[2];
+				size_t   numValues;
+
+				local_readIndexEntry(brickFile, f,
+				                     local_getBrickNumber(brickFile, b),
+				                     entry);
+				if (entry[1] == 0)
+					continue;
+				local_getBrickExtent(brickFile, b, lo, ext);
+				numValues = (size_t)ext[0] * ext[1] * ext[2]
+				            * brickFile->numComponents;
+				local_readBrick(brickFile, f, entry, numValues * formatSize,
+				                brick, shuffled, packed);
+				for (size_t i = 0; i < numValues; i++) {
+					double v = local_getValue(brick, brickFile->format, i);
+					if (isFirst || (v < brickFile->statMin))
+						brickFile->statMin = v;
+					if (isFirst || (v > brickFile->statMax))
+						brickFile->statMax = v;
+					isFirst = false;
+				}
+			}
+		}
+	}
+} /* local_recalcExtrema */
+
+static void
+local_getIntersection(const uint32_t *brickLo,
+                      const uint32_t *brickExt,
+                      const uint32_t *idxLo,
+                      const uint32_t *dims,
+                      uint32_t       *lo,
+                      uint32_t       *hi)
+{
+	for (int i = 0; i < 3; i++) {
+		lo[i] = (brickLo[i] > idxLo[i]) ? brickLo[i] : idxLo[i];
+		hi[i] = (brickLo[i] + brickExt[i] < idxLo[i] + dims[i])
+		        ? brickLo[i] + brickExt[i] : idxLo[i] + dims[i];
+	}
+}
+
+static inline double
+local_getValue(const void *p, brickFileFormat_t format, size_t i)
+{
+	return (format == BRICKFILE_FORMAT_FLOAT)
+	       ? (double)(((const float *)p)[i]) : ((const double *)p)[i];
+}
+
+static inline void
+local_setValue(void *p, brickFileFormat_t format, size_t i, double v)
+{
+	if (format == BRICKFILE_FORMAT_FLOAT)
+		((float *)p)[i] = (float)v;
+	else
+		((double *)p)[i] = v;
+}
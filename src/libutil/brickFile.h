@@ -0,0 +1,424 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BRICKFILE_H
+#define BRICKFILE_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/brickFile.h
+ * @ingroup libutilFilesBrickFile
+ * @brief  This file provides the interface of the brick file type.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*--- Typedefs ----------------------------------------------------------*/
+
+/** @brief  Gives the precision of the data in a brick file. */
+typedef enum {
+	/** @brief  The data is in single precision. */
+	BRICKFILE_FORMAT_FLOAT,
+	/** @brief  The data is in double precision. */
+	BRICKFILE_FORMAT_DOUBLE
+} brickFileFormat_t;
+
+/** @brief  Gives the compression applied to the bricks. */
+typedef enum {
+	/** @brief  The bricks are stored as they are. */
+	BRICKFILE_COMPRESSION_NONE,
+	/** @brief  The bytes are shuffled and then compressed with lzBlock. */
+	BRICKFILE_COMPRESSION_SHUFFLE_LZ
+} brickFileCompression_t;
+
+
+/*--- ADT handle --------------------------------------------------------*/
+
+/** Defines the handle for the brick file structure. */
+typedef struct brickFile_struct *brickFile_t;
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @name  Creating and Deleting
+ *
+ * @{
+ */
+
+/**
+ * @brief  Creates a new brick file object.
+ *
+ * The object describes single precision data with one component, stored
+ * uncompressed in bricks of 32^3 cells.
+ *
+ * @return  Returns a new (uninitialized) brick file object.
+ */
+extern brickFile_t
+brickFile_new(void);
+
+
+/**
+ * @brief  Creates a new brick file object from a brick file.
+ *
+ * The header and the brick index are read, the index is kept in memory.
+ *
+ * @param[in]  *fileName
+ *                The name of the file to open.
+ *
+ * @return  Returns a new brick file object describing the underlying file.
+ */
+extern brickFile_t
+brickFile_newFromFile(const char *fileName);
+
+
+/**
+ * @brief  Deletes a brick file object and frees the associated memory.
+ *
+ * @param[in,out]  *brickFile
+ *                     A pointer to the external variable holding the
+ *                     reference to the object.  After deletion, the
+ *                     external variable will be set to @c NULL.  Passing
+ *                     @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_del(brickFile_t *brickFile);
+
+
+/** @} */
+
+/**
+ * @name  Getter
+ *
+ * @{
+ */
+
+/**
+ * @brief  Retrieves the file name.
+ *
+ * @param[in]  brickFile
+ *                The object to query.
+ *
+ * @return  Returns the file name, this points to internal memory.
+ */
+extern const char *
+brickFile_getFileName(const brickFile_t brickFile);
+
+
+/**
+ * @brief  Retrieves the size of the grid.
+ *
+ * @param[in]   brickFile
+ *                 The object to query.
+ * @param[out]  *dims
+ *                 Array of three elements receiving the number of cells in
+ *                 each dimension.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_getSize(const brickFile_t brickFile, uint32_t *dims);
+
+
+/**
+ * @brief  Retrieves the size of the bricks.
+ *
+ * @param[in]   brickFile
+ *                 The object to query.
+ * @param[out]  *brickDims
+ *                 Array of three elements receiving the number of cells
+ *                 of a brick in each dimension.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_getBrickSize(const brickFile_t brickFile, uint32_t *brickDims);
+
+
+/**
+ * @brief  Retrieves the precision of the data.
+ *
+ * @param[in]  brickFile
+ *                The object to query.
+ *
+ * @return  Returns the precision of the data.
+ */
+extern brickFileFormat_t
+brickFile_getFormat(const brickFile_t brickFile);
+
+
+/**
+ * @brief  Retrieves the number of components per cell.
+ *
+ * @param[in]  brickFile
+ *                The object to query.
+ *
+ * @return  Returns the number of components.
+ */
+extern int
+brickFile_getNumComponents(const brickFile_t brickFile);
+
+
+/**
+ * @brief  Retrieves the compression of the bricks.
+ *
+ * @param[in]  brickFile
+ *                The object to query.
+ *
+ * @return  Returns the compression.
+ */
+extern brickFileCompression_t
+brickFile_getCompression(const brickFile_t brickFile);
+
+
+/**
+ * @brief  Retrieves the statistics of the data stored in the file.
+ *
+ * The statistics cover all values of the bricks stored in the file (all
+ * components), cells of a stored brick that were never written count as
+ * zero.  Rewritten cells only contribute their latest value.
+ *
+ * @param[in]   brickFile
+ *                 The object to query.
+ * @param[out]  *min
+ *                 Receives the minimum, may be @c NULL.
+ * @param[out]  *max
+ *                 Receives the maximum, may be @c NULL.
+ * @param[out]  *mean
+ *                 Receives the mean, may be @c NULL.
+ * @param[out]  *rms
+ *                 Receives the root mean square, may be @c NULL.
+ *
+ * @return  Returns the number of values the statistics are based on.
+ */
+extern uint64_t
+brickFile_getStatistics(const brickFile_t brickFile,
+                        double            *min,
+                        double            *max,
+                        double            *mean,
+                        double            *rms);
+
+
+/** @} */
+
+/**
+ * @name  Setter
+ *
+ * These only make sense before brickFile_makeEmptyFile() is called.
+ *
+ * @{
+ */
+
+/**
+ * @brief  Sets the file name.
+ *
+ * @param[in,out]  brickFile
+ *                    The object to work with.
+ * @param[in]      *fileName
+ *                    The new file name, this will be copied.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_setFileName(brickFile_t brickFile, const char *fileName);
+
+
+/**
+ * @brief  Sets the size of the grid.
+ *
+ * @param[in,out]  brickFile
+ *                    The object to work with.
+ * @param[in]      *dims
+ *                    The number of cells in each dimension.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_setSize(brickFile_t brickFile, const uint32_t *dims);
+
+
+/**
+ * @brief  Sets the size of the bricks.
+ *
+ * Bricks at the upper boundaries of the grid are cut to the grid size.
+ *
+ * @param[in,out]  brickFile
+ *                    The object to work with.
+ * @param[in]      *brickDims
+ *                    The number of cells of a brick in each dimension.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_setBrickSize(brickFile_t brickFile, const uint32_t *brickDims);
+
+
+/**
+ * @brief  Sets the precision of the data.
+ *
+ * @param[in,out]  brickFile
+ *                    The object to work with.
+ * @param[in]      format
+ *                    The precision.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_setFormat(brickFile_t brickFile, brickFileFormat_t format);
+
+
+/**
+ * @brief  Sets the number of components per cell.
+ *
+ * @param[in,out]  brickFile
+ *                    The object to work with.
+ * @param[in]      numComponents
+ *                    The number of components, must be positive.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_setNumComponents(brickFile_t brickFile, int numComponents);
+
+
+/**
+ * @brief  Sets the compression of the bricks.
+ *
+ * @param[in,out]  brickFile
+ *                    The object to work with.
+ * @param[in]      compression
+ *                    The compression.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_setCompression(brickFile_t            brickFile,
+                         brickFileCompression_t compression);
+
+
+/** @} */
+
+/**
+ * @name  IO
+ *
+ * @{
+ */
+
+/**
+ * @brief  Creates a file with the header and an empty brick index.
+ *
+ * Bricks that are never written read as zero.
+ *
+ * @param[in]  brickFile
+ *                The object for which to create the file.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_makeEmptyFile(const brickFile_t brickFile);
+
+
+/**
+ * @brief  Reads a portion of the data in the file.
+ *
+ * Only the bricks intersecting the window are read, each with one
+ * contiguous read.  The data array may have more components than the file,
+ * the additional components are not touched.
+ *
+ * @param[in]   brickFile
+ *                 The file object to work with.
+ * @param[out]  *data
+ *                 The array into which to write.
+ * @param[in]   dataFormat
+ *                 The format of the data array.
+ * @param[in]   numComponents
+ *                 The number of components in the data array.
+ * @param[in]   *idxLo
+ *                 The lower left corner of the window.
+ * @param[in]   *dims
+ *                 The size of the window.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_readWindowed(const brickFile_t        brickFile,
+                       void *restrict           data,
+                       brickFileFormat_t        dataFormat,
+                       int                      numComponents,
+                       const uint32_t *restrict idxLo,
+                       const uint32_t *restrict dims);
+
+
+/**
+ * @brief  Writes a window into the file.
+ *
+ * Every brick intersecting the window is stored and its index entry is
+ * updated.  A brick that was stored before is written to its old place if
+ * it still fits there, otherwise it is appended to the file and the old
+ * space is not reclaimed.  Bricks only partially covered by the window
+ * and bricks that were stored before are read first, to merge them and to
+ * remove their old values from the statistics; windows aligned to the
+ * bricks and written once are hence cheapest.  If a replaced brick held
+ * the minimum or maximum, all stored bricks are read again to find the
+ * new extrema.  Concurrent writes into the same file must be serialized
+ * by the caller.
+ *
+ * @param[in]  brickFile
+ *                The file object to work with.
+ * @param[in]  *data
+ *                The array to write.  It may have more components than
+ *                the file, only the first ones are written.
+ * @param[in]  dataFormat
+ *                The format of the data array.
+ * @param[in]  numComponents
+ *                The number of components in the data array.
+ * @param[in]  *idxLo
+ *                The lower left corner of the window.
+ * @param[in]  *dims
+ *                The size of the window.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+brickFile_writeWindowed(const brickFile_t        brickFile,
+                        const void *restrict     data,
+                        brickFileFormat_t        dataFormat,
+                        int                      numComponents,
+                        const uint32_t *restrict idxLo,
+                        const uint32_t *restrict dims);
+
+
+/** @} */
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libutilFilesBrickFile Brick File
+ * @ingroup libutilFiles
+ * @brief Provides low-level interfaces to brick files.
+ *
+ * A brick file stores a grid in bricks of a fixed size (cut at the upper
+ * grid boundaries).  The file starts with a header of 128 bytes holding
+ * the grid and brick size, the precision, the number of components, the
+ * compression and statistics of the data.  It is followed by an index
+ * with the offset and stored size (two 64bit integers) of every brick, in
+ * row-major order with x varying fastest, and then the bricks themselves.
+ * All values are in the byte order of the machine that created the file;
+ * files of the other byte order are recognized and swapped on reading.
+ * A stored size of 0 marks a brick that was never written, a stored size
+ * smaller than the raw size marks a compressed brick.
+ */
+
+
+#endif
@@ -0,0 +1,66 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BRICKFILE_ADT_H
+#define BRICKFILE_ADT_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/brickFile_adt.h
+ * @ingroup libutilFilesBrickFile
+ * @brief  This file provides the main structure of the brick file ADT.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "brickFile.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "endian.h"
+
+
+/*--- ADT implementation ------------------------------------------------*/
+
+/** @brief  Main structure for the brick file object. */
+struct brickFile_struct {
+	/** @brief  The name of the file on disk. */
+	char                   *fileName;
+	/** @brief  The endianess of the machine. */
+	endian_t               machineEndianess;
+	/** @brief  The endianess of the file. */
+	endian_t               fileEndianess;
+	/** @brief  The number of cells of the grid. */
+	uint32_t               dims[3];
+	/** @brief  The number of cells of a brick. */
+	uint32_t               brickDims[3];
+	/** @brief  The number of bricks in each dimension. */
+	uint32_t               numBricks[3];
+	/** @brief  The precision of the data. */
+	brickFileFormat_t      format;
+	/** @brief  The number of components per cell. */
+	int                    numComponents;
+	/** @brief  The compression of the bricks. */
+	brickFileCompression_t compression;
+	/** @brief  The number of values the statistics are based on. */
+	uint64_t               statCount;
+	/** @brief  The smallest value stored. */
+	double                 statMin;
+	/** @brief  The largest value stored. */
+	double                 statMax;
+	/** @brief  The sum of all values stored. */
+	double                 statSum;
+	/** @brief  The sum of the squares of all values stored. */
+	double                 statSumSq;
+	/**
+	 * @brief  The brick index (offset and stored size for every brick) or
+	 *         @c NULL if it has not been read yet.
+	 */
+	uint64_t               *index;
+};
+
+
+#endif
@@ -0,0 +1,392 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "brickFile_tests.h"
+#include "brickFile.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/xmem.h"
+#include "../libutil/xfile.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "brickFile_adt.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static brickFile_t
+local_getBrickFile(const char             *fileName,
+                   brickFileFormat_t      format,
+                   brickFileCompression_t compression);
+
+static double
+local_getValue(uint32_t i, uint32_t j, uint32_t k);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+brickFile_new_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	brickFile_t brickFile;
+#ifdef XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	brickFile = brickFile_new();
+	if (brickFile->fileName != NULL)
+		hasPassed = false;
+	if (brickFile->format != BRICKFILE_FORMAT_FLOAT)
+		hasPassed = false;
+	if (brickFile->numComponents != 1)
+		hasPassed = false;
+	if (brickFile->compression != BRICKFILE_COMPRESSION_NONE)
+		hasPassed = false;
+	if (brickFile->brickDims[0] != 32 || brickFile->index != NULL)
+		hasPassed = false;
+	brickFile_del(&brickFile);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+brickFile_newFromFile_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	brickFile_t brickFile;
+	uint32_t    dims[3];
+#ifdef XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	brickFile = local_getBrickFile("brickTestEmpty.brick",
+	                               BRICKFILE_FORMAT_DOUBLE,
+	                               BRICKFILE_COMPRESSION_SHUFFLE_LZ);
+	brickFile_makeEmptyFile(brickFile);
+	brickFile_del(&brickFile);
+
+	brickFile = brickFile_newFromFile("brickTestEmpty.brick");
+	brickFile_getSize(brickFile, dims);
+	if (dims[0] != 9 || dims[1] != 7 || dims[2] != 5)
+		hasPassed = false;
+	brickFile_getBrickSize(brickFile, dims);
+	if (dims[0] != 4 || dims[1] != 3 || dims[2] != 2)
+		hasPassed = false;
+	if (brickFile->numBricks[0] != 3 || brickFile->numBricks[1] != 3
+	    || brickFile->numBricks[2] != 3)
+		hasPassed = false;
+	if (brickFile_getFormat(brickFile) != BRICKFILE_FORMAT_DOUBLE)
+		hasPassed = false;
+	if (brickFile_getNumComponents(brickFile) != 2)
+		hasPassed = false;
+	if (brickFile_getCompression(brickFile)
+	    != BRICKFILE_COMPRESSION_SHUFFLE_LZ)
+		hasPassed = false;
+	if (brickFile_getStatistics(brickFile, NULL, NULL, NULL, NULL) != 0)
+		hasPassed = false;
+	for (int i = 0; i < 2 * 27; i++) {
+		if (brickFile->index[i] != 0)
+			hasPassed = false;
+	}
+	brickFile_del(&brickFile);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* brickFile_newFromFile_test */
+
+extern bool
+brickFile_del_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	brickFile_t brickFile;
+#ifdef XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	brickFile = brickFile_new();
+	brickFile_setFileName(brickFile, "brickTestDel.brick");
+	brickFile_del(&brickFile);
+	if (brickFile != NULL)
+		hasPassed = false;
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+brickFile_readWriteWindowed_test(void)
+{
+	bool        hasPassed   = true;
+	int         rank        = 0;
+	brickFile_t brickFile;
+	uint32_t    idxLo[3][3] = {{0, 0, 0}, {0, 0, 2}, {1, 2, 0}};
+	uint32_t    dims[3][3]  = {{9, 7, 2}, {9, 7, 3}, {6, 3, 5}};
+	double      *data;
+	const char  *names[2]   = {"brickTestPlain.brick", "brickTestLZ.brick"};
+#ifdef XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	data = xmalloc(sizeof(double) * 3 * 9 * 7 * 5);
+
+	for (int c = 0; c < 2; c++) {
+		brickFile = local_getBrickFile(names[c], BRICKFILE_FORMAT_FLOAT,
+		                               c == 0 ? BRICKFILE_COMPRESSION_NONE
+		                               : BRICKFILE_COMPRESSION_SHUFFLE_LZ);
+		brickFile_makeEmptyFile(brickFile);
+
+		// Two slabs that cut through the bricks, with a third component
+		// in the data array that is not stored.
+		for (int w = 0; w < 2; w++) {
+			size_t pos = 0;
+			for (uint32_t k = 0; k < dims[w][2]; k++) {
+				for (uint32_t j = 0; j < dims[w][1]; j++) {
+					for (uint32_t i = 0; i < dims[w][0]; i++) {
+						double v = local_getValue(i + idxLo[w][0],
+						                          j + idxLo[w][1],
+						                          k + idxLo[w][2]);
+						data[pos++] = v;
+						data[pos++] = -v;
+						data[pos++] = 1e10;
+					}
+				}
+			}
+			brickFile_writeWindowed(brickFile, data,
+			                        BRICKFILE_FORMAT_DOUBLE, 3,
+			                        idxLo[w], dims[w]);
+		}
+		brickFile_del(&brickFile);
+
+		// Read an unaligned window with a fresh object.
+		brickFile = brickFile_newFromFile(names[c]);
+		for (size_t i = 0; i < 3 * 9 * 7 * 5; i++)
+			data[i] = 42.0;
+		brickFile_readWindowed(brickFile, data, BRICKFILE_FORMAT_DOUBLE, 3,
+		                       idxLo[2], dims[2]);
+		for (uint32_t k = 0; k < dims[2][2]; k++) {
+			for (uint32_t j = 0; j < dims[2][1]; j++) {
+				for (uint32_t i = 0; i < dims[2][0]; i++) {
+					size_t pos = 3 * (i + (j + k * dims[2][1]) * dims[2][0]);
+					double v   = (float)local_getValue(i + idxLo[2][0],
+					                                   j + idxLo[2][1],
+					                                   k + idxLo[2][2]);
+					if (islessgreater(data[pos], v)
+					    || islessgreater(data[pos + 1], -v)
+					    || islessgreater(data[pos + 2], 42.0))
+						hasPassed = false;
+				}
+			}
+		}
+		if (c == 1) {
+			// The smooth data must have been stored compressed.
+			bool isCompressed = false;
+			for (int i = 0; i < 27; i++) {
+				if (brickFile->index[2 * i + 1] < 4 * 3 * 2 * 2 * 4)
+					isCompressed = true;
+			}
+			if (!isCompressed)
+				hasPassed = false;
+		}
+		brickFile_del(&brickFile);
+	}
+
+	xfree(data);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* brickFile_readWriteWindowed_test */
+
+extern bool
+brickFile_getStatistics_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	brickFile_t brickFile;
+	uint32_t    idxLo[3]  = {0, 0, 0};
+	uint32_t    dims[3]   = {9, 7, 5};
+	uint32_t    rIdxLo[3] = {5, 4, 3};
+	uint32_t    rDims[3]  = {4, 3, 2};
+	double      *data, *ref;
+	double      min, max, mean, rms, refMin, refMax;
+	double      sum = 0.0, sumSq = 0.0;
+	FILE        *f;
+	long        fileSize;
+#ifdef XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	data = xmalloc(sizeof(double) * 2 * 9 * 7 * 5);
+	ref  = xmalloc(sizeof(double) * 2 * 9 * 7 * 5);
+	for (size_t i = 0; i < 9 * 7 * 5; i++) {
+		data[2 * i]     = (double)i;
+		data[2 * i + 1] = -0.5 * i;
+		sum            += 0.5 * i;
+		sumSq          += 1.25 * i * i;
+	}
+
+	brickFile = local_getBrickFile("brickTestStats.brick",
+	                               BRICKFILE_FORMAT_DOUBLE,
+	                               BRICKFILE_COMPRESSION_NONE);
+	brickFile_makeEmptyFile(brickFile);
+	brickFile_writeWindowed(brickFile, data, BRICKFILE_FORMAT_DOUBLE, 2,
+	                        idxLo, dims);
+	brickFile_del(&brickFile);
+
+	brickFile = brickFile_newFromFile("brickTestStats.brick");
+	if (brickFile_getStatistics(brickFile, &min, &max, &mean, &rms)
+	    != 2 * 9 * 7 * 5)
+		hasPassed = false;
+	if (islessgreater(min, -0.5 * 314) || islessgreater(max, 314.0))
+		hasPassed = false;
+	if (fabs(mean - sum / 630.) > 1e-10 || fabs(rms - sqrt(sumSq / 630.))
+	    > 1e-10)
+		hasPassed = false;
+	brickFile_del(&brickFile);
+
+	// Rewrite an unaligned window holding the maximum, the old values must
+	// leave the statistics and the bricks must keep their place.
+	for (size_t i = 0; i < 9 * 7 * 5; i++) {
+		ref[2 * i]     = data[2 * i];
+		ref[2 * i + 1] = data[2 * i + 1];
+	}
+	for (uint32_t k = 0; k < rDims[2]; k++) {
+		for (uint32_t j = 0; j < rDims[1]; j++) {
+			for (uint32_t i = 0; i < rDims[0]; i++) {
+				size_t pos = i + (j + k * rDims[1]) * rDims[0];
+				size_t idx = (i + rIdxLo[0]) + ((j + rIdxLo[1])
+				             + (k + rIdxLo[2]) * 7) * 9;
+				data[2 * pos]     = 0.25 * idx;
+				data[2 * pos + 1] = 7.0;
+				ref[2 * idx]      = 0.25 * idx;
+				ref[2 * idx + 1]  = 7.0;
+			}
+		}
+	}
+	sum    = 0.0;
+	sumSq  = 0.0;
+	refMin = ref[0];
+	refMax = ref[0];
+	for (size_t i = 0; i < 2 * 9 * 7 * 5; i++) {
+		sum   += ref[i];
+		sumSq += ref[i] * ref[i];
+		refMin = (ref[i] < refMin) ? ref[i] : refMin;
+		refMax = (ref[i] > refMax) ? ref[i] : refMax;
+	}
+	brickFile = brickFile_newFromFile("brickTestStats.brick");
+	f         = xfopen("brickTestStats.brick", "rb");
+	xfseek(f, 0L, SEEK_END);
+	fileSize  = xftell(f);
+	xfclose(&f);
+	brickFile_writeWindowed(brickFile, data, BRICKFILE_FORMAT_DOUBLE, 2,
+	                        rIdxLo, rDims);
+	if (brickFile_getStatistics(brickFile, &min, &max, &mean, &rms)
+	    != 2 * 9 * 7 * 5)
+		hasPassed = false;
+	if (islessgreater(min, refMin) || islessgreater(max, refMax))
+		hasPassed = false;
+	if (fabs(mean - sum / 630.) > 1e-10 || fabs(rms - sqrt(sumSq / 630.))
+	    > 1e-10)
+		hasPassed = false;
+	f = xfopen("brickTestStats.brick", "rb");
+	xfseek(f, 0L, SEEK_END);
+	if (xftell(f) != fileSize)
+		hasPassed = false;
+	xfclose(&f);
+	brickFile_del(&brickFile);
+
+	xfree(ref);
+	xfree(data);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* brickFile_getStatistics_test */
+
+/*--- Implementations of local functions --------------------------------*/
+static brickFile_t
+local_getBrickFile(const char             *fileName,
+                   brickFileFormat_t      format,
+                   brickFileCompression_t compression)
+{
+	brickFile_t brickFile;
+	uint32_t    dims[3]      = {9, 7, 5};
+	uint32_t    brickDims[3] = {4, 3, 2};
+
+	brickFile = brickFile_new();
+	brickFile_setFileName(brickFile, fileName);
+	brickFile_setSize(brickFile, dims);
+	brickFile_setBrickSize(brickFile, brickDims);
+	brickFile_setFormat(brickFile, format);
+	brickFile_setNumComponents(brickFile, 2);
+	brickFile_setCompression(brickFile, compression);
+
+	return brickFile;
+}
+
+static double
+local_getValue(uint32_t i, uint32_t j, uint32_t k)
+{
+	return 1.0 + 0.001 * i + 0.01 * j + 0.1 * k;
+}
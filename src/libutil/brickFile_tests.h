@@ -0,0 +1,31 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BRICKFILE_TESTS_H
+#define BRICKFILE_TESTS_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+brickFile_new_test(void);
+
+extern bool
+brickFile_newFromFile_test(void);
+
+extern bool
+brickFile_del_test(void);
+
+extern bool
+brickFile_readWriteWindowed_test(void);
+
+extern bool
+brickFile_getStatistics_test(void);
+
+
+#endif
@@ -16,6 +16,8 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "byteswap.h"
 #include <assert.h>
+#include <string.h>
+#include <stdint.h>
 
 
 /*--- Implemenations of exported functions ------------------------------*/
@@ -50,3 +52,47 @@ byteswapVec(void *vec, size_t sizeOfVec, int numComponents)
 		}
 	}
 }
+
+extern void
+byteswapArray(void *p, size_t s, size_t n)
+{
+	unsigned char *pc = (unsigned char *)p;
+
+	// memcpy instead of a cast to stay clear of alignment and aliasing
+	// issues, compilers turn it into plain loads and stores.
+	if (s == 2) {
+		for (size_t i = 0; i < n; i++) {
+			uint16_t v;
+			memcpy(&v, pc + i * 2, 2);
+			v = (uint16_t)((v >> 8) | (v << 8));
+			memcpy(pc + i * 2, &v, 2);
+		}
+	} else if (s == 4) {
+		for (size_t i = 0; i < n; i++) {
+			uint32_t v;
+			memcpy(&v, pc + i * 4, 4);
+			v = ((v >> 24) & UINT32_C(0x000000ff))
+			    | ((v >> 8) & UINT32_C(0x0000ff00))
+			    | ((v << 8) & UINT32_C(0x00ff0000))
+			    | ((v << 24) & UINT32_C(0xff000000));
+			memcpy(pc + i * 4, &v, 4);
+		}
+	} else if (s == 8) {
+		for (size_t i = 0; i < n; i++) {
+			uint64_t v;
+			memcpy(&v, pc + i * 8, 8);
+			v = ((v >> 56) & UINT64_C(0x00000000000000ff))
+			    | ((v >> 40) & UINT64_C(0x000000000000ff00))
+			    | ((v >> 24) & UINT64_C(0x0000000000ff0000))
+			    | ((v >> 8) & UINT64_C(0x00000000ff000000))
+			    | ((v << 8) & UINT64_C(0x000000ff00000000))
+			    | ((v << 24) & UINT64_C(0x0000ff0000000000))
+			    | ((v << 40) & UINT64_C(0x00ff000000000000))
+			    | ((v << 56) & UINT64_C(0xff00000000000000));
+			memcpy(pc + i * 8, &v, 8);
+		}
+	} else {
+		for (size_t i = 0; i < n; i++)
+			byteswap(pc + i * s, s);
+	}
+}
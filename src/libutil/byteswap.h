@@ -58,4 +58,22 @@ byteswap(void *p, size_t s);
 extern void
 byteswapVec(void *vec, size_t sizeOfVec, int numComponents);
 
+/**
+ * @brief  Performs a byteswapping of all elements of an array.
+ *
+ * This is equivalent to calling byteswap() for every element, but much
+ * faster for the common element sizes of 2, 4 and 8 bytes.
+ *
+ * @param[in,out]  *p
+ *                    The array that should be byteswapped.
+ * @param[in]      s
+ *                    The number of bytes of one element.
+ * @param[in]      n
+ *                    The number of elements in the array.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+byteswapArray(void *p, size_t s, size_t n);
+
 #endif
@@ -148,6 +148,25 @@ local_writeBlockActual(FILE         *f,
                        bool         isInteger);
 
 
+/**
+ * @brief  Writes a contiguous chunk of data through the direct I/O
+ *         interface of xfile, bypassing the stream buffer.
+ *
+ * @param[in,out]  gadget
+ *                    The Gadget object, the current file needs to be
+ *                    positioned where the data should go.  After the call
+ *                    the file is positioned directly behind the data.
+ * @param[in]      data
+ *                    The data to write.
+ * @param[in]      bytes
+ *                    The number of bytes to write.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeBlockDirect(gadget_t gadget, const void *data, size_t bytes);
+
+
 /**
  * @brief  This is the general version of writing data to the file.
  *
@@ -324,6 +343,7 @@ gadget_new(void)
 	gadget->lastOpened  = -1;
 	gadget->headers     = NULL;
 	gadget->tocs        = NULL;
+	gadget->useDirectIO = false;
 
 	return gadget;
 }
@@ -446,6 +466,14 @@ gadget_setFileEndianess(gadget_t gadget, endian_t endianess)
 		gadget->doByteSwap = false;
 }
 
+extern void
+gadget_setUseDirectIO(gadget_t gadget, bool useDirectIO)
+{
+	assert(gadget != NULL);
+
+	gadget->useDirectIO = useDirectIO;
+}
+
 extern void
 gadget_setHeaderOfFile(gadget_t       gadget,
                        int            fileNumber,
@@ -693,8 +721,15 @@ gadget_writeBlockToCurrentFile(gadget_t      gadget,
 	gadgetBlock_writeBlockSize(gadget->f, bs, gadget->doByteSwap);
 	xfseek(gadget->f, pSkipFile * sOE, SEEK_CUR);
 
-	local_writeBlockActual(gadget->f, stai, gadget->doByteSwap, pWriteFile,
-	                       sOE, nC, gadgetBlock_isInteger(block));
+	if (gadget->useDirectIO && !gadget->doByteSwap && stai_isLinear(stai)
+	    && (sOE == (size_t)stai_getSizeOfElementInBytes(stai))) {
+		local_writeBlockDirect(gadget, stai_getBase(stai),
+		                       (size_t)pWriteFile * sOE);
+	} else {
+		local_writeBlockActual(gadget->f, stai, gadget->doByteSwap,
+		                       pWriteFile, sOE, nC,
+		                       gadgetBlock_isInteger(block));
+	}
 
 	xfseek(gadget->f, (nPiB - pSkipFile - pWriteFile) * sOE, SEEK_CUR);
 	gadgetBlock_writeBlockSize(gadget->f, bs, gadget->doByteSwap);
@@ -949,6 +984,23 @@ local_writeBlockActual(FILE         *f,
 	}
 }
 
+static void
+local_writeBlockDirect(gadget_t gadget, const void *data, size_t bytes)
+{
+	xfileDirect_t fd;
+	long          pos;
+
+	fflush(gadget->f);
+	pos = xftell(gadget->f);
+
+	fd  = xfile_openDirect(gadget->fileNames[gadget->lastOpened],
+	                       (size_t)pos);
+	xfile_writeDirect(fd, data, bytes);
+	xfile_closeDirect(&fd);
+
+	xfseek(gadget->f, pos + (long)bytes, SEEK_SET);
+}
+
 static void
 local_writeBlockActualGeneral(FILE         *f,
                               uint64_t     pWrite,
@@ -209,6 +209,26 @@ extern void
 gadget_setFileEndianess(gadget_t gadget, endian_t endianess);
 
 
+/**
+ * @brief  Sets whether the particle data should be written with direct
+ *         I/O.
+ *
+ * When enabled, blocks that can be written without conversion bypass the
+ * stream buffer and are written through xfile_openDirect(), which keeps
+ * large snapshots from flooding the page cache.  This is most effective
+ * if the files have been preallocated with gadget_createEmptyFile().
+ *
+ * @param[in,out]  gadget
+ *                    The Gadget file object.  Must not be @c NULL.
+ * @param[in]      useDirectIO
+ *                    Toggles direct I/O, it is disabled by default.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gadget_setUseDirectIO(gadget_t gadget, bool useDirectIO);
+
+
 /**
  * @brief  Sets the header for a given file.
  *
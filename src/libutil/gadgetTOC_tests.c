@@ -149,6 +149,13 @@ gadgetTOC_clone_test(void)
 	           toc->blocks[0].nameInV2Files) != 0)
 		hasPassed = false;
 
+	// Blocks added to the clone must not show up in the template.
+	gadgetTOC_addEntryByType(clone, GADGETBLOCK_U___);
+	if (gadgetTOC_blockExists(toc, GADGETBLOCK_U___))
+		hasPassed = false;
+	if (clone->numBlocks != toc->numBlocks + 1)
+		hasPassed = false;
+
 	gadgetTOC_del(&clone);
 	gadgetTOC_del(&toc);
 #ifdef XMEM_TRACK_MEM
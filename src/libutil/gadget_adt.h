@@ -49,6 +49,8 @@ struct gadget_struct {
 	gadgetHeader_t  *headers;
 	/** @brief An array of length #numFiles holding the TOC of each file. */
 	gadgetTOC_t     *tocs;
+	/** @brief Toggles writing the particle data with xfile_writeDirect(). */
+	bool            useDirectIO;
 };
 
 #endif
@@ -284,6 +284,26 @@ gadget_writeBlockToCurrentFile_test(void)
 	                         "tests/gadgetFake_v2.big.dat"))
 		hasPassed = false;
 
+	gadget_setFileNamesFromStem(gadget, "gadgetFake_v2.direct.2.dat");
+	gadget_setFileVersion(gadget, GADGETVERSION_TWO);
+	gadget_setFileEndianess(gadget, ENDIAN_LITTLE);
+	gadget_setUseDirectIO(gadget, true);
+	gadget_createEmptyFile(gadget, 0);
+	gadget_open(gadget, GADGET_MODE_WRITE_CONT, 0);
+	gadget_writeHeaderToCurrentFile(gadget);
+	stai = stai_new(&(data[0][0]), 3 * sizeof(float), 3 * sizeof(float));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_POS_, 0, 20, stai);
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_VEL_, 0, 20, stai);
+	stai_del(&stai);
+	stai = stai_new(&(data[0][0]), sizeof(float), 3 * sizeof(float));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_ID__, 0, 20, stai);
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_MASS, 0, 10, stai);
+	stai_del(&stai);
+	gadget_close(gadget);
+	if (!xfile_filesAreEqual("gadgetFake_v2.direct.2.dat",
+	                         "tests/gadgetFake_v2.little.dat"))
+		hasPassed = false;
+
 	gadget_del(&gadget);
 	if (gadget != NULL)
 		hasPassed = false;
@@ -12,6 +12,14 @@
  */
 
 
+/*--- Feature test macros -----------------------------------------------*/
+// mmap() and posix_madvise() are XSI, this must be set before any system
+// header is included.
+#ifndef _XOPEN_SOURCE
+#  define _XOPEN_SOURCE 600
+#endif
+
+
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "grafic.h"
@@ -19,7 +27,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+#  include <errno.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#endif
+#ifdef WITH_OPENMP
+#  include <omp.h>
+#endif
 #include "endian.h"
 #include "xmem.h"
 #include "xstring.h"
@@ -34,6 +54,9 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The size of the largest header record including its markers. */
+#define LOCAL_MAX_HEADER_RECORD_SIZE 52
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static bool
@@ -66,6 +89,18 @@ local_readWindowedActualRead(const grafic_t           grafic,
                              const uint32_t *restrict dims,
                              bool                     doByteswap);
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+static void
+local_readWindowedMmap(const grafic_t           grafic,
+                       void *restrict           data,
+                       graficFormat_t           dataFormat,
+                       int                      numComponents,
+                       const uint32_t *restrict idxLo,
+                       const uint32_t *restrict dims,
+                       bool                     doByteswap);
+
+#endif
+
 static void
 local_writeWindowedActualRead(const grafic_t           grafic,
                               const void *restrict     data,
@@ -75,9 +110,12 @@ local_writeWindowedActualRead(const grafic_t           grafic,
                               const uint32_t *restrict dims,
                               bool                     doByteswap);
 
+static void
+local_checkPlaneMarkers(FILE *f, long offset, size_t numInPlane);
+
 static void
 local_cpBufferToData(float *restrict buffer,
-                     uint32_t        num,
+                     size_t          num,
                      void *restrict  data,
                      graficFormat_t  format,
                      int             numComponents,
@@ -86,21 +124,27 @@ local_cpBufferToData(float *restrict buffer,
 
 static void
 local_cpDataToBuffer(float *restrict      buffer,
-                     uint32_t             num,
+                     size_t               num,
                      const void *restrict data,
                      graficFormat_t       format,
                      int                  numComponents,
                      size_t               dataOffset,
                      bool                 doByteswap);
 
-static void
-local_skipPlane(FILE *f, long numInPlane);
+static size_t
+local_packHeader(grafic_t grafic, char *header);
 
 static void
-local_skipRow(FILE *f, long numInRow);
+local_writeHeader(grafic_t grafic, FILE *f);
 
 static void
-local_writeHeader(grafic_t grafic, FILE *f);
+local_writePlanesDirect(const grafic_t grafic,
+                        const void     *data,
+                        graficFormat_t dataFormat,
+                        int            numComponents,
+                        uint32_t       firstPlane,
+                        uint32_t       numPlanes,
+                        bool           doByteswap);
 
 static void
 local_writePlane(FILE           *f,
@@ -133,6 +177,8 @@ grafic_new(void)
 	grafic->omegav           = 0.0f;
 	grafic->h0               = 0.0f;
 	grafic->iseed            = 0;
+	grafic->useMmap          = false;
+	grafic->useDirectIO      = false;
 
 	grafic_setIsWhiteNoise(grafic, false);
 
@@ -375,6 +421,34 @@ grafic_setIsWhiteNoise(grafic_t grafic, bool isWhiteNoise)
 	grafic->headerSkip   = isWhiteNoise ? 16 : 44;
 }
 
+extern void
+grafic_setUseMmap(grafic_t grafic, bool useMmap)
+{
+	assert(grafic != NULL);
+
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	grafic->useMmap = useMmap;
+#else
+	grafic->useMmap = false;
+#endif
+}
+
+extern bool
+grafic_getUseMmap(const grafic_t grafic)
+{
+	assert(grafic != NULL);
+
+	return grafic->useMmap;
+}
+
+extern void
+grafic_setUseDirectIO(grafic_t grafic, bool useDirectIO)
+{
+	assert(grafic != NULL);
+
+	grafic->useDirectIO = useDirectIO;
+}
+
 extern void
 grafic_makeEmptyFile(const grafic_t grafic)
 {
@@ -390,11 +464,11 @@ grafic_makeEmptyFile(const grafic_t grafic)
 	assert(grafic->np3 > 0);
 
 	numInPlane = grafic->np1 * grafic->np2;
-	fileSize   = (numInPlane + 8) * grafic->np3;
-	fileSize  += grafic->headerSkip + 8;
+	fileSize   = (size_t)grafic_getPlaneOffset(grafic, grafic->np3);
 	xfile_createFileWithSize(grafic->graficFileName, fileSize);
 
-	f = xfopen(grafic->graficFileName, "w+b");
+	// Do not truncate, that would give back the reserved space.
+	f = xfopen(grafic->graficFileName, "r+b");
 	local_writeHeader(grafic, f);
 	b = (int)(numInPlane * sizeof(float));
 	if (grafic->fileEndianess != grafic->machineEndianess)
@@ -407,6 +481,19 @@ grafic_makeEmptyFile(const grafic_t grafic)
 	xfclose(&f);
 }
 
+extern long
+grafic_getPlaneOffset(const grafic_t grafic, uint32_t numPlane)
+{
+	long sizeOfRecord;
+
+	assert(grafic != NULL);
+
+	sizeOfRecord = (long)(sizeof(float) * grafic->np1 * grafic->np2)
+	               + 2 * sizeof(int);
+
+	return grafic->headerSkip + 2 * sizeof(int) + numPlane * sizeOfRecord;
+}
+
 extern void
 grafic_read(const grafic_t grafic,
             void           *data,
@@ -460,6 +547,14 @@ grafic_write(const grafic_t grafic,
 
 	numPlane = grafic->np1 * grafic->np2;
 
+	if (grafic->useDirectIO) {
+		xfile_createFileWithSize(grafic->graficFileName,
+		                         grafic_getPlaneOffset(grafic, grafic->np3));
+		local_writePlanesDirect(grafic, data, dataFormat, numComponents, 0,
+		                        grafic->np3, false);
+		return;
+	}
+
 	f        = xfopen(grafic->graficFileName, "wb");
 
 	local_writeHeader(grafic, f);
@@ -502,6 +597,13 @@ grafic_readWindowed(const grafic_t           grafic,
 
 	doByteswap = grafic->machineEndianess != grafic->fileEndianess;
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	if (grafic->useMmap) {
+		local_readWindowedMmap(grafic, data, dataFormat, numComponents,
+		                       idxLo, dims, doByteswap);
+		return;
+	}
+#endif
 	local_readWindowedActualRead(grafic, data, dataFormat, numComponents,
 	                             idxLo, dims, doByteswap);
 }
@@ -532,10 +634,18 @@ grafic_writeWindowed(const grafic_t           grafic,
 
 	doByteswap = grafic->machineEndianess != grafic->fileEndianess;
 
+	if (grafic->useDirectIO && (dims[0] == grafic->np1)
+	    && (dims[1] == grafic->np2)) {
+		local_writePlanesDirect(grafic, data, dataFormat, numComponents,
+		                        idxLo[2], dims[2], doByteswap);
+		return;
+	}
+
 	local_writeWindowedActualRead(grafic, data, dataFormat, numComponents,
 	                              idxLo, dims, doByteswap);
 }
 
+
 extern void
 grafic_readSlab(grafic_t       grafic,
                 void           *data,
@@ -659,8 +769,7 @@ local_readPlane(float *data, size_t numInPlane, FILE *f, bool doByteswap)
 		diediedie(EXIT_FAILURE);
 
 	if (doByteswap)
-		for (size_t i = 0; i < numInPlane; i++)
-			byteswap(data + i, sizeof(float));
+		byteswapArray(data, sizeof(float), numInPlane);
 }
 
 static void *
@@ -700,40 +809,145 @@ local_readWindowedActualRead(const grafic_t           grafic,
                              bool                     doByteswap)
 {
 	FILE   *f;
-	float  *buffer    = xmalloc(sizeof(float) * dims[0]);
+	size_t numInPlane = (size_t)(grafic->np1) * grafic->np2;
+	size_t numInBlock = (size_t)(grafic->np1) * dims[1];
+	bool   readBlock  = (2 * dims[0] >= grafic->np1);
+	float  *buffer;
 	size_t dataOffset = 0;
 
-	f = xfopen(grafic->graficFileName, "rb");
-	xfseek(f, grafic->headerSkip + 8L, SEEK_SET);
-	for (uint32_t k = 0; k < idxLo[2]; k++)
-		local_skipPlane(f, grafic->np1 * grafic->np2);
+	buffer = xmalloc(sizeof(float) * (readBlock ? numInBlock : dims[0]));
+
+	f      = xfopen(grafic->graficFileName, "rb");
 	for (uint32_t k = 0; k < dims[2]; k++) {
-		int b1, b2;
-		xfread(&b1, sizeof(int), 1, f);
-		for (uint32_t j = 0; j < idxLo[1]; j++)
-			local_skipRow(f, grafic->np1);
-		for (uint32_t j = 0; j < dims[1]; j++) {
-			if (idxLo[0] > 0)
-				xfseek(f, sizeof(float) * idxLo[0], SEEK_CUR);
-			xfread(buffer, sizeof(float), dims[0], f);
-			if (grafic->np1 - dims[0] - idxLo[0] > 0)
-				xfseek(f, sizeof(float) * (grafic->np1 - dims[0] - idxLo[0]),
-				       SEEK_CUR);
-			local_cpBufferToData(buffer, dims[0], data, dataFormat,
-			                     numComponents, dataOffset, doByteswap);
-			dataOffset += dims[0];
+		long offset = grafic_getPlaneOffset(grafic, idxLo[2] + k);
+
+		local_checkPlaneMarkers(f, offset, numInPlane);
+		offset += sizeof(int);
+		if (readBlock) {
+			// The window covers most of every row: get all rows of the
+			// window in one go and pick out the window afterwards.
+			xfseek(f, offset + (long)(sizeof(float) * grafic->np1
+			                          * idxLo[1]), SEEK_SET);
+			xfread(buffer, sizeof(float), numInBlock, f);
+			if (doByteswap)
+				byteswapArray(buffer, sizeof(float), numInBlock);
+			for (uint32_t j = 0; j < dims[1]; j++) {
+				local_cpBufferToData(buffer + (size_t)j * grafic->np1
+				                     + idxLo[0], dims[0], data,
+				                     dataFormat, numComponents,
+				                     dataOffset, false);
+				dataOffset += dims[0];
+			}
+		} else {
+			for (uint32_t j = 0; j < dims[1]; j++) {
+				size_t idx = (size_t)(idxLo[1] + j) * grafic->np1
+				             + idxLo[0];
+				xfseek(f, offset + (long)(sizeof(float) * idx), SEEK_SET);
+				xfread(buffer, sizeof(float), dims[0], f);
+				local_cpBufferToData(buffer, dims[0], data, dataFormat,
+				                     numComponents, dataOffset, doByteswap);
+				dataOffset += dims[0];
+			}
 		}
-		for (uint32_t j = 0; j < grafic->np2 - dims[1] - idxLo[1]; j++)
-			local_skipRow(f, grafic->np1);
-		xfread(&b2, sizeof(int), 1, f);
-		if (b1 != b2)
-			diediedie(EXIT_FAILURE);
 	}
 
 	xfclose(&f);
 	xfree(buffer);
 } /* local_readWindowedActualRead */
 
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+static void
+local_readWindowedMmap(const grafic_t           grafic,
+                       void *restrict           data,
+                       graficFormat_t           dataFormat,
+                       int                      numComponents,
+                       const uint32_t *restrict idxLo,
+                       const uint32_t *restrict dims,
+                       bool                     doByteswap)
+{
+	size_t      numInPlane = (size_t)(grafic->np1) * grafic->np2;
+	size_t      numRows    = (size_t)(dims[1]) * dims[2];
+	int         numThreads = 1;
+	float       *buffer    = NULL;
+	off_t       offsetFirst, offsetEnd, mapStart;
+	size_t      mapLength;
+	struct stat fileStat;
+	char        *map;
+	int         fd;
+
+	offsetFirst = grafic_getPlaneOffset(grafic, idxLo[2]);
+	offsetEnd   = grafic_getPlaneOffset(grafic, idxLo[2] + dims[2]);
+	mapStart    = offsetFirst - offsetFirst % sysconf(_SC_PAGESIZE);
+	mapLength   = (size_t)(offsetEnd - mapStart);
+
+	fd          = open(grafic->graficFileName, O_RDONLY);
+	if ((fd == -1) || (fstat(fd, &fileStat) != 0)) {
+		fprintf(stderr, "Could not open %s: %s\n",
+		        grafic->graficFileName, strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+	if (fileStat.st_size < offsetEnd) {
+		fprintf(stderr, "%s is too small for its header\n",
+		        grafic->graficFileName);
+		diediedie(EXIT_FAILURE);
+	}
+	map = mmap(NULL, mapLength, PROT_READ, MAP_PRIVATE, fd, mapStart);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "Could not map %s: %s\n",
+		        grafic->graficFileName, strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+	close(fd);
+	posix_madvise(map, mapLength, POSIX_MADV_SEQUENTIAL);
+
+	for (uint32_t k = 0; k < dims[2]; k++) {
+		const char *plane = map + (grafic_getPlaneOffset(grafic,
+		                                                idxLo[2] + k)
+		                           - mapStart);
+		if (memcmp(plane, plane + sizeof(int) + sizeof(float) * numInPlane,
+		           sizeof(int)) != 0) {
+			fprintf(stderr, "Corrupted record markers in %s\n",
+			        grafic->graficFileName);
+			diediedie(EXIT_FAILURE);
+		}
+	}
+
+#ifdef WITH_OPENMP
+	numThreads = omp_get_max_threads();
+#endif
+	if (doByteswap)
+		buffer = xmalloc(sizeof(float) * dims[0] * numThreads);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+	for (size_t r = 0; r < numRows; r++) {
+		size_t j      = idxLo[1] + r % dims[1];
+		size_t k      = idxLo[2] + r / dims[1];
+		off_t  offset = grafic_getPlaneOffset(grafic, k) + sizeof(int)
+		                + sizeof(float) * (j * grafic->np1 + idxLo[0]);
+		float  *row   = (float *)(map + (offset - mapStart));
+
+		if (doByteswap) {
+			int tid = 0;
+#ifdef WITH_OPENMP
+			tid = omp_get_thread_num();
+#endif
+			memcpy(buffer + (size_t)(dims[0]) * tid, row,
+			       sizeof(float) * dims[0]);
+			row = buffer + (size_t)(dims[0]) * tid;
+		}
+		local_cpBufferToData(row, dims[0], data, dataFormat,
+		                     numComponents, r * dims[0], doByteswap);
+	}
+
+	if (buffer != NULL)
+		xfree(buffer);
+	munmap(map, mapLength);
+} /* local_readWindowedMmap */
+
+#endif
+
 static void
 local_writeWindowedActualRead(const grafic_t           grafic,
                               const void *restrict     data,
@@ -744,61 +958,78 @@ local_writeWindowedActualRead(const grafic_t           grafic,
                               bool                     doByteswap)
 {
 	FILE   *f;
-	float  *buffer    = xmalloc(sizeof(float) * dims[0]);
-	size_t dataOffset = 0;
+	size_t numInPlane  = (size_t)(grafic->np1) * grafic->np2;
+	bool   writeBlock  = (dims[0] == grafic->np1);
+	size_t numInBuffer = writeBlock ? (size_t)(dims[0]) * dims[1] : dims[0];
+	float  *buffer     = xmalloc(sizeof(float) * numInBuffer);
+	size_t dataOffset  = 0;
 
 	f = xfopen(grafic->graficFileName, "r+b");
-	xfseek(f, grafic->headerSkip + 8L, SEEK_SET);
-	for (uint32_t k = 0; k < idxLo[2]; k++)
-		local_skipPlane(f, grafic->np1 * grafic->np2);
 	for (uint32_t k = 0; k < dims[2]; k++) {
-		int b1, b2;
-		xfread(&b1, sizeof(int), 1, f);
-		for (uint32_t j = 0; j < idxLo[1]; j++)
-			xfseek(f, grafic->np1 * sizeof(float), SEEK_CUR);
-		for (uint32_t j = 0; j < dims[1]; j++) {
-			if (idxLo[0] > 0)
-				xfseek(f, sizeof(float) * idxLo[0], SEEK_CUR);
-			local_cpDataToBuffer(buffer, dims[0], data, dataFormat,
+		long offset = grafic_getPlaneOffset(grafic, idxLo[2] + k);
+
+		local_checkPlaneMarkers(f, offset, numInPlane);
+		offset += sizeof(int);
+		if (writeBlock) {
+			// Full rows are contiguous in the file, write them at once.
+			local_cpDataToBuffer(buffer, numInBuffer, data, dataFormat,
 			                     numComponents, dataOffset, doByteswap);
-			dataOffset += dims[0];
-			xfwrite(buffer, sizeof(float), dims[0], f);
-			if (grafic->np1 - dims[0] - idxLo[0] > 0)
-				xfseek(f, sizeof(float) * (grafic->np1 - dims[0] - idxLo[0]),
-				       SEEK_CUR);
+			dataOffset += numInBuffer;
+			xfseek(f, offset + (long)(sizeof(float) * grafic->np1
+			                          * idxLo[1]), SEEK_SET);
+			xfwrite(buffer, sizeof(float), numInBuffer, f);
+		} else {
+			for (uint32_t j = 0; j < dims[1]; j++) {
+				size_t idx = (size_t)(idxLo[1] + j) * grafic->np1
+				             + idxLo[0];
+				local_cpDataToBuffer(buffer, dims[0], data, dataFormat,
+				                     numComponents, dataOffset, doByteswap);
+				dataOffset += dims[0];
+				xfseek(f, offset + (long)(sizeof(float) * idx), SEEK_SET);
+				xfwrite(buffer, sizeof(float), dims[0], f);
+			}
 		}
-		for (uint32_t j = 0; j < grafic->np2 - dims[1] - idxLo[1]; j++)
-			xfseek(f, grafic->np1 * sizeof(float), SEEK_CUR);
-		xfread(&b2, sizeof(int), 1, f);
-		if (b1 != b2)
-			diediedie(EXIT_FAILURE);
 	}
 
 	xfclose(&f);
 	xfree(buffer);
 } /* local_writeWindowedActualRead */
 
+static void
+local_checkPlaneMarkers(FILE *f, long offset, size_t numInPlane)
+{
+	int b1, b2;
+
+	xfseek(f, offset, SEEK_SET);
+	xfread(&b1, sizeof(int), 1, f);
+	xfseek(f, offset + (long)(sizeof(int) + sizeof(float) * numInPlane),
+	       SEEK_SET);
+	xfread(&b2, sizeof(int), 1, f);
+	if (b1 != b2)
+		diediedie(EXIT_FAILURE);
+}
+
 static void
 local_cpBufferToData(float *restrict buffer,
-                     uint32_t        num,
+                     size_t          num,
                      void *restrict  data,
                      graficFormat_t  format,
                      int             numComponents,
                      size_t          dataOffset,
                      bool            doByteswap)
 {
-	if (doByteswap) {
-		for (uint32_t i = 0; i < num; i++)
-			byteswap(buffer + i, sizeof(float));
-	}
+	if (doByteswap)
+		byteswapArray(buffer, sizeof(float), num);
 
-	if (format == GRAFIC_FORMAT_FLOAT) {
-		for (uint32_t i = 0; i < num; i++) {
+	if ((format == GRAFIC_FORMAT_FLOAT) && (numComponents == 1)) {
+		memcpy(((float *)data) + dataOffset, buffer, sizeof(float) * num);
+	} else if (format == GRAFIC_FORMAT_FLOAT) {
+		for (size_t i = 0; i < num; i++) {
 			size_t idx = (dataOffset + i) * numComponents;
 			((float *)data)[idx] = buffer[i];
 		}
 	} else {
-		for (uint32_t i = 0; i < num; i++) {
+		for (size_t i = 0; i < num; i++) {
 			size_t idx = (dataOffset + i) * numComponents;
 			((double *)data)[idx] = (double)(buffer[i]);
 		}
@@ -807,80 +1038,81 @@ local_cpBufferToData(float *restrict buffer,
 
 static void
 local_cpDataToBuffer(float *restrict      buffer,
-                     uint32_t             num,
+                     size_t               num,
                      const void *restrict data,
                      graficFormat_t       format,
                      int                  numComponents,
                      size_t               dataOffset,
                      bool                 doByteswap)
 {
-	if (format == GRAFIC_FORMAT_FLOAT) {
-		for (uint32_t i = 0; i < num; i++) {
+	if ((format == GRAFIC_FORMAT_FLOAT) && (numComponents == 1)) {
+		memcpy(buffer, ((const float *)data) + dataOffset,
+		       sizeof(float) * num);
+	} else if (format == GRAFIC_FORMAT_FLOAT) {
+		for (size_t i = 0; i < num; i++) {
 			size_t idx = (dataOffset + i) * numComponents;
 			buffer[i] = ((float *)data)[idx];
 		}
 	} else {
-		for (uint32_t i = 0; i < num; i++) {
+		for (size_t i = 0; i < num; i++) {
 			size_t idx = (dataOffset + i) * numComponents;
 			buffer[i] = (float)(((double *)data)[idx]);
 		}
 	}
 
-	if (doByteswap) {
-		for (uint32_t i = 0; i < num; i++)
-			byteswap(buffer + i, sizeof(float));
-	}
-}
-
-static void
-local_skipRow(FILE *f, long numInRow)
-{
-	xfseek(f, numInRow * sizeof(float), SEEK_CUR);
+	if (doByteswap)
+		byteswapArray(buffer, sizeof(float), num);
 }
 
-static void
-local_skipPlane(FILE *f, long numInPlane)
+static size_t
+local_packHeader(grafic_t grafic, char *header)
 {
-	int b1, b2;
-
-	xfread(&b1, sizeof(int), 1, f);
-
-	xfseek(f, numInPlane * sizeof(float), SEEK_CUR);
-
-	xfread(&b2, sizeof(int), 1, f);
-	if (b1 != b2)
-		diediedie(EXIT_FAILURE);
-}
+	char *p = header;
 
-static void
-local_writeHeader(grafic_t grafic, FILE *f)
-{
 	if (grafic->machineEndianess != grafic->fileEndianess) {
 		local_swapHeaderValues(grafic); // swap to file encoding
 		byteswap(&(grafic->headerSkip), sizeof(int));
 	}
 
-	xfwrite(&(grafic->headerSkip), sizeof(int), 1, f);
-	xfwrite(&(grafic->np1), sizeof(int), 1, f);
-	xfwrite(&(grafic->np2), sizeof(int), 1, f);
-	xfwrite(&(grafic->np3), sizeof(int), 1, f);
+	memcpy(p, &(grafic->headerSkip), sizeof(int));
+	p += sizeof(int);
+	memcpy(p, &(grafic->np1), sizeof(int));
+	p += sizeof(int);
+	memcpy(p, &(grafic->np2), sizeof(int));
+	p += sizeof(int);
+	memcpy(p, &(grafic->np3), sizeof(int));
+	p += sizeof(int);
 	if (!grafic->isWhiteNoise) {
-		xfwrite(&(grafic->dx), sizeof(float), 1, f);
-		xfwrite(&(grafic->x1o), sizeof(float), 1, f);
-		xfwrite(&(grafic->x2o), sizeof(float), 1, f);
-		xfwrite(&(grafic->x3o), sizeof(float), 1, f);
-		xfwrite(&(grafic->astart), sizeof(float), 1, f);
-		xfwrite(&(grafic->omegam), sizeof(float), 1, f);
-		xfwrite(&(grafic->omegav), sizeof(float), 1, f);
-		xfwrite(&(grafic->h0), sizeof(float), 1, f);
-	} else
-		xfwrite(&(grafic->iseed), sizeof(int), 1, f);
-	xfwrite(&(grafic->headerSkip), sizeof(int), 1, f);
+		const float values[8] = {grafic->dx,     grafic->x1o,
+		                         grafic->x2o,    grafic->x3o,
+		                         grafic->astart, grafic->omegam,
+		                         grafic->omegav, grafic->h0};
+		memcpy(p, values, sizeof(values));
+		p += sizeof(values);
+	} else {
+		memcpy(p, &(grafic->iseed), sizeof(int));
+		p += sizeof(int);
+	}
+	memcpy(p, &(grafic->headerSkip), sizeof(int));
+	p += sizeof(int);
 
 	if (grafic->machineEndianess != grafic->fileEndianess) {
 		local_swapHeaderValues(grafic); // swap back to system
 		byteswap(&(grafic->headerSkip), sizeof(int));
 	}
+
+	assert(p - header <= LOCAL_MAX_HEADER_RECORD_SIZE);
+
+	return (size_t)(p - header);
+}
+
+static void
+local_writeHeader(grafic_t grafic, FILE *f)
+{
+	char   header[LOCAL_MAX_HEADER_RECORD_SIZE];
+	size_t size = local_packHeader(grafic, header);
+
+	xfwrite(header, 1, size, f);
 }
 
 static void
@@ -905,3 +1137,56 @@ local_writePlane(FILE           *f,
 		}
 	}
 }
+
+static void
+local_writePlanesDirect(const grafic_t grafic,
+                        const void     *data,
+                        graficFormat_t dataFormat,
+                        int            numComponents,
+                        uint32_t       firstPlane,
+                        uint32_t       numPlanes,
+                        bool           doByteswap)
+{
+	size_t        numInPlane = (size_t)(grafic->np1) * grafic->np2;
+	bool          isPlain    = (dataFormat == GRAFIC_FORMAT_FLOAT)
+	                           && (numComponents == 1) && !doByteswap;
+	float         *buffer    = NULL;
+	size_t        dataOffset = 0;
+	int           b          = (int)(numInPlane * sizeof(float));
+	xfileDirect_t out;
+
+	if (doByteswap)
+		byteswap(&b, sizeof(int));
+	if (!isPlain)
+		buffer = xmalloc(sizeof(float) * numInPlane);
+
+	// Starting with the first plane, the header is written as well to
+	// have one contiguous region.
+	if (firstPlane == 0) {
+		char   header[LOCAL_MAX_HEADER_RECORD_SIZE];
+		size_t size = local_packHeader(grafic, header);
+		out = xfile_openDirect(grafic->graficFileName, 0);
+		xfile_writeDirect(out, header, size);
+	} else {
+		out = xfile_openDirect(grafic->graficFileName,
+		                       grafic_getPlaneOffset(grafic, firstPlane));
+	}
+
+	for (uint32_t k = 0; k < numPlanes; k++) {
+		xfile_writeDirect(out, &b, sizeof(int));
+		if (isPlain) {
+			xfile_writeDirect(out, ((const float *)data) + dataOffset,
+			                  sizeof(float) * numInPlane);
+		} else {
+			local_cpDataToBuffer(buffer, numInPlane, data, dataFormat,
+			                     numComponents, dataOffset, doByteswap);
+			xfile_writeDirect(out, buffer, sizeof(float) * numInPlane);
+		}
+		xfile_writeDirect(out, &b, sizeof(int));
+		dataOffset += numInPlane;
+	}
+
+	xfile_closeDirect(&out);
+	if (buffer != NULL)
+		xfree(buffer);
+} /* local_writePlanesDirect */
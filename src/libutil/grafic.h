@@ -377,6 +377,59 @@ extern void
 grafic_setIsWhiteNoise(grafic_t grafic, bool isWhiteNoise);
 
 
+/**
+ * @brief  Selects whether windows are read through a memory mapping.
+ *
+ * By default grafic_readWindowed() reads all rows of the window of one
+ * plane with a single read if the window spans at least half of a row,
+ * and row by row otherwise.  With a memory mapping the rows are instead
+ * copied directly from the mapped file, which is preferable for narrow
+ * windows.  This is only available on systems conforming to XSI
+ * (_XOPEN_SOURCE >= 600), otherwise the setting is ignored, see
+ * grafic_getUseMmap().
+ *
+ * @param[in,out]  grafic
+ *                    The file object to work with.
+ * @param[in]      useMmap
+ *                    Whether to use a memory mapping.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+grafic_setUseMmap(grafic_t grafic, bool useMmap);
+
+/**
+ * @brief  Tells whether windows are read through a memory mapping.
+ *
+ * @param[in]  grafic
+ *                The file object to query.
+ *
+ * @return  Returns @c true if windows are read through a memory mapping,
+ *          this is always @c false without XSI support.
+ */
+extern bool
+grafic_getUseMmap(const grafic_t grafic);
+
+
+/**
+ * @brief  Selects whether large writes bypass the page cache.
+ *
+ * If enabled, grafic_write() and grafic_writeWindowed() for windows
+ * covering whole planes stream the planes through xfile_openDirect(), so
+ * that writing large files does not evict other data from the page
+ * cache.  Narrower windows are always written through the page cache.
+ *
+ * @param[in,out]  grafic
+ *                    The file object to work with.
+ * @param[in]      useDirectIO
+ *                    Whether to bypass the page cache.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+grafic_setUseDirectIO(grafic_t grafic, bool useDirectIO);
+
+
 /** @} */
 
 /**
@@ -396,6 +449,24 @@ grafic_setIsWhiteNoise(grafic_t grafic, bool isWhiteNoise);
 extern void
 grafic_makeEmptyFile(const grafic_t grafic);
 
+/**
+ * @brief  Gives the position of a plane in the file.
+ *
+ * The position is that of the leading record marker of the plane, the
+ * data of the plane starts sizeof(int) bytes later.  Asking for the plane
+ * after the last one gives the size of the file.
+ *
+ * @param[in]  grafic
+ *                The grafic object to work with.
+ * @param[in]  numPlane
+ *                The number of the plane, between 0 and np[2].
+ *
+ * @return  Returns the offset of the plane from the start of the file in
+ *          bytes.
+ */
+extern long
+grafic_getPlaneOffset(const grafic_t grafic, uint32_t numPlane);
+
 
 /**
  * @brief  Reads the complete grafic file into a prepared array.
@@ -0,0 +1,184 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/graficMPI.c
+ * @ingroup libutilFilesGrafic
+ * @brief  This file provides the implementation of the MPI-IO writer for
+ *         Grafic files.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "graficMPI.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <mpi.h>
+#include "xmem.h"
+#include "diediedie.h"
+#include "byteswap.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "grafic_adt.h"
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Converts the data of a window to the single precision floats
+ *         that are stored in the file.
+ *
+ * @param[out]  *buffer
+ *                 The buffer to fill, must hold @c num floats.
+ * @param[in]   num
+ *                 The number of elements to convert.
+ * @param[in]   *data
+ *                 The data of the window.
+ * @param[in]   format
+ *                 The format of the data.
+ * @param[in]   numComponents
+ *                 The number of components in the data, only the first
+ *                 one is converted.
+ * @param[in]   doByteswap
+ *                 Whether the buffer must be byteswapped for the file.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_cpDataToBuffer(float *restrict      buffer,
+                     size_t               num,
+                     const void *restrict data,
+                     graficFormat_t       format,
+                     int                  numComponents,
+                     bool                 doByteswap);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern void
+graficMPI_writeWindowed(const grafic_t           grafic,
+                        const void *restrict     data,
+                        graficFormat_t           dataFormat,
+                        int                      numComponents,
+                        const uint32_t *restrict idxLo,
+                        const uint32_t *restrict dims,
+                        MPI_Comm                 comm)
+{
+	MPI_File     fh;
+	MPI_Datatype planeType, fileType, memType;
+	int          sizes[2], subsizes[2], starts[2];
+	size_t       numElements;
+	float        *buffer = NULL;
+	const void   *writeBuffer;
+	bool         doByteswap;
+	int          rank;
+
+	assert(grafic != NULL);
+	assert(grafic->graficFileName != NULL);
+	assert(numComponents > 0);
+	assert(idxLo != NULL);
+	assert(dims != NULL);
+
+	numElements = (size_t)(dims[0]) * dims[1] * dims[2];
+	assert(data != NULL || numElements == 0);
+
+	if ((idxLo[0] + dims[0] > grafic->np1)
+	    || (idxLo[1] + dims[1] > grafic->np2)
+	    || (idxLo[2] + dims[2] > grafic->np3)) {
+		fprintf(stderr, "Window too large for file :(\n");
+		diediedie(EXIT_FAILURE);
+	}
+
+	doByteswap = grafic->machineEndianess != grafic->fileEndianess;
+	MPI_Comm_rank(comm, &rank);
+
+	// The header, the record markers and the zeros between the windows.
+	if (rank == 0)
+		grafic_makeEmptyFile(grafic);
+	MPI_Barrier(comm);
+
+	if (MPI_File_open(comm, grafic->graficFileName, MPI_MODE_WRONLY,
+	                  MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+		fprintf(stderr, "Could not open %s for writing.\n",
+		        grafic->graficFileName);
+		diediedie(EXIT_FAILURE);
+	}
+
+	if (numElements == 0) {
+		// Still take part in the collective write, with nothing to write.
+		MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native",
+		                  MPI_INFO_NULL);
+		MPI_File_write_at_all(fh, 0, NULL, 0, MPI_BYTE, MPI_STATUS_IGNORE);
+		MPI_File_close(&fh);
+		return;
+	}
+
+	// The window in one plane, repeated every record (plane and markers).
+	sizes[0]    = (int)(grafic->np2);
+	sizes[1]    = (int)(grafic->np1);
+	subsizes[0] = (int)(dims[1]);
+	subsizes[1] = (int)(dims[0]);
+	starts[0]   = (int)(idxLo[1]);
+	starts[1]   = (int)(idxLo[0]);
+	MPI_Type_create_subarray(2, sizes, subsizes, starts, MPI_ORDER_C,
+	                         MPI_FLOAT, &planeType);
+	MPI_Type_create_resized(planeType, 0,
+	                        grafic_getPlaneOffset(grafic, 1)
+	                        - grafic_getPlaneOffset(grafic, 0), &fileType);
+	MPI_Type_commit(&fileType);
+	MPI_Type_contiguous((int)(dims[0] * dims[1]), MPI_FLOAT, &memType);
+	MPI_Type_commit(&memType);
+
+	if ((dataFormat == GRAFIC_FORMAT_FLOAT) && (numComponents == 1)
+	    && !doByteswap) {
+		writeBuffer = data;
+	} else {
+		buffer      = xmalloc(sizeof(float) * numElements);
+		local_cpDataToBuffer(buffer, numElements, data, dataFormat,
+		                     numComponents, doByteswap);
+		writeBuffer = buffer;
+	}
+
+	MPI_File_set_view(fh, grafic_getPlaneOffset(grafic, idxLo[2])
+	                  + sizeof(int), MPI_FLOAT, fileType, "native",
+	                  MPI_INFO_NULL);
+	MPI_File_write_at_all(fh, 0, (void *)writeBuffer, (int)(dims[2]),
+	                      memType, MPI_STATUS_IGNORE);
+	MPI_File_close(&fh);
+
+	if (buffer != NULL)
+		xfree(buffer);
+	MPI_Type_free(&memType);
+	MPI_Type_free(&fileType);
+	MPI_Type_free(&planeType);
+} /* graficMPI_writeWindowed */
+
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_cpDataToBuffer(float *restrict      buffer,
+                     size_t               num,
+                     const void *restrict data,
+                     graficFormat_t       format,
+                     int                  numComponents,
+                     bool                 doByteswap)
+{
+	if (format == GRAFIC_FORMAT_FLOAT) {
+		for (size_t i = 0; i < num; i++)
+			buffer[i] = ((const float *)data)[i * numComponents];
+	} else {
+		for (size_t i = 0; i < num; i++)
+			buffer[i] = (float)(((const double *)data)[i * numComponents]);
+	}
+
+	if (doByteswap)
+		byteswapArray(buffer, sizeof(float), num);
+}
@@ -0,0 +1,69 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRAFICMPI_H
+#define GRAFICMPI_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/graficMPI.h
+ * @ingroup libutilFilesGrafic
+ * @brief  This file provides the MPI-IO writer for Grafic files.
+ *
+ * This is kept apart from grafic.h, so that code which is not compiled
+ * with the MPI compiler can still use the serial Grafic interface.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "grafic.h"
+#include <stdint.h>
+#include <mpi.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Collectively creates the file and writes the windows of all
+ *         tasks into it with MPI-IO.
+ *
+ * This must be called by all tasks of the communicator.  Task 0 creates
+ * the file with grafic_makeEmptyFile(), the windows of all tasks are then
+ * written with one collective write.  The windows must not overlap, parts
+ * of the file not covered by any window are zero.  A task without data
+ * passes a window with a zero extent.  The result is identical to calling
+ * grafic_makeEmptyFile() followed by grafic_writeWindowed() for every
+ * window.
+ *
+ * @param[in]  grafic
+ *                The file object to work with.
+ * @param[in]  data
+ *                The array to write.
+ * @param[in]  dataFormat
+ *                The format of the data array.
+ * @param[in]  numComponents
+ *                The number of components in the data array.
+ * @param[in]  *idxLo
+ *                The lower left corner of the window of this task.
+ * @param[in]  *dims
+ *                The size of the window of this task.
+ * @param[in]  comm
+ *                The communicator of the tasks that write the file.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+graficMPI_writeWindowed(const grafic_t           grafic,
+                        const void *restrict     data,
+                        graficFormat_t           dataFormat,
+                        int                      numComponents,
+                        const uint32_t *restrict idxLo,
+                        const uint32_t *restrict dims,
+                        MPI_Comm                 comm);
+
+
+#endif
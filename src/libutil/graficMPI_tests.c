@@ -0,0 +1,137 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "graficMPI_tests.h"
+#include "graficMPI.h"
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+#include "../libutil/xmem.h"
+#include "../libutil/xfile.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "grafic_adt.h"
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static double *
+local_getWindowMPI(int      rank,
+                   int      size,
+                   uint32_t *np,
+                   uint32_t *idxLo,
+                   uint32_t *dims);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+graficMPI_writeWindowed_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	int      size      = 1;
+	uint32_t np[3]     = {5, 4, 6};
+	float    xoff[3]   = {0.5f, 1.5f, 2.5f};
+	uint32_t idxLo[3], dims[3];
+	double   *data;
+	int      passed;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// A normal file in native byte order and a foreign white noise file.
+	for (int c = 0; c < 2; c++) {
+		grafic_t grafic = grafic_new();
+		grafic_t serial = grafic_new();
+
+		for (int i = 0; i < 2; i++) {
+			grafic_t g = (i == 0) ? grafic : serial;
+			grafic_setIsWhiteNoise(g, c == 1);
+			grafic_setSize(g, np);
+			if (c == 0) {
+				grafic_setDx(g, 0.25f);
+				grafic_setXoff(g, xoff);
+				grafic_setAstart(g, 0.02f);
+				grafic_setOmegam(g, 0.3f);
+				grafic_setOmegav(g, 0.7f);
+				grafic_setH0(g, 70.f);
+			} else {
+				grafic_setIseed(g, 666);
+				g->fileEndianess = (g->machineEndianess == ENDIAN_LITTLE)
+				                   ? ENDIAN_BIG : ENDIAN_LITTLE;
+			}
+		}
+		grafic_setFileName(grafic, "writeWindowedMPI.grafic");
+		grafic_setFileName(serial, "writeWindowedMPISerial.grafic");
+
+		if (rank == 0) {
+			grafic_makeEmptyFile(serial);
+			for (int r = 0; r < size; r++) {
+				data = local_getWindowMPI(r, size, np, idxLo, dims);
+				if (dims[2] > 0)
+					grafic_writeWindowed(serial, data, GRAFIC_FORMAT_DOUBLE,
+					                     2, idxLo, dims);
+				xfree(data);
+			}
+		}
+		data = local_getWindowMPI(rank, size, np, idxLo, dims);
+		graficMPI_writeWindowed(grafic, data, GRAFIC_FORMAT_DOUBLE, 2,
+		                        idxLo, dims, MPI_COMM_WORLD);
+		xfree(data);
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		if ((rank == 0)
+		    && !xfile_filesAreEqual("writeWindowedMPI.grafic",
+		                            "writeWindowedMPISerial.grafic"))
+			hasPassed = false;
+
+		grafic_del(&serial);
+		grafic_del(&grafic);
+	}
+	passed    = hasPassed ? 1 : 0;
+	MPI_Bcast(&passed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	hasPassed = (passed == 1);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* graficMPI_writeWindowed_test */
+
+
+/*--- Implementations of local functions --------------------------------*/
+static double *
+local_getWindowMPI(int      rank,
+                   int      size,
+                   uint32_t *np,
+                   uint32_t *idxLo,
+                   uint32_t *dims)
+{
+	double *data;
+	size_t numElements;
+
+	// Every task gets a set of planes without the borders in x.
+	idxLo[0]    = 1;
+	idxLo[1]    = 0;
+	idxLo[2]    = (uint32_t)(rank * np[2] / size);
+	dims[0]     = np[0] - 2;
+	dims[1]     = np[1];
+	dims[2]     = (uint32_t)((rank + 1) * np[2] / size) - idxLo[2];
+	numElements = (size_t)(dims[0]) * dims[1] * dims[2];
+
+	data        = xmalloc(sizeof(double) * 2 * (numElements + 1));
+	for (size_t i = 0; i < numElements; i++)
+		data[2 * i] = (double)(i + 1000 * rank);
+
+	return data;
+}
@@ -0,0 +1,19 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRAFICMPI_TESTS_H
+#define GRAFICMPI_TESTS_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+graficMPI_writeWindowed_test(void);
+
+
+#endif
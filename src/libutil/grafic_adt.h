@@ -38,6 +38,10 @@ struct grafic_struct {
 	bool     isWhiteNoise;
 	/** @brief  Gives the size of the header. */
 	int      headerSkip;
+	/** @brief  Toggles reading windows through a memory mapping. */
+	bool     useMmap;
+	/** @brief  Toggles writing whole planes past the page cache. */
+	bool     useDirectIO;
 	// Header entries always there
 	/** @brief  The x-size of the grid. */
 	uint32_t np1;
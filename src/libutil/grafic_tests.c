@@ -14,6 +14,7 @@
 #  include <mpi.h>
 #endif
 #include "../libutil/xmem.h"
+#include "../libutil/xfile.h"
 
 
 /*--- Implemention of main structure ------------------------------------*/
@@ -1055,4 +1056,147 @@ grafic_writeWindowed_test(void)
 	return hasPassed ? true : false;
 } /* grafic_readWindowed_test */
 
+extern bool
+grafic_readWriteWindowedBulk_test(void)
+{
+	bool     hasPassed   = true;
+	int      rank        = 0;
+	grafic_t grafic;
+	uint32_t size[3]     = {8, 6, 3};
+	uint32_t idxLo[4][3] = {{0, 1, 0}, {2, 5, 0}, {1, 0, 1}, {5, 2, 0}};
+	uint32_t dims[4][3]  = {{8, 4, 3}, {3, 1, 3}, {6, 5, 2}, {2, 3, 3}};
+	double   *data;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grafic = grafic_new();
+	grafic_setIsWhiteNoise(grafic, true);
+	grafic_setSize(grafic, size);
+	grafic_setFileName(grafic, "writeWindowedBulk.grafic");
+	grafic_makeEmptyFile(grafic);
+	data = xmalloc(sizeof(double) * 2 * size[0] * size[1] * size[2]);
+
+	// Full rows (one write per plane) and partial rows (one per row).
+	for (int w = 0; w < 2; w++) {
+		size_t pos = 0;
+		for (uint32_t k = 0; k < dims[w][2]; k++) {
+			for (uint32_t j = 0; j < dims[w][1]; j++) {
+				for (uint32_t i = 0; i < dims[w][0]; i++) {
+					data[pos++] = (double)(i + idxLo[w][0]
+					                       + ((j + idxLo[w][1])
+					                          + (k + idxLo[w][2]) * size[1])
+					                       * size[0]);
+				}
+			}
+		}
+		grafic_writeWindowed(grafic, data, GRAFIC_FORMAT_DOUBLE, 1,
+		                     idxLo[w], dims[w]);
+	}
+
+	// Wide and narrow windows, through stdio and through a mapping.
+	for (int m = 0; m < 2; m++) {
+		grafic_setUseMmap(grafic, m == 1);
+		if (grafic_getUseMmap(grafic) != (m == 1))
+			hasPassed = false;
+		for (int w = 0; w < 4; w++) {
+			size_t pos = 0;
+			grafic_readWindowed(grafic, data, GRAFIC_FORMAT_DOUBLE, 2,
+			                    idxLo[w], dims[w]);
+			for (uint32_t k = 0; k < dims[w][2]; k++) {
+				for (uint32_t j = 0; j < dims[w][1]; j++) {
+					for (uint32_t i = 0; i < dims[w][0]; i++) {
+						uint32_t jj       = j + idxLo[w][1];
+						double   expected = 0.0;
+						if ((jj >= 1 && jj < 5)
+						    || (jj == 5 && i + idxLo[w][0] >= 2
+						        && i + idxLo[w][0] < 5))
+							expected = (double)(i + idxLo[w][0]
+							                    + (jj + (k + idxLo[w][2])
+							                       * size[1]) * size[0]);
+						if (islessgreater(data[2 * pos], expected))
+							hasPassed = false;
+						pos++;
+					}
+				}
+			}
+		}
+	}
+
+	xfree(data);
+	grafic_del(&grafic);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* grafic_readWriteWindowedBulk_test */
+
+extern bool
+grafic_writeDirect_test(void)
+{
+	bool       hasPassed   = true;
+	int        rank        = 0;
+	grafic_t   grafic;
+	uint32_t   size[3]     = {5, 4, 6};
+	uint32_t   idxLo[3]    = {0, 0, 2};
+	uint32_t   dims[3]     = {5, 4, 3};
+	size_t     numElements = 5 * 4 * 6;
+	double     *data;
+	const char *names[2]   = {"writeDirectRef.grafic", "writeDirect.grafic"};
+#ifdef XMEM_TRACK_MEM
+	size_t     allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	data = xmalloc(sizeof(double) * 2 * numElements);
+	for (size_t i = 0; i < 2 * numElements; i++)
+		data[i] = (double)i;
+
+	// The direct path must produce the same files as the normal one.
+	for (int d = 0; d < 2; d++) {
+		grafic = grafic_new();
+		grafic_setSize(grafic, size);
+		grafic_setFileName(grafic, names[d]);
+		grafic_setUseDirectIO(grafic, d == 1);
+		grafic_write(grafic, data, GRAFIC_FORMAT_DOUBLE, 2);
+		grafic_del(&grafic);
+	}
+	if (!xfile_filesAreEqual(names[0], names[1]))
+		hasPassed = false;
+
+	for (int d = 0; d < 2; d++) {
+		grafic = grafic_new();
+		grafic_setSize(grafic, size);
+		grafic_setFileName(grafic, names[d]);
+		grafic_setUseDirectIO(grafic, d == 1);
+		grafic_makeEmptyFile(grafic);
+		grafic_writeWindowed(grafic, data, GRAFIC_FORMAT_DOUBLE, 2,
+		                     idxLo, dims);
+		grafic_del(&grafic);
+	}
+	if (!xfile_filesAreEqual(names[0], names[1]))
+		hasPassed = false;
+
+	xfree(data);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* grafic_writeDirect_test */
+
 /*--- Implementations of local functions --------------------------------*/
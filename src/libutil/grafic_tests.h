@@ -96,5 +96,11 @@ grafic_readWindowed_test(void);
 extern bool
 grafic_writeWindowed_test(void);
 
+extern bool
+grafic_readWriteWindowedBulk_test(void);
+
+extern bool
+grafic_writeDirect_test(void);
+
 
 #endif
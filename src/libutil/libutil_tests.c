@@ -6,15 +6,19 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "refCounter_tests.h"
+#include "xfile_tests.h"
 #include "xstring_tests.h"
 #include "stai_tests.h"
 #include "varArr_tests.h"
 #include "endian_tests.h"
 #include "tile_tests.h"
 #include "lIdx_tests.h"
+#include "phKey_tests.h"
 #include "filename_tests.h"
 #include "bov_tests.h"
 #include "grafic_tests.h"
+#include "lzBlock_tests.h"
+#include "brickFile_tests.h"
 #include "cubepm_tests.h"
 #include "gadgetVersion_tests.h"
 #include "gadgetBlock_tests.h"
@@ -29,6 +33,7 @@
 #  include "commSchemeBuffer_tests.h"
 #  include "commScheme_tests.h"
 #  include "groupi_tests.h"
+#  include "graficMPI_tests.h"
 #  include <mpi.h>
 #endif
 #ifdef XMEM_TRACK_MEM
@@ -100,6 +105,12 @@ main(void)
 		RUNTEST(&refCounter_noReferenceLeft_test, hasFailed);
 	}
 
+	if (rank == 0) {
+		printf("\nRunning tests for xfile:\n");
+		RUNTEST(&xfile_createFileWithSize_test, hasFailed);
+		RUNTEST(&xfile_writeDirect_test, hasFailed);
+	}
+
 	if (rank == 0) {
 		printf("\nRunning tests for xstring:\n");
 		RUNTEST(&xstring_xdirname_test, hasFailed);
@@ -140,6 +151,11 @@ main(void)
 		RUNTEST(&lIdx_toCoordNd_test, hasFailed);
 	}
 
+	if (rank == 0) {
+		printf("\nRunning tests for phKey:\n");
+		RUNTEST(&phKey_fromCoord3d_test, hasFailed);
+	}
+
 	if (rank == 0) {
 		printf("\nRunning tests for filename:\n");
 		RUNTEST(&filename_new_test, hasFailed);
@@ -205,6 +221,7 @@ main(void)
 		RUNTEST(&bov_setDataComponents_test, hasFailed);
 		RUNTEST(&bov_read_test, hasFailed);
 		RUNTEST(&bov_readWindowed_test, hasFailed);
+		RUNTEST(&bov_readWindowedMmap_test, hasFailed);
 	}
 
 	if (rank == 0) {
@@ -237,6 +254,24 @@ main(void)
 		RUNTEST(&grafic_readWindowed_test, hasFailed);
 		RUNTEST(&grafic_write_test, hasFailed);
 		RUNTEST(&grafic_writeWindowed_test, hasFailed);
+		RUNTEST(&grafic_readWriteWindowedBulk_test, hasFailed);
+		RUNTEST(&grafic_writeDirect_test, hasFailed);
+	}
+
+	if (rank == 0) {
+		printf("\nRunning tests for lzBlock:\n");
+		RUNTEST(&lzBlock_compress_test, hasFailed);
+		RUNTEST(&lzBlock_decompress_test, hasFailed);
+		RUNTEST(&lzBlock_shuffle_test, hasFailed);
+	}
+
+	if (rank == 0) {
+		printf("\nRunning tests for brickFile:\n");
+		RUNTEST(&brickFile_new_test, hasFailed);
+		RUNTEST(&brickFile_newFromFile_test, hasFailed);
+		RUNTEST(&brickFile_del_test, hasFailed);
+		RUNTEST(&brickFile_readWriteWindowed_test, hasFailed);
+		RUNTEST(&brickFile_getStatistics_test, hasFailed);
 	}
 
 	if (rank == 0) {
@@ -337,6 +372,10 @@ main(void)
 	RUNTESTMPI(&groupi_del_test, hasFailed);
 	RUNTESTMPI(&groupi_test, hasFailed);
 
+	if (rank == 0)
+		printf("\nRunning tests for graficMPI:\n");
+	RUNTESTMPI(&graficMPI_writeWindowed_test, hasFailed);
+
 	MPI_Finalize();
 #endif
 
@@ -0,0 +1,281 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/lzBlock.c
+ * @ingroup libutilMisc
+ * @brief  This file provides the implementation of the block compressor.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "lzBlock.h"
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The logarithm of the number of entries in the match finder. */
+#define LOCAL_HASH_LOG 14
+
+/** @brief  The shortest back-reference that is encoded. */
+#define LOCAL_MIN_MATCH 4
+
+/** @brief  The largest distance of a back-reference. */
+#define LOCAL_MAX_OFFSET 65535
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static uint32_t
+local_read32(const unsigned char *p);
+
+static uint32_t
+local_hash(uint32_t sequence);
+
+static bool
+local_emitSequence(unsigned char       **op,
+                   const unsigned char *opEnd,
+                   const unsigned char *literals,
+                   size_t              numLiterals,
+                   size_t              offset,
+                   size_t              matchLength);
+
+static unsigned char *
+local_writeLength(unsigned char *op, size_t length);
+
+static bool
+local_readLength(const unsigned char **ip,
+                 const unsigned char *ipEnd,
+                 size_t              *length);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern size_t
+lzBlock_getMaxCompressedSize(size_t inSize)
+{
+	return inSize + inSize / 255 + 16;
+}
+
+extern size_t
+lzBlock_compress(const void *in, size_t inSize, void *out, size_t outCapacity)
+{
+	const unsigned char *src   = (const unsigned char *)in;
+	unsigned char       *op    = (unsigned char *)out;
+	const unsigned char *opEnd = op + outCapacity;
+	size_t              ip     = 0;
+	size_t              anchor = 0;
+	// Positions are stored shifted by one, 0 marks an empty slot.
+	uint32_t            table[1 << LOCAL_HASH_LOG];
+
+	assert(in != NULL || inSize == 0);
+	assert(out != NULL);
+	assert(inSize < UINT32_MAX);
+
+	memset(table, 0, sizeof(table));
+
+	while (ip + LOCAL_MIN_MATCH <= inSize) {
+		uint32_t sequence = local_read32(src + ip);
+		uint32_t h        = local_hash(sequence);
+		size_t   ref      = table[h];
+
+		table[h] = (uint32_t)(ip + 1);
+		if ((ref != 0) && (ip - (ref - 1) <= LOCAL_MAX_OFFSET)
+		    && (local_read32(src + ref - 1) == sequence)) {
+			size_t len = LOCAL_MIN_MATCH;
+			ref--;
+			while ((ip + len < inSize) && (src[ref + len] == src[ip + len]))
+				len++;
+			if (!local_emitSequence(&op, opEnd, src + anchor, ip - anchor,
+			                        ip - ref, len))
+				return 0;
+			ip    += len;
+			anchor = ip;
+		} else {
+			ip++;
+		}
+	}
+	if (!local_emitSequence(&op, opEnd, src + anchor, inSize - anchor, 0, 0))
+		return 0;
+
+	return (size_t)(op - (unsigned char *)out);
+} /* lzBlock_compress */
+
+extern bool
+lzBlock_decompress(const void *in, size_t inSize, void *out, size_t outSize)
+{
+	const unsigned char *ip    = (const unsigned char *)in;
+	const unsigned char *ipEnd = ip + inSize;
+	unsigned char       *op    = (unsigned char *)out;
+	unsigned char       *opEnd = op + outSize;
+
+	assert(in != NULL || inSize == 0);
+	assert(out != NULL || outSize == 0);
+
+	while (ip < ipEnd) {
+		unsigned int token = *ip++;
+		size_t       numLiterals;
+		size_t       offset, matchLength;
+
+		numLiterals = token >> 4;
+		if ((numLiterals == 15) && !local_readLength(&ip, ipEnd,
+		                                             &numLiterals))
+			return false;
+		if ((numLiterals > (size_t)(ipEnd - ip))
+		    || (numLiterals > (size_t)(opEnd - op)))
+			return false;
+		memcpy(op, ip, numLiterals);
+		op += numLiterals;
+		ip += numLiterals;
+
+		// The last sequence has no back-reference.
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return false;
+		offset = (size_t)(ip[0]) | ((size_t)(ip[1]) << 8);
+		ip    += 2;
+		if ((offset == 0) || (offset > (size_t)(op - (unsigned char *)out)))
+			return false;
+		matchLength = token & 15;
+		if ((matchLength == 15) && !local_readLength(&ip, ipEnd,
+		                                             &matchLength))
+			return false;
+		matchLength += LOCAL_MIN_MATCH;
+		if (matchLength > (size_t)(opEnd - op))
+			return false;
+		if (offset >= matchLength) {
+			memcpy(op, op - offset, matchLength);
+		} else {
+			// Overlapping copy, repeats the last offset bytes.
+			for (size_t i = 0; i < matchLength; i++)
+				op[i] = op[i - offset];
+		}
+		op += matchLength;
+	}
+
+	return (op == opEnd) ? true : false;
+} /* lzBlock_decompress */
+
+extern void
+lzBlock_shuffle(const void *in,
+                void       *out,
+                size_t     elementSize,
+                size_t     numElements)
+{
+	const unsigned char *src = (const unsigned char *)in;
+	unsigned char       *dst = (unsigned char *)out;
+
+	assert(in != out);
+
+	for (size_t b = 0; b < elementSize; b++) {
+		for (size_t i = 0; i < numElements; i++)
+			dst[b * numElements + i] = src[i * elementSize + b];
+	}
+}
+
+extern void
+lzBlock_unshuffle(const void *in,
+                  void       *out,
+                  size_t     elementSize,
+                  size_t     numElements)
+{
+	const unsigned char *src = (const unsigned char *)in;
+	unsigned char       *dst = (unsigned char *)out;
+
+	assert(in != out);
+
+	for (size_t b = 0; b < elementSize; b++) {
+		for (size_t i = 0; i < numElements; i++)
+			dst[i * elementSize + b] = src[b * numElements + i];
+	}
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static uint32_t
+local_read32(const unsigned char *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(uint32_t));
+
+	return v;
+}
+
+static uint32_t
+local_hash(uint32_t sequence)
+{
+	return (sequence * UINT32_C(2654435761)) >> (32 - LOCAL_HASH_LOG);
+}
+
+static bool
+local_emitSequence(unsigned char       **op,
+                   const unsigned char *opEnd,
+                   const unsigned char *literals,
+                   size_t              numLiterals,
+                   size_t              offset,
+                   size_t              matchLength)
+{
+	unsigned char *p         = *op;
+	size_t        matchCode  = matchLength > 0
+	                           ? matchLength - LOCAL_MIN_MATCH : 0;
+	size_t        worstCase;
+
+	worstCase = 1 + numLiterals / 255 + 1 + numLiterals
+	            + 2 + matchCode / 255 + 1;
+	if (worstCase > (size_t)(opEnd - p))
+		return false;
+
+	*p++ = (unsigned char)(((numLiterals < 15 ? numLiterals : 15) << 4)
+	                       | (matchCode < 15 ? matchCode : 15));
+	if (numLiterals >= 15)
+		p = local_writeLength(p, numLiterals - 15);
+	memcpy(p, literals, numLiterals);
+	p += numLiterals;
+
+	if (matchLength > 0) {
+		*p++ = (unsigned char)(offset & 0xff);
+		*p++ = (unsigned char)(offset >> 8);
+		if (matchCode >= 15)
+			p = local_writeLength(p, matchCode - 15);
+	}
+
+	*op = p;
+
+	return true;
+}
+
+static unsigned char *
+local_writeLength(unsigned char *op, size_t length)
+{
+	while (length >= 255) {
+		*op++   = 255;
+		length -= 255;
+	}
+	*op++ = (unsigned char)length;
+
+	return op;
+}
+
+static bool
+local_readLength(const unsigned char **ip,
+                 const unsigned char *ipEnd,
+                 size_t              *length)
+{
+	unsigned char b;
+
+	do {
+		if (*ip >= ipEnd)
+			return false;
+		b        = *(*ip)++;
+		*length += b;
+	} while (b == 255);
+
+	return true;
+}
@@ -0,0 +1,130 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef LZBLOCK_H
+#define LZBLOCK_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/lzBlock.h
+ * @ingroup libutilMisc
+ * @brief  This file provides the interface to a simple and fast block
+ *         compressor.
+ *
+ * The compressor is a plain LZ77 variant in the spirit of LZ4: the output
+ * is a sequence of literal runs and back-references of at least four
+ * bytes into a 64k window.  It does not need any external library and
+ * trades compression ratio for speed.  For floating point data it works
+ * best after regrouping the bytes with lzBlock_shuffle().
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Gives the size of the output buffer that is always sufficient
+ *         for the compression of a block.
+ *
+ * @param[in]  inSize
+ *                The size of the uncompressed block in bytes.
+ *
+ * @return  Returns the worst case size of the compressed block in bytes.
+ */
+extern size_t
+lzBlock_getMaxCompressedSize(size_t inSize);
+
+
+/**
+ * @brief  Compresses a block.
+ *
+ * @param[in]   *in
+ *                 The data that should be compressed.
+ * @param[in]   inSize
+ *                 The number of bytes in @c in.
+ * @param[out]  *out
+ *                 The buffer receiving the compressed data.
+ * @param[in]   outCapacity
+ *                 The size of the output buffer in bytes.
+ *
+ * @return  Returns the size of the compressed block in bytes, or 0 if it
+ *          does not fit into the output buffer.
+ */
+extern size_t
+lzBlock_compress(const void *in, size_t inSize, void *out, size_t outCapacity);
+
+
+/**
+ * @brief  Decompresses a block.
+ *
+ * The input is validated while decoding, corrupted input will not make
+ * the function read or write outside of the provided buffers.
+ *
+ * @param[in]   *in
+ *                 The compressed block.
+ * @param[in]   inSize
+ *                 The size of the compressed block in bytes.
+ * @param[out]  *out
+ *                 The buffer receiving the uncompressed data.
+ * @param[in]   outSize
+ *                 The expected size of the uncompressed data in bytes.
+ *
+ * @return  Returns @c true if the block decompressed to exactly
+ *          @c outSize bytes and @c false if the input is corrupted.
+ */
+extern bool
+lzBlock_decompress(const void *in, size_t inSize, void *out, size_t outSize);
+
+
+/**
+ * @brief  Regroups the bytes of an array such that all first bytes of the
+ *         elements come first, then all second bytes, and so on.
+ *
+ * @param[in]   *in
+ *                 The array to shuffle.
+ * @param[out]  *out
+ *                 The output array, must not overlap with @c in.
+ * @param[in]   elementSize
+ *                 The size of one element in bytes.
+ * @param[in]   numElements
+ *                 The number of elements.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+lzBlock_shuffle(const void *in,
+                void       *out,
+                size_t     elementSize,
+                size_t     numElements);
+
+
+/**
+ * @brief  Reverts lzBlock_shuffle().
+ *
+ * @param[in]   *in
+ *                 The shuffled array.
+ * @param[out]  *out
+ *                 The output array, must not overlap with @c in.
+ * @param[in]   elementSize
+ *                 The size of one element in bytes.
+ * @param[in]   numElements
+ *                 The number of elements.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+lzBlock_unshuffle(const void *in,
+                  void       *out,
+                  size_t     elementSize,
+                  size_t     numElements);
+
+
+#endif
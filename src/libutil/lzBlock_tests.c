@@ -0,0 +1,221 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "lzBlock_tests.h"
+#include "lzBlock.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/xmem.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_NUM_VALUES 4096
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static void
+local_fillSmoothFloats(float *values, size_t n);
+
+static bool
+local_roundtrip(const void *in, size_t inSize, size_t *compressedSize);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+lzBlock_compress_test(void)
+{
+	bool          hasPassed = true;
+	int           rank      = 0;
+	unsigned char *bytes;
+	float         *values, *shuffled;
+	size_t        n = LOCAL_NUM_VALUES * sizeof(float);
+	size_t        compressedSize;
+	uint32_t      state = 12345;
+#ifdef XMEM_TRACK_MEM
+	size_t        allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	bytes    = xmalloc(n);
+	values   = xmalloc(n);
+	shuffled = xmalloc(n);
+
+	// Constant data must compress well.
+	memset(bytes, 0, n);
+	if (!local_roundtrip(bytes, n, &compressedSize) || compressedSize > n / 64)
+		hasPassed = false;
+
+	// Random data does not compress but must survive.
+	for (size_t i = 0; i < n; i++) {
+		state    = state * 1103515245u + 12345u;
+		bytes[i] = (unsigned char)(state >> 24);
+	}
+	if (!local_roundtrip(bytes, n, &compressedSize)
+	    || compressedSize > lzBlock_getMaxCompressedSize(n))
+		hasPassed = false;
+
+	// Tiny blocks, shorter than a back-reference.
+	for (size_t i = 0; i < 6; i++) {
+		if (!local_roundtrip(bytes, i, &compressedSize))
+			hasPassed = false;
+	}
+
+	// Repeating patterns produce long, overlapping matches.
+	for (size_t i = 0; i < n; i++)
+		bytes[i] = (unsigned char)(i % 3);
+	if (!local_roundtrip(bytes, n, &compressedSize) || compressedSize > n / 64)
+		hasPassed = false;
+
+	// Smooth floats compress after shuffling.
+	local_fillSmoothFloats(values, LOCAL_NUM_VALUES);
+	lzBlock_shuffle(values, shuffled, sizeof(float), LOCAL_NUM_VALUES);
+	if (!local_roundtrip(shuffled, n, &compressedSize) || compressedSize >= n)
+		hasPassed = false;
+
+	// Too small output buffers are reported.
+	memset(bytes, 0, n);
+	if (lzBlock_compress(bytes, n, shuffled, 4) != 0)
+		hasPassed = false;
+
+	xfree(shuffled);
+	xfree(values);
+	xfree(bytes);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* lzBlock_compress_test */
+
+extern bool
+lzBlock_decompress_test(void)
+{
+	bool          hasPassed = true;
+	int           rank      = 0;
+	float         *values;
+	unsigned char *packed, *out;
+	size_t        n = LOCAL_NUM_VALUES * sizeof(float);
+	size_t        packedSize;
+#ifdef XMEM_TRACK_MEM
+	size_t        allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	values = xmalloc(n);
+	packed = xmalloc(lzBlock_getMaxCompressedSize(n));
+	out    = xmalloc(n);
+
+	local_fillSmoothFloats(values, LOCAL_NUM_VALUES);
+	packedSize = lzBlock_compress(values, n, packed,
+	                              lzBlock_getMaxCompressedSize(n));
+	if (packedSize == 0)
+		hasPassed = false;
+
+	// Wrong expected sizes and truncated input are rejected.
+	if (lzBlock_decompress(packed, packedSize, out, n - 1))
+		hasPassed = false;
+	if (lzBlock_decompress(packed, packedSize / 2, out, n))
+		hasPassed = false;
+
+	// Back-references before the start of the output are rejected.
+	packed[0] = 0x00;
+	packed[1] = 0x10;
+	packed[2] = 0x00;
+	if (lzBlock_decompress(packed, 3, out, 4))
+		hasPassed = false;
+
+	xfree(out);
+	xfree(packed);
+	xfree(values);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* lzBlock_decompress_test */
+
+extern bool
+lzBlock_shuffle_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	double   values[5] = {1.0, -2.5, 3.25, 1e10, -7e-3};
+	double   back[5];
+	uint16_t shorts[3] = {0x0102, 0x0304, 0x0506};
+	uint16_t shuffled[3];
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	lzBlock_shuffle(shorts, shuffled, sizeof(uint16_t), 3);
+	for (int i = 0; i < 3; i++) {
+		const unsigned char *s = (const unsigned char *)shorts;
+		const unsigned char *d = (const unsigned char *)shuffled;
+		if ((d[i] != s[2 * i]) || (d[3 + i] != s[2 * i + 1]))
+			hasPassed = false;
+	}
+
+	{
+		unsigned char tmp[sizeof(values)];
+		lzBlock_shuffle(values, tmp, sizeof(double), 5);
+		lzBlock_unshuffle(tmp, back, sizeof(double), 5);
+		if (memcmp(values, back, sizeof(values)) != 0)
+			hasPassed = false;
+	}
+
+	return hasPassed ? true : false;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_fillSmoothFloats(float *values, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		values[i] = (float)(sin(i * 0.01) * 100.0);
+}
+
+static bool
+local_roundtrip(const void *in, size_t inSize, size_t *compressedSize)
+{
+	bool          hasPassed = true;
+	size_t        capacity  = lzBlock_getMaxCompressedSize(inSize);
+	unsigned char *packed   = xmalloc(capacity);
+	unsigned char *out      = xmalloc(inSize + 1);
+
+	*compressedSize = lzBlock_compress(in, inSize, packed, capacity);
+	if (*compressedSize == 0)
+		hasPassed = false;
+	else if (!lzBlock_decompress(packed, *compressedSize, out, inSize))
+		hasPassed = false;
+	else if ((inSize > 0) && (memcmp(in, out, inSize) != 0))
+		hasPassed = false;
+
+	xfree(out);
+	xfree(packed);
+
+	return hasPassed;
+}
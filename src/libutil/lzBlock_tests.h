@@ -0,0 +1,25 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef LZBLOCK_TESTS_H
+#define LZBLOCK_TESTS_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+lzBlock_compress_test(void);
+
+extern bool
+lzBlock_decompress_test(void);
+
+extern bool
+lzBlock_shuffle_test(void);
+
+
+#endif
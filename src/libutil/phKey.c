@@ -0,0 +1,65 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/phKey.c
+ * @ingroup   libutilMiscPHKey
+ * @brief  Implements the Peano-Hilbert keys.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "phKey.h"
+#include <assert.h>
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern uint64_t
+phKey_fromCoord3d(const uint32_t coords[3], int bits)
+{
+	uint32_t x[3] = {coords[0], coords[1], coords[2]};
+	uint32_t t;
+	uint64_t key  = UINT64_C(0);
+
+	assert(bits >= 0 && bits <= PHKEY_MAX_BITS);
+
+	if (bits == 0)
+		return key;
+
+	// Transforms the coordinates into the transposed Hilbert index
+	// (J. Skilling, AIP Conf. Proc. 707, 381 (2004)).
+	for (uint32_t q = UINT32_C(1) << (bits - 1); q > 1; q >>= 1) {
+		const uint32_t p = q - 1;
+		for (int i = 0; i < 3; i++) {
+			if (x[i] & q) {
+				x[0] ^= p;
+			} else {
+				t     = (x[0] ^ x[i]) & p;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+	x[1] ^= x[0];
+	x[2] ^= x[1];
+	t     = 0;
+	for (uint32_t q = UINT32_C(1) << (bits - 1); q > 1; q >>= 1) {
+		if (x[2] & q)
+			t ^= q - 1;
+	}
+	for (int i = 0; i < 3; i++)
+		x[i] ^= t;
+
+	// The key interleaves the bits, starting with the highest.
+	for (int b = bits - 1; b >= 0; b--) {
+		for (int i = 0; i < 3; i++)
+			key = (key << 1) | ((x[i] >> b) & 1);
+	}
+
+	return key;
+} // phKey_fromCoord3d
@@ -0,0 +1,62 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef PHKEY_H
+#define PHKEY_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/phKey.h
+ * @ingroup  libutilMiscPHKey
+ * @brief  Provides the interface to Peano-Hilbert keys.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdint.h>
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The maximal number of bits per dimension of a key. */
+#define PHKEY_MAX_BITS 21
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Calculates the position of a cell along the Peano-Hilbert curve
+ *         through a cube.
+ *
+ * The curve runs through a cube of 2^bits cells per dimension, subsequent
+ * keys belong to neighbouring cells.  The curves are nested, dropping the
+ * lowest bit of the coordinates gives the key of the parent cell on the
+ * curve with one bit less, which is the key shifted by three bits.
+ *
+ * @param[in]  coords
+ *                The coordinates of the cell, must be smaller than
+ *                2^bits.
+ * @param[in]  bits
+ *                The number of bits per dimension, at most
+ *                #PHKEY_MAX_BITS.
+ *
+ * @return  Returns the key.
+ */
+extern uint64_t
+phKey_fromCoord3d(const uint32_t coords[3], int bits);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libutilMiscPHKey Peano-Hilbert Keys
+ * @ingroup libutilMisc
+ * @brief Provides the ordering of cells along a Peano-Hilbert curve.
+ */
+
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/phKey_tests.c
+ * @ingroup  libutilMiscPHKeyTest
+ * @brief  Implements the tests for the phKey module.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "phKey_tests.h"
+#include "phKey.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "xmem.h"
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+phKey_fromCoord3d_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	for (int bits = 1; bits <= 4; bits++) {
+		const uint32_t dim      = UINT32_C(1) << bits;
+		const uint64_t numCells = (uint64_t)dim * dim * dim;
+		uint32_t       *cellAt  = xmalloc(sizeof(uint32_t) * 3 * numCells);
+		bool           *isUsed  = xmalloc(sizeof(bool) * numCells);
+		uint32_t       c[3], parent[3];
+
+		for (uint64_t i = 0; i < numCells; i++)
+			isUsed[i] = false;
+
+		// Every cell gets its own key and is inside its parent.
+		for (c[2] = 0; c[2] < dim; c[2]++) {
+			for (c[1] = 0; c[1] < dim; c[1]++) {
+				for (c[0] = 0; c[0] < dim; c[0]++) {
+					uint64_t key = phKey_fromCoord3d(c, bits);
+
+					for (int i = 0; i < 3; i++)
+						parent[i] = c[i] >> 1;
+					if ((key >= numCells) || isUsed[key])
+						hasPassed = false;
+					else
+						isUsed[key] = true;
+					if ((key >> 3) != phKey_fromCoord3d(parent, bits - 1))
+						hasPassed = false;
+					if (key < numCells) {
+						for (int i = 0; i < 3; i++)
+							cellAt[key * 3 + i] = c[i];
+					}
+				}
+			}
+		}
+
+		// Subsequent keys belong to neighbouring cells.
+		for (uint64_t key = 1; hasPassed && (key < numCells); key++) {
+			int dist = 0;
+
+			for (int i = 0; i < 3; i++)
+				dist += abs((int)cellAt[key * 3 + i]
+				            - (int)cellAt[(key - 1) * 3 + i]);
+			if (dist != 1)
+				hasPassed = false;
+		}
+
+		xfree(isUsed);
+		xfree(cellAt);
+	}
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* phKey_fromCoord3d_test */
@@ -0,0 +1,43 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef PHKEY_TESTS_H
+#define PHKEY_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/phKey_tests.h
+ * @ingroup  libutilMiscPHKeyTest
+ * @brief  Provides the interface for testing the phKey module.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Tests phKey_fromCoord3d().
+ *
+ * @return  Returns @c true if the tests succeeded and @c false otherwise.
+ */
+extern bool
+phKey_fromCoord3d_test(void);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libutilMiscPHKeyTest Test for Peano-Hilbert Keys
+ * @ingroup libutilMiscPHKey
+ * @brief Provides test functions for the Peano-Hilbert keys.
+ */
+
+
+#endif
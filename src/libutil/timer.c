@@ -114,4 +114,30 @@ timer_stop_text(double timing, const char *text)
 	return timing;
 }
 
+extern double
+timer_startLocal(void)
+{
+#if (defined WITH_MPI)
+	return -MPI_Wtime();
+#elif (defined _OPENMP)
+	return -omp_get_wtime();
+#else
+	return -clock() * CPS_INV;
+#endif
+}
+
+extern double
+timer_stopLocal(double timing)
+{
+#if (defined WITH_MPI)
+	timing += MPI_Wtime();
+#elif (defined _OPENMP)
+	timing += omp_get_wtime();
+#else
+	timing += clock() * CPS_INV;
+#endif
+
+	return timing;
+}
+
 /*--- Implementations of local functions --------------------------------*/
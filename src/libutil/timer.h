@@ -72,5 +72,30 @@ timer_stop(double timing);
 extern double
 timer_stop_text(double timing, const char *text);
 
+/**
+ * @brief  This starts a timer that is local to the calling task.
+ *
+ * Contrary to timer_start(), this does not synchronize the MPI tasks and
+ * may hence be used in code that is not executed by all tasks alike.
+ *
+ * @return  Returns a number that can be passed to timer_stopLocal() to
+ *          evaluate the elapsed time in seconds.
+ */
+extern double
+timer_startLocal(void);
+
+/**
+ * @brief  This will stop a timer that is local to the calling task.
+ *
+ * @param[in]  timing
+ *                The value obtained from a previous call of
+ *                timer_startLocal().
+ *
+ * @return  Returns the number of seconds elapsed on the calling task
+ *          between the call of timer_startLocal() and timer_stopLocal().
+ */
+extern double
+timer_stopLocal(double timing);
+
 
 #endif
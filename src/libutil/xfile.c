@@ -12,6 +12,17 @@
  */
 
 
+/*--- Feature test macros -----------------------------------------------*/
+// posix_fallocate(), pwrite() and posix_fadvise() are XSI, O_DIRECT needs
+// _GNU_SOURCE; both must be set before any system header is included.
+#ifndef _XOPEN_SOURCE
+#  define _XOPEN_SOURCE 600
+#endif
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+#endif
+
+
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include "xfile.h"
@@ -26,6 +37,89 @@
 #  include <sys/stat.h>
 #  include <fcntl.h>
 #endif
+#include "xmem.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The alignment of buffers, offsets and sizes for direct IO. */
+#define LOCAL_DIRECT_ALIGNMENT 4096
+
+/** @brief  The size of the buffer of a direct handle. */
+#define LOCAL_DIRECT_BUFFER_SIZE (1 << 22)
+
+
+/*--- Implemention of main structure ------------------------------------*/
+
+/** @brief  The structure behind a direct handle. */
+struct xfileDirect_struct {
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	/** @brief  The descriptor for unaligned writes. */
+	int    fd;
+	/** @brief  The descriptor opened with O_DIRECT, -1 if unavailable. */
+	int    fdDirect;
+	/** @brief  The aligned buffer. */
+	char   *buffer;
+	/** @brief  The file offset of the first byte of the buffer. */
+	size_t bufferOffset;
+	/** @brief  The first valid byte in the buffer. */
+	size_t bufferStart;
+	/** @brief  The end of the valid bytes in the buffer. */
+	size_t bufferEnd;
+	/** @brief  The position at which the writing started. */
+	size_t offset;
+#else
+	/** @brief  The file pointer used for buffered writing. */
+	FILE   *f;
+#endif
+};
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+
+/**
+ * @brief  Writes the buffer of a direct handle.
+ *
+ * @param[in,out]  fd
+ *                    The handle to work with.
+ * @param[in]      isFinal
+ *                    If @c true, the unaligned tail is written as well,
+ *                    otherwise it is kept in the buffer.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_flushDirect(xfileDirect_t fd, bool isFinal);
+
+
+/**
+ * @brief  Writes all bytes at a given position, retrying on short writes.
+ *
+ * @param[in]  fd
+ *                The descriptor to write to.
+ * @param[in]  buf
+ *                The data to write.
+ * @param[in]  bytes
+ *                The number of bytes to write.
+ * @param[in]  offset
+ *                The position in the file.
+ * @param[in]  mayBeRefused
+ *                If @c true, a write refused with @c EINVAL (as done by
+ *                file systems without direct IO support) is reported to
+ *                the caller instead of terminating the program.
+ *
+ * @return  Returns @c true if the data was written and @c false if the
+ *          write was refused.
+ */
+static bool
+local_pwrite(int        fd,
+             const char *buf,
+             size_t     bytes,
+             size_t     offset,
+             bool       mayBeRefused);
+
+#endif
 
 
 /*--- Implementations of exported functios ------------------------------*/
@@ -132,13 +226,20 @@ xfile_createFileWithSize(const char *fname, size_t bytes)
 	}
 	close(fd);
 #else
-	FILE *f;
-	char nullData = 124;
+	FILE   *f;
+	char   nullData[LOCAL_DIRECT_ALIGNMENT];
+	size_t numWritten = 0;
 
+	memset(nullData, 0, LOCAL_DIRECT_ALIGNMENT);
 	f = xfopen(fname, "wb");
 
-	for (size_t i = 0; i < bytes; i++)
-		xfwrite(&nullData, sizeof(char), 1, f);
+	while (numWritten < bytes) {
+		size_t num = bytes - numWritten;
+		num         = num > LOCAL_DIRECT_ALIGNMENT ? LOCAL_DIRECT_ALIGNMENT
+		              : num;
+		xfwrite(nullData, sizeof(char), num, f);
+		numWritten += num;
+	}
 
 	xfclose(&f);
 #endif
@@ -194,3 +295,190 @@ xfile_filesAreEqual(const char *fn1, const char *fn2)
 
 	return filesAreEqual ? true : false;
 }
+
+extern bool
+xfile_hasDirectIO(void)
+{
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	return true;
+#else
+	return false;
+#endif
+}
+
+extern xfileDirect_t
+xfile_openDirect(const char *fname, size_t offset)
+{
+	xfileDirect_t fd;
+
+	assert(fname != NULL);
+
+	fd = xmalloc(sizeof(struct xfileDirect_struct));
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	int errnum;
+
+	fd->fd = open(fname, O_WRONLY | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP
+	              | S_IWGRP | S_IROTH | S_IWOTH);
+	if (fd->fd == -1) {
+		errnum = errno;
+		fprintf(stderr, "Error in %s:%i %s\n",
+		        __func__, __LINE__, strerror(errnum));
+		exit(EXIT_FAILURE);
+	}
+#  ifdef O_DIRECT
+	// Not all file systems support this, those use the page cache.
+	fd->fdDirect = open(fname, O_WRONLY | O_DIRECT);
+#  else
+	fd->fdDirect = -1;
+#  endif
+	errnum = posix_memalign((void **)&(fd->buffer), LOCAL_DIRECT_ALIGNMENT,
+	                        LOCAL_DIRECT_BUFFER_SIZE);
+	if (errnum != 0) {
+		fprintf(stderr, "Error in %s:%i %s\n",
+		        __func__, __LINE__, strerror(errnum));
+		exit(EXIT_FAILURE);
+	}
+	// The buffer mirrors the file from the aligned position before offset.
+	fd->bufferStart  = offset % LOCAL_DIRECT_ALIGNMENT;
+	fd->bufferOffset = offset - fd->bufferStart;
+	fd->bufferEnd    = fd->bufferStart;
+	fd->offset       = offset;
+#else
+	fd->f = fopen(fname, "r+b");
+	if (fd->f == NULL)
+		fd->f = xfopen(fname, "w+b");
+	xfseek(fd->f, (long)offset, SEEK_SET);
+#endif
+
+	return fd;
+}
+
+extern void
+xfile_writeDirect(xfileDirect_t fd, const void *data, size_t bytes)
+{
+	assert(fd != NULL);
+	assert(data != NULL || bytes == 0);
+
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	const char *d = data;
+
+	while (bytes > 0) {
+		size_t num = LOCAL_DIRECT_BUFFER_SIZE - fd->bufferEnd;
+		num = num > bytes ? bytes : num;
+		memcpy(fd->buffer + fd->bufferEnd, d, num);
+		fd->bufferEnd += num;
+		d             += num;
+		bytes         -= num;
+		if (fd->bufferEnd == LOCAL_DIRECT_BUFFER_SIZE)
+			local_flushDirect(fd, false);
+	}
+#else
+	xfwrite(data, 1, bytes, fd->f);
+#endif
+}
+
+extern void
+xfile_closeDirect(xfileDirect_t *fd)
+{
+	assert(fd != NULL && *fd != NULL);
+
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+	size_t end;
+
+	local_flushDirect(*fd, true);
+	end = (*fd)->bufferOffset + (*fd)->bufferEnd;
+	// Whatever went through the page cache should not stay there.
+	fdatasync((*fd)->fd);
+	posix_fadvise((*fd)->fd, (off_t)((*fd)->offset),
+	              (off_t)(end - (*fd)->offset), POSIX_FADV_DONTNEED);
+	if ((*fd)->fdDirect != -1)
+		close((*fd)->fdDirect);
+	close((*fd)->fd);
+	free((*fd)->buffer);
+#else
+	xfclose(&((*fd)->f));
+#endif
+	xfree(*fd);
+	*fd = NULL;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
+static void
+local_flushDirect(xfileDirect_t fd, bool isFinal)
+{
+	size_t pos = fd->bufferStart;
+	size_t numAligned;
+
+	if (!isFinal && (fd->bufferEnd < LOCAL_DIRECT_ALIGNMENT))
+		return;
+
+	// The start of the region is not aligned, write up to the first
+	// aligned position through the page cache.
+	if (pos > 0) {
+		size_t end = fd->bufferEnd < LOCAL_DIRECT_ALIGNMENT
+		             ? fd->bufferEnd : LOCAL_DIRECT_ALIGNMENT;
+		local_pwrite(fd->fd, fd->buffer + pos, end - pos,
+		             fd->bufferOffset + pos, false);
+		pos = end;
+	}
+
+	numAligned = (fd->bufferEnd - pos) / LOCAL_DIRECT_ALIGNMENT
+	             * LOCAL_DIRECT_ALIGNMENT;
+	if (numAligned > 0) {
+		bool done = false;
+		if (fd->fdDirect != -1) {
+			done = local_pwrite(fd->fdDirect, fd->buffer + pos, numAligned,
+			                    fd->bufferOffset + pos, true);
+			if (!done) {
+				close(fd->fdDirect);
+				fd->fdDirect = -1;
+			}
+		}
+		if (!done)
+			local_pwrite(fd->fd, fd->buffer + pos, numAligned,
+			             fd->bufferOffset + pos, false);
+		pos += numAligned;
+	}
+
+	if (isFinal && (pos < fd->bufferEnd)) {
+		local_pwrite(fd->fd, fd->buffer + pos, fd->bufferEnd - pos,
+		             fd->bufferOffset + pos, false);
+		pos = fd->bufferEnd;
+	}
+
+	// Keep the unaligned rest, it now starts at an aligned position.
+	memmove(fd->buffer, fd->buffer + pos, fd->bufferEnd - pos);
+	fd->bufferOffset += pos;
+	fd->bufferEnd    -= pos;
+	fd->bufferStart   = 0;
+} /* local_flushDirect */
+
+static bool
+local_pwrite(int        fd,
+             const char *buf,
+             size_t     bytes,
+             size_t     offset,
+             bool       mayBeRefused)
+{
+	while (bytes > 0) {
+		ssize_t num = pwrite(fd, buf, bytes, (off_t)offset);
+		if (num == -1) {
+			int errnum = errno;
+			if (errnum == EINTR)
+				continue;
+			if (mayBeRefused && (errnum == EINVAL))
+				return false;
+			fprintf(stderr, "Error in %s:%i %s\n",
+			        __func__, __LINE__, strerror(errnum));
+			exit(EXIT_FAILURE);
+		}
+		buf    += num;
+		bytes  -= (size_t)num;
+		offset += (size_t)num;
+	}
+
+	return true;
+}
+
+#endif
@@ -23,6 +23,12 @@
 #include <stdbool.h>
 
 
+/*--- ADT handle --------------------------------------------------------*/
+
+/** @brief  A handle for a file opened for direct sequential writing. */
+typedef struct xfileDirect_struct *xfileDirect_t;
+
+
 /*--- Prototypes of exported functions ----------------------------------*/
 
 /**
@@ -113,6 +119,10 @@ xftell(FILE *stream);
  * \brief  Creates a new file and ensures that it contains bytes number
  *         of bytes.
  *
+ * On systems conforming to XSI (_XOPEN_SOURCE >= 600) the space is
+ * reserved with posix_fallocate(), otherwise the file is filled with
+ * zeros.
+ *
  * \param  *fname  The name of the file to create.
  * \param  bytes   The file size in bytes.
  *
@@ -146,5 +156,67 @@ xfile_checkIfFileExists(const char *fname);
 extern bool
 xfile_filesAreEqual(const char *f1, const char *f2);
 
+/**
+ * \brief  Tells whether the XSI file functions are used.
+ *
+ * \return  Returns \c true if xfile_createFileWithSize() reserves the space
+ *          with posix_fallocate() and the direct handles write with
+ *          pwrite(), and \c false if both fall back to stdio.
+ */
+extern bool
+xfile_hasDirectIO(void);
+
+/**
+ * \brief  Opens a file for writing one contiguous region sequentially
+ *         while bypassing the page cache.
+ *
+ * The data is collected in an aligned buffer and written in aligned
+ * blocks through a descriptor opened with O_DIRECT, only the unaligned
+ * head and tail of the region go through the page cache.  If O_DIRECT is
+ * not available, the written range is dropped from the page cache when
+ * closing instead.  Both require an XSI conforming system
+ * (_XOPEN_SOURCE >= 600, O_DIRECT additionally _GNU_SOURCE, both are
+ * requested by xfile.c), otherwise this falls back to normal buffered
+ * writing, see xfile_hasDirectIO().
+ *
+ * The file is created if it does not exist, it is never truncated.
+ *
+ * \param[in]  *fname
+ *                 The name of the file.
+ * \param[in]  offset
+ *                 The position at which the writing starts.
+ *
+ * \return  Returns a new handle, the program is terminated if the file
+ *          cannot be opened.
+ */
+extern xfileDirect_t
+xfile_openDirect(const char *fname, size_t offset);
+
+/**
+ * \brief  Appends data to the region written through a direct handle.
+ *
+ * \param[in,out]  fd
+ *                     The handle to write to.
+ * \param[in]      *data
+ *                     The data to write.
+ * \param[in]      bytes
+ *                     The number of bytes to write.
+ *
+ * \return  Returns nothing, the program is terminated on errors.
+ */
+extern void
+xfile_writeDirect(xfileDirect_t fd, const void *data, size_t bytes);
+
+/**
+ * \brief  Writes the remaining buffered data and closes a direct handle.
+ *
+ * \param[in,out]  *fd
+ *                     Pointer to the handle, it will be set to @c NULL.
+ *
+ * \return  Returns nothing.
+ */
+extern void
+xfile_closeDirect(xfileDirect_t *fd);
+
 
 #endif
@@ -0,0 +1,139 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/xfile_tests.c
+ * @ingroup  libutilCoreXfileTest
+ * @brief  Implements the tests for the xfile module.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "xfile_tests.h"
+#include "xfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xmem.h"
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_TESTFILE "xfileTest.dat"
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+xfile_createFileWithSize_test(void)
+{
+	bool   hasPassed = true;
+	int    rank      = 0;
+	size_t bytes     = 10000;
+	char   *data;
+	FILE   *f;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// The build must reserve the space with posix_fallocate().
+	if (!xfile_hasDirectIO())
+		hasPassed = false;
+
+	xfile_createFileWithSize(LOCAL_TESTFILE, bytes);
+	f = xfopen(LOCAL_TESTFILE, "rb");
+	xfseek(f, 0L, SEEK_END);
+	if ((size_t)xftell(f) != bytes)
+		hasPassed = false;
+	xfseek(f, 0L, SEEK_SET);
+	data = xmalloc(bytes);
+	if (fread(data, 1, bytes, f) != bytes)
+		hasPassed = false;
+	for (size_t i = 0; i < bytes; i++)
+		if (data[i] != 0)
+			hasPassed = false;
+	xfree(data);
+	xfclose(&f);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* xfile_createFileWithSize_test */
+
+extern bool
+xfile_writeDirect_test(void)
+{
+	bool          hasPassed = true;
+	int           rank      = 0;
+	const size_t  bytes     = 3 * 4096 + 100;
+	const size_t  offset    = 1000;
+	const size_t  numData   = 9000;
+	const size_t  chunks[3] = {1, 4095, 4904};
+	char          *data, *check;
+	xfileDirect_t fd;
+	FILE          *f;
+#ifdef XMEM_TRACK_MEM
+	size_t        allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// The build must write through pwrite() and not through stdio.
+	if (!xfile_hasDirectIO())
+		hasPassed = false;
+
+	data  = xmalloc(bytes);
+	check = xmalloc(bytes);
+	memset(data, 0x55, bytes);
+	f = xfopen(LOCAL_TESTFILE, "wb");
+	xfwrite(data, 1, bytes, f);
+	xfclose(&f);
+
+	// An unaligned region written in unaligned pieces, the data around it
+	// must stay untouched.
+	for (size_t i = 0; i < numData; i++)
+		data[offset + i] = (char)(i % 251);
+	fd = xfile_openDirect(LOCAL_TESTFILE, offset);
+	for (size_t i = 0, pos = offset; i < 3; pos += chunks[i], i++)
+		xfile_writeDirect(fd, data + pos, chunks[i]);
+	xfile_closeDirect(&fd);
+	if (fd != NULL)
+		hasPassed = false;
+
+	f = xfopen(LOCAL_TESTFILE, "rb");
+	if (fread(check, 1, bytes, f) != bytes)
+		hasPassed = false;
+	if (fread(check, 1, 1, f) != 0)
+		hasPassed = false;
+	xfclose(&f);
+	if (memcmp(data, check, bytes) != 0)
+		hasPassed = false;
+
+	xfree(check);
+	xfree(data);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* xfile_writeDirect_test */
@@ -0,0 +1,52 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef XFILE_TESTS_H
+#define XFILE_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file  libutil/xfile_tests.h
+ * @ingroup  libutilCoreXfileTest
+ * @brief  Provides the interface for testing the xfile module.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Tests xfile_createFileWithSize().
+ *
+ * @return  Returns @c true if the tests succeeded and @c false otherwise.
+ */
+extern bool
+xfile_createFileWithSize_test(void);
+
+/**
+ * @brief  Tests xfile_openDirect(), xfile_writeDirect() and
+ *         xfile_closeDirect().
+ *
+ * @return  Returns @c true if the tests succeeded and @c false otherwise.
+ */
+extern bool
+xfile_writeDirect_test(void);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libutilCoreXfileTest Test for xfile
+ * @ingroup libutilCore
+ * @brief Provides test functions for the file utilities.
+ */
+
+
+#endif
@@ -152,15 +152,19 @@ checkZero_run(checkZero_t te)
 	stat   = gridStatistics_new();
 
 	timing = timer_start_text("  Filling input grid... ");
+	gridReader_setSummary(te->reader, stat, NULL);
 	local_fillInputGrid(te->gridIn, te->reader);
+	gridReader_setSummary(te->reader, NULL, NULL);
 	timing = timer_stop_text(timing, "took %.5fs\n");
 
+	// The moments were accumulated while reading, only the reduction
+	// across the tasks is left.
 	timing = timer_start_text("  Calculating statistics on input grid... ");
-#ifdef WITH_MPI	
-	gridStatistics_calcGridRegularDistrib(stat, te->distribIn, 0);
-#else
-	gridStatistics_calcGridRegular(stat, te->gridIn, 0);
+#ifdef WITH_MPI
+	gridStatistics_reduce(stat,
+	                      gridRegularDistrib_getGlobalComm(te->distribIn));
 #endif
+	gridStatistics_finalize(stat);
         mean = gridStatistics_getMean(stat);
 	timing = timer_stop_text(timing, "took %.5fs\n");
 	if (rank == 0)
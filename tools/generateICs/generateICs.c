@@ -41,6 +41,9 @@
 #include "../../src/libgrid/gridPatch.h"
 #include "../../src/libpart/partBunch.h"
 #include "../../src/libgrid/gridPoint.h"
+#ifdef WITH_HDF5
+#  include "../../src/libgrid/gridReaderHDF5.h"
+#endif
 #include "../../src/liblare/lare.h"
 
 
@@ -48,6 +51,26 @@
 #include "generateICs_adt.h"
 
 
+/*--- Local structures --------------------------------------------------*/
+
+/** @brief  Describes one file that needs to be produced. */
+struct local_fileJob_struct {
+	/** @brief  The number of particles in the file. */
+	uint64_t cost;
+	/** @brief  The ID of the first particle in the file. */
+	uint64_t firstID;
+	/**
+	 * @brief  The position of the first particle among all particles of
+	 *         its type (for the HDF5 output).
+	 */
+	uint64_t typeOffset;
+	/** @brief  The file number (relative to its level). */
+	uint32_t file;
+	/** @brief  The zoom level the file belongs to. */
+	int32_t  level;
+};
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
 /**
@@ -72,14 +95,58 @@ local_alloc(void);
 inline static void
 local_init(generateICs_t genics);
 
+/**
+ * @brief  Sets the parts of the core object that are the same for all
+ *         tiles of the current level.
+ *
+ * @param[out]  core
+ *                 The core object to set up.
+ * @param[in]   genics
+ *                 The application to work with.
+ *
+ * @return  Returns nothing.
+ */
 static void
 local_setupCore(generateICsCore_t   core,
                 const generateICs_t genics);
 
+/**
+ * @brief  Counts the particles of each level in each tile once, all later
+ *         queries are answered from these counts.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_initMaskStats(generateICs_t genics);
+
+static uint64_t
+local_computeNumParts(const generateICs_t genics, uint32_t tile);
+
+static uint64_t
+local_computeNumPartsTileLevel(const generateICs_t genics,
+                               uint32_t            tile,
+                               int32_t             level);
+
 static uint64_t
 local_computeNumPartsLevel(const generateICs_t genics, 
 														int8_t level);
 
+/**
+ * @brief  Gives the number of files of all levels below a given one.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  level
+ *                The level.
+ *
+ * @return  Returns the global number of the first file of the level.
+ */
+static uint32_t
+local_getFileOffset(const generateICs_t genics, int32_t level);
+
 /**
  * @brief  Helper function for generateICs_run().
  *
@@ -90,17 +157,299 @@ local_computeNumPartsLevel(const generateICs_t genics,
  *                    information about the number of cells in each file.
  * @param[in]      file
  *                    The file number to work on.
+ * @param[in]      firstID
+ *                    The ID of the first particle in the file, only used
+ *                    for sequential IDs.
+ * @param[in]      typeOffset
+ *                    The position of the first particle of the file in the
+ *                    datasets of its type, only used for HDF5 output.
  *
- * @return  Returns nothing.
+ * @return  Returns the number of (dark matter) particles generated.
  */
-static void
-local_doFile(generateICs_t genics, const g9pICMap_t map, int file, uint64_t *startID);
+static uint64_t
+local_doFile(generateICs_t    genics,
+             const g9pICMap_t map,
+             int              file,
+             uint64_t         firstID,
+             uint64_t         typeOffset);
+
+/**
+ * @brief  Gives the number of (dark matter) particles in a file.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  map
+ *                The mapping of tiles onto the files of the level.
+ * @param[in]  file
+ *                The file number.
+ * @param[in]  level
+ *                The level the file belongs to.
+ *
+ * @return  Returns the number of particles in the file.
+ */
+static uint64_t
+local_computeNumPartsFile(const generateICs_t genics,
+                          const g9pICMap_t    map,
+                          uint32_t            file,
+                          int32_t             level);
+
+/**
+ * @brief  Gives the files of the levels to produce, in the order in which
+ *         they should be produced.
+ *
+ * The files of all levels are sorted by the number of particles in them,
+ * largest first, so that the expensive files are started early and the
+ * cheap ones fill the gaps at the end.  The IDs follow the level and file
+ * order, every task can hence derive them from the mask alone and produce
+ * any file independently of the others.
+ *
+ * @param[in]   genics
+ *                 The application to work with.
+ * @param[in]   maps
+ *                 The mapping of tiles onto the files for each level.
+ * @param[in]   levelLo
+ *                 The first level to produce.
+ * @param[in]   levelHi
+ *                 The last level to produce.
+ * @param[out]  numJobs
+ *                 Receives the number of files.
+ *
+ * @return  Returns a new array of @c numJobs files, the caller is
+ *          responsible for freeing it.
+ */
+static struct local_fileJob_struct *
+local_getFileJobs(const generateICs_t genics,
+                  const g9pICMap_t    *maps,
+                  int32_t             levelLo,
+                  int32_t             levelHi,
+                  uint32_t            *numJobs);
+
+/**
+ * @brief  Gives the first position at or after @c pos in the tile order of
+ *         the map whose tile contains particles of the current level.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  map
+ *                The map giving the order of the tiles.
+ * @param[in]  pos
+ *                The position to start looking at.
+ * @param[in]  lastPos
+ *                The last position to consider.
+ *
+ * @return  Returns the position, or @c lastPos + 1 if there is none, see
+ *          g9pICMap_getTileAt() for the tile at it.
+ */
+static uint32_t
+local_getNextTile(const generateICs_t genics,
+                  const g9pICMap_t    map,
+                  uint32_t            pos,
+                  uint32_t            lastPos);
+
+/**
+ * @brief  Reads the velocity fields of the cells of one tile that are at
+ *         the current level.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  tile
+ *                The tile to read.
+ *
+ * @return  Returns a new patch holding the three velocity components,
+ *          it covers the bounding box of the cells of the tile at the
+ *          current level.
+ */
+static gridPatch_t
+local_readTile(const generateICs_t genics, uint32_t tile);
+
+/**
+ * @brief  Gives the velocity input of the current level.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ *
+ * @return  Returns the input object.
+ */
+static generateICsIn_t
+local_getIn(const generateICs_t genics);
+
+/**
+ * @brief  Generates the (dark matter) particles of one tile.
+ *
+ * @param[in]      genics
+ *                    The application to work with.
+ * @param[in,out]  core
+ *                    The core object used for generating the particles.
+ * @param[out]     particles
+ *                    The particle storage to fill.
+ * @param[in]      offset
+ *                    The position in @c particles of the first particle
+ *                    of the tile.
+ * @param[in]      tile
+ *                    The tile to work on.
+ * @param[in]      patch
+ *                    The velocity fields of the tile, see local_readTile().
+ * @param[in,out]  startID
+ *                    The first ID to use, updated to the next free ID.
+ *
+ * @return  Returns the number of generated particles.
+ */
+static uint64_t
+local_convertTile(const generateICs_t genics,
+                  generateICsCore_t   core,
+                  partBunch_t         particles,
+                  uint64_t            offset,
+                  uint32_t            tile,
+                  gridPatch_t         patch,
+                  uint64_t            *startID);
+
+static bool
+local_isGasLevel(const generateICs_t genics);
+
+static bool
+local_needsMassBlock(const generateICs_t genics);
 
 static void
 local_writeGadgetFile(generateICs_t     genics,
                       int               file,
-                      const partBunch_t particles,
-                      g9pICMap_t map);
+                      const partBunch_t particles);
+
+/**
+ * @brief  Sets up header and table of contents of a file and opens it for
+ *         writing.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      file
+ *                    The file number (relative to the current level).
+ * @param[in]      np
+ *                    The total number of particles in the file, including
+ *                    gas particles.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_openGadgetFile(generateICs_t genics, int file, uint64_t np);
+
+/**
+ * @brief  Writes particles to their position in the open file.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      particles
+ *                    The particle storage.
+ * @param[in]      first
+ *                    The first particle in the storage to write.
+ * @param[in]      np
+ *                    The number of particles to write.
+ * @param[in]      pSkip
+ *                    The number of particles in the blocks of the file
+ *                    before the first written particle.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeParticles(generateICs_t     genics,
+                     const partBunch_t particles,
+                     uint64_t          first,
+                     uint64_t          np,
+                     uint64_t          pSkip);
+
+static void
+local_writeGasEnergies(generateICs_t genics, uint64_t pSkip, uint64_t np);
+
+/**
+ * @brief  Creates the HDF5 file with room for all particles of the levels
+ *         generated in this run, collective with MPI.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      levelLo
+ *                    The first level that is generated.
+ * @param[in]      levelHi
+ *                    The last level that is generated.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_createHDF5File(generateICs_t genics, int32_t levelLo, int32_t levelHi);
+
+/**
+ * @brief  Writes particles of the current level to the HDF5 file.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      particles
+ *                    The particle storage, with gas the dark matter
+ *                    particles are in the second half.
+ * @param[in]      np
+ *                    The number of (dark matter) particles to write.
+ * @param[in]      typeOffset
+ *                    The position of the first particle in the datasets of
+ *                    its type.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeHDF5(generateICs_t     genics,
+                const partBunch_t particles,
+                uint64_t          np,
+                uint64_t          typeOffset);
+
+static int
+local_compareFileJobs(const void *a, const void *b);
+
+/**
+ * @brief  Reports the amount of data read from HDF5 input files and the
+ *         time spent doing so, summed over all tasks.
+ *
+ * This must be called by all tasks, only task 0 prints.
+ *
+ * @param[in]  genics
+ *                The generator whose input readers to query.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_printReadStats(const generateICs_t genics);
+
+/**
+ * @brief  Checks that particles can be written in Peano-Hilbert order.
+ *
+ * Sorting every tile along the curve only puts a whole file into curve
+ * order if the curve through the tiles and the curves through the cells
+ * nest, that is if the number of tiles and the grid sizes of all levels
+ * are powers of two.  The program terminates with an error otherwise.
+ *
+ * @param[in]  genics
+ *                The generator to check.
+ * @param[in]  levelLo
+ *                The lowest level that is generated.
+ * @param[in]  levelHi
+ *                The highest level that is generated.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_checkPeanoHilbertOrder(const generateICs_t genics,
+                             int32_t             levelLo,
+                             int32_t             levelHi);
+
+#ifdef WITH_MPI
+
+/**
+ * @brief  Atomically retrieves and increments the shared file counter.
+ *
+ * @param[in]  win
+ *                The window exposing the counter on rank 0.
+ *
+ * @return  Returns the index of the next file to work on, this may be
+ *          beyond the number of files once all files are handed out.
+ */
+static uint32_t
+local_fetchNextFileIdx(MPI_Win win);
+
+#endif
 
 
 /*--- Exported functions: Creating and deleting -------------------------*/
@@ -127,6 +476,16 @@ generateICs_del(generateICs_t *genics)
 		generateICsData_del( &( (*genics)->data ) );
 	if ( (*genics)->in != NULL )
 		generateICsIn_del( &( (*genics)->in ) );
+	if ( (*genics)->inForLevel != NULL ) {
+		for (int i = 0; i < g9pMask_getNumLevel((*genics)->mask); i++)
+			if ( (*genics)->inForLevel[i] != NULL )
+				generateICsIn_del( &( (*genics)->inForLevel[i] ) );
+		xfree( (*genics)->inForLevel );
+	}
+	if ( (*genics)->numPartsInTile != NULL )
+		xfree( (*genics)->numPartsInTile );
+	if ( (*genics)->numPartsInLevel != NULL )
+		xfree( (*genics)->numPartsInLevel );
 	if ( (*genics)->out != NULL )
 		generateICsOut_del( &( (*genics)->out ) );
 	if ( (*genics)->hierarchy != NULL )
@@ -166,14 +525,12 @@ extern void
 generateICs_run(generateICs_t genics)
 {
 	assert(genics != NULL);
-	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
-	uint32_t maxlev = g9pMask_getMaxLevel(genics->mask);
-	uint32_t numFiles = genics->out->numFilesForLevel[genics->zoomlevel-minlev];
-	uint64_t startID = 0;
-
-	g9pICMap_t map = g9pICMap_new( numFiles, 0, NULL,
-	                               g9pMask_getRef(genics->mask),
-	                               genics->zoomlevel);
+	uint32_t minlev  = g9pMask_getMinLevel(genics->mask);
+	uint32_t maxlev  = g9pMask_getMaxLevel(genics->mask);
+	int32_t  levelLo = genics->allLevels ? (int32_t)minlev : genics->zoomlevel;
+	int32_t  levelHi = genics->allLevels ? (int32_t)maxlev : genics->zoomlevel;
+	uint64_t numParts         = UINT64_C(0);
+	uint64_t numPartsExpected = UINT64_C(0);
 
 	if (genics->rank == 0)
 		generateICs_printSummary(genics, stdout);
@@ -182,67 +539,241 @@ generateICs_run(generateICs_t genics)
 	gridPointUint32_t fullDims = {tmp, tmp, tmp};
 	generateICsOut_initBaseHeader(genics->out, genics->data, fullDims,
 	                              genics->mode);
-	                            
-	                              
-	if (genics->rank != 0 && genics->mode->sequentialIDs) {
-		fprintf(stderr, "Sorry, sequentialIDs are supported only for single CPU runs.\n");
-		diediedie(EXIT_FAILURE);
+
+	local_initMaskStats(genics);
+
+	// Along the Peano-Hilbert curve every file holds a compact region.
+	uint32_t   *tileOrder = NULL;
+	if (genics->mode->peanoHilbertOrder) {
+		local_checkPeanoHilbertOrder(genics, levelLo, levelHi);
+		tileOrder = g9pMask_getTileOrderPeanoHilbert(genics->mask);
 	}
-	for (uint8_t lev=minlev; lev < genics->zoomlevel;lev++) {
-		startID += local_computeNumPartsLevel(genics,lev);
+
+	g9pICMap_t *maps = xmalloc(sizeof(g9pICMap_t) * (levelHi - levelLo + 1));
+	for (int32_t lev = levelLo; lev <= levelHi; lev++) {
+		maps[lev - levelLo] = g9pICMap_newWithTileOrder(
+		    genics->out->numFilesForLevel[lev - minlev], 0, NULL,
+		    g9pMask_getRef(genics->mask), lev, tileOrder);
+		numPartsExpected   += local_computeNumPartsLevel(genics, lev);
 	}
-	
-        uint32_t N1, N2, Nperproc;
-        uint32_t  NDO=0;
-        uint32_t foffset=0;
-        for (uint32_t i = 0; i < genics->zoomlevel-minlev; i++){
-			foffset+=genics->out->numFilesForLevel[i];
-		}
+	if (tileOrder != NULL)
+		xfree(tileOrder);
+
+	// The files are handed out one at a time from a shared counter, tasks
+	// that are done with their file simply pick up the next one.
+	uint32_t                    numJobs;
+	struct local_fileJob_struct *jobs;
+	uint32_t                    next = 0;
+
+	jobs = local_getFileJobs(genics, maps, levelLo, levelHi, &numJobs);
+	if (genics->out->hdf5 != NULL)
+		local_createHDF5File(genics, levelLo, levelHi);
+#ifdef WITH_MPI
+	uint32_t counter = 0;
+	MPI_Win  win;
+
+	MPI_Win_create(&counter, (genics->rank == 0) ? sizeof(uint32_t) : 0,
+	               sizeof(uint32_t), MPI_INFO_NULL, MPI_COMM_WORLD, &win);
+	next = local_fetchNextFileIdx(win);
+#endif
+
+	while (next < numJobs) {
+		const struct local_fileJob_struct *job = jobs + next;
+
+		genics->zoomlevel = job->level;
+		printf(" * Working on file %i (level %i)\n",
+		       job->file + local_getFileOffset(genics, job->level),
+		       job->level);
+		double timing = timer_startLocal();
 
-        if (genics->size <=  numFiles ) 
-          {
-            Nperproc= numFiles / genics->size;
-            N1 = Nperproc * genics->rank ;
-            N2= Nperproc  + N1;
-
-            if (genics->rank  ==  genics->size -1 )
-              {
-                N2 = numFiles;
-              } 
-          }
-        else
-          {
-            if ( genics->rank <=  numFiles -1 )
-              {
-                N1 = genics->rank;
-                N2 = N1+1;
-              }
-            else
-              {NDO=1;}
-          }
-
-        printf(" * Comienzo a producir files desde  %i a %i\n", N1, N2);
-
-        if ( NDO == 0 ) 
-          {
-            for (uint32_t i = N1; i < N2; i++) 
-              {
-		
-		//	for (uint32_t i = 0; i < genics->out->numFiles; i++) {
-		printf(" * Working on file %i\n", i+foffset);
-		double timing = timer_start();
-		
-		local_doFile(genics, map, i, &startID);
-		
-		timing = timer_stop(timing);
+		numParts += local_doFile(genics, maps[job->level - levelLo],
+		                         job->file, job->firstID, job->typeOffset);
+
+		timing = timer_stopLocal(timing);
 		printf("      File processed in in %.2fs\n", timing);
-	      }
-	  }
+#ifdef WITH_MPI
+		next = local_fetchNextFileIdx(win);
+#else
+		next++;
+#endif
+	}
 
-	g9pICMap_del(&map);
+#ifdef WITH_HDF5
+	if (genics->out->hdf5 != NULL)
+		generateICsHDF5_close(genics->out->hdf5);
+#endif
+#ifdef WITH_MPI
+	MPI_Win_free(&win);
+	MPI_Allreduce(MPI_IN_PLACE, &numParts, 1, MPI_UINT64_T, MPI_SUM,
+	              MPI_COMM_WORLD);
+#endif
+	if (numParts != numPartsExpected) {
+		fprintf(stderr, "ERROR: Generated %" PRIu64 " particles, expected %"
+		        PRIu64 ".\n", numParts, numPartsExpected);
+		diediedie(EXIT_FAILURE);
+	}
+	local_printReadStats(genics);
+	xfree(jobs);
+	for (int32_t lev = levelLo; lev <= levelHi; lev++)
+		g9pICMap_del(&(maps[lev - levelLo]));
+	xfree(maps);
 } // generateICs_run
 
 /*--- Implementations of local functions --------------------------------*/
+static struct local_fileJob_struct *
+local_getFileJobs(const generateICs_t genics,
+                  const g9pICMap_t    *maps,
+                  int32_t             levelLo,
+                  int32_t             levelHi,
+                  uint32_t            *numJobs)
+{
+	struct local_fileJob_struct *jobs;
+	uint32_t                    minlev = g9pMask_getMinLevel(genics->mask);
+	uint32_t                    n      = 0;
+	uint64_t                    numPartsOfType[6] = {0, 0, 0, 0, 0, 0};
+
+	*numJobs = 0;
+	for (int32_t lev = levelLo; lev <= levelHi; lev++)
+		*numJobs += genics->out->numFilesForLevel[lev - minlev];
+	jobs = xmalloc(sizeof(struct local_fileJob_struct) * *numJobs);
+
+	for (int32_t lev = levelLo; lev <= levelHi; lev++) {
+		uint32_t numFiles = genics->out->numFilesForLevel[lev - minlev];
+		int32_t  type     = genics->typeForLevel[lev - minlev];
+		uint64_t firstID  = UINT64_C(0);
+
+		for (int32_t l = minlev; l < lev; l++)
+			firstID += local_computeNumPartsLevel(genics, l);
+
+		for (uint32_t i = 0; i < numFiles; i++, n++) {
+			jobs[n].cost    = local_computeNumPartsFile(genics,
+			                                            maps[lev - levelLo],
+			                                            i, lev);
+			jobs[n].firstID    = firstID;
+			jobs[n].typeOffset = numPartsOfType[type];
+			jobs[n].file       = i;
+			jobs[n].level      = lev;
+			firstID              += jobs[n].cost;
+			numPartsOfType[type] += jobs[n].cost;
+		}
+	}
+	qsort(jobs, *numJobs, sizeof(struct local_fileJob_struct),
+	      &local_compareFileJobs);
+
+	return jobs;
+} // local_getFileJobs
+
+static uint64_t
+local_computeNumPartsFile(const generateICs_t genics,
+                          const g9pICMap_t    map,
+                          uint32_t            file,
+                          int32_t             level)
+{
+	uint32_t firstTile = g9pICMap_getFirstTileInFile(map, file);
+	uint32_t lastTile  = g9pICMap_getLastTileInFile(map, file);
+	uint64_t np        = UINT64_C(0);
+
+	for (uint32_t i = firstTile; i <= lastTile; i++)
+		np += local_computeNumPartsTileLevel(genics,
+		                                     g9pICMap_getTileAt(map, i),
+		                                     level);
+
+	return np;
+}
+
+static int
+local_compareFileJobs(const void *a, const void *b)
+{
+	const struct local_fileJob_struct *ja = a;
+	const struct local_fileJob_struct *jb = b;
+
+	if (ja->cost != jb->cost)
+		return (ja->cost > jb->cost) ? -1 : 1;
+	if (ja->level != jb->level)
+		return (ja->level < jb->level) ? -1 : 1;
+
+	return (ja->file < jb->file) ? -1 : (ja->file > jb->file);
+}
+
+static void
+local_printReadStats(const generateICs_t genics)
+{
+	double stats[2] = {0.0, 0.0};
+
+#ifdef WITH_HDF5
+	const int numIns = (genics->inForLevel == NULL)
+	                   ? 1 : g9pMask_getNumLevel(genics->mask);
+
+	for (int i = 0; i < numIns; i++) {
+		generateICsIn_t in = (genics->inForLevel == NULL)
+		                     ? genics->in : genics->inForLevel[i];
+		if (in == NULL)
+			continue;
+
+		gridReader_t readers[3] = {in->velx, in->vely, in->velz};
+		for (int j = 0; j < 3; j++) {
+			uint64_t bytes;
+			double   seconds;
+			if (gridReader_getType(readers[j]) != GRIDIO_TYPE_HDF5)
+				continue;
+			gridReaderHDF5_getReadStats((gridReaderHDF5_t)readers[j],
+			                            &bytes, &seconds);
+			stats[0] += (double)bytes;
+			stats[1] += seconds;
+		}
+	}
+#endif
+#ifdef WITH_MPI
+	MPI_Allreduce(MPI_IN_PLACE, stats, 2, MPI_DOUBLE, MPI_SUM,
+	              MPI_COMM_WORLD);
+#endif
+
+	if ((genics->rank == 0) && (stats[0] > 0.0)) {
+		printf(" * Read %.2f MB of HDF5 input in %.2fs summed over all tasks "
+		       "(%.2f MB/s per task)\n", stats[0] / 1048576., stats[1],
+		       stats[1] > 0. ? stats[0] / 1048576. / stats[1] : 0.0);
+	}
+}
+
+static void
+local_checkPeanoHilbertOrder(const generateICs_t genics,
+                             int32_t             levelLo,
+                             int32_t             levelHi)
+{
+	const uint32_t numTiles = g9pMask_getNumTiles(genics->mask)[0];
+
+	if ((numTiles & (numTiles - 1)) != 0) {
+		fprintf(stderr, "ERROR: peanoHilbertOrder needs a power of two "
+		        "tiles per dimension, got %" PRIu32 ".\n", numTiles);
+		diediedie(EXIT_FAILURE);
+	}
+	for (int32_t lev = levelLo; lev <= levelHi; lev++) {
+		uint32_t dim1D = g9pMask_getDim1DLevel(genics->mask, (uint8_t)lev);
+		if ((dim1D & (dim1D - 1)) != 0) {
+			fprintf(stderr, "ERROR: peanoHilbertOrder needs a power of two "
+			        "grid size, level %" PRIi32 " has %" PRIu32 ".\n",
+			        lev, dim1D);
+			diediedie(EXIT_FAILURE);
+		}
+	}
+}
+
+#ifdef WITH_MPI
+static uint32_t
+local_fetchNextFileIdx(MPI_Win win)
+{
+	const uint32_t one = 1;
+	uint32_t       idx;
+
+	MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, win);
+	MPI_Fetch_and_op(&one, &idx, MPI_UINT32_T, 0, 0, MPI_SUM, win);
+	MPI_Win_unlock(0, win);
+
+	return idx;
+}
+
+#endif
+
 inline static generateICs_t
 local_alloc(void)
 {
@@ -264,6 +795,9 @@ local_init(generateICs_t genics)
 
 #ifdef WITH_OPENMP
 	genics->numThreads = omp_get_max_threads();
+	// The particle generation runs next to the reading of the next tile,
+	// it needs to be allowed to spawn its own team of threads.
+	omp_set_max_active_levels(2);
 #else
 	genics->numThreads = 1;
 #endif
@@ -271,6 +805,10 @@ local_init(generateICs_t genics)
 	genics->mode      = NULL;
 	genics->data      = NULL;
 	genics->in        = NULL;
+	genics->inForLevel = NULL;
+	genics->allLevels  = false;
+	genics->numPartsInTile  = NULL;
+	genics->numPartsInLevel = NULL;
 	genics->out       = NULL;
 	genics->hierarchy = NULL;
 	genics->datastore = NULL;
@@ -279,34 +817,68 @@ local_init(generateICs_t genics)
 	genics->shift = xmalloc(sizeof(double)*3);
 } // local_init
 
+static void
+local_initMaskStats(generateICs_t genics)
+{
+	const uint32_t numTiles  = g9pMask_getTotalNumTiles(genics->mask);
+	const int8_t   numLevels = g9pMask_getNumLevel(genics->mask);
+
+	if (genics->numPartsInTile != NULL)
+		return;
+
+	genics->numPartsInTile  = xmalloc(sizeof(uint64_t) * numTiles
+	                                  * numLevels);
+	genics->numPartsInLevel = xmalloc(sizeof(uint64_t) * numLevels);
+	for (int8_t l = 0; l < numLevels; l++)
+		genics->numPartsInLevel[l] = UINT64_C(0);
+
+	for (uint32_t tile = 0; tile < numTiles; tile++) {
+		uint64_t *numCells = genics->numPartsInTile + tile * numLevels;
+
+		(void)g9pMask_getNumCellsInTile(genics->mask, tile, numCells);
+		for (int8_t l = 0; l < numLevels; l++)
+			genics->numPartsInLevel[l] += numCells[l];
+	}
+} // local_initMaskStats
+
 static uint64_t
 local_computeNumParts(const generateICs_t genics, uint32_t tile)
 {
-	uint64_t np;
+	return local_computeNumPartsTileLevel(genics, tile, genics->zoomlevel);
+}
+
+static uint64_t
+local_computeNumPartsTileLevel(const generateICs_t genics,
+                               uint32_t            tile,
+                               int32_t             level)
+{
+	const uint32_t minlev = g9pMask_getMinLevel(genics->mask);
 
-	np = g9pMask_getNumCellsInTileForLevel( genics->mask, tile,
-											genics->zoomlevel);
-	                                        //g9pMask_getMinLevel(genics->mask) );
+	assert(genics->numPartsInTile != NULL);
 
-	return np;
+	return genics->numPartsInTile[tile * g9pMask_getNumLevel(genics->mask)
+	                              + level - minlev];
 }
 
 static uint64_t
 local_computeNumPartsLevel(const generateICs_t genics, 
 														int8_t level)
 {
-	uint64_t np=0;
-	//int			file = level - g9pMask_getMinLevel(genics->mask);
-	uint32_t    firstTile = 0;
-	uint32_t    lastTile  = g9pMask_getTotalNumTiles(genics->mask);
-	
-	
-	for(uint32_t tile=firstTile; tile<lastTile; tile++){
-		np += g9pMask_getNumCellsInTileForLevel( genics->mask, tile,
-	                                        level );
-	}
+	assert(genics->numPartsInLevel != NULL);
 
-	return np;
+	return genics->numPartsInLevel[level - g9pMask_getMinLevel(genics->mask)];
+}
+
+static uint32_t
+local_getFileOffset(const generateICs_t genics, int32_t level)
+{
+	uint32_t minlev  = g9pMask_getMinLevel(genics->mask);
+	uint32_t foffset = 0;
+
+	for (int32_t i = 0; i < level - (int32_t)minlev; i++)
+		foffset += genics->out->numFilesForLevel[i];
+
+	return foffset;
 }
 
 static void
@@ -319,17 +891,35 @@ local_setupCore(generateICsCore_t   core,
 
 	printf("   fullDims = (%u, %u, %u)\n", core->fullDims[0],
 	       core->fullDims[1], core->fullDims[2]);
-}
+
+	if (local_isGasLevel(genics)) {
+		core->doGas      = true;
+		core->gasShift   = genics->data->boxsizeInMpch / core->fullDims[0]
+		                   * 0.25;
+		core->npGasTotal = local_computeNumPartsLevel(genics,
+		                                              genics->zoomlevel);
+		printf("   Making gas particles\n");
+		printf("   Gas offset: %lf\n", core->gasShift);
+		printf("   Total gas particles: %lu\n", core->npGasTotal);
+	}
+
+	core->numCenters = 0;
+	if (genics->mode->autoCenter) {
+		g9pMask_getCenter(genics->mask, core->centers[core->numCenters]);
+		core->numCenters++;
+	}
+	if (genics->shift[0]!=0 || genics->shift[1]!=0 || genics->shift[2]!=0) {
+		for (int i=0;i<3;i++) {
+			core->centers[core->numCenters][i] = (genics->data->boxsizeInMpch/2 - genics->shift[i])/genics->data->boxsizeInMpch;
+		}
+		core->numCenters++;
+	}
+} // local_setupCore
 
 static partBunch_t
 local_getParticleStorage(const generateICs_t genics,
-                         const uint32_t      firstTile,
-                         const uint32_t      lastTile)
+                         uint64_t            numParticles)
 {
-	uint64_t numParticles = UINT64_C(0);
-	for (uint32_t i = firstTile; i <= lastTile; i++) {
-		numParticles += local_computeNumParts(genics, i);
-	}
 	if (genics->mode->doGas && (genics->typeForLevel)[genics->zoomlevel-g9pMask_getMinLevel(genics->mask)]==1)
 		numParticles *= 2;
 
@@ -352,15 +942,27 @@ local_getParticleStorage(const generateICs_t genics,
 	return particles;
 } // local_getParticleStorage
 
-static void
-local_doFile(generateICs_t genics, g9pICMap_t map, int file, uint64_t *startID)
+static uint64_t
+local_doFile(generateICs_t    genics,
+             const g9pICMap_t map,
+             int              file,
+             uint64_t         firstID,
+             uint64_t         typeOffset)
 {
-	uint32_t    firstTile = g9pICMap_getFirstTileInFile(map, file);
-	uint32_t    lastTile  = g9pICMap_getLastTileInFile(map, file);
-	uint64_t    partsRead = UINT64_C(0);
-
-	partBunch_t particles = local_getParticleStorage(genics,
-	                                                 firstTile, lastTile);
+	uint32_t    firstPos    = g9pICMap_getFirstTileInFile(map, file);
+	uint32_t    lastPos     = g9pICMap_getLastTileInFile(map, file);
+	const bool  isGas       = local_isGasLevel(genics);
+	const bool  toHDF5      = (genics->out->hdf5 != NULL);
+	uint64_t    npInFile    = local_computeNumPartsFile(genics, map, file,
+	                                                    genics->zoomlevel);
+	uint64_t    partsDone   = UINT64_C(0);
+	uint64_t    startID     = firstID;
+	double      timeRead    = 0.0;
+	double      timeConvert = 0.0;
+	double      timeTotal   = 0.0;
+	partBunch_t particles   = NULL;
+	gridPatch_t nextPatch   = NULL;
+	uint32_t    nextPos;
 
 	generateICsCore_s core = GENICSCORE_INIT_STRUCT(genics->data,
 	                                                genics->mode);
@@ -368,124 +970,254 @@ local_doFile(generateICs_t genics, g9pICMap_t map, int file, uint64_t *startID)
 	
 	printf("np in level: %i\n",
 				local_computeNumPartsLevel(genics, genics->zoomlevel)); 
-	
-	for (uint32_t i = firstTile; i <= lastTile; i++) {
-//		printf("cells in tile: %i\n", g9pMask_getNumCellsInTileForLevel(genics->mask,i,genics->zoomlevel));
-		core.numParticles = local_computeNumParts(genics, i);
-		if(core.numParticles > 0) {
-		core.pos          = partBunch_at(particles, 0, partsRead);
-		core.vel          = partBunch_at(particles, 1, partsRead);
-		core.id           = partBunch_at(particles, 2, partsRead);
-		core.patch        = g9pMask_getEmptyPatchForTileLevel(genics->mask, i, genics->zoomlevel);
-		core.level		  = genics->zoomlevel;
-		core.maxDims	  = g9pMask_getDim1DLevel(genics->mask,g9pMask_getMaxLevel(genics->mask));
-		core.maskdata	  = g9pMask_getTileData(genics->mask,i);
-		core.maskDim1D	  = g9pMask_getDim1D(genics->mask);
-		core.partDim1D	  = g9pMask_getDim1DLevel(genics->mask,genics->zoomlevel);
-		core.startID	  = *startID;
-		(void)gridPatch_attachVar(core.patch, genics->in->varVelx);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVely);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVelz);
-
-//		fpv_t             *velxP = gridPatch_getVarDataHandle(core.patch, 0);
-	//	printf("\n %i \n", i);
-
-		gridReader_readIntoPatchForVar(genics->in->velx, core.patch, 0);
-		gridReader_readIntoPatchForVar(genics->in->vely, core.patch, 1);
-		gridReader_readIntoPatchForVar(genics->in->velz, core.patch, 2);
-		
-		//fpv_t             *velx1P = gridPatch_getVarDataHandle(core.patch, 0);
-		//printf(" %i \n", velx1P);
-		
-		generateICsCore_toParticles(&core);
-		
-		*startID = core.startID;
-		printf("StartID: %i\n",*startID);
-
-		//fpv_t             *velx2P = gridPatch_getVarDataHandle(core.patch, 0);
-		//printf(" %i \n\n", velx2P);
-
-		gridPatch_del( &(core.patch) );
-		partsRead += core.numParticles;
-	    }
-	}
-	printf("   Particles read: %lu\n", partsRead);
-	//printf("pos: %f", core.pos[1]);
-	if (genics->mode->doGas && (genics->typeForLevel)[genics->zoomlevel-g9pMask_getMinLevel(genics->mask)]==1) {
-		printf("   Making gas particles\n");
-		uint64_t npGasTotal = local_computeNumPartsLevel(genics, genics->zoomlevel);
-		//npGasTotal = core.fullDims[0];
-		//npGasTotal *= core.fullDims[1];
-		//npGasTotal *= core.fullDims[2];
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCode_dm2Gas(&core, 0.25, npGasTotal);
-	}
-	
-	if (genics->mode->autoCenter) {
-		float newCenter[3];
-		g9pMask_getCenter(genics->mask, newCenter);
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCore_recenter(&core, newCenter);
+
+	// An empty file has nothing to stream, but still needs its (empty)
+	// blocks, hence it is written in one go.
+	const bool perTile = genics->out->writePerTile && (npInFile > 0);
+
+	if (perTile && !toHDF5)
+		local_openGadgetFile(genics, file, isGas ? 2 * npInFile : npInFile);
+	else if (!perTile)
+		particles = local_getParticleStorage(genics, npInFile);
+
+	nextPos = local_getNextTile(genics, map, firstPos, lastPos);
+	if (nextPos <= lastPos) {
+		double timing = timer_startLocal();
+		nextPatch  = local_readTile(genics,
+		                            g9pICMap_getTileAt(map, nextPos));
+		timing     = timer_stopLocal(timing);
+		timeRead  += timing;
+		timeTotal += timing;
 	}
-	
-	if (genics->shift[0]!=0 || genics->shift[1]!=0 || genics->shift[2]!=0) {
-		float newCenter[3];
-		for (int i=0;i<3;i++) {
-			newCenter[i] = (genics->data->boxsizeInMpch/2 - genics->shift[i])/genics->data->boxsizeInMpch;
+
+	while (nextPos <= lastPos) {
+		const uint32_t pos    = nextPos;
+		const uint32_t tile   = g9pICMap_getTileAt(map, pos);
+		gridPatch_t    patch  = nextPatch;
+		uint64_t       offset = partsDone;
+		uint64_t       np     = UINT64_C(0);
+		double         timing = timer_startLocal();
+
+		nextPos   = local_getNextTile(genics, map, pos + 1, lastPos);
+		nextPatch = NULL;
+		if (perTile) {
+			particles = local_getParticleStorage(
+			    genics, local_computeNumParts(genics, tile));
+			offset    = UINT64_C(0);
 		}
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCore_recenter(&core, newCenter);
-	}
-	
-	if (genics->mode->kpc) {
-        core.numParticles = partBunch_getNumParticles(particles);
-        core.pos          = partBunch_at(particles, 0, 0);
-        core.vel          = partBunch_at(particles, 1, 0);
-        core.id           = partBunch_at(particles, 2, 0);
-		generateICsCore_kpc(&core);
+
+		// The velocities of the next tile are read while the particles of
+		// the current tile are generated.
+#ifdef _OPENMP
+#  pragma omp parallel sections num_threads(2)
+#endif
+		{
+#ifdef _OPENMP
+#  pragma omp section
+#endif
+			if (nextPos <= lastPos) {
+				double t = timer_startLocal();
+				nextPatch = local_readTile(genics,
+				                           g9pICMap_getTileAt(map, nextPos));
+				timeRead += timer_stopLocal(t);
+			}
+#ifdef _OPENMP
+#  pragma omp section
+#endif
+			{
+				double t = timer_startLocal();
+				np           = local_convertTile(genics, &core, particles,
+				                                 offset, tile, patch, &startID);
+				timeConvert += timer_stopLocal(t);
+			}
+		}
+		timeTotal += timer_stopLocal(timing);
+		gridPatch_del(&patch);
+
+		if (perTile && toHDF5) {
+			local_writeHDF5(genics, particles, np, typeOffset + partsDone);
+			partBunch_del(&particles);
+		} else if (perTile) {
+			// With gas, the tile holds np gas particles followed by np dark
+			// matter particles, they go to the two halves of the blocks.
+			local_writeParticles(genics, particles, 0, np, partsDone);
+			if (isGas) {
+				local_writeParticles(genics, particles, np, np,
+				                     npInFile + partsDone);
+				local_writeGasEnergies(genics, partsDone, np);
+			}
+			partBunch_del(&particles);
+		}
+		partsDone += np;
 	}
+	printf("   Particles read: %lu\n", partsDone);
+	printf("      Reading %.2fs, converting %.2fs, %.2fs of it overlapped\n",
+	       timeRead, timeConvert, timeRead + timeConvert - timeTotal);
 
+	if (perTile) {
+		if (!toHDF5)
+			gadget_close(genics->out->gadget);
+	} else {
+		if (toHDF5)
+			local_writeHDF5(genics, particles, partsDone, typeOffset);
+		else
+			local_writeGadgetFile(genics, file, particles);
+		partBunch_del(&particles);
+	}
 
-	local_writeGadgetFile(genics, file, particles, map);
+	if ((partsDone != npInFile) || (startID != firstID + npInFile)) {
+		fprintf(stderr, "ERROR: File %i holds %" PRIu64 " particles with "
+		        "IDs from %" PRIu64 " to %" PRIu64 ", expected %" PRIu64
+		        " particles.\n", file, partsDone, firstID, startID,
+		        npInFile);
+		diediedie(EXIT_FAILURE);
+	}
 
-	partBunch_del(&particles);
+	return partsDone;
 } // local_doFile
 
+static uint32_t
+local_getNextTile(const generateICs_t genics,
+                  const g9pICMap_t    map,
+                  uint32_t            pos,
+                  uint32_t            lastPos)
+{
+	while ((pos <= lastPos)
+	       && (local_computeNumParts(genics,
+	                                 g9pICMap_getTileAt(map, pos)) == 0))
+		pos++;
+
+	return pos;
+}
+
+static gridPatch_t
+local_readTile(const generateICs_t genics, uint32_t tile)
+{
+	generateICsIn_t in = local_getIn(genics);
+	gridPatch_t     patch;
+
+	// Only the part of the tile actually at the current level is read.
+	patch = g9pMask_getOccupiedPatchForTileLevel(genics->mask, tile,
+	                                             genics->zoomlevel);
+	assert(patch != NULL);
+	(void)gridPatch_attachVar(patch, in->varVelx);
+	(void)gridPatch_attachVar(patch, in->varVely);
+	(void)gridPatch_attachVar(patch, in->varVelz);
+
+	gridReader_readIntoPatchForVar(in->velx, patch, 0);
+	gridReader_readIntoPatchForVar(in->vely, patch, 1);
+	gridReader_readIntoPatchForVar(in->velz, patch, 2);
+
+	return patch;
+}
+
+static generateICsIn_t
+local_getIn(const generateICs_t genics)
+{
+	if (genics->inForLevel == NULL)
+		return genics->in;
+
+	return genics->inForLevel[genics->zoomlevel
+	                          - g9pMask_getMinLevel(genics->mask)];
+}
+
+static uint64_t
+local_convertTile(const generateICs_t genics,
+                  generateICsCore_t   core,
+                  partBunch_t         particles,
+                  uint64_t            offset,
+                  uint32_t            tile,
+                  gridPatch_t         patch,
+                  uint64_t            *startID)
+{
+	gridPointUint32_t tileIdxHi;
+
+	core->numParticles = local_computeNumParts(genics, tile);
+	core->pos          = partBunch_at(particles, 0, offset);
+	core->vel          = partBunch_at(particles, 1, offset);
+	core->id           = partBunch_at(particles, 2, offset);
+	core->patch        = patch;
+	core->level		   = genics->zoomlevel;
+	core->maxDims	   = g9pMask_getDim1DLevel(genics->mask,g9pMask_getMaxLevel(genics->mask));
+	core->maskdata	   = g9pMask_getTileData(genics->mask,tile);
+	core->maskDim1D	   = g9pMask_getDim1D(genics->mask);
+	core->partDim1D	   = g9pMask_getDim1DLevel(genics->mask,genics->zoomlevel);
+	core->startID	   = *startID;
+	g9pMask_getTileIdxsForLevel(genics->mask, tile, genics->zoomlevel,
+	                            core->tileIdxLo, tileIdxHi);
+	core->tileDim1D    = tileIdxHi[0] - core->tileIdxLo[0] + 1;
+	// The dark matter twins of the gas particles fill the second half.
+	core->gasStride    = partBunch_getNumParticles(particles) / 2;
+
+	generateICsCore_toParticles(core);
+
+	*startID    = core->startID;
+	printf("StartID: %i\n",*startID);
+	core->patch = NULL;
+
+	return core->numParticles;
+} // local_convertTile
+
+static bool
+local_isGasLevel(const generateICs_t genics)
+{
+	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
+
+	return genics->mode->doGas
+	       && (genics->typeForLevel)[genics->zoomlevel-minlev] == 1;
+}
+
+static bool
+local_needsMassBlock(const generateICs_t genics)
+{
+	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
+	uint32_t maxlev = g9pMask_getMaxLevel(genics->mask);
+	int32_t  type   = (genics->typeForLevel)[genics->zoomlevel-minlev];
+	uint32_t numLevelsOfType = 0;
+
+	for (uint32_t lev = minlev; lev <= maxlev; lev++) {
+		if ((genics->typeForLevel)[lev-minlev] == type)
+			numLevelsOfType++;
+	}
+
+	return (numLevelsOfType > 1) || genics->mode->doMassBlock;
+}
+
 static void
 local_writeGadgetFile(generateICs_t     genics,
                       int               file,
-                      const partBunch_t particles,
-                      g9pICMap_t map)
+                      const partBunch_t particles)
+{
+	const uint64_t np = partBunch_getNumParticles(particles);
+
+	local_openGadgetFile(genics, file, np);
+	local_writeParticles(genics, particles, 0, np, 0);
+	if (local_isGasLevel(genics))
+		local_writeGasEnergies(genics, 0, np / 2);
+	gadget_close(genics->out->gadget);
+} // local_writeGadgetFile
+
+static void
+local_openGadgetFile(generateICs_t genics, int file, uint64_t np)
 {
 	uint32_t       npLocal[6] = {0, 0, 0, 0, 0, 0};
 	uint64_t       npAll[6] = {0, 0, 0, 0, 0, 0};
 	double         massArr[6] = {0., 0., 0., 0., 0., 0.};
 	gadgetHeader_t myHeader;
+	// With allLevels a task writes files of different levels, the blocks
+	// hence must only depend on the level of this file.
+	gadgetTOC_t    toc = gadgetTOC_clone(genics->out->toc);
 
-	const uint64_t               np = partBunch_getNumParticles(particles);
 	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
 	uint32_t maxlev = g9pMask_getMaxLevel(genics->mask);
-	uint32_t   numLevels = maxlev - minlev + 1;
 	uint32_t   arrIdx = (genics->typeForLevel)[genics->zoomlevel-minlev];
 	uint32_t nlevfortype[6] = {0, 0, 0, 0, 0, 0};
 	uint64_t npFull;
 	
-	uint32_t foffset=0;
-        for (uint32_t i = 0; i < genics->zoomlevel-minlev; i++){
-			foffset+=genics->out->numFilesForLevel[i];
-		}
+	uint32_t foffset = local_getFileOffset(genics, genics->zoomlevel);
 	
     for(int lev=minlev; lev<=maxlev; lev++) {
-		for(int type=0; type<=6; type++) {
+		for(int type=0; type<6; type++) {
 			if((genics->typeForLevel)[lev-minlev]==type) nlevfortype[type]++;
 		}
 	}
@@ -515,16 +1247,11 @@ local_writeGadgetFile(generateICs_t     genics,
 			npFull = POW_NDIM((uint64_t)g9pMask_getDim1DLevel(genics->mask,level));
 			massArr[idx] = generateICsOut_boxMass(genics->data) / npFull;
 		}
-		
-		//idx = 1 + maxlev - level;
-		//npAll[idx] = (uint64_t)local_computeNumPartsFileLevel(genics, map, level);
-		//npFull = POW_NDIM(g9pMask_getDim1DLevel(genics->mask,level));
-		//massArr[idx] = generateICsOut_boxMass(genics->data) / npFull;
 	}
 	printf("\n mass: %lf\n",generateICsOut_boxMass(genics->data));
 	
-	if(nlevfortype[arrIdx]>1 || genics->mode->doMassBlock) {
-		gadgetTOC_addEntryByType(genics->out->toc, GADGETBLOCK_MASS);
+	if (local_needsMassBlock(genics)) {
+		gadgetTOC_addEntryByType(toc, GADGETBLOCK_MASS);
 	}
 	if (genics->mode->doGas) {
 		const double omegaBaryon0 = cosmoModel_getOmegaBaryon0(genics->data->model);
@@ -533,71 +1260,142 @@ local_writeGadgetFile(generateICs_t     genics,
 		massArr[0]  = massArr[1] * omegaBaryon0 / omegaMatter0;
 		massArr[1]  -= massArr[0];
 		if(arrIdx==1)
-			gadgetTOC_addEntryByType(genics->out->toc, GADGETBLOCK_U___);
+			gadgetTOC_addEntryByType(toc, GADGETBLOCK_U___);
 	}
 	gadgetHeader_setNall(myHeader,npAll);
 	gadgetHeader_setMassArr(myHeader, massArr);
-	//gadgetHeader_setNumFiles(myHeader,numLevels);
-	//
 	
 	gadgetHeader_getMassArr(myHeader, massArr);
 	gadgetHeader_setNp(myHeader, npLocal);
-	gadgetTOC_calcSizes(genics->out->toc, npLocal, massArr, false,
+	gadgetTOC_calcSizes(toc, npLocal, massArr, false,
 	                    genics->mode->useLongIDs);
-	gadgetTOC_calcOffset(genics->out->toc);
+	gadgetTOC_calcOffset(toc);
 	gadget_setHeaderOfFile(genics->out->gadget, file+foffset, myHeader);
-	gadget_setTOCOfFile( genics->out->gadget, file+foffset,
-	                     gadgetTOC_clone(genics->out->toc) );
+	gadget_setTOCOfFile(genics->out->gadget, file+foffset, toc);
 	gadget_open(genics->out->gadget, GADGET_MODE_WRITE_CREATE, file+foffset);
 	gadget_writeHeaderToCurrentFile(genics->out->gadget);
-	{
-		stai_t stai;
-		stai = stai_new( partBunch_at(particles, 0, 0),
-		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_POS_,
-		                               0, np, stai);
-		stai_del(&stai);
-		stai = stai_new( partBunch_at(particles, 1, 0),
-		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_VEL_,
-		                               0, np, stai);
-		stai_del(&stai);
-		if (genics->mode->useLongIDs) {
-			stai = stai_new( partBunch_at(particles, 2, 0),
-			                 sizeof(uint64_t), sizeof(uint64_t) );
-		} else {
-			stai = stai_new( partBunch_at(particles, 2, 0),
-			                 sizeof(uint32_t), sizeof(uint32_t) );
+} // local_openGadgetFile
+
+static void
+local_writeParticles(generateICs_t     genics,
+                     const partBunch_t particles,
+                     uint64_t          first,
+                     uint64_t          np,
+                     uint64_t          pSkip)
+{
+	stai_t stai;
+
+	stai = stai_new( partBunch_at(particles, 0, first),
+	                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_POS_,
+	                               pSkip, np, stai);
+	stai_del(&stai);
+	stai = stai_new( partBunch_at(particles, 1, first),
+	                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_VEL_,
+	                               pSkip, np, stai);
+	stai_del(&stai);
+	if (genics->mode->useLongIDs) {
+		stai = stai_new( partBunch_at(particles, 2, first),
+		                 sizeof(uint64_t), sizeof(uint64_t) );
+	} else {
+		stai = stai_new( partBunch_at(particles, 2, first),
+		                 sizeof(uint32_t), sizeof(uint32_t) );
+	}
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_ID__,
+	                               pSkip, np, stai);
+	stai_del(&stai);
+
+	if (local_needsMassBlock(genics)) {
+		fpv_t    *masses = xmalloc(sizeof(fpv_t) * np);
+		uint64_t npFull;
+
+		npFull = POW_NDIM((uint64_t)g9pMask_getDim1DLevel(genics->mask,genics->zoomlevel));
+		fpv_t mass1 = generateICsOut_boxMass(genics->data) / npFull;
+		for (uint64_t i = 0; i < np; i++) {
+			masses[i] = mass1;
 		}
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_ID__,
-		                               0, np, stai);
+		stai = stai_new( masses, sizeof(fpv_t), sizeof(fpv_t) );
+		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_MASS,
+		                               pSkip, np, stai);
 		stai_del(&stai);
-		
-		
-		if(nlevfortype[arrIdx]>1 || genics->mode->doMassBlock) {
-			fpv_t masses[np];
-			npFull = POW_NDIM((uint64_t)g9pMask_getDim1DLevel(genics->mask,genics->zoomlevel));
-			fpv_t mass1 = generateICsOut_boxMass(genics->data) / npFull;
-			for(int i=0; i<np; i++) {
-				masses[i] = mass1;
-			}
-			stai = stai_new( masses, sizeof(fpv_t), sizeof(fpv_t) );
-			gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_MASS,
-		                               0, np, stai);
-		    stai_del(&stai);
-		}
-		
-		if(genics->mode->doGas && arrIdx==1) {
-			uint64_t npl = npLocal[0];
-			fpv_t energies[npl];
-			for(int i=0;i<npl;i++) {
-				energies[i]=0;
-			}
-			stai = stai_new(energies, sizeof(fpv_t), sizeof(fpv_t) );
-			gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_U___,
-		                               0, npl, stai);
-		    stai_del(&stai);
-		}
+		xfree(masses);
 	}
-	gadget_close(genics->out->gadget);
-} // local_writeGadgetFile
+} // local_writeParticles
+
+static void
+local_writeGasEnergies(generateICs_t genics, uint64_t pSkip, uint64_t np)
+{
+	fpv_t  *energies = xmalloc(sizeof(fpv_t) * np);
+	stai_t stai;
+
+	for (uint64_t i = 0; i < np; i++) {
+		energies[i] = 0;
+	}
+	stai = stai_new(energies, sizeof(fpv_t), sizeof(fpv_t) );
+	gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_U___,
+	                               pSkip, np, stai);
+	stai_del(&stai);
+	xfree(energies);
+}
+
+static void
+local_createHDF5File(generateICs_t genics, int32_t levelLo, int32_t levelHi)
+{
+#ifdef WITH_HDF5
+	uint32_t       minlev     = g9pMask_getMinLevel(genics->mask);
+	uint64_t       npTotal[6] = {0, 0, 0, 0, 0, 0};
+	gadgetHeader_t header     = gadgetHeader_clone(genics->out->baseHeader);
+
+	for (int32_t lev = levelLo; lev <= levelHi; lev++) {
+		int32_t type = (genics->typeForLevel)[lev - minlev];
+
+		npTotal[type] += local_computeNumPartsLevel(genics, lev);
+		if (genics->mode->doGas && (type == 1))
+			npTotal[0] += local_computeNumPartsLevel(genics, lev);
+	}
+	if (genics->mode->kpc)
+		gadgetHeader_setBoxsize(header, gadgetHeader_getBoxsize(header)*1000);
+
+	generateICsHDF5_create(genics->out->hdf5, header, npTotal,
+	                       genics->mode->useLongIDs);
+	gadgetHeader_del(&header);
+#endif
+} // local_createHDF5File
+
+static void
+local_writeHDF5(generateICs_t     genics,
+                const partBunch_t particles,
+                uint64_t          np,
+                uint64_t          typeOffset)
+{
+#ifdef WITH_HDF5
+	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
+	int32_t  type   = (genics->typeForLevel)[genics->zoomlevel - minlev];
+	uint64_t npFull, first = UINT64_C(0);
+	double   mass;
+
+	npFull = POW_NDIM((uint64_t)g9pMask_getDim1DLevel(genics->mask,
+	                                                  genics->zoomlevel));
+	mass   = generateICsOut_boxMass(genics->data) / npFull;
+
+	if (local_isGasLevel(genics)) {
+		// The gas particles carry the baryon fraction of the mass.
+		double massGas = mass * cosmoModel_getOmegaBaryon0(genics->data->model)
+		                 / cosmoModel_getOmegaMatter0(genics->data->model);
+
+		generateICsHDF5_writeParticles(genics->out->hdf5, 0, typeOffset, np,
+		                               partBunch_at(particles, 0, 0),
+		                               partBunch_at(particles, 1, 0),
+		                               partBunch_at(particles, 2, 0),
+		                               (fpv_t)massGas);
+		mass -= massGas;
+		first = partBunch_getNumParticles(particles) / 2;
+	}
+	generateICsHDF5_writeParticles(genics->out->hdf5, type, typeOffset, np,
+	                               partBunch_at(particles, 0, first),
+	                               partBunch_at(particles, 1, first),
+	                               partBunch_at(particles, 2, first),
+	                               (fpv_t)mass);
+#endif
+} // local_writeHDF5
@@ -166,6 +166,42 @@ generateICs_setShift(generateICs_t genics, gridPointDbl_t shift);
 extern void
 generateICs_setZoomLevel(generateICs_t genics, int32_t z);
 
+/**
+ * @brief  Selects whether all levels of the mask are produced in one run
+ *         instead of only the zoom level.
+ *
+ * @param[in,out]  genics
+ *                    The application object to work with.  Passing @c NULL
+ *                    is undefined.
+ * @param[in]      allLevels
+ *                    If @c true, all levels are produced, the input for
+ *                    each level must then be set with
+ *                    generateICs_setInForLevel().
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICs_setAllLevels(generateICs_t genics, bool allLevels);
+
+/**
+ * @brief  Sets the velocity input for one level.
+ *
+ * @param[in,out]  genics
+ *                    The application object to work with.  The mask must
+ *                    already be set.  Passing @c NULL is undefined.
+ * @param[in]      level
+ *                    The level the input belongs to.
+ * @param[in]      in
+ *                    The input.  The caller relinquishes control of the
+ *                    object.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICs_setInForLevel(generateICs_t   genics,
+                          int32_t         level,
+                          generateICsIn_t in);
+
 /** @} */
 
 /**
@@ -35,6 +35,9 @@
 
 #define GENERATEICSCONFIG_DEFAULT_DOMASSBLOCK false
 
+/** @brief  Gives the default for writing particles in Peano-Hilbert order. */
+#define GENERATEICSCONFIG_DEFAULT_PEANOHILBERTORDER false
+
 /** @brief  Gives the default for re-centering to zoom region or not. */
 #define GENERATEICSCONFIG_DEFAULT_AUTOCENTER false
 
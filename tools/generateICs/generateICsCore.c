@@ -20,34 +20,128 @@
 #include <string.h>
 #include "../../src/libutil/xmem.h"
 #include "../../src/libutil/lIdx.h"
+#include "../../src/libutil/phKey.h"
+#include <stdlib.h>
 
 
 /*--- Local defines -----------------------------------------------------*/
 
 
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  Connects a particle to its Peano-Hilbert key. */
+struct local_particleKey_struct {
+	/** @brief  The key of the cell of the particle. */
+	uint64_t key;
+	/** @brief  The index of the particle in the storage. */
+	uint64_t idx;
+};
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
+/**
+ * @brief  Checks whether a cell is at the level particles are generated
+ *         for.
+ *
+ * @param[in]  d
+ *                The core object to work with.
+ * @param[in]  p
+ *                The cell on the grid of the current level.
+ * @param[in]  maskTileDim
+ *                The number of mask cells per tile in one dimension.
+ *
+ * @return  Returns @c true if the cell yields a particle.
+ */
+static inline bool
+local_isAtLevel(generateICsCore_const_t d,
+                const gridPointUint32_t p,
+                uint64_t                maskTileDim);
+
+/**
+ * @brief  Counts the particles in one slab of the patch.
+ *
+ * @param[in]  d
+ *                The core object to work with.
+ * @param[in]  idxLo
+ *                The lower indices of the patch.
+ * @param[in]  dims
+ *                The dimensions of the patch.
+ * @param[in]  z
+ *                The (global) z index of the slab.
+ *
+ * @return  Returns the number of particles in the slab.
+ */
+static uint64_t
+local_countSlab(generateICsCore_const_t d,
+                const gridPointUint32_t idxLo,
+                const gridPointUint32_t dims,
+                uint32_t                z);
+
+/**
+ * @brief  Sets up position, velocity and ID of the particles in one slab
+ *         of the patch.
+ *
+ * @param[in]  d
+ *                The core object to work with.
+ * @param[in]  idxLo
+ *                The lower indices of the patch.
+ * @param[in]  dims
+ *                The dimensions of the patch.
+ * @param[in]  z
+ *                The (global) z index of the slab.
+ * @param[in]  i
+ *                The index of the first particle of the slab.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_fillSlab(generateICsCore_const_t d,
+               const gridPointUint32_t idxLo,
+               const gridPointUint32_t dims,
+               uint32_t                z,
+               uint64_t                i);
+
+/**
+ * @brief  Brings the entries of one particle array into the order of the
+ *         keys.
+ *
+ * @param[in,out]  data
+ *                    The array to reorder.
+ * @param[in]      keys
+ *                    The sorted keys, giving the old index of each entry.
+ * @param[in]      n
+ *                    The number of entries.
+ * @param[in]      size
+ *                    The size of one entry in bytes.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_permute(void                                  *data,
+              const struct local_particleKey_struct *keys,
+              uint64_t                              n,
+              size_t                                size);
+
+static int
+local_compareParticleKeys(const void *a, const void *b);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern void
 generateICsCore_toParticles(generateICsCore_const_t d)
 {
 	generateICsCore_initPosID(d);
-	generateICsCore_vel2pos(d);
-	generateICsCore_convertVel(d);
+	if (d->mode->peanoHilbertOrder)
+		generateICsCore_sortPeanoHilbert(d);
+	generateICsCore_convertParticles(d);
 }
 
 extern void
 generateICsCore_initPosID(generateICsCore_const_t d)
 {
 	gridPointUint32_t dims, idxLo;
-	fpv_t             *velxP = gridPatch_getVarDataHandle(d->patch, 0);
-	fpv_t             *velyP = gridPatch_getVarDataHandle(d->patch, 1);
-	fpv_t             *velzP = gridPatch_getVarDataHandle(d->patch, 2);
-	const double      dx     = d->data->boxsizeInMpch / d->fullDims[0];
-	bool			  flg;
-	gridPointUint32_t maxDims3;
-	maxDims3[0]=d->maxDims; maxDims3[1]=d->maxDims; maxDims3[2]=d->maxDims;
+	uint64_t          *slabOffset;
 
 	gridPatch_getIdxLo(d->patch, idxLo);
 	gridPatch_getDims(d->patch, dims);
@@ -55,161 +149,271 @@ generateICsCore_initPosID(generateICsCore_const_t d)
 	printf("   Patch idxLo: (%u,%u,%u)\n", idxLo[0], idxLo[1], idxLo[2]);
 	printf("   Patch dims:  (%u,%u,%u)\n", dims[0], dims[1], dims[2]);
 
-	gridPointUint32_t p, q, pm;
-	uint64_t          i = 0;
-	uint64_t          iin = 0, idxM;
-	uint64_t		   patchMaskDim = (dims[0]*(d->maskDim1D))/(d->partDim1D);
-	for (p[2] = idxLo[2]; p[2] < idxLo[2] + dims[2]; p[2]++) {
-		for (p[1] = idxLo[1]; p[1] < idxLo[1] + dims[1]; p[1]++) {
-			for (p[0] = idxLo[0]; p[0] < idxLo[0] + dims[0]; p[0]++) {
-				for(int j=0;j<3;j++) {
-					q[j]=((p[j]-idxLo[j])*(d->maskDim1D))/(d->partDim1D);
-				}
-				idxM = q[0] + (q[1] + q[2]*patchMaskDim)*patchMaskDim;
-				
-				if(d->maskdata == NULL) flg = true;
-				else flg = (d->level == d->maskdata[idxM]);
-				
-				if(flg) {
-					//printf(" %i/%i ",i,idxM);
-					d->vel[i * 3]     = velxP[iin];
-					d->vel[i * 3 + 1] = velyP[iin];
-					d->vel[i * 3 + 2] = velzP[iin];
-					d->pos[i * 3]     = (fpv_t)( (p[0] + .5) * dx );
-					d->pos[i * 3 + 1] = (fpv_t)( (p[1] + .5) * dx );
-					d->pos[i * 3 + 2] = (fpv_t)( (p[2] + .5) * dx );
-					for(int k=0;k<3;k++) {
-						pm[k] = p[k]*((d->maxDims)/(d->partDim1D));
-					}
-					if (d->mode->useLongIDs) {
-						( (uint64_t *)(d->id) )[i] = lIdx_fromCoord3d(pm,
-						                                              maxDims3);
-						//printf("%lu\n",( (uint64_t *)(d->id))[i]);
-					} else {
-						if (d->mode->sequentialIDs) {
-							( (uint32_t *)(d->id) )[i] = d->startID + i;
-						} else {
-							( (uint32_t *)(d->id) )[i] = lIdx_fromCoord3d(pm,
-						                                              maxDims3);
-						}
-					}
-					i++;
-				}
-				iin++;
-			}
-		}
-	}
-	d->startID += i;
-	//printf(" %i/%i ",i,idxM);
-} // generateICsCore_vel2pos
-
-extern void
-generateICsCore_vel2pos(generateICsCore_const_t d)
-{
-// uses type generic fmod, i.e. float MOD(float, float) or
-// double MOD(double, double), depending on what fpv_t is
-#define SCALE(d, k)                                           \
-	( fmod( (fpv_t)( (d->pos[k] + d->data->vFact * d->vel[k]) \
-	                 * d->data->posFactor ),                  \
-	        (fpv_t)(d->data->boxsizeInMpch * d->data->posFactor) ) )
+	// The position of a particle in the output depends on all particles
+	// before it, hence the particles in each slab are counted first and
+	// the slabs are then filled independently from their offsets.
+	slabOffset = xmalloc(sizeof(uint64_t) * (dims[2] + 1));
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
-	for (uint64_t i = 0; i < d->numParticles; i++) {
-		d->pos[i * 3]     += (fpv_t)(d->data->boxsizeInMpch);
-		d->pos[i * 3]      = SCALE( d, (i * 3) );
-		d->pos[i * 3 + 1] += (fpv_t)(d->data->boxsizeInMpch);
-		d->pos[i * 3 + 1]  = SCALE( d, (i * 3 + 1) );
-		d->pos[i * 3 + 2] += (fpv_t)(d->data->boxsizeInMpch);
-		d->pos[i * 3 + 2]  = SCALE( d, (i * 3 + 2) );
-	}
-#undef SCALE
-} // generateICsCore_vel2pos
+	for (uint32_t z = 0; z < dims[2]; z++)
+		slabOffset[z + 1] = local_countSlab(d, idxLo, dims, idxLo[2] + z);
+
+	slabOffset[0] = UINT64_C(0);
+	for (uint32_t z = 0; z < dims[2]; z++)
+		slabOffset[z + 1] += slabOffset[z];
+	assert(slabOffset[dims[2]] == d->numParticles);
 
-extern void
-generateICsCore_convertVel(generateICsCore_const_t d)
-{
-	double_t ainit = d->data->aInit;
-	const fpv_t fac = d->data->velFactor / sqrt(ainit);
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
-	for (uint64_t i = 0; i < d->numParticles; i++) {
-		d->vel[i * 3]     *= fac;
-		d->vel[i * 3 + 1] *= fac;
-		d->vel[i * 3 + 2] *= fac;
-	}
-}
+	for (uint32_t z = 0; z < dims[2]; z++)
+		local_fillSlab(d, idxLo, dims, idxLo[2] + z, slabOffset[z]);
+
+	d->startID += slabOffset[dims[2]];
+	xfree(slabOffset);
+} // generateICsCore_initPosID
 
 extern void
-generateICsCode_dm2Gas(generateICsCore_const_t d,
-                       const double            gasOffset,
-                       const uint64_t          npGasTotal)
+generateICsCore_sortPeanoHilbert(generateICsCore_const_t d)
 {
-	const double shift     = d->data->boxsizeInMpch / d->fullDims[0]
-	                         * gasOffset;
-	uint64_t     npGasOrDM = d->numParticles / 2;
+	const double                    dx   = d->data->boxsizeInMpch
+	                                       / d->fullDims[0];
+	struct local_particleKey_struct *keys;
+	int                             bits = 0;
 
-	printf("   Gas offset: %lf\n", shift);
-	printf("   Local gas particles: %lu\n", npGasOrDM);
-	printf("   Total gas particles: %lu\n", npGasTotal);
-
-	memcpy(d->pos + 3 * npGasOrDM, d->pos, sizeof(fpv_t) * 3 * npGasOrDM);
-	memcpy(d->vel + 3 * npGasOrDM, d->vel, sizeof(fpv_t) * 3 * npGasOrDM);
-	if (d->mode->useLongIDs) {
-		memcpy( (uint64_t *)(d->id) + npGasOrDM, d->id,
-		        sizeof(uint64_t) * npGasOrDM );
-	} else {
-		memcpy( (uint32_t *)(d->id) + npGasOrDM, d->id,
-		        sizeof(uint32_t) * npGasOrDM );
-	}
+	while ((UINT32_C(1) << bits) < d->fullDims[0])
+		bits++;
+	assert(bits <= PHKEY_MAX_BITS);
 
+	keys = xmalloc(sizeof(struct local_particleKey_struct)
+	               * d->numParticles);
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
-	for (uint64_t i = 0; i < npGasOrDM; i++) {
-		d->pos[i * 3]     += shift;
-		d->pos[i * 3 + 1] += shift;
-		d->pos[i * 3 + 2] += shift;
-	}
-#ifdef _OPENMP
-#  pragma omp parallel for
-#endif
-	for (uint64_t i = npGasOrDM; i < d->numParticles; i++) {
-		if (d->mode->useLongIDs) {
-			( (uint64_t *)(d->id) )[i] += npGasTotal;
-		} else {
-			( (uint32_t *)(d->id) )[i] += (uint32_t)npGasTotal;
+	for (uint64_t i = 0; i < d->numParticles; i++) {
+		uint32_t c[3];
+		// The positions are still the cell centres.
+		for (int k = 0; k < 3; k++) {
+			c[k] = (uint32_t)floor(d->pos[i * 3 + k] / dx);
+			if (c[k] >= d->fullDims[k])
+				c[k] = d->fullDims[k] - 1;
 		}
+		keys[i].key = phKey_fromCoord3d(c, bits);
+		keys[i].idx = i;
 	}
-} // generateICsCode_dm2Gas
+	qsort(keys, d->numParticles, sizeof(struct local_particleKey_struct),
+	      &local_compareParticleKeys);
+
+	local_permute(d->pos, keys, d->numParticles, sizeof(fpv_t) * 3);
+	local_permute(d->vel, keys, d->numParticles, sizeof(fpv_t) * 3);
+	if (d->mode->useLongIDs) {
+		local_permute(d->id, keys, d->numParticles, sizeof(uint64_t));
+	} else if (d->mode->sequentialIDs) {
+		// Sequential IDs follow the order in the file.
+		const uint64_t firstID = d->startID - d->numParticles;
+		for (uint64_t i = 0; i < d->numParticles; i++)
+			( (uint32_t *)(d->id) )[i] = firstID + i;
+	} else {
+		local_permute(d->id, keys, d->numParticles, sizeof(uint32_t));
+	}
+
+	xfree(keys);
+} // generateICsCore_sortPeanoHilbert
 
 extern void
-generateICsCore_recenter(generateICsCore_const_t d, float* newCenter) {
-	fpv_t box = (fpv_t)(d->data->boxsizeInMpch);
+generateICsCore_convertParticles(generateICsCore_const_t d)
+{
+// uses type generic fmod, i.e. float MOD(float, float) or
+// double MOD(double, double), depending on what fpv_t is
+#define SCALE(d, x, v)                                   \
+	( fmod( (fpv_t)( ((x) + d->data->vFact * (v))        \
+	                 * d->data->posFactor ),             \
+	        (fpv_t)(d->data->boxsizeInMpch * d->data->posFactor) ) )
+	double_t    ainit = d->data->aInit;
+	const fpv_t fac   = d->data->velFactor / sqrt(ainit);
+	const fpv_t box   = (fpv_t)(d->data->boxsizeInMpch);
+	const int   numTwins = d->doGas ? 2 : 1;
+
+	if (d->doGas)
+		assert(d->gasStride >= d->numParticles);
+
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
 	for (uint64_t i = 0; i < d->numParticles; i++) {
-		for(int k = 0; k<3; k++) {
-			d->pos[i*3 + k] += box/2 - (newCenter[k]*box);
-			if(d->pos[i*3 + k] > box) d->pos[i*3 + k] -= box;
-			if(d->pos[i*3 + k] < 0) d->pos[i*3 + k] += box;
+		fpv_t pos[2][3];
+		fpv_t vel[3];
+
+		for (int k = 0; k < 3; k++) {
+			pos[0][k]  = d->pos[i * 3 + k];
+			pos[0][k] += box;
+			pos[0][k]  = SCALE(d, pos[0][k], d->vel[i * 3 + k]);
+			vel[k]     = d->vel[i * 3 + k] * fac;
+		}
+
+		// The gas particle is offset from the dark matter particle.
+		if (d->doGas) {
+			for (int k = 0; k < 3; k++) {
+				pos[1][k]  = pos[0][k];
+				pos[0][k] += d->gasShift;
+			}
+		}
+
+		for (int t = 0; t < numTwins; t++) {
+			for (int c = 0; c < d->numCenters; c++) {
+				for (int k = 0; k < 3; k++) {
+					pos[t][k] += box / 2 - (d->centers[c][k] * box);
+					if (pos[t][k] > box)
+						pos[t][k] -= box;
+					if (pos[t][k] < 0)
+						pos[t][k] += box;
+				}
+			}
+			if (d->mode->kpc) {
+				for (int k = 0; k < 3; k++)
+					pos[t][k] *= 1000;
+			}
+		}
+
+		for (int k = 0; k < 3; k++) {
+			d->pos[i * 3 + k] = pos[0][k];
+			d->vel[i * 3 + k] = vel[k];
+		}
+		if (d->doGas) {
+			const uint64_t j = i + d->gasStride;
+
+			for (int k = 0; k < 3; k++) {
+				d->pos[j * 3 + k] = pos[1][k];
+				d->vel[j * 3 + k] = vel[k];
+			}
+			if (d->mode->useLongIDs) {
+				( (uint64_t *)(d->id) )[j] = ( (uint64_t *)(d->id) )[i]
+				                             + d->npGasTotal;
+			} else {
+				( (uint32_t *)(d->id) )[j] = ( (uint32_t *)(d->id) )[i]
+				                             + (uint32_t)d->npGasTotal;
+			}
+		}
+	}
+#undef SCALE
+} // generateICsCore_convertParticles
+
+/*--- Implementations of local functions --------------------------------*/
+static inline bool
+local_isAtLevel(generateICsCore_const_t d,
+                const gridPointUint32_t p,
+                uint64_t                maskTileDim)
+{
+	uint64_t q[3];
+
+	if (d->maskdata == NULL)
+		return true;
+
+	// The patch may only cover part of the tile, the mask data always
+	// covers the full tile.
+	for (int j = 0; j < 3; j++)
+		q[j] = ((uint64_t)(p[j]-d->tileIdxLo[j])*(d->maskDim1D))/(d->partDim1D);
+
+	return d->level == d->maskdata[q[0] + (q[1] + q[2]*maskTileDim)*maskTileDim];
+}
+
+static uint64_t
+local_countSlab(generateICsCore_const_t d,
+                const gridPointUint32_t idxLo,
+                const gridPointUint32_t dims,
+                uint32_t                z)
+{
+	gridPointUint32_t p;
+	uint64_t          num = UINT64_C(0);
+	const uint64_t    maskTileDim = ((uint64_t)d->tileDim1D*(d->maskDim1D))/(d->partDim1D);
+
+	p[2] = z;
+	for (p[1] = idxLo[1]; p[1] < idxLo[1] + dims[1]; p[1]++) {
+		for (p[0] = idxLo[0]; p[0] < idxLo[0] + dims[0]; p[0]++) {
+			if (local_isAtLevel(d, p, maskTileDim))
+				num++;
 		}
 	}
+
+	return num;
 }
 
-extern void
-generateICsCore_kpc(generateICsCore_const_t d) {
+static void
+local_fillSlab(generateICsCore_const_t d,
+               const gridPointUint32_t idxLo,
+               const gridPointUint32_t dims,
+               uint32_t                z,
+               uint64_t                i)
+{
+	const fpv_t       *velxP = gridPatch_getVarDataHandle(d->patch, 0);
+	const fpv_t       *velyP = gridPatch_getVarDataHandle(d->patch, 1);
+	const fpv_t       *velzP = gridPatch_getVarDataHandle(d->patch, 2);
+	const double      dx     = d->data->boxsizeInMpch / d->fullDims[0];
+	const uint32_t    fac    = (d->maxDims)/(d->partDim1D);
+	const uint64_t    maskTileDim = ((uint64_t)d->tileDim1D*(d->maskDim1D))/(d->partDim1D);
+	gridPointUint32_t maxDims3;
+	gridPointUint32_t p, pm;
+	uint64_t          iin = (uint64_t)(z - idxLo[2]) * dims[0] * dims[1];
+
+	maxDims3[0]=d->maxDims; maxDims3[1]=d->maxDims; maxDims3[2]=d->maxDims;
+
+	p[2] = z;
+	for (p[1] = idxLo[1]; p[1] < idxLo[1] + dims[1]; p[1]++) {
+		for (p[0] = idxLo[0]; p[0] < idxLo[0] + dims[0]; p[0]++, iin++) {
+			if (!local_isAtLevel(d, p, maskTileDim))
+				continue;
+
+			d->vel[i * 3]     = velxP[iin];
+			d->vel[i * 3 + 1] = velyP[iin];
+			d->vel[i * 3 + 2] = velzP[iin];
+			d->pos[i * 3]     = (fpv_t)( (p[0] + .5) * dx );
+			d->pos[i * 3 + 1] = (fpv_t)( (p[1] + .5) * dx );
+			d->pos[i * 3 + 2] = (fpv_t)( (p[2] + .5) * dx );
+			for(int k=0;k<3;k++) {
+				pm[k] = p[k]*fac;
+			}
+			if (d->mode->useLongIDs) {
+				( (uint64_t *)(d->id) )[i] = lIdx_fromCoord3d(pm,
+				                                              maxDims3);
+			} else {
+				if (d->mode->sequentialIDs) {
+					( (uint32_t *)(d->id) )[i] = d->startID + i;
+				} else {
+					( (uint32_t *)(d->id) )[i] = lIdx_fromCoord3d(pm,
+					                                              maxDims3);
+				}
+			}
+			i++;
+		}
+	}
+} // local_fillSlab
+
+static void
+local_permute(void                                  *data,
+              const struct local_particleKey_struct *keys,
+              uint64_t                              n,
+              size_t                                size)
+{
+	char *tmp = xmalloc(size * n);
+
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
-        for (uint64_t i = 0; i < d->numParticles; i++) {
-                for(int k = 0; k<3; k++) {
-                        d->pos[i*3 + k] *= 1000;
-                }
-        }
+	for (uint64_t i = 0; i < n; i++)
+		memcpy(tmp + i * size, (char *)data + keys[i].idx * size, size);
+	memcpy(data, tmp, size * n);
 
+	xfree(tmp);
 }
 
-/*--- Implementations of local functions --------------------------------*/
+static int
+local_compareParticleKeys(const void *a, const void *b)
+{
+	const struct local_particleKey_struct *ka = a;
+	const struct local_particleKey_struct *kb = b;
+
+	if (ka->key < kb->key)
+		return -1;
+	return (ka->key > kb->key) ? 1 : 0;
+}
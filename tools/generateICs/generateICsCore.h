@@ -38,6 +38,14 @@ struct generateICsCore_struct {
 	int8_t					level;
 	int8_t					*maskdata;
 	uint64_t				maxDims;
+	gridPointUint32_t		tileIdxLo;
+	uint32_t				tileDim1D;
+	bool					doGas;
+	double					gasShift;
+	uint64_t				gasStride;
+	uint64_t				npGasTotal;
+	int						numCenters;
+	float					centers[2][3];
 };
 
 typedef struct generateICsCore_struct        generateICsCore_s;
@@ -60,6 +68,12 @@ typedef struct generateICsCore_struct *const generateICsCore_const_t;
 		.maskDim1D = 0,				 \
 		.partDim1D = 0,				 \
 		.maxDims = 0,				 \
+		.tileDim1D = 0,				 \
+		.doGas = false,				 \
+		.gasShift = 0.0,			 \
+		.gasStride = 0,				 \
+		.npGasTotal = 0,			 \
+		.numCenters = 0,			 \
 	}
 
 
@@ -70,22 +84,42 @@ generateICsCore_toParticles(generateICsCore_const_t d);
 extern void
 generateICsCore_initPosID(generateICsCore_const_t d);
 
+/**
+ * @brief  Sorts the particles set up by generateICsCore_initPosID() along
+ *         the Peano-Hilbert curve through the full box.
+ *
+ * The curve is nested, sorting the particles of every tile hence puts a
+ * file that holds its tiles in Peano-Hilbert order into that order as a
+ * whole.  This only holds if the number of tiles per dimension and the
+ * grid size of the level are powers of two, generateICs_run() checks this
+ * before any particles are made.  Sequential 32bit IDs are reassigned to
+ * follow the new order.
+ *
+ * @param[in]  d
+ *                The core object to work with.
+ *
+ * @return  Returns nothing.
+ */
 extern void
-generateICsCore_vel2pos(generateICsCore_const_t d);
-
-extern void
-generateICsCore_convertVel(generateICsCore_const_t d);
-
-extern void
-generateICsCode_dm2Gas(generateICsCore_const_t d,
-                       const double            gasOffset,
-                       const uint64_t          npGasTotal);
-                       
-extern void
-generateICsCore_recenter(generateICsCore_const_t d, float* newCenter);
+generateICsCore_sortPeanoHilbert(generateICsCore_const_t d);
 
+/**
+ * @brief  Turns the particles set up by generateICsCore_initPosID() into
+ *         their final form in one sweep.
+ *
+ * Per particle this displaces the position by the velocity, wraps it
+ * periodically, converts the velocity, places the gas twin (if
+ * @c doGas is set, the dark matter twin is stored @c gasStride particles
+ * further and its ID is offset by @c npGasTotal), applies the
+ * @c numCenters recenterings and finally converts to kpc if requested.
+ *
+ * @param[in]  d
+ *                The core object to work with.
+ *
+ * @return  Returns nothing.
+ */
 extern void
-generateICsCore_kpc(generateICsCore_const_t d);
+generateICsCore_convertParticles(generateICsCore_const_t d);
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -65,6 +65,8 @@ struct generateICs_IniData_struct {
 	bool   sequentialIDs;
 	/** @brief  Stores key @c doMassBlock. */
 	bool   doMassBlock;
+	/** @brief  Stores key @c peanoHilbertOrder. */
+	bool   peanoHilbertOrder;
 	/** @brief  Stores key @c ginnungagapSection. */
 	char   *g9pSection;
 	/** @brief  Stores key @c inputSection. */
@@ -200,6 +202,29 @@ inline static void
 local_iniDataNewFromIni_doMassBlock(generateICs_iniData_t iniData,
                                   parse_ini_t           ini,
                                   const char            *secName);
+
+/** @copydoc local_iniDataNewFromIni_boxsize() */
+inline static void
+local_iniDataNewFromIni_peanoHilbertOrder(generateICs_iniData_t iniData,
+                                          parse_ini_t           ini,
+                                          const char            *secName);
+/**
+ * @brief  Creates the reader for one velocity component.
+ *
+ * Collective reads are refused: the tasks read different numbers of tiles
+ * (handed out dynamically) from a second thread while converting, which
+ * collective MPI-IO cannot follow and would deadlock on.
+ *
+ * @param[in]  ini
+ *                The ini file to work with.
+ * @param[in]  name
+ *                The name of the section describing the reader.
+ *
+ * @return  Returns the new reader.
+ */
+inline static gridReader_t
+local_newFromIni_velReader(parse_ini_t ini, const char *name);
+
 /**
  * @brief  Helper function for generateICsFactory_newFromIni() dealing with
  *         the input.
@@ -209,15 +234,12 @@ local_iniDataNewFromIni_doMassBlock(generateICs_iniData_t iniData,
  * @param[in]      *levelSection
  *                    The name of the section from which to construct the
  *                    input details.
- * @param[in,out]  genics
- *                    The object to work with.
  *
- * @return  Returns nothing.
+ * @return  Returns the new input object.
  */
-inline static void
-local_newFromIni_input(parse_ini_t   ini,
-                       const char    *secName,
-                       generateICs_t genics);
+inline static generateICsIn_t
+local_newFromIni_input(parse_ini_t ini,
+                       const char  *secName);
 
 
 /**
@@ -253,6 +275,7 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 	char 		tname[50];
 	int32_t	minlev, maxlev;
 	double* shift;
+	bool    allLevels;
 
 	assert(ini != NULL);
 
@@ -264,7 +287,8 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 
 	generateICsMode_t mode;
 	mode = generateICsMode_new(iniData->doGas, iniData->doLongIDs, iniData->autoCenter, 
-	                           iniData->kpc,iniData->sequentialIDs, iniData->doMassBlock);
+	                           iniData->kpc,iniData->sequentialIDs, iniData->doMassBlock,
+	                           iniData->peanoHilbertOrder);
 	generateICs_setMode(genics, mode);
 
 	generateICsData_t data;
@@ -290,19 +314,46 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 	minlev = g9pMask_getMinLevel(mask);
 	maxlev = g9pMask_getMaxLevel(mask);
 
-	local_newFromIni_input(ini, iniData->inputSection, genics);
+	if (!parse_ini_get_bool(ini, "allLevels",
+	                        (sectionName != NULL) ? sectionName :
+	                        GENERATEICSCONFIG_DEFAULT_SECTIONNAME,
+	                        &allLevels))
+		allLevels = false;
+
+	if (allLevels) {
+		// Every level reads its velocities from its own input section.
+		for (int i = minlev; i <= maxlev; i++) {
+			char *inputSection;
+
+			sprintf(tname, "inputSectionForLevel%1u", i);
+			getFromIni(&inputSection, parse_ini_get_string, ini, tname,
+			           (sectionName != NULL) ? sectionName :
+			           GENERATEICSCONFIG_DEFAULT_SECTIONNAME);
+			generateICs_setInForLevel(genics, i,
+			                          local_newFromIni_input(ini,
+			                                                 inputSection));
+			xfree(inputSection);
+		}
+		generateICs_setAllLevels(genics, true);
+		generateICs_setZoomLevel(genics, minlev);
+	} else {
+		generateICs_setIn(genics,
+		                  local_newFromIni_input(ini, iniData->inputSection));
+	}
 	local_newFromIni_output(ini, iniData->outputSection, genics,minlev,maxlev);
 
 	local_iniDataDel(&iniData);
 	
-	getFromIni(
-	&(zlevel),
-	parse_ini_get_int32,
-	ini,
-	"zoomLevel",
-		        (sectionName != NULL) ? sectionName :
-	                                  GENERATEICSCONFIG_DEFAULT_SECTIONNAME);
-	generateICs_setZoomLevel(genics,zlevel);
+	if (!allLevels) {
+		getFromIni(
+		&(zlevel),
+		parse_ini_get_int32,
+		ini,
+		"zoomLevel",
+			        (sectionName != NULL) ? sectionName :
+		                                  GENERATEICSCONFIG_DEFAULT_SECTIONNAME);
+		generateICs_setZoomLevel(genics,zlevel);
+	}
 	
 	int32_t  TypeForLevel [maxlev-minlev+1];
 	
@@ -343,6 +394,7 @@ local_iniDataNewFromIni(parse_ini_t ini, const char *sectionName)
 	local_iniDataNewFromIni_kpc(iniData, ini, sectionName);
 	local_iniDataNewFromIni_sequentialIDs(iniData, ini, sectionName);
 	local_iniDataNewFromIni_doMassBlock(iniData, ini, sectionName);
+	local_iniDataNewFromIni_peanoHilbertOrder(iniData, ini, sectionName);
 	local_iniDataNewFromIni_section(iniData, ini, sectionName);
 
 	local_iniDataNewFromIni_boxsize(iniData, ini, iniData->g9pSection);
@@ -361,6 +413,7 @@ local_iniDataInit(generateICs_iniData_t iniData)
 	iniData->doLongIDs        = false;
 	iniData->sequentialIDs    = true;
 	iniData->doMassBlock      = false;
+	iniData->peanoHilbertOrder = false;
 	iniData->g9pSection       = NULL;
 	iniData->inputSection     = NULL;
 	iniData->outputSection    = NULL;
@@ -480,6 +533,21 @@ local_iniDataNewFromIni_doMassBlock(generateICs_iniData_t iniData,
 	}
 }
 
+inline static void
+local_iniDataNewFromIni_peanoHilbertOrder(generateICs_iniData_t iniData,
+                                          parse_ini_t           ini,
+                                          const char            *secName)
+{
+	assert(iniData != NULL);
+	assert(ini != NULL);
+	assert(secName != NULL);
+
+	if ( !parse_ini_get_bool( ini, "peanoHilbertOrder", secName,
+	                          &(iniData->peanoHilbertOrder) ) ) {
+		iniData->peanoHilbertOrder = GENERATEICSCONFIG_DEFAULT_PEANOHILBERTORDER;
+	}
+}
+
 inline static void
 local_iniDataNewFromIni_autoCenter(generateICs_iniData_t iniData,
                                   parse_ini_t           ini,
@@ -551,25 +619,39 @@ local_iniDataNewFromIni_section(generateICs_iniData_t iniData,
 	}
 } // local_iniDataNewFromIni_section
 
-inline static void
-local_newFromIni_input(parse_ini_t   ini,
-                       const char    *secName,
-                       generateICs_t genics)
+inline static gridReader_t
+local_newFromIni_velReader(parse_ini_t ini, const char *name)
+{
+	bool doCollectiveRead;
+
+	if (parse_ini_get_bool(ini, "doCollectiveRead", name, &doCollectiveRead)
+	    && doCollectiveRead) {
+		fprintf(stderr, "ERROR: generateICs cannot read %s collectively, "
+		        "set doCollectiveRead = false.\n", name);
+		diediedie(EXIT_FAILURE);
+	}
+
+	return gridReaderFactory_newReaderFromIni(ini, name);
+}
+
+inline static generateICsIn_t
+local_newFromIni_input(parse_ini_t ini,
+                       const char  *secName)
 {
 	char         *name;
 	gridReader_t reader[3];
 	bool		 tmp, doPatch;
 
 	getFromIni(&name, parse_ini_get_string, ini, "velxSection", secName);
-	reader[0] = gridReaderFactory_newReaderFromIni(ini, name);
+	reader[0] = local_newFromIni_velReader(ini, name);
 	xfree(name);
 
 	getFromIni(&name, parse_ini_get_string, ini, "velySection", secName);
-	reader[1] = gridReaderFactory_newReaderFromIni(ini, name);
+	reader[1] = local_newFromIni_velReader(ini, name);
 	xfree(name);
 
 	getFromIni(&name, parse_ini_get_string, ini, "velzSection", secName);
-	reader[2] = gridReaderFactory_newReaderFromIni(ini, name);
+	reader[2] = local_newFromIni_velReader(ini, name);
 	xfree(name);
 
 /*	tmp = parse_ini_get_bool(ini, "doPatch", secName,
@@ -580,8 +662,7 @@ local_newFromIni_input(parse_ini_t   ini,
 		local_doPatch(ini, secName, reader[2]);
 	}
 */
-	generateICs_setIn( genics,
-	                   generateICsIn_new(reader[0], reader[1], reader[2]) );
+	return generateICsIn_new(reader[0], reader[1], reader[2]);
 }
 
 void
@@ -684,8 +765,11 @@ local_newFromIni_output(parse_ini_t   ini,
 	uint32_t        numFiles;
 	char            *prefix;
 	char            *version;
+	char            *format;
 	char 			tname[50];
 	gadgetVersion_t ver;
+	bool            useDirectIO;
+	bool            writePerTile;
 
 //	getFromIni(&numFiles, parse_ini_get_uint32, ini, "numFiles", secName);
 	
@@ -707,8 +791,34 @@ local_newFromIni_output(parse_ini_t   ini,
 		xfree(version);
 	}
 
+	if ( !parse_ini_get_bool(ini, "useDirectIO", secName,
+	                         &useDirectIO) ) {
+		useDirectIO = false;
+	}
+	if ( !parse_ini_get_bool(ini, "writePerTile", secName,
+	                         &writePerTile) ) {
+		writePerTile = false;
+	}
+
 	generateICsOut_t out;
 	out = generateICsOut_new(prefix, numFilesForLevel, ver, maxlev-minlev+1);
+	gadget_setUseDirectIO(out->gadget, useDirectIO);
+	out->writePerTile = writePerTile;
+
+	if ( parse_ini_get_string(ini, "format", secName, &format) ) {
+		if (strcmp(format, "hdf5") == 0) {
+#ifdef WITH_HDF5
+			out->hdf5 = generateICsHDF5_new(prefix);
+#else
+			fprintf(stderr, "ERROR: HDF5 output requires HDF5 support.\n");
+			diediedie(EXIT_FAILURE);
+#endif
+		} else if (strcmp(format, "gadget") != 0) {
+			fprintf(stderr, "ERROR: Unknown output format %s\n", format);
+			diediedie(EXIT_FAILURE);
+		}
+		xfree(format);
+	}
 
 	generateICs_setOut(genics, out);
 
@@ -0,0 +1,362 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file generateICs/generateICsHDF5.c
+ * @ingroup  toolsGICSHDF5
+ * @brief  Implements the HDF5 snapshot output.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "generateICsConfig.h"
+#include "generateICsHDF5.h"
+#ifdef WITH_HDF5
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../../src/libutil/xmem.h"
+#include "../../src/libutil/xstring.h"
+#include "../../src/libutil/diediedie.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+#ifdef ENABLE_DOUBLE
+#  define LOCAL_FPV_H5TYPE H5T_NATIVE_DOUBLE
+#else
+#  define LOCAL_FPV_H5TYPE H5T_NATIVE_FLOAT
+#endif
+
+/** @brief  The datasets of each particle type. */
+enum {
+	LOCAL_DS_COORDINATES = 0,
+	LOCAL_DS_VELOCITIES,
+	LOCAL_DS_PARTICLEIDS,
+	LOCAL_DS_MASSES,
+	LOCAL_DS_INTERNALENERGY,
+	LOCAL_DS_NUM = GENERATEICSHDF5_NUM_DATASETS
+};
+
+/** @brief  The names of the datasets, in the order of the enum above. */
+static const char *local_dsNames[LOCAL_DS_NUM]
+    = {"Coordinates", "Velocities", "ParticleIDs", "Masses",
+	   "InternalEnergy"};
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static void
+local_writeHeader(const generateICsHDF5_t genicsHDF5,
+                  const gadgetHeader_t    header);
+
+static void
+local_writeAttribute(hid_t      loc,
+                     const char *name,
+                     hid_t      type,
+                     hsize_t    num,
+                     const void *data);
+
+static void
+local_createType(const generateICsHDF5_t genicsHDF5, int type);
+
+static hid_t
+local_getIDType(const generateICsHDF5_t genicsHDF5);
+
+static void
+local_writeDataSet(hid_t      dataSet,
+                   hid_t      memType,
+                   hsize_t    numComponents,
+                   uint64_t   offset,
+                   uint64_t   np,
+                   const void *data);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern generateICsHDF5_t
+generateICsHDF5_new(const char *prefix)
+{
+	generateICsHDF5_t genicsHDF5;
+
+	assert(prefix != NULL);
+
+	genicsHDF5             = xmalloc( sizeof(struct generateICsHDF5_struct) );
+	genicsHDF5->fileName   = xstrmerge(prefix, ".hdf5");
+	genicsHDF5->file       = H5I_INVALID_HID;
+	genicsHDF5->useLongIDs = false;
+	for (int i = 0; i < 6; i++) {
+		genicsHDF5->npTotal[i] = UINT64_C(0);
+		for (int j = 0; j < LOCAL_DS_NUM; j++)
+			genicsHDF5->dataSets[i][j] = H5I_INVALID_HID;
+	}
+
+	return genicsHDF5;
+}
+
+extern void
+generateICsHDF5_del(generateICsHDF5_t *genicsHDF5)
+{
+	assert(genicsHDF5 != NULL && *genicsHDF5 != NULL);
+	assert((*genicsHDF5)->file == H5I_INVALID_HID);
+
+	xfree( (*genicsHDF5)->fileName );
+	xfree(*genicsHDF5);
+
+	*genicsHDF5 = NULL;
+}
+
+extern void
+generateICsHDF5_create(generateICsHDF5_t    genicsHDF5,
+                       const gadgetHeader_t header,
+                       const uint64_t       npTotal[6],
+                       bool                 useLongIDs)
+{
+	hid_t accessProp = H5P_DEFAULT;
+
+	assert(genicsHDF5 != NULL);
+	assert(genicsHDF5->file == H5I_INVALID_HID);
+
+#ifdef WITH_MPI
+	accessProp = H5Pcreate(H5P_FILE_ACCESS);
+	if (H5Pset_fapl_mpio(accessProp, MPI_COMM_WORLD, MPI_INFO_NULL) < 0)
+		diediedie(EXIT_FAILURE);
+#endif
+	genicsHDF5->file = H5Fcreate(genicsHDF5->fileName, H5F_ACC_TRUNC,
+	                             H5P_DEFAULT, accessProp);
+	if (genicsHDF5->file < 0) {
+		fprintf(stderr, "ERROR: Could not create %s\n", genicsHDF5->fileName);
+		diediedie(EXIT_FAILURE);
+	}
+	if (accessProp != H5P_DEFAULT)
+		H5Pclose(accessProp);
+
+	genicsHDF5->useLongIDs = useLongIDs;
+	for (int i = 0; i < 6; i++)
+		genicsHDF5->npTotal[i] = npTotal[i];
+
+	local_writeHeader(genicsHDF5, header);
+	for (int i = 0; i < 6; i++)
+		local_createType(genicsHDF5, i);
+} // generateICsHDF5_create
+
+extern void
+generateICsHDF5_writeParticles(generateICsHDF5_t genicsHDF5,
+                               int               type,
+                               uint64_t          offset,
+                               uint64_t          np,
+                               const fpv_t       *pos,
+                               const fpv_t       *vel,
+                               const void        *ids,
+                               fpv_t             mass)
+{
+	hid_t *dataSets = genicsHDF5->dataSets[type];
+	fpv_t *buffer;
+
+	assert(genicsHDF5 != NULL && genicsHDF5->file != H5I_INVALID_HID);
+	assert(type >= 0 && type < 6);
+	assert(offset + np <= genicsHDF5->npTotal[type]);
+
+	if (np == 0)
+		return;
+
+	local_writeDataSet(dataSets[LOCAL_DS_COORDINATES], LOCAL_FPV_H5TYPE, 3,
+	                   offset, np, pos);
+	local_writeDataSet(dataSets[LOCAL_DS_VELOCITIES], LOCAL_FPV_H5TYPE, 3,
+	                   offset, np, vel);
+	local_writeDataSet(dataSets[LOCAL_DS_PARTICLEIDS],
+	                   local_getIDType(genicsHDF5), 1, offset, np, ids);
+
+	buffer = xmalloc(sizeof(fpv_t) * np);
+	for (uint64_t i = 0; i < np; i++)
+		buffer[i] = mass;
+	local_writeDataSet(dataSets[LOCAL_DS_MASSES], LOCAL_FPV_H5TYPE, 1,
+	                   offset, np, buffer);
+	if (type == 0) {
+		for (uint64_t i = 0; i < np; i++)
+			buffer[i] = 0.0;
+		local_writeDataSet(dataSets[LOCAL_DS_INTERNALENERGY],
+		                   LOCAL_FPV_H5TYPE, 1, offset, np, buffer);
+	}
+	xfree(buffer);
+} // generateICsHDF5_writeParticles
+
+extern void
+generateICsHDF5_close(generateICsHDF5_t genicsHDF5)
+{
+	assert(genicsHDF5 != NULL && genicsHDF5->file != H5I_INVALID_HID);
+
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < LOCAL_DS_NUM; j++) {
+			if (genicsHDF5->dataSets[i][j] != H5I_INVALID_HID)
+				H5Dclose(genicsHDF5->dataSets[i][j]);
+			genicsHDF5->dataSets[i][j] = H5I_INVALID_HID;
+		}
+	}
+	H5Fclose(genicsHDF5->file);
+	genicsHDF5->file = H5I_INVALID_HID;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_writeHeader(const generateICsHDF5_t genicsHDF5,
+                  const gadgetHeader_t    header)
+{
+	uint64_t npHigh[6] = {0, 0, 0, 0, 0, 0};
+	double   massArr[6] = {0., 0., 0., 0., 0., 0.};
+	double   value;
+	int32_t  flag;
+	hid_t    group;
+
+	group = H5Gcreate(genicsHDF5->file, "Header", H5P_DEFAULT, H5P_DEFAULT,
+	                  H5P_DEFAULT);
+	if (group < 0)
+		diediedie(EXIT_FAILURE);
+
+	// As GADGET-4, all counts are written as 64 bit integers and the file
+	// holds all particles, hence this file's counts are the totals.  The
+	// high words are only kept for readers that add them to the total,
+	// which is already complete.
+	local_writeAttribute(group, "NumPart_ThisFile", H5T_NATIVE_UINT64, 6,
+	                     genicsHDF5->npTotal);
+	local_writeAttribute(group, "NumPart_Total", H5T_NATIVE_UINT64, 6,
+	                     genicsHDF5->npTotal);
+	local_writeAttribute(group, "NumPart_Total_HighWord", H5T_NATIVE_UINT64,
+	                     6, npHigh);
+	// Every particle has its mass in the Masses dataset.
+	local_writeAttribute(group, "MassTable", H5T_NATIVE_DOUBLE, 6, massArr);
+	value = gadgetHeader_getTime(header);
+	local_writeAttribute(group, "Time", H5T_NATIVE_DOUBLE, 1, &value);
+	value = gadgetHeader_getRedshift(header);
+	local_writeAttribute(group, "Redshift", H5T_NATIVE_DOUBLE, 1, &value);
+	value = gadgetHeader_getBoxsize(header);
+	local_writeAttribute(group, "BoxSize", H5T_NATIVE_DOUBLE, 1, &value);
+	value = gadgetHeader_getOmega0(header);
+	local_writeAttribute(group, "Omega0", H5T_NATIVE_DOUBLE, 1, &value);
+	value = gadgetHeader_getOmegaLambda(header);
+	local_writeAttribute(group, "OmegaLambda", H5T_NATIVE_DOUBLE, 1, &value);
+	value = gadgetHeader_getHubbleParameter(header);
+	local_writeAttribute(group, "HubbleParam", H5T_NATIVE_DOUBLE, 1, &value);
+	flag = 1;
+	local_writeAttribute(group, "NumFilesPerSnapshot", H5T_NATIVE_INT32, 1,
+	                     &flag);
+	flag = 0;
+	local_writeAttribute(group, "Flag_Entropy_ICs", H5T_NATIVE_INT32, 1,
+	                     &flag);
+#ifdef ENABLE_DOUBLE
+	flag = 1;
+#endif
+	local_writeAttribute(group, "Flag_DoublePrecision", H5T_NATIVE_INT32, 1,
+	                     &flag);
+	flag = NDIM;
+	local_writeAttribute(group, "Dimension", H5T_NATIVE_INT32, 1, &flag);
+
+	H5Gclose(group);
+} // local_writeHeader
+
+static void
+local_writeAttribute(hid_t      loc,
+                     const char *name,
+                     hid_t      type,
+                     hsize_t    num,
+                     const void *data)
+{
+	hid_t space, attr;
+
+	if (num == 1)
+		space = H5Screate(H5S_SCALAR);
+	else
+		space = H5Screate_simple(1, &num, NULL);
+	attr = H5Acreate(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+	if ((attr < 0) || (H5Awrite(attr, type, data) < 0))
+		diediedie(EXIT_FAILURE);
+
+	H5Aclose(attr);
+	H5Sclose(space);
+}
+
+static void
+local_createType(const generateICsHDF5_t genicsHDF5, int type)
+{
+	const hsize_t np         = genicsHDF5->npTotal[type];
+	const hsize_t dims[2]    = {np, 3};
+	char          groupName[16];
+	hid_t         group, props;
+
+	if (np == 0)
+		return;
+
+	sprintf(groupName, "PartType%i", type);
+	group = H5Gcreate(genicsHDF5->file, groupName, H5P_DEFAULT, H5P_DEFAULT,
+	                  H5P_DEFAULT);
+	if (group < 0)
+		diediedie(EXIT_FAILURE);
+
+	// Allocating up front lets any task write any part of the dataset,
+	// every particle is written exactly once, so there is nothing to fill.
+	props = H5Pcreate(H5P_DATASET_CREATE);
+	H5Pset_alloc_time(props, H5D_ALLOC_TIME_EARLY);
+	H5Pset_fill_time(props, H5D_FILL_TIME_NEVER);
+
+	for (int j = 0; j < LOCAL_DS_NUM; j++) {
+		const int rank = (j <= LOCAL_DS_VELOCITIES) ? 2 : 1;
+		hid_t     dt   = LOCAL_FPV_H5TYPE;
+		hid_t     space;
+
+		if ((j == LOCAL_DS_INTERNALENERGY) && (type != 0))
+			continue;
+		if (j == LOCAL_DS_PARTICLEIDS)
+			dt = local_getIDType(genicsHDF5);
+
+		space = H5Screate_simple(rank, dims, NULL);
+		genicsHDF5->dataSets[type][j] = H5Dcreate(group, local_dsNames[j], dt,
+		                                    space, H5P_DEFAULT, props,
+		                                    H5P_DEFAULT);
+		if (genicsHDF5->dataSets[type][j] < 0)
+			diediedie(EXIT_FAILURE);
+		H5Sclose(space);
+	}
+
+	H5Pclose(props);
+	H5Gclose(group);
+} // local_createType
+
+static hid_t
+local_getIDType(const generateICsHDF5_t genicsHDF5)
+{
+	return genicsHDF5->useLongIDs ? H5T_NATIVE_UINT64 : H5T_NATIVE_UINT32;
+}
+
+static void
+local_writeDataSet(hid_t      dataSet,
+                   hid_t      memType,
+                   hsize_t    numComponents,
+                   uint64_t   offset,
+                   uint64_t   np,
+                   const void *data)
+{
+	const int     rank     = (numComponents > 1) ? 2 : 1;
+	const hsize_t start[2] = {offset, 0};
+	const hsize_t count[2] = {np, numComponents};
+	hid_t         spaceFile, spaceMem;
+	herr_t        rtn;
+
+	assert(dataSet != H5I_INVALID_HID);
+
+	spaceFile = H5Dget_space(dataSet);
+	H5Sselect_hyperslab(spaceFile, H5S_SELECT_SET, start, NULL, count, NULL);
+	spaceMem  = H5Screate_simple(rank, count, NULL);
+
+	rtn = H5Dwrite(dataSet, memType, spaceMem, spaceFile, H5P_DEFAULT, data);
+	if (rtn < 0)
+		diediedie(EXIT_FAILURE);
+
+	H5Sclose(spaceMem);
+	H5Sclose(spaceFile);
+}
+
+#endif
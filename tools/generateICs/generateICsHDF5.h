@@ -0,0 +1,139 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GENERATEICSHDF5_H
+#define GENERATEICSHDF5_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file generateICs/generateICsHDF5.h
+ * @ingroup  toolsGICSHDF5
+ * @brief  Provides the HDF5 snapshot output (GADGET-4/SWIFT layout).
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "generateICsConfig.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../src/libutil/gadgetHeader.h"
+#ifdef WITH_HDF5
+#  include <hdf5.h>
+#endif
+
+
+/*--- ADT handle --------------------------------------------------------*/
+typedef struct generateICsHDF5_struct *generateICsHDF5_t;
+
+
+#ifdef WITH_HDF5
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The number of datasets per particle type. */
+#define GENERATEICSHDF5_NUM_DATASETS 5
+
+
+/*--- Structure definition ----------------------------------------------*/
+struct generateICsHDF5_struct {
+	// Input
+	char     *fileName;
+	// Generated by create()
+	hid_t    file;
+	uint64_t npTotal[6];
+	bool     useLongIDs;
+	// Kept open until close(), opening is collective with MPI but the
+	// particles are written by single tasks.
+	hid_t    dataSets[6][GENERATEICSHDF5_NUM_DATASETS];
+};
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern generateICsHDF5_t
+generateICsHDF5_new(const char *prefix);
+
+extern void
+generateICsHDF5_del(generateICsHDF5_t *genicsHDF5);
+
+/**
+ * @brief  Creates the snapshot file with its header and all datasets.
+ *
+ * With MPI this is collective, all tasks must call it with the same
+ * arguments.  The datasets are allocated at their final size, the
+ * particles are afterwards written in arbitrary order by any task.
+ *
+ * @param[in,out]  genicsHDF5
+ *                    The output to work with.
+ * @param[in]      header
+ *                    Provides time, box size and cosmology of the snapshot.
+ * @param[in]      npTotal
+ *                    The number of particles of each type in the file.
+ * @param[in]      useLongIDs
+ *                    Whether the IDs are 64 bit integers.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICsHDF5_create(generateICsHDF5_t    genicsHDF5,
+                       const gadgetHeader_t header,
+                       const uint64_t       npTotal[6],
+                       bool                 useLongIDs);
+
+/**
+ * @brief  Writes a consecutive range of particles of one type.
+ *
+ * @param[in,out]  genicsHDF5
+ *                    The output to work with, must have been created.
+ * @param[in]      type
+ *                    The particle type, selects the PartType group.
+ * @param[in]      offset
+ *                    The position of the first particle in the datasets.
+ * @param[in]      np
+ *                    The number of particles to write.
+ * @param[in]      *pos
+ *                    The positions, three per particle.
+ * @param[in]      *vel
+ *                    The velocities, three per particle.
+ * @param[in]      *ids
+ *                    The IDs, 32 or 64 bit depending on create().
+ * @param[in]      mass
+ *                    The mass of each of the particles.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICsHDF5_writeParticles(generateICsHDF5_t genicsHDF5,
+                               int               type,
+                               uint64_t          offset,
+                               uint64_t          np,
+                               const fpv_t       *pos,
+                               const fpv_t       *vel,
+                               const void        *ids,
+                               fpv_t             mass);
+
+/**
+ * @brief  Closes the snapshot file, this is collective with MPI.
+ *
+ * @param[in,out]  genicsHDF5
+ *                    The output to work with.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICsHDF5_close(generateICsHDF5_t genicsHDF5);
+
+#endif
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup toolsGICSHDF5 HDF5 output
+ * @ingroup toolsGICS
+ * @brief Writes the particles into one HDF5 snapshot file.
+ */
+
+#endif
@@ -32,13 +32,15 @@ struct generateICsMode_struct {
 	const bool kpc;
 	const bool sequentialIDs;
 	const bool doMassBlock;
+	const bool peanoHilbertOrder;
 };
 
 
 /*--- Prototypes of exported functions ----------------------------------*/
 extern generateICsMode_t
 generateICsMode_new(const bool doGas, const bool useLongIDs, const bool autoCenter, 
-                    const bool kpc, const bool sequentialIDs, const bool doMassBlock);
+                    const bool kpc, const bool sequentialIDs, const bool doMassBlock,
+                    const bool peanoHilbertOrder);
 
 extern void
 generateICsMode_del(generateICsMode_t *mode);
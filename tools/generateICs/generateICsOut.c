@@ -57,7 +57,9 @@ generateICsOut_new(const char *prefix, uint32_t* outputFiles, gadgetVersion_t v,
 	gadgetTOC_addEntryByType(genicsOut->toc, GADGETBLOCK_ID__);
 	//gadgetTOC_addEntryByType(genicsOut->toc, GADGETBLOCK_MASS);
 
-	genicsOut->baseHeader = NULL;
+	genicsOut->writePerTile = false;
+	genicsOut->hdf5         = NULL;
+	genicsOut->baseHeader   = NULL;
 
 	return genicsOut;
 } // generateICsOut_new
@@ -72,6 +74,11 @@ generateICsOut_del(generateICsOut_t *genicsOut)
 		gadgetHeader_del( &( (*genicsOut)->baseHeader ) );
 	}
 	gadget_del( &( (*genicsOut)->gadget ) );
+#ifdef WITH_HDF5
+	if ( (*genicsOut)->hdf5 != NULL ) {
+		generateICsHDF5_del( &( (*genicsOut)->hdf5 ) );
+	}
+#endif
 
 	xfree(*genicsOut);
 
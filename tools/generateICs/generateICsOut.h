@@ -19,6 +19,7 @@
 #include "generateICsConfig.h"
 #include "generateICsData.h"
 #include "generateICsMode.h"
+#include "generateICsHDF5.h"
 #include "../../src/libutil/gadget.h"
 
 
@@ -32,7 +33,12 @@ struct generateICsOut_struct {
 	//const int      numFiles;
 	uint32_t*		numFilesForLevel;
 	gadget_t       gadget;
+	// The blocks every file has, each file extends its own copy
 	gadgetTOC_t    toc;
+	// Write the particles of each tile as soon as they are generated
+	bool           writePerTile;
+	// If set, all particles go to this HDF5 file instead of gadget
+	generateICsHDF5_t hdf5;
 	// Generated by initBaseHeader();
 	gadgetHeader_t baseHeader;
 };
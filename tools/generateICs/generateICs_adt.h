@@ -62,6 +62,15 @@ struct generateICs_struct {
 	int32_t zoomlevel;
 	int32_t *typeForLevel;
 	double *shift;
+
+	/** @brief  Whether all levels are produced in one run. */
+	bool            allLevels;
+	/** @brief  Stores the input of each level when doing all levels. */
+	generateICsIn_t *inForLevel;
+	/** @brief  The number of particles of each level in each tile. */
+	uint64_t        *numPartsInTile;
+	/** @brief  The number of particles in each level. */
+	uint64_t        *numPartsInLevel;
 };
 
 
@@ -157,6 +157,36 @@ generateICs_setZoomLevel(generateICs_t genics, int32_t z)
 	genics->zoomlevel = z;
 }
 
+extern void
+generateICs_setAllLevels(generateICs_t genics, bool allLevels)
+{
+	assert(genics != NULL);
+	genics->allLevels = allLevels;
+}
+
+extern void
+generateICs_setInForLevel(generateICs_t   genics,
+                          int32_t         level,
+                          generateICsIn_t in)
+{
+	assert(genics != NULL);
+	assert(genics->mask != NULL);
+	assert(level >= g9pMask_getMinLevel(genics->mask)
+	       && level <= g9pMask_getMaxLevel(genics->mask));
+
+	const int numLevels = g9pMask_getNumLevel(genics->mask);
+	const int idx       = level - g9pMask_getMinLevel(genics->mask);
+
+	if (genics->inForLevel == NULL) {
+		genics->inForLevel = xmalloc(sizeof(generateICsIn_t) * numLevels);
+		for (int i = 0; i < numLevels; i++)
+			genics->inForLevel[i] = NULL;
+	}
+	if (genics->inForLevel[idx] != NULL)
+		generateICsIn_del(&(genics->inForLevel[idx]));
+	genics->inForLevel[idx] = in;
+}
+
 extern uint32_t
 generateICs_getMinLevel(generateICs_t genics)
 {
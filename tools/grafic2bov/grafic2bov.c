@@ -156,11 +156,13 @@ local_getDataAndMeta(const char *fname,
 static void
 local_writeData(const char *fname, const float *data, size_t numElements)
 {
-	FILE *f;
+	xfileDirect_t fd;
+	size_t        bytes = sizeof(float) * numElements;
 
-	f = xfopen(fname, "wb");
-	xfwrite(data, sizeof(float), numElements, f);
-	xfclose(&f);
+	xfile_createFileWithSize(fname, bytes);
+	fd = xfile_openDirect(fname, 0);
+	xfile_writeDirect(fd, data, bytes);
+	xfile_closeDirect(&fd);
 }
 
 static void
@@ -350,15 +350,17 @@ local_doHistogram(makeMask_t mama)
 		int      particleMult  = 1;
 		int      gridMult      = 1;
 		for (uint32_t i = 0; i < mama->setup->numLevels; i++) {
-			uint32_t numInBin = gridHistogram_getCountInBin(histo, i + 1);
-			printf("    level %1u (%5u^%i): %10u (%10u particles)\n",
+			uint64_t numInBin = gridHistogram_getCountInBin(histo, i + 1);
+			printf("    level %1u (%5u^%i): %10" PRIu64
+			       " (%10" PRIu64 " particles)\n",
 			       i, mama->setup->baseGridSize1D * gridMult, NDIM,
 			       numInBin, numInBin * particleMult);
 			numTotalParts += numInBin * particleMult;
 			particleMult  *= POW_NDIM(mama->setup->refinementFactor);
 			gridMult      *= mama->setup->refinementFactor;
 		}
-		printf("      -->  total of %10lu particles\n", numTotalParts);
+		printf("      -->  total of %10" PRIu64 " particles\n",
+		       numTotalParts);
 	}
 
 	gridHistogram_del(&histo);
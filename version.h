@@ -0,0 +1,138 @@
+// Copyright (C) 2010, 2011, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef VERSION_H
+#define VERSION_H
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file version.h
+ * @brief  Provides the code version information.
+ */
+
+
+/*--- Version information -----------------------------------------------*/
+
+/**
+ * @name  Version Information
+ *
+ * @{
+ */
+
+/** @brief The state of the package (0: alpha, 1: beta, 2: release). */
+#define PACKAGE_STATE 2
+
+/** @brief  The name of the package. */
+#define PACKAGE_NAME          "ginnungagap"
+
+/** @brief  The main owner of this package . */
+#define PACKAGE_OWNER         "Steffen Knollmann"
+
+/** @brief  The email address to report bugs. */
+#define PACKAGE_BUG_EMAIL     "sknollmann@gmail.com"
+
+/** @brief  The major version of the package. */
+#define PACKAGE_VERSION_MAJOR 0
+
+/** @brief  The minor version of the package. */
+#define PACKAGE_VERSION_MINOR 7
+
+/** @brief  The micro version of the package. */
+#define PACKAGE_VERSION_MICRO 0
+
+#if (PACKAGE_STATE == 0)
+#  define PACKAGE_VERSION_EXTRA "(alpha)"
+#elif (PACKAGE_STATE == 1)
+#  define PACKAGE_VERSION_EXTRA "(beta)"
+#elif (PACKAGE_STATE == 2)
+#  define PACKAGE_VERSION_EXTRA "(release)"
+#else
+#  error "PACKAGE_STATE must be 0, 1, or 2"
+#endif
+/**
+ * @def PACKAGE_VERSION_EXTRA
+ * @brief  Gives some extra information about the package version.
+ */
+
+/** @brief  The git revision number of this version of the package. */
+#define PACKAGE_VERSION_REVISION "\ncommit cafb76a28d91eac267c789bebf15f4ca2e0765a6"
+
+/** @} */
+
+
+/*--- Built information -------------------------------------------------*/
+
+/**
+ * @name  Built information
+ * @{
+ */
+
+/** @brief  The user who ran @c configure. */
+#define PACKAGE_BUILT_USER "root"
+/** @brief  The date at which @c configure was run. */
+#define PACKAGE_BUILT_DATE "Mon Oct 19 02:11:09 UTC 2026"
+/** @brief  The machine @c configure was run on. */ 
+#define PACKAGE_BUILT_HOST "vm"
+/** @brief  The directory from which @c configure was started. */ 
+#define PACKAGE_BUILT_DIR  "/root/repo"
+
+/** @} */
+
+
+/*--- Macros to report the version and built information ----------------*/
+
+/**
+ * @brief  Macros to Report the Version and Built Information
+ * @{
+ */
+
+/** @brief  Show version information of main pacakge. */
+#define PRINT_VERSION_INFO(f)                                         \
+    fprintf((f), "\nThis is %s %i.%i.%i %s  %s\n\n"                   \
+                 "Copyright (C) 2010, 2011, 2012, 2013 %s\n"          \
+                 "This is free software; see the source for copying " \
+                 "conditions.  There is NO \n"                        \
+                 "warranty; not even for MERCHANTABILITY or FITNESS " \
+                 "FOR A PARTICULAR PURPOSE.\n\n"                      \
+                 "Please send bugreports to %s.\n\n",                 \
+            PACKAGE_NAME,                                             \
+            PACKAGE_VERSION_MAJOR,                                    \
+            PACKAGE_VERSION_MINOR,                                    \
+            PACKAGE_VERSION_MICRO,                                    \
+            PACKAGE_VERSION_EXTRA,                                    \
+            PACKAGE_VERSION_REVISION,                                 \
+            PACKAGE_OWNER,                                            \
+            PACKAGE_BUG_EMAIL);
+
+/** @brief  Show built information. */
+#define PRINT_BUILT_INFO(f)                                             \
+    fprintf((f), "\nBinary built by %s@%s (%s)\nfrom directory %s\n\n", \
+            PACKAGE_BUILT_USER,                                         \
+            PACKAGE_BUILT_HOST,                                         \
+            PACKAGE_BUILT_DATE,                                         \
+            PACKAGE_BUILT_DIR);
+
+/** @brief  Show version information of a subpackage. */
+#define PRINT_VERSION_INFO2(f, progname)                              \
+    fprintf((f), "\nThis is %s of %s %i.%i.%i %s  %s\n\n"             \
+                 "Copyright (C) 2010, 2011, 2012, 2013 %s\n"          \
+                 "This is free software; see the source for copying " \
+                 "conditions.  There is NO \n"                        \
+                 "warranty; not even for MERCHANTABILITY or FITNESS " \
+                 "FOR A PARTICULAR PURPOSE.\n\n"                      \
+                 "Please send bugreports to %s.\n\n",                 \
+            (progname),                                               \
+            PACKAGE_NAME,                                             \
+            PACKAGE_VERSION_MAJOR,                                    \
+            PACKAGE_VERSION_MINOR,                                    \
+            PACKAGE_VERSION_MICRO,                                    \
+            PACKAGE_VERSION_EXTRA,                                    \
+            PACKAGE_VERSION_REVISION,                                 \
+            PACKAGE_OWNER,                                            \
+            PACKAGE_BUG_EMAIL);
+
+/** @} */
+
+#endif